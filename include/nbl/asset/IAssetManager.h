@@ -6,6 +6,7 @@
 #define __NBL_ASSET_I_ASSET_MANAGER_H_INCLUDED__
 
 #include <array>
+#include <optional>
 #include <ostream>
 
 #include "nbl/core/declarations.h"
@@ -36,8 +37,8 @@ std::function<void(SAssetBundle&)> makeAssetDisposeFunc(const IAssetManager* con
 //! Class responsible for handling loading of assets from file system or other resources
 /**
 	It provides a loading, writing and creation functionality that is almost thread-safe.
-	There is one issue with threading, starting loading the same asset at the exact same time 
-	may end up with two copies in the cache.
+	Starting to load the same cacheable asset from two threads at once makes the latter wait for the former
+	and then fetch the result from the cache, see getAssetAsync() for loading on the CTaskScheduler.
 
 	IAssetManager performs caching of CPU assets associated with resource handles such as names, 
 	filenames, UUIDs. However there are separate caches for each asset type.
@@ -85,11 +86,16 @@ class NBL_API2 IAssetManager : public core::IReferenceCounted, public core::Quit
         static void refCtdDispose(T* _asset) { _asset->drop(); }
 
         core::smart_refctd_ptr<system::ISystem> m_system;
+        core::smart_refctd_ptr<core::CTaskScheduler> m_scheduler;
         IAssetLoader::IAssetLoaderOverride m_defaultLoaderOverride;
 
         std::array<AssetCacheType*, IAsset::ET_STANDARD_TYPES_COUNT> m_assetCache;
         std::array<CpuGpuCacheType*, IAsset::ET_STANDARD_TYPES_COUNT> m_cpuGpuCache;
 
+        //! Cacheable loads which are in progress, keyed same as `m_assetCache`
+        std::mutex m_inFlightLoadMutex;
+        core::unordered_map<std::string,core::CTaskScheduler::future_t<bool>> m_inFlightLoads;
+
         struct Loaders {
             Loaders() : perFileExt{&refCtdGreet<IAssetLoader>, &refCtdDispose<IAssetLoader>} {}
 
@@ -125,8 +131,9 @@ class NBL_API2 IAssetManager : public core::IReferenceCounted, public core::Quit
 
     public:
         //! Constructor
-        explicit IAssetManager(core::smart_refctd_ptr<system::ISystem>&& system, core::smart_refctd_ptr<CCompilerSet>&& compilerSet = nullptr) :
+        explicit IAssetManager(core::smart_refctd_ptr<system::ISystem>&& system, core::smart_refctd_ptr<CCompilerSet>&& compilerSet = nullptr, core::smart_refctd_ptr<core::CTaskScheduler>&& scheduler = nullptr) :
             m_system(std::move(system)),
+            m_scheduler(scheduler ? std::move(scheduler):core::smart_refctd_ptr<core::CTaskScheduler>(core::CTaskScheduler::getDefault())),
             m_compilerSet(std::move(compilerSet)),
             m_defaultLoaderOverride(this)
         {
@@ -142,6 +149,8 @@ class NBL_API2 IAssetManager : public core::IReferenceCounted, public core::Quit
         }
 
 		inline system::ISystem* getSystem() const { return m_system.get(); }
+		//! Scheduler running `getAssetAsync` and loaders' child loads, defaults to `core::CTaskScheduler::getDefault()`
+		inline core::CTaskScheduler* getScheduler() const { return m_scheduler.get(); }
 
         const IGeometryCreator* getGeometryCreator() const;
         IMeshManipulator* getMeshManipulator();
@@ -216,6 +225,9 @@ class NBL_API2 IAssetManager : public core::IReferenceCounted, public core::Quit
                 mask = core::bitfieldInsert<flags_t>(mask, IAssetLoader::ECF_DONT_CACHE_REFERENCES, 2u*_hierarchyLevel, 2u*restoreLevels);
                 params.cacheFlags = static_cast<IAssetLoader::E_CACHING_FLAGS>(params.cacheFlags & mask);
             }
+            // a partially loaded image must neither be served from, nor end up in the cache under the key of the whole one
+            if (!params.imageSubset.isWholeImage())
+                params.cacheFlags = IAssetLoader::ECF_DUPLICATE_REFERENCES;
 
             IAssetLoader::SAssetLoadContext ctx{params, _file};
 
@@ -243,6 +255,21 @@ class NBL_API2 IAssetManager : public core::IReferenceCounted, public core::Quit
             if (!file)
                 return {};//return empty bundle
 
+            // somebody else could be loading the same asset right now, then we wait for them and look in the cache again
+            CInFlightLoad inFlight;
+            if (!restoreLevels && (levelFlags&IAssetLoader::ECF_DUPLICATE_TOP_LEVEL)==0ull)
+            {
+                const auto key = filename.string();
+                const auto otherLoad = claimInFlightLoad(key,inFlight);
+                // if they failed, or the asset got evicted in the meantime, we fall through and try ourselves
+                if (!otherLoad.valid() || waitForInFlightLoad(otherLoad))
+                {
+                    auto found = findAssets(key);
+                    if (found->size())
+                        return _override->chooseRelevantFromFound(found->begin(), found->end(), ctx, _hierarchyLevel);
+                }
+            }
+
             auto ext = system::extension_wo_dot(filename);
             auto capableLoadersRng = m_loaders.perFileExt.findRange(ext);
             // loaders associated with the file's extension tryout
@@ -270,6 +297,7 @@ class NBL_API2 IAssetManager : public core::IReferenceCounted, public core::Quit
                 if (!bundle.getContents().empty() && addToCache)
                     _override->insertAssetIntoCache(bundle, filename.string(), ctx, _hierarchyLevel);
             }
+            inFlight.finish(!bundle.getContents().empty());
 
             auto whole_bundle_not_dummy = [restoreLevels](const SAssetBundle& _b) {
                 auto rng = _b.getContents();
@@ -317,6 +345,37 @@ class NBL_API2 IAssetManager : public core::IReferenceCounted, public core::Quit
             
             return bundle;
         }
+        //! RAII claim on loading a cacheable asset, other threads requesting the same key wait until `finish` gets called
+        /** Needs to be finished on the thread which claimed it, the load and everything it spawns runs in a `core::CTaskScheduler::CNoWaitScope`. */
+        class CInFlightLoad final : public core::Uncopyable
+        {
+            public:
+                CInFlightLoad() = default;
+                inline ~CInFlightLoad() {finish(false);}
+
+                //! `loaded` tells the waiters whether its worth looking in the cache again, only first call has an effect
+                NBL_API2 void finish(const bool loaded);
+
+            private:
+                friend class IAssetManager;
+
+                IAssetManager* m_manager = nullptr;
+                std::string m_key;
+                std::optional<core::CTaskScheduler::promise_t<bool>> m_promise;
+                std::optional<core::CTaskScheduler::CNoWaitScope> m_noWait;
+        };
+        //! Returns a valid future if another thread is already loading `_key`, otherwise `claim` becomes responsible for signalling the end of the load
+        /** If the caller runs inside of someone's load (it's in a `core::CTaskScheduler::CNoWaitScope`) then it gets neither a future nor the claim
+        and should load on its own, the other load could be waiting on us, either because it's the same one further down our stack, or
+        because it needs something we already claimed. So only loads which don't happen on behalf of other loads get deduplicated. */
+        NBL_API2 core::CTaskScheduler::future_t<bool> claimInFlightLoad(const std::string& _key, CInFlightLoad& claim);
+        //! Waits on a future from `claimInFlightLoad` without running other tasks in the meantime
+        /** Keeps the thread from picking up long running tasks in the meantime, the waiter can only hold up others through its own task groups. */
+        static inline bool waitForInFlightLoad(const core::CTaskScheduler::future_t<bool>& otherLoad)
+        {
+            return otherLoad.get(false);
+        }
+
         //TODO change name
         template <bool RestoreWholeBundle>
         SAssetBundle getAssetInHierarchy_impl(const std::string& _filePath, const IAssetLoader::SAssetLoadParams& _params, uint32_t _hierarchyLevel, IAssetLoader::IAssetLoaderOverride* _override)
@@ -370,6 +429,23 @@ class NBL_API2 IAssetManager : public core::IReferenceCounted, public core::Quit
             return getAssetInHierarchy_impl<false>(_filename, _params, _hierarchyLevel);
         }
 
+        //! Runs `getAssetInHierarchy` on the scheduler, unless the override disallows it in which case the load happens before returning
+        core::CTaskScheduler::future_t<SAssetBundle> getAssetInHierarchyAsync(const std::string& _filePath, const IAssetLoader::SAssetLoadParams& _params, uint32_t _hierarchyLevel, IAssetLoader::IAssetLoaderOverride* _override)
+        {
+            if (!_override->allowConcurrentLoads(IAssetLoader::SAssetLoadContext(_params,nullptr),_hierarchyLevel))
+            {
+                core::CTaskScheduler::promise_t<SAssetBundle> promise(m_scheduler.get());
+                promise.set_value(getAssetInHierarchy(_filePath,_params,_hierarchyLevel,_override));
+                return promise.get_future();
+            }
+            // the copy constructor of the params would drop the `reload` flag
+            auto params = std::make_shared<const IAssetLoader::SAssetLoadParams>(_params,_params.reload);
+            return m_scheduler->async([this,_filePath,params,_hierarchyLevel,_override]() -> SAssetBundle
+            {
+                return getAssetInHierarchy(_filePath,*params,_hierarchyLevel,_override);
+            });
+        }
+
         SAssetBundle getAssetInHierarchyWholeBundleRestore(system::IFile* _file, const std::string& _supposedFilename, const IAssetLoader::SAssetLoadParams& _params, uint32_t _hierarchyLevel, IAssetLoader::IAssetLoaderOverride* _override)
         {
             return getAssetInHierarchy_impl<true>(_file, _supposedFilename, _params, _hierarchyLevel, _override);
@@ -411,6 +487,17 @@ class NBL_API2 IAssetManager : public core::IReferenceCounted, public core::Quit
             return getAsset(_file, _supposedFilename, _params, &m_defaultLoaderOverride);
         }
 
+        //! Non-blocking `getAsset`, the returned future helps execute other pending tasks while you wait on it
+        /** The `_override` needs to be thread-safe unless its `allowConcurrentLoads` returns false, and must outlive the load. */
+        core::CTaskScheduler::future_t<SAssetBundle> getAssetAsync(const std::string& _filename, const IAssetLoader::SAssetLoadParams& _params, IAssetLoader::IAssetLoaderOverride* _override)
+        {
+            return getAssetInHierarchyAsync(_filename, _params, 0u, _override);
+        }
+        core::CTaskScheduler::future_t<SAssetBundle> getAssetAsync(const std::string& _filename, const IAssetLoader::SAssetLoadParams& _params)
+        {
+            return getAssetAsync(_filename, _params, &m_defaultLoaderOverride);
+        }
+
         SAssetBundle getAssetWholeBundleRestore(const std::string& _filename, const IAssetLoader::SAssetLoadParams& _params, IAssetLoader::IAssetLoaderOverride* _override)
         {
             return getAssetInHierarchyWholeBundleRestore(_filename, _params, 0u, _override);
@@ -16,6 +16,7 @@
 #include "nbl/asset/filters/CBlitUtilities.h"
 
 #include "nbl/asset/format/decodePixels.h"
+#include "nbl/asset/format/convertPixelRows.h"
 
 namespace nbl::asset
 {
@@ -399,20 +400,25 @@ class CBlitImageFilter :
 
 					constexpr bool is_seq_policy_v = std::is_same_v<std::remove_reference_t<ExecutionPolicy>, core::execution::sequenced_policy>;
 
-					struct DummyTexelType
-					{
-						double texel[ChannelCount];
-					};
-					std::for_each(policy, reinterpret_cast<DummyTexelType*>(intermediateStorage[axis]), reinterpret_cast<DummyTexelType*>(intermediateStorage[axis] + outputTexelCount*ChannelCount), [&sampler, outFormat, &histograms, &scratchHelper, alphaChannel, state](const DummyTexelType& dummyTexel)
+					// every chunk of texels grabs a histogram once, instead of every texel
+					const uint32_t chunkCount = (outputTexelCount+HistogramChunkTexels-1u)/HistogramChunkTexels;
+					CBasicImageFilterCommon::BlockIterator<1u> begin(&chunkCount);
+					CBasicImageFilterCommon::BlockIterator<1u> end(&chunkCount,&chunkCount);
+					core::for_each(policy, begin, end, [&sampler, outFormat, &histograms, &scratchHelper, alphaChannel, state, outputTexelCount, axis, intermediateStorage](const std::array<uint32_t,1u>& chunk)
 					{
 						const uint32_t index = scratchHelper.template alloc<is_seq_policy_v>();
+						uint32_t* const histogram = histograms+index*state->alphaBinCount;
 
-						value_t texelAlpha = dummyTexel.texel[alphaChannel];
-						texelAlpha -= double(sampler.nextSample()) * (asset::getFormatPrecision<value_t>(outFormat, alphaChannel, texelAlpha) / double(~0u));
+						const uint32_t texelEnd = core::min((chunk[0]+1u)*HistogramChunkTexels,outputTexelCount);
+						for (uint32_t texel=chunk[0]*HistogramChunkTexels; texel<texelEnd; texel++)
+						{
+							value_t texelAlpha = intermediateStorage[axis][texel*ChannelCount+alphaChannel];
+							texelAlpha -= double(sampler.nextSample()) * (asset::getFormatPrecision<value_t>(outFormat, alphaChannel, texelAlpha) / double(~0u));
 
-						const uint32_t binIndex = uint32_t(core::round(core::clamp(texelAlpha, 0.0, 1.0) * double(state->alphaBinCount - 1)));
-						assert(binIndex < state->alphaBinCount);
-						histograms[index*state->alphaBinCount+binIndex]++;
+							const uint32_t binIndex = uint32_t(core::round(core::clamp(texelAlpha, 0.0, 1.0) * double(state->alphaBinCount - 1)));
+							assert(binIndex < state->alphaBinCount);
+							histogram[binIndex]++;
+						}
 
 						scratchHelper.template free<is_seq_policy_v>(index);
 					});
@@ -471,7 +477,12 @@ class CBlitImageFilter :
 			for (auto i = 0; i < MaxAxisCount; ++i)
 				scaledKernelPhasedLUTPixel[i] = reinterpret_cast<lut_value_t*>(state->scratchMemory + getScratchOffset(state, ESU_SCALED_KERNEL_PHASED_LUT) + axisOffsets[i]);
 
-			for (uint32_t layer=0; layer!=layerCount; layer++) // TODO: could be parallelized
+			// input texels which don't need wrapping get decoded a whole run at a time when nothing but a swizzle sits between the decode and the filtering
+			const bool rowDecodable = std::is_same_v<value_t,double> && isPixelRowConvertible(inFormat);
+			const uint32_t inTexelByteSize = getTexelOrBlockBytesize(inFormat);
+
+			// layers share the intermediate storage so they go one after another, every pass within a layer is spread over all the lines
+			for (uint32_t layer=0; layer!=layerCount; layer++)
 			{
 				const core::vectorSIMDi32 vLayer(0,0,0,layer);
 				const auto windowMinCoord = windowMinCoordBase+vLayer;
@@ -495,110 +506,173 @@ class CBlitImageFilter :
 					// z x y output along y
 					// x y z output along z
 					const int loopCoordID[2] = {/*axis,*/axis!=IImage::ET_2D ? 1:0,axis!=IImage::ET_3D ? 2:0};
+					// lines get grouped into tiles along the loop coordinate which is closer together in the output, so a task fills whole cache lines instead of false sharing them
+					auto outputStride = [&](const uint32_t loop) -> uint32_t
+					{
+						// the last pass might write straight into the image, where x is what's closest together
+						if (lastPass && !needsNormalization)
+							return loopCoordID[loop]==0 ? 0u:1u;
+						return intermediateStrides[axis][loopCoordID[loop]];
+					};
+					uint32_t tiledLoop = outputStride(1)<outputStride(0) ? 1u:0u;
+					if (intermediateExtent[axis][loopCoordID[tiledLoop]]<TileLineCount)
+						tiledLoop ^= 1u;
 					//
 					assert(is_seq_policy_v || std::thread::hardware_concurrency()<=64u);
 					ParallelScratchHelper scratchHelper;
 
+					// widen this axis' part of the phased LUT once, so the convolution is a plain multiply-add over contiguous channels
+					const uint32_t phaseWeightCount = windowSize*ChannelCount;
+					core::vector<value_t> phasedWeights(phaseCount[axis]*phaseWeightCount);
+					for (size_t w=0u; w<phasedWeights.size(); w++)
+					{
+						if constexpr (std::is_same_v<lut_value_t,uint16_t>)
+							phasedWeights[w] = value_t(core::Float16Compressor::decompress(scaledKernelPhasedLUTPixel[axis][w]));
+						else
+							phasedWeights[w] = scaledKernelPhasedLUTPixel[axis][w];
+					}
+
 					constexpr uint32_t batch_dims = 2u;
-					const uint32_t batchExtent[batch_dims] = {
+					const uint32_t lineCount[batch_dims] = {
 						static_cast<uint32_t>(intermediateExtent[axis][loopCoordID[0]]),
 						static_cast<uint32_t>(intermediateExtent[axis][loopCoordID[1]])
 					};
+					uint32_t batchExtent[batch_dims] = {lineCount[0],lineCount[1]};
+					batchExtent[tiledLoop] = (batchExtent[tiledLoop]+TileLineCount-1u)/TileLineCount;
 					CBasicImageFilterCommon::BlockIterator<batch_dims> begin(batchExtent);
 					const uint32_t spaceFillingEnd[batch_dims] = {0u,batchExtent[1]};
 					CBasicImageFilterCommon::BlockIterator<batch_dims> end(begin.getExtentBatches(),spaceFillingEnd);
-					std::for_each(policy,begin,end,[&](const std::array<uint32_t,batch_dims>& batchCoord) -> void
+					core::for_each(policy,begin,end,[&](const std::array<uint32_t,batch_dims>& batchCoord) -> void
 					{
 						constexpr bool is_seq_policy_v = std::is_same_v<std::remove_reference_t<ExecutionPolicy>, core::execution::sequenced_policy>;
 
+						const uint32_t tileBegin = batchCoord[tiledLoop]*TileLineCount;
+						const uint32_t tileLineCount = core::min(tileBegin+TileLineCount,lineCount[tiledLoop])-tileBegin;
+						core::vectorSIMDi32 localTexCoord[TileLineCount];
+						// whole lines plus window borders
+						value_t* lineBuffer[TileLineCount];
+						value_t* outLine[TileLineCount];
+
 						// we need some tmp memory for threads in the first pass so that they dont step on each other
 						uint32_t decode_offset;
-						// whole line plus window borders
-						value_t* lineBuffer;
-						core::vectorSIMDi32 localTexCoord(0);
-						localTexCoord[loopCoordID[0]] = batchCoord[0];
-						localTexCoord[loopCoordID[1]] = batchCoord[1];
-						if (axis!=IImage::ET_1D)
-							lineBuffer = intermediateStorage[axis-1]+core::dot(static_cast<const core::vectorSIMDi32&>(intermediateStrides[axis-1]),localTexCoord)[0];
-						else
+						if (axis==IImage::ET_1D)
 						{
-							const auto inputEnd = inExtent.width+real_window_size.x;
 							decode_offset = scratchHelper.template alloc<is_seq_policy_v>();
-							lineBuffer = intermediateStorage[1]+decode_offset*ChannelCount*inputEnd;
-							for (auto& i=localTexCoord.x; i<inputEnd; i++)
+							assert(decode_offset<m_maxParallelism/TileLineCount);
+						}
+						for (uint32_t l=0u; l<tileLineCount; l++)
+						{
+							auto& lineCoord = localTexCoord[l];
+							lineCoord = core::vectorSIMDi32(0);
+							lineCoord[loopCoordID[0]] = batchCoord[0];
+							lineCoord[loopCoordID[1]] = batchCoord[1];
+							lineCoord[loopCoordID[tiledLoop]] = tileBegin+l;
+							outLine[l] = intermediateStorage[axis]+core::dot(static_cast<const core::vectorSIMDi32&>(intermediateStrides[axis]),lineCoord)[0];
+							if (axis!=IImage::ET_1D)
 							{
-								core::vectorSIMDi32 globalTexelCoord(localTexCoord+windowMinCoord);
-
-								core::vectorSIMDu32 blockLocalTexelCoord(0u);
-								const void* srcPix[] = { // multiple loads for texture boundaries aren't that bad
-									inImg->getTexelBlockData(inMipLevel,inImg->wrapTextureCoordinate(inMipLevel,globalTexelCoord,axisWraps),blockLocalTexelCoord),
-									nullptr,
-									nullptr,
-									nullptr
-								};
-								if (!srcPix[0])
-									continue;
-
-								auto sample = lineBuffer+i*ChannelCount;
-
-								base_t::template onDecode(inFormat, state, srcPix, sample, blockLocalTexelCoord.x, blockLocalTexelCoord.y, ChannelCount);
+								lineBuffer[l] = intermediateStorage[axis-1]+core::dot(static_cast<const core::vectorSIMDi32&>(intermediateStrides[axis-1]),lineCoord)[0];
+								continue;
+							}
 
+							const int32_t inputEnd = inExtent.width+real_window_size.x;
+							lineBuffer[l] = intermediateStorage[1]+(decode_offset*TileLineCount+l)*ChannelCount*inputEnd;
+							auto postDecode = [&](value_t* const sample, const int32_t globalX) -> void
+							{
 								if (nonPremultBlendSemantic)
 								{
 									for (auto i=0; i<ChannelCount; i++)
 									if (i!=alphaChannel)
 										sample[i] *= sample[alphaChannel];
 								}
-								else if (coverageSemantic && globalTexelCoord[axis]>=inOffsetBaseLayer[axis] && globalTexelCoord[axis]<inLimit[axis])
+								else if (coverageSemantic && globalX>=inOffsetBaseLayer.x && globalX<inLimit.x)
 								{
 									if (sample[alphaChannel]<=alphaRefValue)
 										cvg_num++;
 									cvg_den++;
 								}
+							};
+							for (auto& i=lineCoord.x; i<inputEnd;)
+							{
+								core::vectorSIMDi32 globalTexelCoord(lineCoord+windowMinCoord);
+								const auto wrappedTexelCoord = inImg->wrapTextureCoordinate(inMipLevel,globalTexelCoord,axisWraps);
+
+								// texels which need no wrapping along x and come from the same region get decoded a row at a time
+								uint32_t runLength = inputEnd-i;
+								const uint8_t* rowData = nullptr;
+								if (rowDecodable && static_cast<int32_t>(wrappedTexelCoord.x)==globalTexelCoord.x)
+									rowData = reinterpret_cast<const uint8_t*>(getTexelRun(inImg,inMipLevel,wrappedTexelCoord,runLength));
+								if (rowData)
+								{
+									for (uint32_t done=0u; done<runLength; )
+									{
+										const uint32_t count = core::min(runLength-done,RowDecodeChunk);
+										double decoded[RowDecodeChunk][4];
+										decodePixelRow(inFormat,rowData+done*inTexelByteSize,decoded[0],count);
+										for (uint32_t t=0u; t<count; t++)
+										{
+											value_t swizzled[4];
+											static_cast<Swizzle&>(*state).template operator()<double,value_t>(decoded[t],swizzled);
+											auto sample = lineBuffer[l]+(i+done+t)*ChannelCount;
+											std::copy(swizzled,swizzled+ChannelCount,sample);
+											postDecode(sample,globalTexelCoord.x+done+t);
+										}
+										done += count;
+									}
+									i += runLength;
+									continue;
+								}
+
+								core::vectorSIMDu32 blockLocalTexelCoord(0u);
+								const void* srcPix[] = { // multiple loads for texture boundaries aren't that bad
+									inImg->getTexelBlockData(inMipLevel,wrappedTexelCoord,blockLocalTexelCoord),
+									nullptr,
+									nullptr,
+									nullptr
+								};
+								if (srcPix[0])
+								{
+									auto sample = lineBuffer[l]+i*ChannelCount;
+									base_t::template onDecode(inFormat, state, srcPix, sample, blockLocalTexelCoord.x, blockLocalTexelCoord.y, ChannelCount);
+									postDecode(sample,globalTexelCoord.x);
+								}
+								i++;
 							}
+							lineCoord.x = 0;
 						}
 
-						auto getWeightedSample = [scaledKernelPhasedLUTPixel, windowSize, lineBuffer, &windowMinCoord, axis](const auto& windowCoord, const auto phaseIndex, const auto windowPixel, const auto channel) -> value_t
-						{
-							value_t kernelWeight;
-							if constexpr (std::is_same_v<lut_value_t, uint16_t>)
-								kernelWeight = value_t(core::Float16Compressor::decompress(scaledKernelPhasedLUTPixel[axis][(phaseIndex * windowSize + windowPixel) * ChannelCount + channel]));
-							else
-								kernelWeight = scaledKernelPhasedLUTPixel[axis][(phaseIndex * windowSize + windowPixel) * ChannelCount + channel];
-
-							return kernelWeight * lineBuffer[(windowCoord - windowMinCoord[axis]) * ChannelCount + channel];
-						};
-
+						// all lines of the tile get filtered together, so the window placement and weights are worked out once and the transposed writes land next to each other
+						const auto valueStride = intermediateStrides[axis][axis];
 						uint32_t phaseIndex = 0;
-						// TODO: this loop should probably get rewritten
-						for (auto& i=(localTexCoord[axis]=0); i<outExtentLayerCount[axis]; i++)
+						for (int32_t i=0; i<outExtentLayerCount[axis]; i++)
 						{
-							// get output pixel
-							auto* const value = intermediateStorage[axis]+core::dot(static_cast<const core::vectorSIMDi32&>(intermediateStrides[axis]),localTexCoord)[0];
-
-							// do the filtering
 							float tmp = float(i)+0.5f;
-							int32_t windowCoord = kernel.getWindowMinCoord(tmp*fScale[axis], tmp);
-
-							for (auto ch = 0; ch < ChannelCount; ++ch)
-								value[ch] = getWeightedSample(windowCoord, phaseIndex, 0, ch);
-
-							for (auto h=1; h<windowSize; h++)
+							const int32_t windowCoord = kernel.getWindowMinCoord(tmp*fScale[axis], tmp);
+							const value_t* const weights = phasedWeights.data()+phaseIndex*phaseWeightCount;
+							const size_t sampleOffset = (windowCoord-windowMinCoord[axis])*ChannelCount;
+							for (uint32_t l=0u; l<tileLineCount; l++)
 							{
-								windowCoord++;
-
-								for (auto ch = 0; ch < ChannelCount; ch++)
-									value[ch] += getWeightedSample(windowCoord, phaseIndex, h, ch);
-							}
-							if (lastPass)
-							{
-								const core::vectorSIMDu32 localOutPos = localTexCoord+outOffsetBaseLayer+vLayer;
-								if (needsNormalization)
-									state->normalization.prepass(value,localOutPos,0u,0u,ChannelCount);
-								else // store to image, we're done
+								// do the filtering
+								const value_t* const samples = lineBuffer[l]+sampleOffset;
+								value_t sum[ChannelCount];
+								for (auto ch=0; ch<ChannelCount; ch++)
+									sum[ch] = weights[ch]*samples[ch];
+								for (uint32_t h=ChannelCount; h<phaseWeightCount; h+=ChannelCount)
+								for (auto ch=0; ch<ChannelCount; ch++)
+									sum[ch] += weights[h+ch]*samples[h+ch];
+								auto* const value = outLine[l]+i*valueStride;
+								std::copy(sum,sum+ChannelCount,value);
+
+								if (lastPass)
 								{
-									core::vectorSIMDu32 dummy(0u);
-									storeToTexel(value,outImg->getTexelBlockData(outMipLevel,localOutPos,dummy),localOutPos);
+									localTexCoord[l][axis] = i;
+									const core::vectorSIMDu32 localOutPos = localTexCoord[l]+outOffsetBaseLayer+vLayer;
+									if (needsNormalization)
+										state->normalization.prepass(value,localOutPos,0u,0u,ChannelCount);
+									else // store to image, we're done
+									{
+										core::vectorSIMDu32 dummy(0u);
+										storeToTexel(value,outImg->getTexelBlockData(outMipLevel,localOutPos,dummy),localOutPos);
+									}
 								}
 							}
 
@@ -611,7 +685,7 @@ class CBlitImageFilter :
 					// we'll only get here if we have to do coverage adjustment
 					if (needsNormalization && lastPass)
 					{
-						state->normalization.finalize<value_t>();
+						state->normalization.template finalize<value_t>();
 						storeToImage(core::rational<int64_t>(cvg_num,cvg_den),axis,outOffsetLayer);
 					}
 				};
@@ -630,13 +704,19 @@ class CBlitImageFilter :
 	private:
 		static inline constexpr uint32_t VectorizationBoundSTL = /*AVX2*/16u;
 		static inline const uint32_t m_maxParallelism = std::thread::hardware_concurrency() * VectorizationBoundSTL;
+		// lines filtered by one task, 8 lines of 4 doubles cover 4 cache lines of the transposed intermediate storage,
+		// the first pass decodes a whole tile so the decode scratch fits `m_maxParallelism/TileLineCount` concurrent tasks
+		static inline constexpr uint32_t TileLineCount = 8u;
+		static inline constexpr uint32_t RowDecodeChunk = 64u;
+		static inline constexpr uint32_t HistogramChunkTexels = 4096u;
 
 		class ParallelScratchHelper
 		{
 		public:
 			ParallelScratchHelper()
 			{
-				std::fill_n(indices, VectorizationBoundSTL, ~0ull);
+				for (auto& index : indices)
+					index.store(~0ull,std::memory_order_relaxed);
 			}
 
 			template<bool isSeqPolicy>
@@ -645,14 +725,14 @@ class CBlitImageFilter :
 				if constexpr (isSeqPolicy)
 					return 0;
 
-				std::unique_lock<std::mutex> lock(mutex);
 				for (uint32_t j = 0u; j < VectorizationBoundSTL; ++j)
 				{
-					int32_t firstFree = core::findLSB(indices[j]);
-					if (firstFree != -1)
+					uint64_t freeMask = indices[j].load(std::memory_order_relaxed);
+					while (freeMask)
 					{
-						indices[j] ^= (0x1u << firstFree); // mark using
-						return j * MaxCores + firstFree;
+						const int32_t firstFree = core::findLSB(freeMask);
+						if (indices[j].compare_exchange_weak(freeMask,freeMask^(0x1ull<<firstFree),std::memory_order_acquire,std::memory_order_relaxed)) // mark using
+							return j * MaxCores + firstFree;
 					}
 				}
 				assert(false);
@@ -663,19 +743,41 @@ class CBlitImageFilter :
 			inline void free(const uint32_t index)
 			{
 				if constexpr (!isSeqPolicy)
-				{
-					std::unique_lock<std::mutex> lock(mutex);
-					indices[index / MaxCores] ^= (0x1u << (index % MaxCores)); // mark free
-				}
+					indices[index / MaxCores].fetch_or(0x1ull << (index % MaxCores),std::memory_order_release); // mark free
 			}
 
 		private:
 			static inline constexpr auto MaxCores = 64;
 
-			uint64_t indices[VectorizationBoundSTL];
-			std::mutex mutex;
+			std::atomic_uint64_t indices[VectorizationBoundSTL];
 		};
 
+		//! Returns the data of the texel at the already wrapped `texelCoord`, and shortens `runLength` to how many texels along x follow it contiguously in the same region
+		static inline const void* getTexelRun(const ICPUImage* image, const uint32_t mipLevel, const core::vectorSIMDu32& texelCoord, uint32_t& runLength)
+		{
+			const auto* const region = image->getRegion(mipLevel,texelCoord);
+			if (!region)
+				return nullptr;
+
+			uint32_t runEnd = region->imageOffset.x+region->imageExtent.width;
+			// regions further in the list win in `getRegion`, so any of them on this row cuts the run short where it starts
+			const auto regions = image->getRegions(mipLevel);
+			for (auto it=region+1; it!=regions.end(); it++)
+			{
+				if (texelCoord.w<it->imageSubresource.baseArrayLayer || texelCoord.w>=it->imageSubresource.baseArrayLayer+it->imageSubresource.layerCount)
+					continue;
+				if (texelCoord.y<it->imageOffset.y || texelCoord.y>=it->imageOffset.y+it->imageExtent.height || texelCoord.z<it->imageOffset.z || texelCoord.z>=it->imageOffset.z+it->imageExtent.depth)
+					continue;
+				if (it->imageOffset.x>texelCoord.x)
+					runEnd = core::min<uint32_t>(runEnd,it->imageOffset.x);
+			}
+			runLength = core::min(runLength,runEnd-texelCoord.x);
+
+			core::vectorSIMDu32 blockCoord;
+			const core::vectorSIMDu32 inRegionCoord = texelCoord-core::vectorSIMDu32(region->imageOffset.x,region->imageOffset.y,region->imageOffset.z,region->imageSubresource.baseArrayLayer);
+			return image->getTexelBlockData(region,inRegionCoord,blockCoord);
+		}
+
 		static inline void getIntermediateExtents(core::vectorSIMDi32* intermediateExtent, const state_type* state, const core::vectorSIMDi32& real_window_size)
 		{
 			assert(intermediateExtent);
@@ -8,6 +8,7 @@
 #include "nbl/core/declarations.h"
 
 #include "nbl/asset/filters/CBlitImageFilter.h"
+#include "nbl/asset/filters/CConvertFormatImageFilter.h"
 
 namespace nbl
 {
@@ -22,6 +23,7 @@ namespace asset
 // but iterative application of the filter will give you 2/originalResolution, 6/originalResolution, 14/originalResolution supports
 // the correct usage is to compute the first mip map with a 100% support kernel, then subsequent iterations with 50% smaller pixel supports
 // (actually in the case of using a Gaussian for both resampling and reconstruction, this is equivalent to using a single kernel of 3,3,5,9,..)
+// Block compressed images get decoded into a floating point scratch image, the mip chain gets generated there and each new level encoded back.
 
 template<typename Swizzle=VoidSwizzle, typename Dither=IdentityDither/*TODO: WhiteNoiseDither*/, typename Normalization=void, bool Clamp=true, typename BlitUtilities = CBlitUtilities<CChannelIndependentWeightFunction1D<CConvolutionWeightFunction1D<CWeightFunction1D<SKaiserFunction>, CWeightFunction1D<SMitchellFunction<>>>>>>
 class CMipMapGenerationImageFilter : public CImageFilter<CMipMapGenerationImageFilter<Swizzle, Dither, Normalization, Clamp, BlitUtilities>>, public CBasicImageFilterCommon
@@ -44,10 +46,12 @@ class CMipMapGenerationImageFilter : public CImageFilter<CMipMapGenerationImageF
 				uint32_t							startMipLevel = 1u;
 				uint32_t							endMipLevel = 0u;
 				ICPUImage*							inOutImage = nullptr;
+				E_BLOCK_ENCODE_QUALITY				blockEncodeQuality = EBEQ_NORMAL; //!< only used when `inOutImage` is block compressed
 		};
 		using state_type = CState;
 		
 		// since the only thing the mip map generator does is call the blit filter, the scratch memory amount is the same
+		// (the blit scratch only depends on the image type and extents, so its the same for the block compression scratch image too)
 		static inline uint32_t getRequiredScratchByteSize(const state_type* state)
 		{
 			auto blit = buildBlitState(state,state->startMipLevel);
@@ -70,17 +74,18 @@ class CMipMapGenerationImageFilter : public CImageFilter<CMipMapGenerationImageF
 			if (state->startMipLevel>=state->endMipLevel || state->endMipLevel>params.mipLevels)
 				return false;
 
-			// TODO: remove this later when we can actually write/encode to block formats
-			if (isBlockCompressionFormat(state->inOutImage->getCreationParameters().format))
-				return false;
-			
-			for (auto inMipLevel=state->startMipLevel; inMipLevel!=state->endMipLevel; inMipLevel++)
+			if (isBlockCompressionFormat(params.format))
 			{
-				auto blit = buildBlitState(state,inMipLevel);
-				if (!pseudo_base_t::validate(&blit))
+				if (!isBlockEncodable(params.format) || state->blockEncodeQuality>=EBEQ_COUNT)
+					return false;
+				// no need for any storage just to validate the blits
+				auto scratch = createBlockCompressionScratch(state,false);
+				if (!scratch)
 					return false;
+				auto scratchState = getBlockCompressionScratchState(state,scratch.get());
+				return validateBlits(&scratchState);
 			}
-			return true; // CBlit already checks kernel
+			return validateBlits(state);
 		}
 
 		template<class ExecutionPolicy>
@@ -89,6 +94,46 @@ class CMipMapGenerationImageFilter : public CImageFilter<CMipMapGenerationImageF
 			if (!validate(state))
 				return false;
 
+			if (isBlockCompressionFormat(state->inOutImage->getCreationParameters().format))
+			{
+				auto scratch = createBlockCompressionScratch(state,true);
+				if (!scratch)
+					return false;
+				// decode the level the chain starts from
+				if (!convertLevel(policy,state->inOutImage,state->startMipLevel-1u,state->baseLayer,scratch.get(),0u,0u,state))
+					return false;
+				auto scratchState = getBlockCompressionScratchState(state,scratch.get());
+				if (!executeBlits(policy,&scratchState))
+					return false;
+				// and encode all the new ones
+				for (auto outMipLevel=state->startMipLevel; outMipLevel!=state->endMipLevel; outMipLevel++)
+				{
+					if (!convertLevel(policy,scratch.get(),outMipLevel-state->startMipLevel+1u,0u,state->inOutImage,outMipLevel,state->baseLayer,state))
+						return false;
+				}
+				return true;
+			}
+			return executeBlits(policy,state);
+		}
+		static inline bool execute(state_type* state)
+		{
+			return execute(core::execution::seq,state);
+		}
+
+	protected:
+		static inline bool validateBlits(state_type* state)
+		{
+			for (auto inMipLevel=state->startMipLevel; inMipLevel!=state->endMipLevel; inMipLevel++)
+			{
+				auto blit = buildBlitState(state,inMipLevel);
+				if (!pseudo_base_t::validate(&blit))
+					return false;
+			}
+			return true; // CBlit already checks kernel
+		}
+		template<class ExecutionPolicy>
+		static inline bool executeBlits(ExecutionPolicy&& policy, state_type* state)
+		{
 			for (auto inMipLevel=state->startMipLevel; inMipLevel!=state->endMipLevel; inMipLevel++)
 			{
 				auto blit = buildBlitState(state, inMipLevel);
@@ -97,12 +142,72 @@ class CMipMapGenerationImageFilter : public CImageFilter<CMipMapGenerationImageF
 			}
 			return true;
 		}
-		static inline bool execute(state_type* state)
+
+		//! Holds the levels from `startMipLevel-1` up to `endMipLevel` of the layers being processed
+		static inline core::smart_refctd_ptr<ICPUImage> createBlockCompressionScratch(const state_type* state, const bool allocate)
 		{
-			return execute(core::execution::seq,state);
+			const auto baseLevel = state->startMipLevel-1u;
+			const auto baseExtent = state->inOutImage->getMipSize(baseLevel);
+
+			IImage::SCreationParams params = state->inOutImage->getCreationParameters();
+			params.format = EF_R32G32B32A32_SFLOAT;
+			params.extent = {baseExtent.x,baseExtent.y,baseExtent.z};
+			params.mipLevels = state->endMipLevel-baseLevel;
+			params.arrayLayers = state->layerCount;
+			params.flags = IImage::ECF_NONE;
+			auto scratch = ICPUImage::create(std::move(params));
+			if (!scratch || !allocate)
+				return scratch;
+
+			auto regions = core::make_refctd_dynamic_array<core::smart_refctd_dynamic_array<IImage::SBufferCopy> >(scratch->getCreationParameters().mipLevels);
+			size_t bufferSize = 0ull;
+			const size_t texelByteSize = getTexelOrBlockBytesize(EF_R32G32B32A32_SFLOAT);
+			for (auto rit=regions->begin(); rit!=regions->end(); rit++)
+			{
+				const auto mipLevel = static_cast<uint32_t>(std::distance(regions->begin(),rit));
+				const auto localExtent = scratch->getMipSize(mipLevel);
+				rit->bufferOffset = bufferSize;
+				rit->bufferRowLength = localExtent.x;
+				rit->bufferImageHeight = localExtent.y;
+				rit->imageSubresource.aspectMask = IImage::EAF_COLOR_BIT;
+				rit->imageSubresource.mipLevel = mipLevel;
+				rit->imageSubresource.baseArrayLayer = 0u;
+				rit->imageSubresource.layerCount = state->layerCount;
+				rit->imageOffset = {0u,0u,0u};
+				rit->imageExtent = {localExtent.x,localExtent.y,localExtent.z};
+				bufferSize += size_t(localExtent.x)*localExtent.y*localExtent.z*state->layerCount*texelByteSize;
+			}
+			if (!scratch->setBufferAndRegions(core::make_smart_refctd_ptr<ICPUBuffer>(bufferSize),regions))
+				return nullptr;
+			return scratch;
+		}
+		static inline state_type getBlockCompressionScratchState(const state_type* state, ICPUImage* scratch)
+		{
+			state_type scratchState = *state;
+			scratchState.baseLayer = 0u;
+			scratchState.startMipLevel = 1u;
+			scratchState.endMipLevel = scratch->getCreationParameters().mipLevels;
+			scratchState.inOutImage = scratch;
+			return scratchState;
+		}
+		//! Decodes or encodes a whole mip level, between the block compressed image and its scratch
+		template<class ExecutionPolicy>
+		static inline bool convertLevel(ExecutionPolicy&& policy, const ICPUImage* inImage, const uint32_t inMipLevel, const uint32_t inBaseLayer, ICPUImage* outImage, const uint32_t outMipLevel, const uint32_t outBaseLayer, const state_type* state)
+		{
+			using convert_filter_t = CConvertFormatImageFilter<>;
+			typename convert_filter_t::state_type convert;
+			convert.extentLayerCount = inImage->getMipSize(inMipLevel);
+			convert.layerCount = state->layerCount;
+			convert.inOffsetBaseLayer = core::vectorSIMDu32(0u,0u,0u,inBaseLayer);
+			convert.outOffsetBaseLayer = core::vectorSIMDu32(0u,0u,0u,outBaseLayer);
+			convert.inMipLevel = inMipLevel;
+			convert.outMipLevel = outMipLevel;
+			convert.inImage = inImage;
+			convert.outImage = outImage;
+			convert.blockEncodeQuality = state->blockEncodeQuality;
+			return convert_filter_t::execute(std::forward<ExecutionPolicy>(policy),&convert);
 		}
 
-	protected:
 		static inline auto buildBlitState(const state_type* state, uint32_t inMipLevel)
 		{
 			const auto prevLevel = inMipLevel-1u;
@@ -12,6 +12,8 @@
 #include "nbl/asset/filters/CSwizzleableAndDitherableFilterBase.h"
 #include "nbl/asset/ICPUImageView.h"
 #include "nbl/asset/format/convertColor.h"
+#include "nbl/asset/format/encodeBlocks.h"
+#include "nbl/asset/format/convertPixelRows.h"
 
 
 namespace nbl::asset
@@ -30,6 +32,8 @@ class CSwizzleAndConvertImageFilterBase : public CSwizzleableAndDitherableFilter
 			public:
 				CState() {}
 				virtual ~CState() {}
+
+				E_BLOCK_ENCODE_QUALITY blockEncodeQuality = EBEQ_NORMAL;	//!< only used when the output format is block compressed
 		};
 
 		using state_type = CState;
@@ -42,14 +46,182 @@ class CSwizzleAndConvertImageFilterBase : public CSwizzleableAndDitherableFilter
 			if (!CMatchedSizeInOutImageFilterCommon::validate(state))
 				return false;
 
-			// TODO: need to triple check it works when we finally enable this feature
-			if (isBlockCompressionFormat(state->outImage->getCreationParameters().format))
-				return false;
+			const auto outFormat = state->outImage->getCreationParameters().format;
+			if (isBlockCompressionFormat(outFormat))
+			{
+				if (!isBlockEncodable(outFormat) || state->blockEncodeQuality>=EBEQ_COUNT)
+					return false;
+				// texels get staged as doubles
+				if (isIntegerFormat(state->inImage->getCreationParameters().format))
+					return false;
+				// blocks get encoded whole, so the output range has to start on a block boundary and end on one or at the edge of the mip level
+				const auto blockDims = asset::getBlockDimensions(outFormat);
+				const auto mipSize = state->outImage->getMipSize(state->outMipLevel);
+				for (auto i=0u; i<3u; i++)
+				{
+					const uint32_t offset = state->outOffsetBaseLayer.pointer[i];
+					const uint32_t end = offset+state->extentLayerCount.pointer[i];
+					if (offset%blockDims.pointer[i] || (end%blockDims.pointer[i] && end!=mipSize.pointer[i]))
+						return false;
+				}
+			}
 
 			return true;
 		}
 
 	protected:
+		//! Output texels of the current output region are collected here and then encoded a whole block at a time
+		class CBlockEncodeStaging
+		{
+			public:
+				inline CBlockEncodeStaging(const state_type* state, const CMatchedSizeInOutImageFilterCommon::CommonExecuteData& commonExecuteData)
+				{
+					const auto* region = commonExecuteData.oit;
+					size_t texelCount = 1ull;
+					for (auto i=0u; i<4u; i++)
+					{
+						// in the same region local coordinates as the positions passed to `onEncode`
+						const int64_t regionOffset = i<3u ? (&region->imageOffset.x)[i]:region->imageSubresource.baseArrayLayer;
+						const int64_t regionExtent = i<3u ? (&region->imageExtent.width)[i]:region->imageSubresource.layerCount;
+						const int64_t rangeBegin = int64_t(state->outOffsetBaseLayer.pointer[i])-regionOffset;
+						const int64_t rangeEnd = rangeBegin+state->extentLayerCount.pointer[i];
+						m_begin[i] = static_cast<uint32_t>(std::clamp<int64_t>(rangeBegin,0,regionExtent));
+						m_extent[i] = static_cast<uint32_t>(std::clamp<int64_t>(rangeEnd,0,regionExtent))-m_begin[i];
+						texelCount *= m_extent[i];
+					}
+					m_texels.resize(texelCount*4ull,0.0);
+				}
+
+				//! Returns nullptr for texels outside of the output range within the current region
+				inline uint8_t* getTexel(const core::vectorSIMDu32& localOutPos)
+				{
+					size_t index = 0ull;
+					for (auto i=4u; i--; )
+					{
+						// positions before the beginning wrap around and fail the test too
+						const uint32_t coord = localOutPos.pointer[i]-m_begin[i];
+						if (coord>=m_extent[i])
+							return nullptr;
+						index = index*m_extent[i]+coord;
+					}
+					return reinterpret_cast<uint8_t*>(m_texels.data()+index*4ull);
+				}
+
+				template<class ExecutionPolicy>
+				inline void encode(ExecutionPolicy&& policy, const CMatchedSizeInOutImageFilterCommon::CommonExecuteData& commonExecuteData, const E_BLOCK_ENCODE_QUALITY quality) const
+				{
+					if (m_texels.empty())
+						return;
+
+					// all encodable formats have 4x4x1 blocks
+					constexpr uint32_t BlockSize = 4u;
+					const core::vectorSIMDu32 blockOffset(m_begin[0]/BlockSize,m_begin[1]/BlockSize,m_begin[2],m_begin[3]);
+					const uint32_t blockCountX = (m_extent[0]+BlockSize-1u)/BlockSize;
+					auto encodeBlockRow = [&](const std::array<uint32_t,3u>& batchCoord) -> void
+					{
+						double texels[BlockSize*BlockSize][4];
+						for (auto xBlock=0u; xBlock<blockCountX; xBlock++)
+						{
+							for (auto y=0u; y<BlockSize; y++)
+							for (auto x=0u; x<BlockSize; x++)
+							{
+								// blocks sticking out past the edge of the mip level replicate the last row and column
+								const uint32_t texelX = std::min(xBlock*BlockSize+x,m_extent[0]-1u);
+								const uint32_t texelY = std::min(batchCoord[0]*BlockSize+y,m_extent[1]-1u);
+								const size_t index = ((size_t(batchCoord[2])*m_extent[2]+batchCoord[1])*m_extent[1]+texelY)*m_extent[0]+texelX;
+								std::copy_n(m_texels.data()+index*4ull,4u,texels[y*BlockSize+x]);
+							}
+							const core::vectorSIMDu32 localBlock(blockOffset.x+xBlock,blockOffset.y+batchCoord[0],blockOffset.z+batchCoord[1],blockOffset.w+batchCoord[2]);
+							encodeBlock(commonExecuteData.outFormat,commonExecuteData.outData+commonExecuteData.oit->getByteOffset(localBlock,commonExecuteData.outByteStrides),texels,quality);
+						}
+					};
+					// parallelize over rows of blocks
+					const uint32_t batchExtent[3] = {(m_extent[1]+BlockSize-1u)/BlockSize,m_extent[2],m_extent[3]};
+					const uint32_t batchEnd[3] = {0u,0u,m_extent[3]};
+					CBasicImageFilterCommon::BlockIterator<3u> begin(batchExtent);
+					CBasicImageFilterCommon::BlockIterator<3u> end(batchExtent,batchEnd);
+					core::for_each(std::forward<ExecutionPolicy>(policy),begin,end,encodeBlockRow);
+				}
+
+			private:
+				uint32_t m_begin[4];
+				uint32_t m_extent[4];
+				core::vector<double> m_texels;
+		};
+		//! Non-null only if the output format is block compressed
+		static inline std::unique_ptr<CBlockEncodeStaging> createBlockEncodeStaging(const state_type* state, const CMatchedSizeInOutImageFilterCommon::CommonExecuteData& commonExecuteData)
+		{
+			if (!isBlockCompressionFormat(commonExecuteData.outFormat))
+				return nullptr;
+			return std::make_unique<CBlockEncodeStaging>(state,commonExecuteData);
+		}
+		//! Where `onEncode` should write the texel, nullptr if it should be skipped
+		static inline uint8_t* getOutPixel(const CMatchedSizeInOutImageFilterCommon::CommonExecuteData& commonExecuteData, CBlockEncodeStaging* staging, const core::vectorSIMDu32& localOutPos)
+		{
+			if (staging)
+				return staging->getTexel(localOutPos);
+			// decoding a block compressed input produces whole blocks, which can stick out past the edge of the output region
+			const auto& extent = commonExecuteData.oit->imageExtent;
+			if (localOutPos.x>=extent.width || localOutPos.y>=extent.height || localOutPos.z>=extent.depth)
+				return nullptr;
+			return commonExecuteData.outData+commonExecuteData.oit->getByteOffset(localOutPos,commonExecuteData.outByteStrides);
+		}
+
+		//! Plain conversions (no swizzle, dither nor normalization) between formats `decodePixelRow` and `encodePixelRow` handle can go a row at a time
+		static inline bool canConvertRows(const CMatchedSizeInOutImageFilterCommon::CommonExecuteData& commonExecuteData)
+		{
+			if constexpr (std::is_same_v<Swizzle,VoidSwizzle> && std::is_same_v<Dither,IdentityDither> && std::is_void_v<Normalization>)
+				return isPixelRowConvertible(commonExecuteData.inFormat) && isPixelRowConvertible(commonExecuteData.outFormat);
+			else
+				return false;
+		}
+		//! Same result as going through `onDecode` and `onEncode` texel by texel, but without the per texel dispatch and addressing
+		template<class ExecutionPolicy>
+		static inline void convertRows(ExecutionPolicy&& policy, const CMatchedSizeInOutImageFilterCommon::CommonExecuteData& commonExecuteData, CBasicImageFilterCommon::clip_region_functor_t& clip)
+		{
+			const uint32_t outChannelCount = getFormatChannelCount(commonExecuteData.outFormat);
+			double clampMin[4], clampMax[4];
+			if constexpr (Clamp)
+			for (uint32_t i=0u; i<outChannelCount; i++)
+			{
+				clampMin[i] = getFormatMinValue<double>(commonExecuteData.outFormat,i);
+				clampMax[i] = getFormatMaxValue<double>(commonExecuteData.outFormat,i);
+			}
+
+			const auto* const oit = commonExecuteData.oit;
+			auto convertRow = [&](const uint32_t readBlockArrayOffset, const core::vectorSIMDu32& readBlockPos, const uint32_t texelCount) -> void
+			{
+				// same as `getOutPixel`, parts of input rows can land outside of the output region
+				core::vectorSIMDu32 localOutPos = readBlockPos+commonExecuteData.offsetDifferenceInTexels;
+				if (localOutPos.y>=oit->imageExtent.height || localOutPos.z>=oit->imageExtent.depth || localOutPos.w>=oit->imageSubresource.layerCount)
+					return;
+				const int64_t outX = static_cast<int32_t>(localOutPos.x);
+				const uint32_t begin = static_cast<uint32_t>(std::clamp<int64_t>(-outX,0,texelCount));
+				const uint32_t end = static_cast<uint32_t>(std::clamp<int64_t>(int64_t(oit->imageExtent.width)-outX,0,texelCount));
+				if (begin>=end)
+					return;
+				localOutPos.x += begin;
+
+				const uint8_t* src = commonExecuteData.inData+readBlockArrayOffset+size_t(begin)*commonExecuteData.inBlockByteSize;
+				uint8_t* dst = commonExecuteData.outData+oit->getByteOffset(localOutPos,commonExecuteData.outByteStrides);
+				constexpr uint32_t MaxChunkTexels = 64u;
+				double texels[MaxChunkTexels][4];
+				for (uint32_t i=begin; i<end; i+=MaxChunkTexels)
+				{
+					const uint32_t chunkTexels = std::min(MaxChunkTexels,end-i);
+					decodePixelRow(commonExecuteData.inFormat,src,texels[0],chunkTexels);
+					if constexpr (Clamp)
+					for (uint32_t t=0u; t<chunkTexels; t++)
+					for (uint32_t c=0u; c<outChannelCount; c++)
+						texels[t][c] = core::clamp(texels[t][c],clampMin[c],clampMax[c]);
+					encodePixelRow(commonExecuteData.outFormat,dst,texels[0],chunkTexels);
+					src += size_t(chunkTexels)*commonExecuteData.inBlockByteSize;
+					dst += size_t(chunkTexels)*commonExecuteData.outBlockByteSize;
+				}
+			};
+			CBasicImageFilterCommon::executePerRegionRows(std::forward<ExecutionPolicy>(policy),commonExecuteData.inImg,convertRow,commonExecuteData.inRegions.begin(),commonExecuteData.inRegions.end(),clip);
+		}
+
 		template<E_FORMAT kInFormat, class ExecutionPolicy, typename decodeBufferType, typename encodeBufferType>
 		static inline void normalizationPrepass(E_FORMAT rInFormat, const ExecutionPolicy& policy, state_type* state, const core::vectorSIMDu32& blockDims)
 		{
@@ -90,7 +262,7 @@ class CSwizzleAndConvertImageFilterBase : public CSwizzleableAndDitherableFilter
 					return true;
 				};
 				CMatchedSizeInOutImageFilterCommon::commonExecute(state,perOutputRegion);
-				state->normalization.finalize<encodeBufferType>();
+				state->normalization.template finalize<encodeBufferType>();
 			}
 		}
 };
@@ -143,10 +315,17 @@ class CSwizzleAndConvertImageFilter : public CImageFilter<CSwizzleAndConvertImag
 			base_t::template normalizationPrepass<inFormat,ExecutionPolicy,decodeBufferType,encodeBufferType>(EF_UNKNOWN,policy,state,blockDims);
 			auto perOutputRegion = [policy,&blockDims,&state](const CMatchedSizeInOutImageFilterCommon::CommonExecuteData& commonExecuteData, CBasicImageFilterCommon::clip_region_functor_t& clip) -> bool
 			{
+				if (base_t::canConvertRows(commonExecuteData))
+				{
+					base_t::convertRows(policy,commonExecuteData,clip);
+					return true;
+				}
 				constexpr uint32_t inChannelsAmount = asset::getFormatChannelCount<inFormat>();
 				constexpr uint32_t outChannelsAmount = asset::getFormatChannelCount<outFormat>();
 
-				auto swizzle = [&commonExecuteData,&blockDims,&state,&outChannelsAmount](uint32_t readBlockArrayOffset, core::vectorSIMDu32 readBlockPos)
+				// block compressed outputs get staged, see `encodeOrStagePixels`
+				auto staging = base_t::createBlockEncodeStaging(state,commonExecuteData);
+				auto swizzle = [&commonExecuteData,&staging,&blockDims,&state,&outChannelsAmount](uint32_t readBlockArrayOffset, core::vectorSIMDu32 readBlockPos)
 				{
 					constexpr auto MaxPlanes = 4;
 					const void* srcPix[MaxPlanes] = { commonExecuteData.inData+readBlockArrayOffset,nullptr,nullptr,nullptr };
@@ -155,7 +334,9 @@ class CSwizzleAndConvertImageFilter : public CImageFilter<CSwizzleAndConvertImag
 					for (auto blockX=0u; blockX<blockDims.x; blockX++)
 					{
 						auto localOutPos = readBlockPos*blockDims+commonExecuteData.offsetDifferenceInTexels;
-						uint8_t* dstPix = commonExecuteData.outData+commonExecuteData.oit->getByteOffset(localOutPos + core::vectorSIMDu32(blockX, blockY),commonExecuteData.outByteStrides);
+						uint8_t* dstPix = base_t::getOutPixel(commonExecuteData,staging.get(),localOutPos+core::vectorSIMDu32(blockX,blockY));
+						if (!dstPix)
+							continue;
 						
 						constexpr auto maxChannels = 4;
 						decodeBufferType decodeBuffer[maxChannels] = {};
@@ -165,6 +346,8 @@ class CSwizzleAndConvertImageFilter : public CImageFilter<CSwizzleAndConvertImag
 					}
 				};
 				CBasicImageFilterCommon::executePerRegion(policy, commonExecuteData.inImg, swizzle, commonExecuteData.inRegions.begin(), commonExecuteData.inRegions.end(), clip);
+				if (staging)
+					staging->encode(policy,commonExecuteData,state->blockEncodeQuality);
 				return true;
 			};
 			return CMatchedSizeInOutImageFilterCommon::commonExecute(state,perOutputRegion);
@@ -211,9 +394,16 @@ class CSwizzleAndConvertImageFilter<EF_UNKNOWN,EF_UNKNOWN,Swizzle,Dither,Normali
 			base_t::template normalizationPrepass<EF_UNKNOWN,ExecutionPolicy,double,double>(inFormat,policy,state,blockDims);
 			auto perOutputRegion = [policy,&blockDims,inFormat,outFormat,outChannelsAmount,&state](const CMatchedSizeInOutImageFilterCommon::CommonExecuteData& commonExecuteData, CBasicImageFilterCommon::clip_region_functor_t& clip) -> bool
 			{
+				if (base_t::canConvertRows(commonExecuteData))
+				{
+					base_t::convertRows(policy,commonExecuteData,clip);
+					return true;
+				}
 				const uint32_t inChannelsAmount = asset::getFormatChannelCount(inFormat);
 
-				auto swizzle = [&commonExecuteData,&blockDims,inFormat,outFormat,outChannelsAmount,&state,inChannelsAmount](uint32_t readBlockArrayOffset, core::vectorSIMDu32 readBlockPos)
+				// block compressed outputs get staged, see `encodeOrStagePixels`
+				auto staging = base_t::createBlockEncodeStaging(state,commonExecuteData);
+				auto swizzle = [&commonExecuteData,&staging,&blockDims,inFormat,outFormat,outChannelsAmount,&state,inChannelsAmount](uint32_t readBlockArrayOffset, core::vectorSIMDu32 readBlockPos)
 				{
 					constexpr auto MaxPlanes = 4;
 					const void* srcPix[MaxPlanes] = { commonExecuteData.inData+readBlockArrayOffset,nullptr,nullptr,nullptr };
@@ -222,7 +412,9 @@ class CSwizzleAndConvertImageFilter<EF_UNKNOWN,EF_UNKNOWN,Swizzle,Dither,Normali
 					for (auto blockX=0u; blockX<blockDims.x; blockX++)
 					{
 						auto localOutPos = readBlockPos*blockDims+commonExecuteData.offsetDifferenceInTexels;
-						uint8_t* dstPix = commonExecuteData.outData+commonExecuteData.oit->getByteOffset(localOutPos + core::vectorSIMDu32(blockX, blockY),commonExecuteData.outByteStrides);
+						uint8_t* dstPix = base_t::getOutPixel(commonExecuteData,staging.get(),localOutPos+core::vectorSIMDu32(blockX,blockY));
+						if (!dstPix)
+							continue;
 				
 						constexpr auto maxChannels = 4;
 						double decodeBuffer[maxChannels] = {};
@@ -232,6 +424,8 @@ class CSwizzleAndConvertImageFilter<EF_UNKNOWN,EF_UNKNOWN,Swizzle,Dither,Normali
 					}
 				};
 				CBasicImageFilterCommon::executePerRegion(policy, commonExecuteData.inImg, swizzle, commonExecuteData.inRegions.begin(), commonExecuteData.inRegions.end(), clip);
+				if (staging)
+					staging->encode(policy,commonExecuteData,state->blockEncodeQuality);
 				return true;
 			};
 			return CMatchedSizeInOutImageFilterCommon::commonExecute(state,perOutputRegion);
@@ -282,13 +476,20 @@ class CSwizzleAndConvertImageFilter<EF_UNKNOWN,outFormat,Swizzle,Dither,Normaliz
 			#endif
 
 			typedef typename std::conditional<asset::isIntegerFormat<outFormat>(), uint64_t, double>::type encodeBufferType;
-			normalizationPrepass<EF_UNKNOWN,ExecutionPolicy,double,encodeBufferType>(inFormat,policy,state,blockDims);
+			base_t::template normalizationPrepass<EF_UNKNOWN,ExecutionPolicy,double,encodeBufferType>(inFormat,policy,state,blockDims);
 			auto perOutputRegion = [policy,&blockDims,inFormat,&state](const CMatchedSizeInOutImageFilterCommon::CommonExecuteData& commonExecuteData, CBasicImageFilterCommon::clip_region_functor_t& clip) -> bool
 			{
+				if (base_t::canConvertRows(commonExecuteData))
+				{
+					base_t::convertRows(policy,commonExecuteData,clip);
+					return true;
+				}
 				const uint32_t inChannelsAmount = asset::getFormatChannelCount(inFormat);
 				constexpr uint32_t outChannelsAmount = asset::getFormatChannelCount<outFormat>();
 
-				auto swizzle = [&commonExecuteData,&blockDims,inFormat,&outChannelsAmount,&state](uint32_t readBlockArrayOffset, core::vectorSIMDu32 readBlockPos)
+				// block compressed outputs get staged, see `encodeOrStagePixels`
+				auto staging = base_t::createBlockEncodeStaging(state,commonExecuteData);
+				auto swizzle = [&commonExecuteData,&staging,&blockDims,inFormat,inChannelsAmount,&outChannelsAmount,&state](uint32_t readBlockArrayOffset, core::vectorSIMDu32 readBlockPos)
 				{
 					constexpr auto MaxPlanes = 4;
 					const void* srcPix[MaxPlanes] = { commonExecuteData.inData + readBlockArrayOffset,nullptr,nullptr,nullptr };
@@ -297,7 +498,9 @@ class CSwizzleAndConvertImageFilter<EF_UNKNOWN,outFormat,Swizzle,Dither,Normaliz
 					for (auto blockX = 0u; blockX < blockDims.x; blockX++)
 					{
 						auto localOutPos = readBlockPos * blockDims + commonExecuteData.offsetDifferenceInTexels;
-						uint8_t* dstPix = commonExecuteData.outData + commonExecuteData.oit->getByteOffset(localOutPos + core::vectorSIMDu32(blockX, blockY), commonExecuteData.outByteStrides);
+						uint8_t* dstPix = base_t::getOutPixel(commonExecuteData,staging.get(),localOutPos+core::vectorSIMDu32(blockX,blockY));
+						if (!dstPix)
+							continue;
 
 						constexpr auto maxChannels = 4;
 						double decodeBuffer[maxChannels] = {};
@@ -307,6 +510,8 @@ class CSwizzleAndConvertImageFilter<EF_UNKNOWN,outFormat,Swizzle,Dither,Normaliz
 					}
 				};
 				CBasicImageFilterCommon::executePerRegion(policy, commonExecuteData.inImg, swizzle, commonExecuteData.inRegions.begin(), commonExecuteData.inRegions.end(), clip);
+				if (staging)
+					staging->encode(policy,commonExecuteData,state->blockEncodeQuality);
 				return true;
 			};
 			return CMatchedSizeInOutImageFilterCommon::commonExecute(state, perOutputRegion);
@@ -358,13 +563,20 @@ class CSwizzleAndConvertImageFilter<inFormat,EF_UNKNOWN,Swizzle,Dither,Normaliza
 			#endif
 
 			typedef typename std::conditional<asset::isIntegerFormat<inFormat>(), uint64_t, double>::type decodeBufferType;
-			normalizationPrepass<inFormat,ExecutionPolicy,decodeBufferType,double>(EF_UNKNOWN,policy,state,blockDims);
+			base_t::template normalizationPrepass<inFormat,ExecutionPolicy,decodeBufferType,double>(EF_UNKNOWN,policy,state,blockDims);
 			auto perOutputRegion = [policy,&blockDims,&outFormat,outChannelsAmount,&state](const CMatchedSizeInOutImageFilterCommon::CommonExecuteData& commonExecuteData, CBasicImageFilterCommon::clip_region_functor_t& clip) -> bool
 			{
+				if (base_t::canConvertRows(commonExecuteData))
+				{
+					base_t::convertRows(policy,commonExecuteData,clip);
+					return true;
+				}
 				constexpr uint32_t inChannelsAmount = asset::getFormatChannelCount<inFormat>();
 				const uint32_t outChannelsAmount = asset::getFormatChannelCount(outFormat);
 
-				auto swizzle = [&commonExecuteData,&blockDims,&outFormat,&outChannelsAmount,&state](uint32_t readBlockArrayOffset, core::vectorSIMDu32 readBlockPos)
+				// block compressed outputs get staged, see `encodeOrStagePixels`
+				auto staging = base_t::createBlockEncodeStaging(state,commonExecuteData);
+				auto swizzle = [&commonExecuteData,&staging,&blockDims,&outFormat,&inChannelsAmount,&outChannelsAmount,&state](uint32_t readBlockArrayOffset, core::vectorSIMDu32 readBlockPos)
 				{
 					constexpr auto MaxPlanes = 4;
 					const void* srcPix[MaxPlanes] = { commonExecuteData.inData + readBlockArrayOffset,nullptr,nullptr,nullptr };
@@ -373,7 +585,9 @@ class CSwizzleAndConvertImageFilter<inFormat,EF_UNKNOWN,Swizzle,Dither,Normaliza
 						for (auto blockX = 0u; blockX < blockDims.x; blockX++)
 						{
 							auto localOutPos = readBlockPos * blockDims + commonExecuteData.offsetDifferenceInTexels;
-							uint8_t* dstPix = commonExecuteData.outData + commonExecuteData.oit->getByteOffset(localOutPos + core::vectorSIMDu32(blockX, blockY), commonExecuteData.outByteStrides);
+							uint8_t* dstPix = base_t::getOutPixel(commonExecuteData,staging.get(),localOutPos+core::vectorSIMDu32(blockX,blockY));
+							if (!dstPix)
+								continue;
 
 							constexpr auto maxChannels = 4;
 							decodeBufferType decodeBuffer[maxChannels] = {};
@@ -383,6 +597,8 @@ class CSwizzleAndConvertImageFilter<inFormat,EF_UNKNOWN,Swizzle,Dither,Normaliza
 						}
 				};
 				CBasicImageFilterCommon::executePerRegion(policy, commonExecuteData.inImg, swizzle, commonExecuteData.inRegions.begin(), commonExecuteData.inRegions.end(), clip);
+				if (staging)
+					staging->encode(policy,commonExecuteData,state->blockEncodeQuality);
 				return true;
 			};
 			return CMatchedSizeInOutImageFilterCommon::commonExecute(state, perOutputRegion);
@@ -15,6 +15,28 @@
 namespace nbl::asset::impl
 {
 
+/*
+	Block compressed formats can't be written one texel at a time, so their texels get
+	staged as 4 channels of the encode buffer type and whole blocks are encoded afterwards.
+	@see CSwizzleAndConvertImageFilter
+*/
+template<E_FORMAT outFormat, typename Tenc>
+inline void encodeOrStagePixels(void* dstPix, const Tenc* encodeBuffer)
+{
+	if constexpr (isBlockCompressionFormat<outFormat>())
+		std::copy_n(encodeBuffer, 4u, reinterpret_cast<Tenc*>(dstPix));
+	else
+		asset::encodePixels<outFormat>(dstPix, encodeBuffer);
+}
+template<typename Tenc>
+inline void encodeOrStagePixels(E_FORMAT outFormat, void* dstPix, const Tenc* encodeBuffer)
+{
+	if (isBlockCompressionFormat(outFormat))
+		std::copy_n(encodeBuffer, 4u, reinterpret_cast<Tenc*>(dstPix));
+	else
+		asset::encodePixelsRuntime(outFormat, dstPix, encodeBuffer);
+}
+
 /*
 	Common base class for Swizzleable or Ditherable ones
 	with custom compile time swizzle, dither, normalization and clamp.
@@ -130,7 +152,7 @@ class CSwizzleableAndDitherableFilterBase
 				}
 			}
 
-			asset::encodePixels<outFormat>(dstPix, encodeBuffer);
+			encodeOrStagePixels<outFormat>(dstPix, encodeBuffer);
 		}
 
 		/*
@@ -161,7 +183,7 @@ class CSwizzleableAndDitherableFilterBase
 				}
 			}
 
-			asset::encodePixelsRuntime(outFormat, dstPix, encodeBuffer);
+			encodeOrStagePixels(outFormat, dstPix, encodeBuffer);
 		}
 };
 
@@ -264,7 +286,7 @@ class CSwizzleableAndDitherableFilterBase<Swizzle,IdentityDither,Normalization,C
 				}
 			}
 
-			asset::encodePixels<outFormat>(dstPix, encodeBuffer);
+			encodeOrStagePixels<outFormat>(dstPix, encodeBuffer);
 		}
 
 		/*
@@ -288,7 +310,7 @@ class CSwizzleableAndDitherableFilterBase<Swizzle,IdentityDither,Normalization,C
 				}
 			}
 
-			asset::encodePixelsRuntime(outFormat, dstPix, encodeBuffer);
+			encodeOrStagePixels(outFormat, dstPix, encodeBuffer);
 		}
 };
 
@@ -411,7 +433,7 @@ class CSwizzleableAndDitherableFilterBase<PolymorphicSwizzle,Dither,Normalizatio
 				}
 			}
 
-			asset::encodePixels<outFormat>(dstPix, encodeBuffer);
+			encodeOrStagePixels<outFormat>(dstPix, encodeBuffer);
 		}
 
 		/*
@@ -442,7 +464,7 @@ class CSwizzleableAndDitherableFilterBase<PolymorphicSwizzle,Dither,Normalizatio
 				}
 			}
 
-			asset::encodePixelsRuntime(outFormat, dstPix, encodeBuffer);
+			encodeOrStagePixels(outFormat, dstPix, encodeBuffer);
 		}
 };
 
@@ -157,6 +157,7 @@ class IImageFilter
 		virtual bool pExecute(const core::execution::sequenced_policy&, IState* state) const = 0;
 		virtual bool pExecute(const core::execution::parallel_policy&, IState* state) const = 0;
 		virtual bool pExecute(const core::execution::parallel_unsequenced_policy&, IState* state) const = 0;
+		virtual bool pExecute(const core::CTaskScheduler::policy_t&, IState* state) const = 0;
 
 		virtual bool pExecute(IState* state) const {return pExecute(core::execution::seq,state);}
 };
@@ -201,6 +202,10 @@ class CImageFilter : public IImageFilter
 		{
 			return execute(policy,state);
 		}
+		inline bool pExecute(const core::CTaskScheduler::policy_t& policy, IState* state) const override
+		{
+			return execute(policy,state);
+		}
 };
 
 }
@@ -1833,7 +1833,21 @@ inline value_type getFormatMinValue(E_FORMAT format, uint32_t channel)
 template <typename value_type>
 inline value_type getFormatPrecision(E_FORMAT format, uint32_t channel, value_type value)
 {
-    _NBL_DEBUG_BREAK_IF(isBlockCompressionFormat(format)); //????
+    // blocks interpolate their endpoints to roughly 8 bit precision, or half float precision for BC6H
+    if (isBlockCompressionFormat(format))
+    {
+        switch (format)
+        {
+        case EF_BC6H_SFLOAT_BLOCK: [[fallthrough]];
+        case EF_BC6H_UFLOAT_BLOCK:
+            return getFormatPrecision<value_type>(EF_R16_SFLOAT, 0u, value);
+        case EF_BC4_SNORM_BLOCK: [[fallthrough]];
+        case EF_BC5_SNORM_BLOCK:
+            return getFormatPrecision<value_type>(EF_R8_SNORM, 0u, value);
+        default:
+            return getFormatPrecision<value_type>(isSRGBFormat(format) ? EF_R8G8B8A8_SRGB:EF_R8G8B8A8_UNORM, channel, value);
+        }
+    }
 
     if (isIntegerFormat(format) || isScaledFormat(format))
         return 1;
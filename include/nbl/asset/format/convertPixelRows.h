@@ -0,0 +1,39 @@
+// Copyright (C) 2018-2023 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#ifndef _NBL_ASSET_CONVERT_PIXEL_ROWS_H_INCLUDED_
+#define _NBL_ASSET_CONVERT_PIXEL_ROWS_H_INCLUDED_
+
+#include "nbl/core/declarations.h"
+#include "nbl/asset/format/EFormat.h"
+
+namespace nbl::asset
+{
+
+//! Whether `decodePixelRow` and `encodePixelRow` can handle `format` at all
+/**
+Any single plane format with 1x1 texel blocks which `decodePixels` and `encodePixels` handle through doubles qualifies,
+integer formats go through 64bit integers and block compressed formats can't be walked texel by texel.
+*/
+inline bool isPixelRowConvertible(const E_FORMAT format)
+{
+	return format!=EF_UNKNOWN && !isBlockCompressionFormat(format) && !isPlanarFormat(format) && !isIntegerFormat(format) && !isDepthOrStencilFormat(format);
+}
+
+//! Whether `format` has a dedicated row kernel, the other convertible formats fall back to a loop over `decodePixels`/`encodePixels`
+NBL_API2 bool hasPixelRowKernel(const E_FORMAT format);
+
+//! Decodes `texelCount` consecutive texels into 4 doubles each
+/**
+Produces exactly the values `decodePixels` would for each texel, the channels `format` doesn't have are zeroed.
+Returns false if `isPixelRowConvertible(format)` is false.
+*/
+NBL_API2 bool decodePixelRow(const E_FORMAT format, const void* src, double* dst, const uint32_t texelCount);
+
+//! Encodes `texelCount` consecutive texels from 4 doubles each, bit for bit the same as `encodePixels` would
+NBL_API2 bool encodePixelRow(const E_FORMAT format, void* dst, const double* src, const uint32_t texelCount);
+
+}
+
+#endif
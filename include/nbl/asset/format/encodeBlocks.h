@@ -0,0 +1,44 @@
+// Copyright (C) 2018-2023 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#ifndef _NBL_ASSET_ENCODE_BLOCKS_H_INCLUDED_
+#define _NBL_ASSET_ENCODE_BLOCKS_H_INCLUDED_
+
+#include "nbl/core/declarations.h"
+#include "nbl/asset/format/EFormat.h"
+
+namespace nbl::asset
+{
+
+//! Speed versus quality trade-off of the block compression encoders
+enum E_BLOCK_ENCODE_QUALITY : uint8_t
+{
+	//! endpoints straight from the bounding box of the block
+	EBEQ_FASTEST,
+	//! endpoints along the principal axis of the block, refined once by least squares
+	EBEQ_NORMAL,
+	//! more refinement passes and a small exhaustive search around the single channel endpoints
+	EBEQ_BEST,
+	EBEQ_COUNT
+};
+
+//! Whether `encodeBlock` can produce `format`, all of the BC family is supported
+inline bool isBlockEncodable(const E_FORMAT format)
+{
+	return format>=EF_BC1_RGB_UNORM_BLOCK && format<=EF_BC7_SRGB_BLOCK;
+}
+
+//! Compresses one 4x4 block of texels, the texels are in row major order
+/**
+The texel values are expected to be in the same ranges and color spaces as `decodePixels` would produce for `format`,
+so linear for the sRGB formats and half float ranges for BC6H. Channels the format doesn't have are ignored.
+
+BC6H is only encoded with its single region mode 11 and BC7 only with mode 6, which are the modes that cover
+smooth content well without the cost of a partition search.
+*/
+NBL_API2 bool encodeBlock(const E_FORMAT format, void* dst, const double texels[16][4], const E_BLOCK_ENCODE_QUALITY quality=EBEQ_NORMAL);
+
+}
+
+#endif
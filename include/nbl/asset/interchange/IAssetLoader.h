@@ -110,18 +110,47 @@ public:
 			loaderFlags(rhs.loaderFlags),
 			meshManipulatorOverride(rhs.meshManipulatorOverride),
 			restoreLevels(rhs.restoreLevels),
+			imageSubset(rhs.imageSubset),
 			logger(rhs.logger),
 			workingDirectory(rhs.workingDirectory),
 			reload(_reload)
 		{
 		}
 
+		//! Part of an image file to load, loaders which can't decode partially ignore it and load everything
+		/** Anything but the whole image at full resolution bypasses the asset cache and the deduplication of concurrent loads, for every level of the hierarchy,
+		because the assets would end up under the same keys as if the whole image was loaded. */
+		struct SImageSubset
+		{
+			inline bool isWholeImage() const
+			{
+				return baseMipLevel==0u && mipLevelCount==~0u && offset[0]==0u && offset[1]==0u && extent[0]==0u && extent[1]==0u && maxExtent==0u;
+			}
+			//! Texels of the image downscaled by `scale` which `[_offset,_offset+_extent)` touches, loaders size downscaled (sub-)images with this
+			/** So a downscaled rectangle is exactly the corresponding part of the whole image downscaled, no matter the loader. */
+			static inline uint32_t scaledExtent(const uint32_t _offset, const uint32_t _extent, const uint32_t scale)
+			{
+				return (_offset+_extent+scale-1u)/scale-_offset/scale;
+			}
+
+			//! Mip levels of the file to load, the first one becomes mip 0 of the image, the count gets clamped to what the file has
+			uint32_t baseMipLevel = 0u;
+			uint32_t mipLevelCount = ~0u;
+			//! Sub-rectangle in texels of `baseMipLevel`, a zero extent means the whole level
+			uint32_t offset[2] = {0u,0u};
+			uint32_t extent[2] = {0u,0u};
+			//! Loaders able to downscale while decoding shrink the (sub-)image by the smallest power of two that makes it fit, 0 means no limit
+			/** JPEG can only go down to 1/8 and logs a warning if that isn't enough, PNG has no limit (but can't downscale interlaced files at all). */
+			uint32_t maxExtent = 0u;
+		};
+
         size_t decryptionKeyLen;
         const uint8_t* decryptionKey;
         E_CACHING_FLAGS cacheFlags;
         E_LOADER_PARAMETER_FLAGS loaderFlags;				//!< Flags having an impact on extraordinary tasks during loading process
 		IMeshManipulator* meshManipulatorOverride = nullptr;    //!< pointer used for specifying custom mesh manipulator to use, if nullptr - default mesh manipulator will be used
 		uint32_t restoreLevels = 0u;
+		SImageSubset imageSubset = {};
 		const bool reload = false;
 		std::filesystem::path workingDirectory = "";
 		system::logger_opt_ptr logger;
@@ -272,6 +301,12 @@ public:
 			return SAssetBundle();
 		}
 
+		//! Whether loaders may load the asset's dependencies on other threads, return false if your override isn't thread-safe
+		inline virtual bool allowConcurrentLoads(const SAssetLoadContext& ctx, const uint32_t hierarchyLevel)
+		{
+			return true;
+		}
+
 		//! After a successful load of an asset or sub-asset
 		//TODO change name
 		virtual void insertAssetIntoCache(SAssetBundle& asset, const std::string& supposedKey, const SAssetLoadContext& ctx, const uint32_t hierarchyLevel);
@@ -311,6 +346,12 @@ protected:
 	SAssetBundle interm_getAssetInHierarchy(IAssetManager* _mgr, system::IFile* _file, const std::string& _supposedFilename, const IAssetLoader::SAssetLoadParams& _params, uint32_t _hierarchyLevel);
 	SAssetBundle interm_getAssetInHierarchy(IAssetManager* _mgr, const std::string& _filename, const IAssetLoader::SAssetLoadParams& _params, uint32_t _hierarchyLevel);
 
+	//! Issue loads of child assets this way and only wait on the futures once you really need the results
+	core::CTaskScheduler::future_t<SAssetBundle> interm_getAssetInHierarchyAsync(IAssetManager* _mgr, const std::string& _filename, const IAssetLoader::SAssetLoadParams& _params, uint32_t _hierarchyLevel, IAssetLoader::IAssetLoaderOverride* _override);
+	//! For assets a loader derives and caches on its own (such as views of loaded images), `_create` only runs if `_key` is not cached and nobody else is creating it already
+	/** `_create` must insert what it made into the cache under `_key`, concurrent callers with the same key wait for it and then look in the cache again. */
+	SAssetBundle interm_findOrCreateCachedAsset(IAssetManager* _mgr, const std::string& _key, const IAsset::E_TYPE* _types, const SAssetLoadContext& _ctx, uint32_t _hierarchyLevel, IAssetLoader::IAssetLoaderOverride* _override, const std::function<SAssetBundle()>& _create);
+
 	SAssetBundle interm_getAssetInHierarchyWholeBundleRestore(IAssetManager* _mgr, system::IFile* _file, const std::string& _supposedFilename, const IAssetLoader::SAssetLoadParams& _params, uint32_t _hierarchyLevel, IAssetLoader::IAssetLoaderOverride* _override);
 	SAssetBundle interm_getAssetInHierarchyWholeBundleRestore(IAssetManager* _mgr, const std::string& _filename, const IAssetLoader::SAssetLoadParams& _params, uint32_t _hierarchyLevel, IAssetLoader::IAssetLoaderOverride* _override);
 	SAssetBundle interm_getAssetInHierarchyWholeBundleRestore(IAssetManager* _mgr, system::IFile* _file, const std::string& _supposedFilename, const IAssetLoader::SAssetLoadParams& _params, uint32_t _hierarchyLevel);
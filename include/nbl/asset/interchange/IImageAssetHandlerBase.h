@@ -148,7 +148,7 @@ class IImageAssetHandlerBase : public virtual core::IReferenceCounted
 					COPY_FILTER::state_type state;
 					fillCommonState(state);
 
-					if (!COPY_FILTER::execute(core::execution::par_unseq,&state)) // execute is a static method
+					if (!COPY_FILTER::execute(core::CTaskScheduler::getDefault()->policy(),&state)) // execute is a static method
 						logger.log("Something went wrong while copying texel block data!", system::ILogger::ELL_ERROR);
 				}
 				else
@@ -163,7 +163,7 @@ class IImageAssetHandlerBase : public virtual core::IReferenceCounted
 					fillCommonState(state);
 					state.swizzle = viewParams.components;
 
-						if (!CONVERSION_FILTER::execute(core::execution::par_unseq,&state)) // static method
+						if (!CONVERSION_FILTER::execute(core::CTaskScheduler::getDefault()->policy(),&state)) // static method
 							logger.log("Something went wrong while converting the image!", system::ILogger::ELL_ERROR);
 				}
 			}
@@ -194,8 +194,10 @@ class IImageAssetHandlerBase : public virtual core::IReferenceCounted
 
 		static inline void performImageFlip(uint8_t* entry, uint8_t* end, uint32_t height, uint32_t rowPitch)
 		{
-			for (uint32_t y = 0, yRising = 0; y < height; y += 2, ++yRising)
-				core::swap_ranges(core::execution::par_unseq, entry + (yRising * rowPitch), entry + ((yRising + 1) * rowPitch), end - ((yRising + 1) * rowPitch));
+			core::CTaskScheduler::getDefault()->parallel_for(height/2u,[entry,end,rowPitch](const size_t yRising) -> void
+			{
+				std::swap_ranges(entry + (yRising * rowPitch), entry + ((yRising + 1) * rowPitch), end - ((yRising + 1) * rowPitch));
+			});
 		}
 
 	private:
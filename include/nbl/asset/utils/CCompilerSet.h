@@ -41,12 +41,17 @@ namespace nbl::asset
 				return nullptr;
 		}
 
+		//! Used by whoever compiles through the set without specifying a cache of their own, such as the logical device
+		inline void setSPIRVCache(core::smart_refctd_ptr<IShaderCompiler::CCache>&& cache) { m_spirvCache = std::move(cache); }
+		inline IShaderCompiler::CCache* getSPIRVCache() const { return m_spirvCache.get(); }
+
 	protected:
 
 #ifdef _NBL_PLATFORM_WINDOWS_
 		core::smart_refctd_ptr<CHLSLCompiler> m_HLSLCompiler = nullptr;
 #endif
 		core::smart_refctd_ptr<CGLSLCompiler> m_GLSLCompiler = nullptr;
+		core::smart_refctd_ptr<IShaderCompiler::CCache> m_spirvCache = nullptr;
 	};
 }
 
@@ -9,11 +9,13 @@
 #include <iostream>
 #include <limits>
 #include <cmath>
+#include <span>
 
 #include "parallel-hashmap/parallel_hashmap/phmap_dump.h"
 
 
 #include "nbl/core/declarations.h"
+#include "nbl/core/execution.h"
 #include "vectorSIMD.h"
 
 #include "nbl/system/declarations.h"
@@ -250,13 +252,18 @@ class CDirQuantCacheBase : public impl::CDirQuantCacheBase
 		template<E_FORMAT CacheFormat>
 		using value_type_t = typename impl::CDirQuantCacheBase::value_type<CacheFormat>::type;
 
+		//! 16 submaps, enough to keep lock contention low with a thread per core
+		_NBL_STATIC_INLINE_CONSTEXPR size_t SubmapCountLog2 = 4u;
+
 		template<E_FORMAT CacheFormat>
 		_NBL_STATIC_INLINE_CONSTEXPR uint32_t quantization_bits_v = value_type_t<CacheFormat>::quantizationBits;
 
+		//! Every submap of the cache carries its own mutex, so `quantize` can be called from many threads at once.
+		//! Loading, saving and clearing the cache must not overlap with quantization.
 		template<E_FORMAT CacheFormat>
 		struct cache_type
 		{
-			using type = core::unordered_map<Key,value_type_t<CacheFormat>,Hash>;
+			using type = phmap::parallel_flat_hash_map<Key,value_type_t<CacheFormat>,Hash,std::equal_to<Key>,core::allocator<std::pair<const Key,value_type_t<CacheFormat>>>,SubmapCountLog2,std::mutex>;
 		};
 		template<E_FORMAT CacheFormat>
 		using cache_type_t = typename cache_type<CacheFormat>::type;
@@ -264,7 +271,7 @@ class CDirQuantCacheBase : public impl::CDirQuantCacheBase
 		template<E_FORMAT CacheFormat>
 		inline void insertIntoCache(const Key& key, const value_type_t<CacheFormat>& value)
 		{
-			std::get<cache_type_t<CacheFormat>>(cache).insert(std::make_pair(key,value));		
+			std::get<cache_type_t<CacheFormat>>(cache).insert(std::make_pair(key,value));
 		}
 
 		//!
@@ -370,7 +377,10 @@ class CDirQuantCacheBase : public impl::CDirQuantCacheBase
 		template<E_FORMAT CacheFormat>
 		inline size_t getSerializedCacheSizeInBytes()
 		{
-			return getSerializedCacheSizeInBytes_impl<CacheFormat>(std::get<cache_type_t<CacheFormat>>(cache).capacity());
+			// every submap gets dumped as a separate table, and empty ones only dump their header, easiest to just count
+			CSizeCountingPhmapOutputArchive counter;
+			std::get<cache_type_t<CacheFormat>>(cache).dump(counter);
+			return counter.size;
 		}
 
 	protected:
@@ -388,14 +398,14 @@ class CDirQuantCacheBase : public impl::CDirQuantCacheBase
 			value_type_t<CacheFormat> quantized;
 			{
 				auto& particularCache = std::get<cache_type_t<CacheFormat>>(cache);
-				auto found = particularCache.find(key);
-				if (found != particularCache.end() && (found->first == key))
-					quantized = found->second;
-				else
+				// can't hold on to an iterator, another thread could rehash the submap under us
+				const bool found = particularCache.if_contains(key,[&quantized](const auto& item)->void{quantized = item.second;});
+				if (!found)
 				{
 					const core::vectorSIMDf fit = findBestFit<dimensions,quantizationBits>(absValue);
 
 					quantized = core::vectorSIMDu32(core::abs(fit));
+					// if another thread beat us to it, it has inserted the exact same value
 					insertIntoCache<CacheFormat>(key,quantized);
 				}
 			}
@@ -452,61 +462,126 @@ class CDirQuantCacheBase : public impl::CDirQuantCacheBase
 				}
 			}
 
-			core::vectorSIMDf bestFit;
-			float closestTo1 = -1.f;
-			auto evaluateFit = [&](const core::vectorSIMDf& newFit) -> void
-			{
-				auto newFitLen = core::length(newFit);
-				const float dp = core::dot<core::vectorSIMDf>(newFit,vectorForDots).preciseDivision(newFitLen)[0];
-				if (dp > closestTo1)
-				{
-					closestTo1 = dp;
-					bestFit = newFit;
-				}
-			};
-
+			// Candidates are tested in SoA form, every lane of a register holds a different scale `n` so each
+			// iteration evaluates 4 consecutive scales against the bottom fit and all the corner offsets at once.
 			constexpr uint32_t cubeHalfSize = (0x1u << quantizationBits) - 1u;
+			constexpr uint32_t candidatesPerScale = cornerCount+1u;
+			constexpr uint32_t lanes = 4u;
 			const core::vectorSIMDf cubeHalfSizeND = core::vectorSIMDf(cubeHalfSize);
-			for (uint32_t n=cubeHalfSize; n>0u; n--)
+			const core::vectorSIMDf laneIndex(0.f,1.f,2.f,3.f);
+			core::vectorSIMDf fittingSoA[dimensions],floorOffsetSoA[dimensions],directionSoA[dimensions];
+			core::vectorSIMDf cornersSoA[cornerCount][dimensions];
+			for (auto i=0u; i<dimensions; i++)
+			{
+				fittingSoA[i] = core::vectorSIMDf(fittingVector[i]);
+				floorOffsetSoA[i] = core::vectorSIMDf(floorOffset[i]);
+				directionSoA[i] = core::vectorSIMDf(vectorForDots[i]);
+				for (auto corn=0u; corn<cornerCount; corn++)
+					cornersSoA[corn][i] = core::vectorSIMDf(corners[corn][i]);
+			}
+
+			// per lane running best, `bestOrder` is the position the candidate would have in a scalar sweep
+			// going from the largest scale down, needed to resolve ties exactly the same way
+			core::vectorSIMDf bestDot(-1.f);
+			core::vectorSIMDf bestOrder((std::numeric_limits<float>::max)());
+			core::vectorSIMDf bestSoA[dimensions];
+			for (uint32_t batch=0u; batch<cubeHalfSize; batch+=lanes)
 			{
 				//we'd use float addition in the interest of speed, to increment the loop
 				//but adding a small number to a large one loses precision, so multiplication preferrable
-				core::vectorSIMDf bottomFit = core::floor(fittingVector*float(n)+floorOffset);
-				if ((bottomFit<=cubeHalfSizeND).all())
-					evaluateFit(bottomFit);
-				for (auto i=0u; i<cornerCount; i++)
+				const core::vectorSIMDf n = core::vectorSIMDf(float(cubeHalfSize-batch))-laneIndex;
+				// last batch can run past n==1
+				const auto scaleValid = n>core::vectorSIMDf(0.f);
+				const core::vectorSIMDf order = (core::vectorSIMDf(float(batch))+laneIndex)*core::vectorSIMDf(float(candidatesPerScale));
+
+				core::vectorSIMDf bottomFit[dimensions];
+				for (auto i=0u; i<dimensions; i++)
+					bottomFit[i] = core::floor(fittingSoA[i]*n+floorOffsetSoA[i]);
+				for (auto cand=0u; cand<candidatesPerScale; cand++)
 				{
-					auto bottomFitTmp = bottomFit+corners[i];
-					if ((bottomFitTmp<=cubeHalfSizeND).all())
-						evaluateFit(bottomFitTmp);
+					core::vectorSIMDf newFit[dimensions];
+					auto valid = scaleValid;
+					core::vectorSIMDf dotProduct(0.f),lengthSquared(0.f);
+					for (auto i=0u; i<dimensions; i++)
+					{
+						newFit[i] = cand ? (bottomFit[i]+cornersSoA[cand-1u][i]):bottomFit[i];
+						valid = valid&(newFit[i]<=cubeHalfSizeND);
+						dotProduct += newFit[i]*directionSoA[i];
+						lengthSquared += newFit[i]*newFit[i];
+					}
+					const core::vectorSIMDf dp = dotProduct.preciseDivision(core::sqrt(lengthSquared));
+					const auto better = valid&(dp>bestDot);
+					if (!better.any())
+						continue;
+					bestDot = core::mix(bestDot,dp,better);
+					bestOrder = core::mix(bestOrder,order+core::vectorSIMDf(float(cand)),better);
+					for (auto i=0u; i<dimensions; i++)
+						bestSoA[i] = core::mix(bestSoA[i],newFit[i],better);
 				}
 			}
 
+			core::vectorSIMDf bestFit;
+			float closestTo1 = -1.f;
+			float closestOrder = (std::numeric_limits<float>::max)();
+			for (auto lane=0u; lane<lanes; lane++)
+			if (bestDot[lane]>closestTo1 || bestDot[lane]==closestTo1&&bestOrder[lane]<closestOrder)
+			{
+				closestTo1 = bestDot[lane];
+				closestOrder = bestOrder[lane];
+				for (auto i=0u; i<dimensions; i++)
+					bestFit[i] = bestSoA[i][lane];
+			}
+
 			return bestFit;
 		}
+
+		//! Batched counterpart of `quantize`, the cache backend is concurrent so a parallel `policy` is fine.
+		template<uint32_t dimensions, E_FORMAT CacheFormat, class ExecutionPolicy, typename T, class Preprocess>
+		inline void quantize(ExecutionPolicy&& policy, std::span<const T> values, value_type_t<CacheFormat>* out, Preprocess&& preprocess)
+		{
+			core::for_each(std::forward<ExecutionPolicy>(policy),values.begin(),values.end(),[&](const T& value)->void
+			{
+				out[&value-values.data()] = quantize<dimensions,CacheFormat>(preprocess(value));
+			});
+		}
 		
 		template<E_FORMAT CacheFormat>
-		static inline size_t getSerializedCacheSizeInBytes_impl(size_t capacity)
+		static inline size_t getSerializedCacheSizeInBytes_impl(size_t capacity, size_t tableCount=1u)
 		{
-			return 1u+sizeof(size_t)*2u+phmap::priv::Group::kWidth+(sizeof(typename cache_type_t<CacheFormat>::slot_type)+1u)*capacity;
+			return (1u+sizeof(size_t)*2u+phmap::priv::Group::kWidth)*tableCount+(sizeof(typename cache_type_t<CacheFormat>::value_type)+1u)*capacity;
 		}
 		template<E_FORMAT CacheFormat>
 		static inline bool validateSerializedCache(const SBufferRange<const ICPUBuffer>& buffer)
 		{
-			if (buffer.offset+buffer.size>buffer.buffer.get()->getSize() || buffer.size<=sizeof(size_t)*2ull)
+			if (buffer.offset+buffer.size>buffer.buffer.get()->getSize())
 				return false;
 			
 			const uint8_t* buffPtr = static_cast<const uint8_t*>(buffer.buffer.get()->getPointer())+buffer.offset;
+			const uint8_t* const buffEnd = buffPtr+buffer.size;
 
-			const size_t size = reinterpret_cast<const size_t*>(buffPtr)[0];
-			const size_t capacity = reinterpret_cast<const size_t*>(buffPtr)[1];
-			if (size == 0)
-				return true;
-
-			if (buffer.size-sizeof(size_t)*2ull<getSerializedCacheSizeInBytes_impl<CacheFormat>(capacity))
-				return false;
+			// the submaps are dumped back to back, each starts with its size and capacity but an empty one stops right there
+			constexpr size_t HeaderSize = sizeof(size_t)*2ull;
+			for (size_t i=0u; i<cache_type_t<CacheFormat>::subcnt(); i++)
+			{
+				if (size_t(buffEnd-buffPtr)<HeaderSize)
+					return false;
+				size_t size,capacity;
+				memcpy(&size,buffPtr,sizeof(size_t));
+				memcpy(&capacity,buffPtr+sizeof(size_t),sizeof(size_t));
+				buffPtr += HeaderSize;
+				if (size==0u)
+					continue;
+
+				// capacities are always one less than a power of two, also keeps the size computation below from overflowing
+				if (size>capacity || (capacity&(capacity+1u)) || capacity>size_t(buffEnd-buffPtr))
+					return false;
+				const size_t tableSize = getSerializedCacheSizeInBytes_impl<CacheFormat>(capacity)-HeaderSize;
+				if (size_t(buffEnd-buffPtr)<tableSize)
+					return false;
+				buffPtr += tableSize;
+			}
 
-			return false;
+			return buffPtr==buffEnd;
 		}
 };
 
@@ -61,6 +61,22 @@ class CQuantNormalCache : public CDirQuantCacheBase<impl::VectorUV,impl::QuantNo
 			normal.makeSafe3D();
 			return Base::quantize<3u,CacheFormat>(normal);
 		}
+
+		//! Quantizes `normals.size()` normals into `out`, pass a parallel `policy` to spread the cache misses over threads
+		template<E_FORMAT CacheFormat, class ExecutionPolicy>
+		void quantize(ExecutionPolicy&& policy, std::span<const core::vectorSIMDf> normals, value_type_t<CacheFormat>* out)
+		{
+			Base::quantize<3u,CacheFormat>(std::forward<ExecutionPolicy>(policy),normals,out,[](core::vectorSIMDf normal)->core::vectorSIMDf
+			{
+				normal.makeSafe3D();
+				return normal;
+			});
+		}
+		template<E_FORMAT CacheFormat>
+		void quantize(std::span<const core::vectorSIMDf> normals, value_type_t<CacheFormat>* out)
+		{
+			quantize<CacheFormat>(core::execution::seq,normals,out);
+		}
 };
 
 }
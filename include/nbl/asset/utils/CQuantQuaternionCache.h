@@ -64,6 +64,21 @@ class CQuantQuaternionCache : public CDirQuantCacheBase<impl::Projection,impl::Q
 		{
 			return Base::quantize<4u,CacheFormat>(reinterpret_cast<const core::vectorSIMDf&>(quat));
 		}
+
+		//! Quantizes `quats.size()` quaternions into `out`, pass a parallel `policy` to spread the cache misses over threads
+		template<E_FORMAT CacheFormat, class ExecutionPolicy>
+		void quantize(ExecutionPolicy&& policy, std::span<const core::quaternion> quats, value_type_t<CacheFormat>* out)
+		{
+			Base::quantize<4u,CacheFormat>(std::forward<ExecutionPolicy>(policy),quats,out,[](const core::quaternion& quat)->const core::vectorSIMDf&
+			{
+				return reinterpret_cast<const core::vectorSIMDf&>(quat);
+			});
+		}
+		template<E_FORMAT CacheFormat>
+		void quantize(std::span<const core::quaternion> quats, value_type_t<CacheFormat>* out)
+		{
+			quantize<CacheFormat>(core::execution::seq,quats,out);
+		}
 };
 
 }
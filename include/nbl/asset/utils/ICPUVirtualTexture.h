@@ -225,7 +225,7 @@ public:
         copy.inImage = _img;
         copy.outImage = paddedImg.get();
 
-        CPaddedCopyImageFilter::execute(core::execution::par_unseq,&copy);
+        CPaddedCopyImageFilter::execute(core::CTaskScheduler::getDefault()->policy(),&copy);
 
         using mip_gen_filter_t = CMipMapGenerationImageFilter<VoidSwizzle, IdentityDither, void/*TODO: whitenoise*/, false, CBlitUtilities<>>;
         //generate all mip levels
@@ -242,7 +242,7 @@ public:
             genmips.axisWraps[1] = _wrapv;
             genmips.axisWraps[2] = ISampler::ETC_CLAMP_TO_EDGE;
             genmips.borderColor = _borderColor;
-            mip_gen_filter_t::execute(core::execution::par_unseq,&genmips);
+            mip_gen_filter_t::execute(core::CTaskScheduler::getDefault()->policy(),&genmips);
             _NBL_ALIGNED_FREE(genmips.scratchMemory);
         }
 
@@ -405,7 +405,7 @@ public:
                     copy.axisWraps[1] = _vwrap;
                     copy.axisWraps[2] = ISampler::ETC_CLAMP_TO_EDGE;
                     copy.borderColor = _borderColor;
-                    if (!CPaddedCopyImageFilter::execute(core::execution::par_unseq,&copy))
+                    if (!CPaddedCopyImageFilter::execute(core::CTaskScheduler::getDefault()->policy(),&copy))
                         assert(false);
                 }
         }
@@ -454,7 +454,7 @@ public:
             copy.inOffset = {static_cast<uint32_t>(_addr.pgTab_x>>(copy.inMipLevel)),static_cast<uint32_t>(_addr.pgTab_y>>(copy.inMipLevel)),0u};
             copy.outOffset = {static_cast<uint32_t>(aliasAddr.pgTab_x>>i), static_cast<uint32_t>(aliasAddr.pgTab_y>>i), 0u};
 
-            CCopyImageFilter::execute(core::execution::par_unseq,&copy);
+            CCopyImageFilter::execute(core::CTaskScheduler::getDefault()->policy(),&copy);
         }
 
         //nasty trick
@@ -5,6 +5,8 @@
 #include "nbl/asset/ICPUBuffer.h"
 #include "nbl/system/ILogger.h"
 
+#include <span>
+
 namespace nbl
 {
 
@@ -39,13 +41,16 @@ public:
         EOP_COUNT
     };
 
-    ISPIRVOptimizer(std::initializer_list<E_OPTIMIZER_PASS> _passes) : m_passes(std::move(_passes)) {}
+    ISPIRVOptimizer(std::initializer_list<E_OPTIMIZER_PASS> _passes) : m_passes(_passes) {}
+
+    inline std::span<const E_OPTIMIZER_PASS> getPasses() const { return m_passes; }
 
     core::smart_refctd_ptr<ICPUBuffer> optimize(const uint32_t* _spirv, uint32_t _dwordCount, system::logger_opt_ptr logger) const;
     core::smart_refctd_ptr<ICPUBuffer> optimize(const ICPUBuffer* _spirv, system::logger_opt_ptr logger) const;
 
 protected:
-    const std::initializer_list<E_OPTIMIZER_PASS> m_passes;
+    // the array backing an `initializer_list` only lives until the end of the full expression, need a copy
+    const core::vector<E_OPTIMIZER_PASS> m_passes;
 };
 
 }
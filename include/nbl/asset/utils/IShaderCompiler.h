@@ -116,6 +116,8 @@ class NBL_API2 IShaderCompiler : public core::IReferenceCounted
 
 		IShaderCompiler(core::smart_refctd_ptr<system::ISystem>&& system);
 
+		class CCache;
+
 		struct SPreprocessorOptions
 		{
 			std::string_view sourceIdentifier = "";
@@ -155,6 +157,7 @@ class NBL_API2 IShaderCompiler : public core::IReferenceCounted
 				@includeFinder Optional parameter; if not nullptr, it will resolve the includes in the code
 				@maxSelfInclusionCount used only when includeFinder is not nullptr
 				@extraDefines adds extra defines to the shader before compilation
+			@spirvCache Optional parameter; if not nullptr, the final (optimized) SPIR-V is looked up and stored there, keyed by the preprocessed source and the options above
 		*/
 		struct SCompilerOptions
 		{
@@ -163,6 +166,7 @@ class NBL_API2 IShaderCompiler : public core::IReferenceCounted
 			const ISPIRVOptimizer* spirvOptimizer = nullptr;
 			core::bitflag<E_DEBUG_INFO_FLAGS> debugInfoFlags = core::bitflag<E_DEBUG_INFO_FLAGS>(E_DEBUG_INFO_FLAGS::EDIF_SOURCE_BIT) | E_DEBUG_INFO_FLAGS::EDIF_TOOL_BIT;
 			SPreprocessorOptions preprocessorOptions = {};
+			CCache* spirvCache = nullptr;
 
 			void setCommonData(const SCompilerOptions& opt)
 			{
@@ -173,6 +177,65 @@ class NBL_API2 IShaderCompiler : public core::IReferenceCounted
 		};
 
 
+		//! Persistent content addressed cache of compiled SPIR-V, safe to share between threads and between processes using the same directory
+		/**
+		The key is a hash of the preprocessed source (which has all the `#include`s resolved by the `CIncludeFinder` and the extra defines expanded),
+		the macro definitions, the shader stage, the target SPIR-V version, the debug info flags and the optimizer passes.
+
+		Every entry is its own file which gets written to a temporary and then renamed into place, so readers never see partial entries.
+		Hits bump the file's modification time, once the directory grows past `maxSize` the least recently used entries get deleted.
+		*/
+		class NBL_API2 CCache final : public core::IReferenceCounted
+		{
+			public:
+				// bump whenever the compilers or the way they get invoked change in a way that alters the output
+				static inline constexpr uint32_t VERSION = 1u;
+
+				using key_t = std::array<uint64_t,4>;
+
+				struct SStatistics
+				{
+					uint64_t hits = 0ull;
+					uint64_t misses = 0ull;
+					uint64_t insertions = 0ull;
+					uint64_t evictions = 0ull;
+				};
+
+				CCache(core::smart_refctd_ptr<system::ISystem>&& system, system::path&& directory, const size_t maxSize=0x1ull<<28u);
+
+				//!
+				static key_t computeKey(const IShader::E_CONTENT_TYPE sourceType, const std::string_view preprocessedCode, const IShader::E_SHADER_STAGE stage, const SCompilerOptions& options);
+
+				//! Returns nullptr on a miss
+				core::smart_refctd_ptr<ICPUBuffer> find(const key_t& key);
+				//!
+				void insert(const key_t& key, const ICPUBuffer* spirv);
+
+				//! Only counts what this object did, not other processes sharing the directory
+				inline SStatistics getStatistics() const
+				{
+					return {m_hits.load(),m_misses.load(),m_insertions.load(),m_evictions.load()};
+				}
+
+				inline const system::path& getDirectory() const {return m_directory;}
+				inline size_t getMaxSize() const {return m_maxSize;}
+
+			private:
+				system::path getEntryPath(const key_t& key) const;
+				// rescans the directory as other processes might have added entries
+				void trim();
+
+				core::smart_refctd_ptr<system::ISystem> m_system;
+				const system::path m_directory;
+				const size_t m_maxSize;
+				// makes temporary file names unique across processes
+				const uint64_t m_nonce;
+				std::mutex m_trimMutex;
+				std::atomic<size_t> m_approximateSize = 0ull;
+				std::atomic<uint64_t> m_tmpCounter = 0ull;
+				std::atomic<uint64_t> m_hits = 0ull, m_misses = 0ull, m_insertions = 0ull, m_evictions = 0ull;
+		};
+
 		virtual core::smart_refctd_ptr<ICPUShader> compileToSPIRV(const char* code, const SCompilerOptions& options) const = 0;
 
 		inline core::smart_refctd_ptr<ICPUShader> compileToSPIRV(system::IFile* sourceFile, const SCompilerOptions& options) const
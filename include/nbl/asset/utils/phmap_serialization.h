@@ -42,6 +42,26 @@ class CBufferPhmapOutputArchive
 
 };
 
+//! Only counts the bytes a dump would write, the size of a table's dump depends on whether it is empty
+class CSizeCountingPhmapOutputArchive
+{
+	public:
+		bool dump(const char* p, size_t sz)
+		{
+			size += sz;
+			return true;
+		}
+
+		template<typename V>
+		typename std::enable_if<phmap::type_traits_internal::IsTriviallyCopyable<V>::value,bool>::type dump(const V& v)
+		{
+			size += sizeof(V);
+			return true;
+		}
+
+		size_t size = 0ull;
+};
+
 }
 
 #endif
\ No newline at end of file
@@ -6,23 +6,28 @@
 #define __NBL_CORE_BYTESWAP_H_INCLUDED__
 
 #include <stdint.h>
+#include <cstring>
 #include <type_traits>
 
 #if defined(_NBL_WINDOWS_API_) && defined(_MSC_VER) && (_MSC_VER > 1298)
 #include <stdlib.h>
 #define bswap_16(X) _byteswap_ushort(X)
 #define bswap_32(X) _byteswap_ulong(X)
+#define bswap_64(X) _byteswap_uint64(X)
 #elif defined(_NBL_OSX_PLATFORM_)
 #include <libkern/OSByteOrder.h>
 #define bswap_16(X) OSReadSwapInt16(&X,0)
 #define bswap_32(X) OSReadSwapInt32(&X,0)
+#define bswap_64(X) OSReadSwapInt64(&X,0)
 #elif defined(__FreeBSD__) || defined(__OpenBSD__)
 #include <sys/endian.h>
 #define bswap_16(X) bswap16(X)
 #define bswap_32(X) bswap32(X)
+#define bswap_64(X) bswap64(X)
 #else
 #define bswap_16(X) ((((X)&0xFF) << 8) | (((X)&0xFF00) >> 8))
 #define bswap_32(X) ( (((X)&0x000000FF)<<24) | (((X)&0xFF000000) >> 24) | (((X)&0x0000FF00) << 8) | (((X) &0x00FF0000) >> 8))
+#define bswap_64(X) ( (uint64_t(bswap_32(uint32_t((X)&0xFFFFFFFFull)))<<32) | uint64_t(bswap_32(uint32_t((X)>>32))) )
 #endif
 
 namespace nbl::core
@@ -68,6 +73,26 @@ namespace nbl::core
 			value = bswap_32(value);
 			return core::FR(value);
 		}
+
+		static inline uint64_t byteswap(const uint64_t number)
+		{
+			return bswap_64(number);
+		}
+
+		static inline int64_t byteswap(const int64_t number)
+		{
+			return bswap_64(uint64_t(number));
+		}
+
+		static inline double byteswap(const double number)
+		{
+			uint64_t value;
+			memcpy(&value,&number,sizeof(double));
+			value = bswap_64(value);
+			double retval;
+			memcpy(&retval,&value,sizeof(double));
+			return retval;
+		}
 	};
 } // end namespace nbl::core
 
@@ -264,6 +264,90 @@ protected:
             return retval;
         }
 
+        //! Conservative estimate of the largest block we are sure to be able to allocate with `maxAlignment`
+        inline size_type findMaxAllocatableSize(const size_type maxAlignment) const noexcept
+        {
+            for (decltype(freeListCount) i=freeListCount; i>0u; i--)
+            {
+                size_type level = i-1u;
+                auto blockCount = freeListStackCtr[level];
+                if (!blockCount)
+                    continue;
+
+                // get first block in the size's free-list, not accurate since there might be bigger blocks further in the list.
+                // however because the free-lists are binned by size, this is accurate within a factor of 1.99999999x
+                const auto& block = freeListStack[level][blockCount-1];
+                // fail to get anything useful out of the block due to alignment constraints
+                Block hypotheticalNewBlock;
+                if (!alignBlockStart(hypotheticalNewBlock,block,maxAlignment))
+                    continue;
+                hypotheticalNewBlock.endOffset = block.endOffset;
+                return hypotheticalNewBlock.getLength();
+            }
+
+            return 0u;
+        }
+
+        //! Sorts and merges adjacent free blocks, returns the start of the free space at the end of the buffer or `bufferSize` if there is none
+        inline size_type coalesceFreeBlocks(void* reservedSpc) noexcept
+        {
+            // TODO: radix sort the whole thing on the block-start value and do a coalesce without `findMinimum`
+            // also add the blocks in reverse order
+            Block* freeListOld[maxListLevels];
+            const Block* freeListOldEnd[maxListLevels];
+            for (decltype(freeListCount) i=0u; i<freeListCount; i++)
+            {
+                freeListOld[i] = freeListStack[i];
+                freeListOldEnd[i] = freeListOld[i]+freeListStackCtr[i];
+                std::sort(freeListOld[i],const_cast<Block*>(freeListOldEnd[i]));
+            }
+
+            swapFreeLists(reservedSpc);
+
+            // begin the coalesce
+            Block lastBlock{0u,0u};
+            auto minimum = findMinimum(freeListOld,freeListOldEnd);
+            while (minimum!=freeListCount)
+            {
+                // find next free block and pop it
+                const Block* nextBlock = freeListOld[minimum]++;
+
+                // check if broke continuity
+                if (nextBlock->startOffset!=lastBlock.endOffset)
+                {
+                    // put old on correct free list
+                    if (lastBlock.getLength())
+                        insertFreeBlock(lastBlock);
+
+                    lastBlock.startOffset = nextBlock->startOffset;
+                }
+
+                lastBlock.endOffset = nextBlock->endOffset;
+                minimum = findMinimum(freeListOld,freeListOldEnd);
+            }
+            #ifdef _NBL_DEBUG
+            for (decltype(freeListCount) i=0u; i<freeListCount; i++)
+                assert(freeListOld[i]==freeListOldEnd[i]);
+            #endif // _NBL_DEBUG
+            // put last block on correct free list
+            if (lastBlock.getLength())
+            {
+                insertFreeBlock(lastBlock);
+                if (lastBlock.endOffset==bufferSize)
+                    return lastBlock.startOffset;
+            }
+
+            return bufferSize;
+        }
+
+        static inline size_type calcReservedSize(size_type bufSz, size_type minBlockSz) noexcept
+        {
+            size_type reserved = 0u;
+            for (size_type i=0u; i<findFreeListCount(bufSz,minBlockSz); i++)
+                reserved += (bufSz/(minBlockSz<<i)+1u)*size_type(2u);
+            return (reserved-2u)*sizeof(Block);
+        }
+
     private:
         //! Lists contain blocks of size < (minBlock<<listIndex)*2 && size >= (minBlock<<listIndex)
         static inline uint32_t  findFreeListInsertIndex(size_type byteSize, size_type minBlockSz) noexcept
@@ -430,14 +514,421 @@ class GeneralpurposeAddressAllocatorStrategy<_size_type,false> : protected Gener
         }
 };
 
+//! Two-level segregated fit, every power of two size range gets `SecondLevelCount` linear sub-ranges each with its own free list
+/**
+A bitmap over the first level and one per second level let us find the first non-empty list whose blocks are all large enough in constant time.
+The free blocks are also indexed by the `minBlockSize`-sized cell they start and end in, which is unique because no block can be shorter,
+so a freed block gets merged with its free neighbours straight away and there is never anything left to defragment.
+The price is that `reset` and resizing are linear in `bufferSize/minBlockSize` instead of the number of levels.
+*/
+template<typename _size_type>
+class GeneralpurposeAddressAllocatorTLSFStrategy
+{
+    protected:
+        //types
+        _NBL_DECLARE_ADDRESS_ALLOCATOR_TYPEDEFS(_size_type);
+        struct Block
+        {
+            size_type startOffset;
+            size_type endOffset;
+
+            inline size_type    getLength()                     const {return endOffset-startOffset;}
+            inline bool         operator<(const Block& other)   const {return startOffset<other.startOffset;}
+        };
+        static inline uint32_t  findFreeListCount(size_type byteSize) noexcept
+        {
+            uint32_t firstLevel,secondLevel;
+            mapSize(byteSize,firstLevel,secondLevel);
+            return firstLevel+1u;
+        }
+
+
+        // constructors
+        GeneralpurposeAddressAllocatorTLSFStrategy(size_type bufSz, size_type minBlockSz) noexcept :
+            bufferSize(bufSz), freeSize(0u), minBlockSize(minBlockSz), firstLevelBitmap(0ull),
+            freeBlocks(nullptr), freeBlockEnds(nullptr), freeListHeads(nullptr)
+        {
+            std::fill_n(secondLevelBitmaps,maxListLevels,0u);
+        }
+        GeneralpurposeAddressAllocatorTLSFStrategy(size_type newBuffSz, const GeneralpurposeAddressAllocatorTLSFStrategy& other, void* newReservedSpc) noexcept :
+            GeneralpurposeAddressAllocatorTLSFStrategy(newBuffSz,other.minBlockSize)
+        {
+            copyState(other,newReservedSpc);
+        }
+        GeneralpurposeAddressAllocatorTLSFStrategy(size_type newBuffSz, GeneralpurposeAddressAllocatorTLSFStrategy&& other, void* newReservedSpc) noexcept :
+            GeneralpurposeAddressAllocatorTLSFStrategy(newBuffSz,other.minBlockSize)
+        {
+            copyState(other,newReservedSpc);
+
+            other.bufferSize = invalid_address;
+            other.freeSize = invalid_address;
+            other.minBlockSize = invalid_address;
+            other.firstLevelBitmap = 0ull;
+            std::fill_n(other.secondLevelBitmaps,maxListLevels,0u);
+            other.freeBlocks = nullptr;
+            other.freeBlockEnds = nullptr;
+            other.freeListHeads = nullptr;
+        }
+
+        virtual ~GeneralpurposeAddressAllocatorTLSFStrategy() {}
+
+
+        GeneralpurposeAddressAllocatorTLSFStrategy& operator=(GeneralpurposeAddressAllocatorTLSFStrategy&& other)
+        {
+            std::swap(bufferSize,other.bufferSize);
+            std::swap(freeSize,other.freeSize);
+            std::swap(minBlockSize,other.minBlockSize);
+            std::swap(firstLevelBitmap,other.firstLevelBitmap);
+            std::swap_ranges(secondLevelBitmaps,secondLevelBitmaps+maxListLevels,other.secondLevelBitmaps);
+            std::swap(freeBlocks,other.freeBlocks);
+            std::swap(freeBlockEnds,other.freeBlockEnds);
+            std::swap(freeListHeads,other.freeListHeads);
+            return *this;
+        }
+
+
+        // members
+        size_type               bufferSize;
+        size_type               freeSize;
+        size_type               minBlockSize;
+
+        constexpr static uint32_t   SecondLevelBits = 4u;
+        constexpr static uint32_t   SecondLevelCount = 0x1u<<SecondLevelBits;
+        //! the lowest first level holds the sizes below `SecondLevelCount`, one per list
+        constexpr static size_t     maxListLevels = sizeof(size_type)*8u-SecondLevelBits+1u;
+        uint64_t                firstLevelBitmap;
+        uint32_t                secondLevelBitmaps[maxListLevels];
+
+
+        //methods
+        inline bool                 is_double_free(size_type addr, size_type bytes) const noexcept
+        {
+            size_type totalFree = 0u;
+            for (size_type list=0u; list<findFreeListCount(bufferSize)*SecondLevelCount; list++)
+            for (size_type i=freeListHeads[list]; i!=invalid_address; i=freeBlocks[i].next)
+            {
+                const Block& freeb = freeBlocks[i].block;
+                totalFree += freeb.getLength();
+                if (addr>=freeb.endOffset)
+                    continue;
+
+                if (addr+bytes<=freeb.startOffset)
+                    continue;
+
+                return true;
+            }
+            #ifdef _NBL_DEBUG
+            assert(freeSize==totalFree);
+            #endif // _NBL_DEBUG
+            return false;
+        }
+        inline uint32_t          findFreeListInsertIndex(size_type byteSize) const noexcept
+        {
+            return findFreeListCount(byteSize)-1u;
+        }
+
+        //! there is only one set of lists, this just lays out and clears the state in the reserved space
+        inline void              swapFreeLists(void* startPtr) noexcept
+        {
+            freeSize = 0u;
+            firstLevelBitmap = 0ull;
+            std::fill_n(secondLevelBitmaps,maxListLevels,0u);
+
+            const size_type cellCount = getCellCount(bufferSize,minBlockSize);
+            freeBlocks = reinterpret_cast<FreeBlock*>(startPtr);
+            freeBlockEnds = reinterpret_cast<size_type*>(freeBlocks+cellCount);
+            freeListHeads = freeBlockEnds+cellCount;
+            for (size_type i=0u; i<cellCount; i++)
+                freeBlocks[i].block.startOffset = invalid_address;
+            std::fill_n(freeBlockEnds,cellCount,invalid_address);
+            std::fill_n(freeListHeads,findFreeListCount(bufferSize)*SecondLevelCount,invalid_address);
+        }
+
+        //! merges the block with the free blocks directly before and after it
+        inline void             insertFreeBlock(Block block)
+        {
+        #ifdef _NBL_DEBUG
+            // only the end of the buffer can be shorter after shrinking
+            assert(block.getLength()>=minBlockSize || block.endOffset==bufferSize);
+        #endif // _NBL_DEBUG
+            freeSize += block.getLength();
+
+            const size_type preceeding = findFreeBlockEndingAt(block.startOffset);
+            if (preceeding!=invalid_address)
+            {
+                block.startOffset = freeBlocks[preceeding].block.startOffset;
+                unlinkFreeBlock(preceeding);
+            }
+            if (block.endOffset<bufferSize)
+            {
+                const size_type following = block.endOffset/minBlockSize;
+                if (freeBlocks[following].block.startOffset==block.endOffset)
+                {
+                    block.endOffset = freeBlocks[following].block.endOffset;
+                    unlinkFreeBlock(following);
+                }
+            }
+            linkFreeBlock(block);
+        }
+
+        //! trims the start of a free block to satisfy the alignment constraint of the start and also the minimum block size of the preceeding free space that would be created
+        inline bool alignBlockStart(Block& newBlock, const Block& origBlock, const size_type alignment) const
+        {
+            newBlock.startOffset = core::roundUp(origBlock.startOffset,alignment);
+            if (origBlock.startOffset!=newBlock.startOffset)
+            {
+                auto initialPreceedingBlockSize = newBlock.startOffset-origBlock.startOffset;
+                if (initialPreceedingBlockSize<minBlockSize)
+                    newBlock.startOffset += core::roundUp(minBlockSize-initialPreceedingBlockSize,alignment);
+            }
+
+            return newBlock.startOffset<origBlock.endOffset;
+        }
+
+        //! Produced blocks can only be larger than `minBlockSize`, so it's easier to reason about the correctness and memory boundedness of the allocation algorithm
+        inline size_type calcSubAllocation(Block& retval, const Block& block, const size_type bytes, const size_type alignment) const
+        {
+            if (!alignBlockStart(retval,block,alignment))
+                return invalid_address;
+
+            retval.endOffset = retval.startOffset+bytes;
+            if (retval.endOffset>block.endOffset)
+                return invalid_address;
+
+            size_type wastedEndSpace = block.endOffset-retval.endOffset;
+            if (wastedEndSpace!=size_type(0u) && wastedEndSpace<minBlockSize)
+                return invalid_address;
+
+            return wastedEndSpace;
+        }
+
+        inline std::pair<Block,Block>   findAndPopSuitableBlock(const size_type bytes, const size_type alignment) noexcept
+        {
+            // minimum block size in front if we need to align, then minimum block size in the back
+            const size_type maxWastedSpace = (alignment>1u ? (alignment-1u+minBlockSize):0u)+minBlockSize;
+            uint32_t firstLevel,secondLevel;
+            if (bytes<=~size_type(0u)-maxWastedSpace && mapSearchSize(bytes+maxWastedSpace,firstLevel,secondLevel))
+            {
+                const size_type list = findNonEmptyList(firstLevel,secondLevel);
+                if (list!=invalid_address)
+                {
+                    const size_type popped = freeListHeads[list];
+                    const Block sourceBlock = freeBlocks[popped].block;
+                    unlinkFreeBlock(popped);
+
+                    Block allocatedBlock;
+                    const size_type wastedSpace = calcSubAllocation(allocatedBlock,sourceBlock,bytes,alignment);
+                    #ifdef _NBL_DEBUG
+                    assert(wastedSpace!=invalid_address);
+                    #endif // _NBL_DEBUG
+                    freeSize -= sourceBlock.getLength();
+                    return {allocatedBlock,sourceBlock};
+                }
+            }
+            // nothing is sure to fit, first-fit through the lists which can hold blocks large enough for `bytes` without any waste
+            mapSize(bytes,firstLevel,secondLevel);
+            for (size_type list=findNonEmptyList(firstLevel,secondLevel); list!=invalid_address; )
+            {
+                for (size_type i=freeListHeads[list]; i!=invalid_address; i=freeBlocks[i].next)
+                {
+                    const Block sourceBlock = freeBlocks[i].block;
+                    Block allocatedBlock;
+                    if (calcSubAllocation(allocatedBlock,sourceBlock,bytes,alignment)==invalid_address)
+                        continue;
+
+                    unlinkFreeBlock(i);
+                    freeSize -= sourceBlock.getLength();
+                    return {allocatedBlock,sourceBlock};
+                }
+
+                if (++list>=maxListLevels*SecondLevelCount)
+                    break;
+                list = findNonEmptyList(list/SecondLevelCount,list%SecondLevelCount);
+            }
+            return {{invalid_address,invalid_address},{invalid_address,invalid_address}};
+        }
+
+        //! Conservative estimate of the largest block we are sure to be able to allocate with `maxAlignment`
+        inline size_type findMaxAllocatableSize(const size_type maxAlignment) const noexcept
+        {
+            for (uint64_t firstLevelMap=firstLevelBitmap; firstLevelMap; )
+            {
+                const uint32_t firstLevel = findMSB(firstLevelMap);
+                for (uint32_t secondLevelMap=secondLevelBitmaps[firstLevel]; secondLevelMap; )
+                {
+                    const uint32_t secondLevel = findMSB(secondLevelMap);
+                    // only look at the head of the list, the lists are binned finely enough for this to be accurate within 1/SecondLevelCount
+                    const Block& block = freeBlocks[freeListHeads[firstLevel*SecondLevelCount+secondLevel]].block;
+                    Block hypotheticalNewBlock;
+                    if (alignBlockStart(hypotheticalNewBlock,block,maxAlignment))
+                    {
+                        hypotheticalNewBlock.endOffset = block.endOffset;
+                        return hypotheticalNewBlock.getLength();
+                    }
+                    secondLevelMap ^= 0x1u<<secondLevel;
+                }
+                firstLevelMap ^= 0x1ull<<firstLevel;
+            }
+
+            return 0u;
+        }
+
+        //! Free blocks are merged on insertion already, so this only needs to find the free space at the end of the buffer
+        inline size_type coalesceFreeBlocks(void* reservedSpc) noexcept
+        {
+            const size_type last = findFreeBlockEndingAt(bufferSize);
+            if (last!=invalid_address)
+                return freeBlocks[last].block.startOffset;
+            return bufferSize;
+        }
+
+        static inline size_type calcReservedSize(size_type bufSz, size_type minBlockSz) noexcept
+        {
+            const size_type cellCount = getCellCount(bufSz,minBlockSz);
+            return cellCount*size_type(sizeof(FreeBlock)+sizeof(size_type))+findFreeListCount(bufSz)*SecondLevelCount*size_type(sizeof(size_type));
+        }
+
+    private:
+        //! intrusive doubly linked list node, stored at the index of the cell the block starts in
+        struct FreeBlock
+        {
+            Block       block;
+            size_type   prev;
+            size_type   next;
+        };
+        FreeBlock*              freeBlocks;
+        //! index of the `FreeBlock` ending in a cell, can be stale so needs to be validated against the block
+        size_type*              freeBlockEnds;
+        size_type*              freeListHeads;
+
+        static inline size_type getCellCount(size_type bufSz, size_type minBlockSz) noexcept
+        {
+            return bufSz/minBlockSz+1u;
+        }
+
+        //! first level is the power of two range of `byteSize`, second level the linear sub-range within it
+        static inline void      mapSize(size_type byteSize, uint32_t& firstLevel, uint32_t& secondLevel) noexcept
+        {
+            if (byteSize<SecondLevelCount)
+            {
+                firstLevel = 0u;
+                secondLevel = byteSize;
+                return;
+            }
+            const uint32_t msb = findMSB(byteSize);
+            firstLevel = msb-SecondLevelBits+1u;
+            secondLevel = uint32_t(byteSize>>size_type(msb-SecondLevelBits))-SecondLevelCount;
+        }
+        //! rounds up to the next sub-range so every block in the resulting list is at least `byteSize` long
+        static inline bool      mapSearchSize(size_type byteSize, uint32_t& firstLevel, uint32_t& secondLevel) noexcept
+        {
+            if (byteSize>=SecondLevelCount)
+            {
+                const size_type roundUpAmount = (size_type(1u)<<size_type(findMSB(byteSize)-SecondLevelBits))-1u;
+                if (byteSize>~size_type(0u)-roundUpAmount)
+                    return false;
+                byteSize += roundUpAmount;
+            }
+            mapSize(byteSize,firstLevel,secondLevel);
+            return true;
+        }
+
+        //! flat index of the first non-empty list at or after the given class, or `invalid_address`
+        inline size_type        findNonEmptyList(uint32_t firstLevel, const uint32_t secondLevel) const noexcept
+        {
+            uint32_t secondLevelMap = secondLevelBitmaps[firstLevel]&(~0u<<secondLevel);
+            if (!secondLevelMap)
+            {
+                const uint64_t firstLevelMap = firstLevelBitmap&(~0ull<<uint64_t(firstLevel+1u));
+                if (!firstLevelMap)
+                    return invalid_address;
+                firstLevel = findLSB(firstLevelMap);
+                secondLevelMap = secondLevelBitmaps[firstLevel];
+            }
+            return firstLevel*SecondLevelCount+findLSB(secondLevelMap);
+        }
+
+        inline size_type        findFreeBlockEndingAt(const size_type offset) const noexcept
+        {
+            if (!offset)
+                return invalid_address;
+            const size_type candidate = freeBlockEnds[(offset-1u)/minBlockSize];
+            if (candidate==invalid_address || freeBlocks[candidate].block.startOffset==invalid_address || freeBlocks[candidate].block.endOffset!=offset)
+                return invalid_address;
+            return candidate;
+        }
+
+        inline void             linkFreeBlock(const Block& block) noexcept
+        {
+            uint32_t firstLevel,secondLevel;
+            mapSize(block.getLength(),firstLevel,secondLevel);
+            const size_type list = firstLevel*SecondLevelCount+secondLevel;
+
+            const size_type index = block.startOffset/minBlockSize;
+            FreeBlock& node = freeBlocks[index];
+            node.block = block;
+            node.prev = invalid_address;
+            node.next = freeListHeads[list];
+            if (node.next!=invalid_address)
+                freeBlocks[node.next].prev = index;
+            freeListHeads[list] = index;
+            freeBlockEnds[(block.endOffset-1u)/minBlockSize] = index;
+
+            secondLevelBitmaps[firstLevel] |= 0x1u<<secondLevel;
+            firstLevelBitmap |= 0x1ull<<uint64_t(firstLevel);
+        }
+        inline void             unlinkFreeBlock(const size_type index) noexcept
+        {
+            FreeBlock& node = freeBlocks[index];
+            if (node.next!=invalid_address)
+                freeBlocks[node.next].prev = node.prev;
+            if (node.prev!=invalid_address)
+                freeBlocks[node.prev].next = node.next;
+            else
+            {
+                uint32_t firstLevel,secondLevel;
+                mapSize(node.block.getLength(),firstLevel,secondLevel);
+                freeListHeads[firstLevel*SecondLevelCount+secondLevel] = node.next;
+                if (node.next==invalid_address)
+                {
+                    secondLevelBitmaps[firstLevel] &= ~(0x1u<<secondLevel);
+                    if (!secondLevelBitmaps[firstLevel])
+                        firstLevelBitmap &= ~(0x1ull<<uint64_t(firstLevel));
+                }
+            }
+            node.block.startOffset = invalid_address;
+        }
+
+        //!
+        void copyState(const GeneralpurposeAddressAllocatorTLSFStrategy& other, void* newReservedSpc)
+        {
+            swapFreeLists(newReservedSpc);
+            // copy the free blocks across, trimming them to the new size
+            for (size_type list=0u; list<findFreeListCount(other.bufferSize)*SecondLevelCount; list++)
+            for (size_type i=other.freeListHeads[list]; i!=invalid_address; i=other.freeBlocks[i].next)
+            {
+                Block block = other.freeBlocks[i].block;
+                if (block.startOffset>=bufferSize)
+                    continue;
+                block.endOffset = std::min(block.endOffset,bufferSize);
+                insertFreeBlock(block);
+            }
+            // then add the new space at the end, it will merge with the old free tail
+            if (bufferSize>other.bufferSize)
+                insertFreeBlock({other.bufferSize,bufferSize});
+        }
+};
+
 }
 
 //! General-purpose allocator, really its like a buddy allocator that supports more sophisticated coalescing
+/** `AllocStrategy` decides how free blocks are found, use `impl::GeneralpurposeAddressAllocatorTLSFStrategy` when there are many live blocks
+as it allocates and frees in constant time and never needs to `defragment`.*/
 template<typename _size_type, class AllocStrategy = impl::GeneralpurposeAddressAllocatorStrategy<_size_type,false> >
-class GeneralpurposeAddressAllocator : public AddressAllocatorBase<GeneralpurposeAddressAllocator<_size_type>,_size_type>, protected AllocStrategy
+class GeneralpurposeAddressAllocator : public AddressAllocatorBase<GeneralpurposeAddressAllocator<_size_type,AllocStrategy>,_size_type>, protected AllocStrategy
 {
     private:
-        typedef AddressAllocatorBase<GeneralpurposeAddressAllocator<_size_type>,_size_type> Base;
+        typedef AddressAllocatorBase<GeneralpurposeAddressAllocator<_size_type,AllocStrategy>,_size_type> Base;
         typedef typename AllocStrategy::Block                                               Block;
     public:
         _NBL_DECLARE_ADDRESS_ALLOCATOR_TYPEDEFS(_size_type);
@@ -550,25 +1041,7 @@ class GeneralpurposeAddressAllocator : public AddressAllocatorBase<Generalpurpos
         //! Conservative estimate, max_size() gives largest size we are sure to be able to allocate
         inline size_type        max_size() const noexcept
         {
-            for (decltype(AllocStrategy::freeListCount) i=AllocStrategy::freeListCount; i>0u; i--)
-            {
-                size_type level = i-1u;
-                auto blockCount = AllocStrategy::freeListStackCtr[level];
-                if (!blockCount)
-                    continue;
-
-                // get first block in the size's free-list, not accurate since there might be bigger blocks further in the list.
-                // however because the free-lists are binned by size, this is accurate within a factor of 1.99999999x
-                const auto& block = AllocStrategy::freeListStack[level][blockCount-1];
-                // fail to get anything useful out of the block due to alignment constraints
-                Block hypotheticalNewBlock;
-                if (!AllocStrategy::alignBlockStart(hypotheticalNewBlock,block,Base::maxRequestableAlignment))
-                    continue;
-                hypotheticalNewBlock.endOffset = block.endOffset;
-                return hypotheticalNewBlock.getLength();
-            }
-
-            return 0u;
+            return AllocStrategy::findMaxAllocatableSize(Base::maxRequestableAlignment);
         }
 
         //! Most allocators do not support e.g. 1-byte allocations
@@ -607,12 +1080,9 @@ class GeneralpurposeAddressAllocator : public AddressAllocatorBase<Generalpurpos
 
         static inline size_type reserved_size(size_type maxAlignment, size_type bufSz, size_type minBlockSize) noexcept
         {
-            size_type reserved = 0u;
-            for (size_type i=0u; i<AllocStrategy::findFreeListCount(bufSz,minBlockSize); i++)
-                reserved += (bufSz/(minBlockSize<<i)+1u)*size_type(2u);
-            return (reserved-2u)*sizeof(Block);
+            return AllocStrategy::calcReservedSize(bufSz,minBlockSize);
         }
-        static inline size_type reserved_size(size_type bufSz, const GeneralpurposeAddressAllocator<_size_type>& other) noexcept
+        static inline size_type reserved_size(size_type bufSz, const GeneralpurposeAddressAllocator& other) noexcept
         {
             return reserved_size(other.maxRequestableAlignment,bufSz,other.minBlockSize);
         }
@@ -638,53 +1108,7 @@ class GeneralpurposeAddressAllocator : public AddressAllocatorBase<Generalpurpos
     protected:
         inline size_type        defragment() noexcept
         {
-            // TODO: radix sort the whole thing on the block-start value and do a coalesce without `AllocStrategy::findMinimum`
-            // also add the blocks in reverse order
-            Block* freeListOld[AllocStrategy::maxListLevels];
-            const Block* freeListOldEnd[AllocStrategy::maxListLevels];
-            for (decltype(AllocStrategy::freeListCount) i=0u; i<AllocStrategy::freeListCount; i++)
-            {
-                freeListOld[i] = AllocStrategy::freeListStack[i];
-                freeListOldEnd[i] = freeListOld[i]+AllocStrategy::freeListStackCtr[i];
-                std::sort(freeListOld[i],const_cast<Block*>(freeListOldEnd[i]));
-            }
-
-            AllocStrategy::swapFreeLists(Base::reservedSpace);
-
-            // begin the coalesce
-            Block lastBlock{0u,0u};
-            auto minimum = AllocStrategy::findMinimum(freeListOld,freeListOldEnd);
-            while (minimum!=AllocStrategy::freeListCount)
-            {
-                // find next free block and pop it
-                const Block* nextBlock = freeListOld[minimum]++;
-
-                // check if broke continuity
-                if (nextBlock->startOffset!=lastBlock.endOffset)
-                {
-                    // put old on correct free list
-                    if (lastBlock.getLength())
-                        AllocStrategy::insertFreeBlock(lastBlock);
-
-                    lastBlock.startOffset = nextBlock->startOffset;
-                }
-
-                lastBlock.endOffset = nextBlock->endOffset;
-                minimum = AllocStrategy::findMinimum(freeListOld,freeListOldEnd);
-            }
-            #ifdef _NBL_DEBUG
-            for (decltype(AllocStrategy::freeListCount) i=0u; i<AllocStrategy::freeListCount; i++)
-                assert(freeListOld[i]==freeListOldEnd[i]);
-            #endif // _NBL_DEBUG
-            // put last block on correct free list
-            if (lastBlock.getLength())
-            {
-                AllocStrategy::insertFreeBlock(lastBlock);
-                if (lastBlock.endOffset==AllocStrategy::bufferSize)
-                    return lastBlock.startOffset;
-            }
-
-            return AllocStrategy::bufferSize;
+            return AllocStrategy::coalesceFreeBlocks(Base::reservedSpace);
         }
 };
 
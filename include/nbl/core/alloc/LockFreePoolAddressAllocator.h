@@ -0,0 +1,453 @@
+// Copyright (C) 2018-2023 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#ifndef __NBL_CORE_LOCK_FREE_POOL_ADDRESS_ALLOCATOR_H_INCLUDED__
+#define __NBL_CORE_LOCK_FREE_POOL_ADDRESS_ALLOCATOR_H_INCLUDED__
+
+#include "BuildConfigOptions.h"
+
+#include <atomic>
+#include <thread>
+
+#include "nbl/core/alloc/AddressAllocatorBase.h"
+
+namespace nbl
+{
+namespace core
+{
+
+
+//! Same contract as `PoolAddressAllocator`, but `alloc_addr`, `free_addr`, `multi_alloc_addr` and `multi_free_addr` can be called from many threads at once
+/**
+The free blocks form a Treiber stack linked through the reserved space, the head carries a tag bumped on every push and pop
+so a block getting popped and pushed back between our load and compare-exchange (ABA) can't corrupt the list.
+In front of it sit `MagazineCount` small caches picked by hashing the thread id, a thread takes its magazine with a single exchange
+and goes straight to the stack if another thread has it, so nobody ever waits and the shared head is only touched once per batch.
+Everything else (resizing, `reset`, `safe_shrink_size`) still needs exclusive access like with any other address allocator,
+and the free size is only exact when nobody is allocating or freeing.
+*/
+template<typename _size_type>
+class LockFreePoolAddressAllocator : public AddressAllocatorBase<LockFreePoolAddressAllocator<_size_type>,_size_type>
+{
+        static_assert(sizeof(_size_type)<=sizeof(uint32_t),"The block index and the ABA tag need to fit in a lock-free 64bit word");
+
+    private:
+        typedef AddressAllocatorBase<LockFreePoolAddressAllocator<_size_type>,_size_type> Base;
+
+    public:
+        _NBL_DECLARE_ADDRESS_ALLOCATOR_TYPEDEFS(_size_type);
+
+        static constexpr bool supportsNullBuffer = true;
+        static constexpr uint32_t maxMultiOps = 256u;
+
+        //! magazines are shared by all threads which hash to the same one
+        static constexpr uint32_t MagazineCount = 16u;
+        static constexpr uint32_t MagazineCapacity = 32u;
+
+        LockFreePoolAddressAllocator() : blockCount(0u), blockSize(1u), head(packHead(0u,invalid_address)), stackSize(0u), magazines(nullptr), nextLinks(nullptr) {}
+
+        virtual ~LockFreePoolAddressAllocator() {}
+
+        LockFreePoolAddressAllocator(void* reservedSpc, _size_type addressOffsetToApply, _size_type alignOffsetNeeded, _size_type maxAllocatableAlignment, size_type bufSz, size_type blockSz) noexcept :
+                    Base(reservedSpc,addressOffsetToApply,alignOffsetNeeded,maxAllocatableAlignment),
+                        blockCount((bufSz-alignOffsetNeeded)/blockSz), blockSize(blockSz), head(packHead(0u,invalid_address)), stackSize(0u), magazines(nullptr), nextLinks(nullptr)
+        {
+            reset();
+        }
+
+        //! When resizing we require that the copying of data buffer has already been handled by the user of the address allocator
+        template<typename... Args>
+        LockFreePoolAddressAllocator(_size_type newBuffSz, LockFreePoolAddressAllocator&& other, Args&&... args) noexcept :
+                    Base(std::move(other),std::forward<Args>(args)...),
+                        blockCount((newBuffSz-Base::alignOffset)/other.blockSize), blockSize(other.blockSize), head(packHead(0u,invalid_address)), stackSize(0u), magazines(nullptr), nextLinks(nullptr)
+        {
+            copyState(other,newBuffSz);
+
+            other.blockCount = invalid_address;
+            other.blockSize = invalid_address;
+            other.head.store(packHead(0u,invalid_address));
+            other.stackSize.store(0u);
+            other.magazines = nullptr;
+            other.nextLinks = nullptr;
+        }
+        template<typename... Args>
+        LockFreePoolAddressAllocator(_size_type newBuffSz, const LockFreePoolAddressAllocator& other, Args&&... args) noexcept :
+                    Base(other,std::forward<Args>(args)...),
+                        blockCount((newBuffSz-Base::alignOffset)/other.blockSize), blockSize(other.blockSize), head(packHead(0u,invalid_address)), stackSize(0u), magazines(nullptr), nextLinks(nullptr)
+        {
+            copyState(other,newBuffSz);
+        }
+
+        LockFreePoolAddressAllocator& operator=(LockFreePoolAddressAllocator&& other)
+        {
+            Base::operator=(std::move(other));
+            std::swap(blockCount,other.blockCount);
+            std::swap(blockSize,other.blockSize);
+            head.store(other.head.exchange(head.load()));
+            stackSize.store(other.stackSize.exchange(stackSize.load()));
+            std::swap(magazines,other.magazines);
+            std::swap(nextLinks,other.nextLinks);
+            return *this;
+        }
+
+
+        inline size_type        alloc_addr(size_type bytes, size_type alignment, size_type hint=0ull) noexcept
+        {
+            if ((blockSize%alignment)!=0u || bytes==0u || bytes>blockSize)
+                return invalid_address;
+
+            size_type block;
+            if (!allocBlocks(1u,&block))
+                return invalid_address;
+            return block*blockSize+Base::combinedOffset;
+        }
+
+        inline void             free_addr(size_type addr, size_type bytes) noexcept
+        {
+            #ifdef _NBL_DEBUG
+                assert(addr>=Base::combinedOffset && (addr-Base::combinedOffset)%blockSize==0);
+            #endif // _NBL_DEBUG
+            const size_type block = addressToBlockID(addr);
+            freeBlocks(1u,&block);
+        }
+
+        //! Only fills the `outAddresses` which are `invalid_address` to begin with, like the `address_allocator_traits` fallback
+        inline void             multi_alloc_addr(uint32_t count, size_type* outAddresses, const size_type* bytes, const size_type* alignment, const size_type* hint=nullptr) noexcept
+        {
+            size_type blocks[maxMultiOps];
+            uint32_t requests[maxMultiOps];
+            for (uint32_t base=0u; base<count; base+=maxMultiOps)
+            {
+                const uint32_t batchEnd = std::min(base+maxMultiOps,count);
+                uint32_t requestCount = 0u;
+                for (uint32_t i=base; i<batchEnd; i++)
+                {
+                    if (outAddresses[i]!=invalid_address || (blockSize%alignment[i])!=0u || bytes[i]==0u || bytes[i]>blockSize)
+                        continue;
+                    requests[requestCount++] = i;
+                }
+
+                const uint32_t allocated = allocBlocks(requestCount,blocks);
+                for (uint32_t i=0u; i<allocated; i++)
+                    outAddresses[requests[i]] = blocks[i]*blockSize+Base::combinedOffset;
+            }
+        }
+
+        inline void             multi_free_addr(uint32_t count, const size_type* addr, const size_type* bytes) noexcept
+        {
+            size_type blocks[maxMultiOps];
+            for (uint32_t base=0u; base<count; base+=maxMultiOps)
+            {
+                const uint32_t batchEnd = std::min(base+maxMultiOps,count);
+                uint32_t blockCountToFree = 0u;
+                for (uint32_t i=base; i<batchEnd; i++)
+                {
+                    if (addr[i]==invalid_address)
+                        continue;
+                    #ifdef _NBL_DEBUG
+                        assert(addr[i]>=Base::combinedOffset && (addr[i]-Base::combinedOffset)%blockSize==0);
+                    #endif // _NBL_DEBUG
+                    blocks[blockCountToFree++] = addressToBlockID(addr[i]);
+                }
+                freeBlocks(blockCountToFree,blocks);
+            }
+        }
+
+        //! not thread-safe
+        inline void             reset()
+        {
+            layoutReservedSpace();
+            for (uint32_t i=0u; i<MagazineCount; i++)
+                new (getMagazines()+i) Magazine();
+
+            auto* next = getNextLinks();
+            for (size_type i=0u; i<blockCount; i++)
+                new (next+i) std::atomic<size_type>(i+1u<blockCount ? (i+1u):invalid_address);
+            head.store(packHead(0u,blockCount ? 0u:invalid_address));
+            stackSize.store(blockCount);
+        }
+
+        //! conservative estimate, does not account for space lost to alignment
+        inline size_type        max_size() const noexcept
+        {
+            return blockSize;
+        }
+
+        //! Most allocators do not support e.g. 1-byte allocations
+        inline size_type        min_size() const noexcept
+        {
+            return blockSize;
+        }
+
+        //! not thread-safe
+        inline size_type        safe_shrink_size(size_type sizeBound, size_type newBuffAlignmentWeCanGuarantee=1u) noexcept
+        {
+            const size_type capacity = get_total_size()-Base::alignOffset;
+            if (sizeBound<capacity)
+            {
+                size_type* const freeList = getScratch();
+                size_type freeCount = 0u;
+                forEachFreeBlock([&](const size_type block){freeList[freeCount++]=block;});
+                if (freeCount)
+                {
+                    // only the free blocks at the very end of the buffer can be trimmed
+                    std::sort(freeList,freeList+freeCount);
+                    size_type trailingFree = 0u;
+                    for (size_type endBlock=blockCount; trailingFree<freeCount; trailingFree++)
+                    {
+                        if (freeList[freeCount-1u-trailingFree]!=--endBlock)
+                            break;
+                    }
+                    sizeBound = std::max(sizeBound,(blockCount-trailingFree)*blockSize);
+                }
+                else
+                    sizeBound = capacity;
+            }
+            return Base::safe_shrink_size(sizeBound,newBuffAlignmentWeCanGuarantee);
+        }
+
+
+        static inline size_type reserved_size(size_type maxAlignment, size_type bufSz, size_type blockSz) noexcept
+        {
+            size_type maxBlockCount = bufSz/blockSz;
+            return sizeof(Magazine)*MagazineCount+maxBlockCount*size_type(sizeof(std::atomic<size_type>)+sizeof(size_type));
+        }
+        static inline size_type reserved_size(const LockFreePoolAddressAllocator<_size_type>& other, size_type bufSz) noexcept
+        {
+            return reserved_size(other.maxRequestableAlignment,bufSz,other.blockSize);
+        }
+
+        //! approximate while other threads are allocating or freeing
+        inline size_type        get_free_size() const noexcept
+        {
+            if (!magazines)
+                return 0u;
+            size_type freeCount = stackSize.load(std::memory_order_relaxed);
+            for (uint32_t i=0u; i<MagazineCount; i++)
+                freeCount += getMagazines()[i].count.load(std::memory_order_relaxed);
+            return freeCount*blockSize;
+        }
+        inline size_type        get_allocated_size() const noexcept
+        {
+            return blockCount*blockSize-get_free_size();
+        }
+        inline size_type        get_total_size() const noexcept
+        {
+            return blockCount*blockSize+Base::alignOffset;
+        }
+
+
+
+        inline size_type addressToBlockID(size_type addr) const noexcept
+        {
+            return (addr-Base::combinedOffset)/blockSize;
+        }
+    protected:
+        struct Magazine
+        {
+            std::atomic<uint32_t>   busy{0u};
+            //! only written by the thread holding `busy`, atomic so `get_free_size` can peek
+            std::atomic<uint32_t>   count{0u};
+            size_type               blocks[MagazineCapacity];
+        };
+
+        size_type   blockCount;
+        size_type   blockSize;
+        //! tag in the high 32 bits, index of the top free block in the low
+        std::atomic_uint64_t    head;
+        //! blocks on the shared stack, the magazines hold the rest of the free blocks
+        std::atomic<size_type>  stackSize;
+
+        // pointers into the reserved space, kept because moving the base swaps `reservedSpace` away before a resize gets to copy the state
+        Magazine*               magazines;
+        std::atomic<size_type>* nextLinks;
+
+        // reserved space is laid out as the magazines, then the next-links of the free stack, then scratch for `safe_shrink_size` and resizing
+        inline void layoutReservedSpace()
+        {
+            magazines = reinterpret_cast<Magazine*>(Base::reservedSpace);
+            nextLinks = reinterpret_cast<std::atomic<size_type>*>(magazines+MagazineCount);
+        }
+        inline Magazine* getMagazines() {return magazines;}
+        inline const Magazine* getMagazines() const {return magazines;}
+        inline std::atomic<size_type>* getNextLinks() {return nextLinks;}
+        inline const std::atomic<size_type>* getNextLinks() const {return nextLinks;}
+        inline size_type* getScratch() {return reinterpret_cast<size_type*>(nextLinks+blockCount);}
+
+        static inline uint64_t packHead(uint64_t tag, size_type block) {return (tag<<32ull)|uint64_t(block);}
+        static inline size_type headBlock(uint64_t packed) {return size_type(packed);}
+        static inline uint64_t headTag(uint64_t packed) {return packed>>32ull;}
+
+        static inline uint32_t getMagazineIndex()
+        {
+            thread_local const uint32_t index = uint32_t(std::hash<std::thread::id>()(std::this_thread::get_id())%MagazineCount);
+            return index;
+        }
+        //! never waits, returns nullptr if another thread holds it
+        inline Magazine* tryAcquireMagazine(const uint32_t index)
+        {
+            Magazine* magazine = getMagazines()+index;
+            if (magazine->busy.load(std::memory_order_relaxed) || magazine->busy.exchange(1u,std::memory_order_acquire))
+                return nullptr;
+            return magazine;
+        }
+        static inline void releaseMagazine(Magazine* magazine)
+        {
+            magazine->busy.store(0u,std::memory_order_release);
+        }
+
+        //! pops up to `count` blocks off the shared stack with one compare-exchange
+        inline uint32_t popChain(const uint32_t count, size_type* outBlocks)
+        {
+            const auto* next = getNextLinks();
+            uint64_t oldHead = head.load(std::memory_order_acquire);
+            uint32_t popped;
+            uint64_t newHead;
+            do
+            {
+                // the links we walk may be getting rewritten by their new owners, but then the tag will have moved and the exchange fails
+                size_type block = headBlock(oldHead);
+                for (popped=0u; popped<count && block!=invalid_address; popped++)
+                {
+                    outBlocks[popped] = block;
+                    block = next[block].load(std::memory_order_relaxed);
+                }
+                if (!popped)
+                    return 0u;
+                newHead = packHead(headTag(oldHead)+1ull,block);
+            } while (!head.compare_exchange_weak(oldHead,newHead,std::memory_order_acq_rel,std::memory_order_acquire));
+            stackSize.fetch_sub(popped,std::memory_order_relaxed);
+            return popped;
+        }
+        //! pushes the blocks as one chain with one compare-exchange
+        inline void pushChain(const uint32_t count, const size_type* blocks)
+        {
+            if (!count)
+                return;
+            auto* next = getNextLinks();
+            for (uint32_t i=1u; i<count; i++)
+                next[blocks[i-1u]].store(blocks[i],std::memory_order_relaxed);
+
+            // count them before they can be popped so `stackSize` never underflows
+            stackSize.fetch_add(count,std::memory_order_relaxed);
+            uint64_t oldHead = head.load(std::memory_order_relaxed);
+            do
+            {
+                next[blocks[count-1u]].store(headBlock(oldHead),std::memory_order_relaxed);
+            } while (!head.compare_exchange_weak(oldHead,packHead(headTag(oldHead)+1ull,blocks[0]),std::memory_order_release,std::memory_order_relaxed));
+        }
+
+        //! returns how many of the `count` blocks it managed to allocate
+        inline uint32_t allocBlocks(const uint32_t count, size_type* outBlocks)
+        {
+            uint32_t allocated = 0u;
+            const uint32_t ownIndex = getMagazineIndex();
+            if (Magazine* magazine=tryAcquireMagazine(ownIndex))
+            {
+                uint32_t magazineCount = magazine->count.load(std::memory_order_relaxed);
+                while (allocated<count)
+                {
+                    // refill half a magazine at a time so that a following free has room too
+                    if (!magazineCount && !(magazineCount=popChain(MagazineCapacity/2u,magazine->blocks)))
+                        break;
+                    const uint32_t taken = std::min(magazineCount,count-allocated);
+                    for (uint32_t i=0u; i<taken; i++)
+                        outBlocks[allocated++] = magazine->blocks[--magazineCount];
+                }
+                magazine->count.store(magazineCount,std::memory_order_relaxed);
+                releaseMagazine(magazine);
+            }
+            else
+                allocated += popChain(count,outBlocks);
+            // the stack ran dry, but other threads might still be sitting on free blocks
+            for (uint32_t i=1u; allocated<count && i<MagazineCount; i++)
+            {
+                Magazine* magazine = tryAcquireMagazine((ownIndex+i)%MagazineCount);
+                if (!magazine)
+                    continue;
+                uint32_t magazineCount = magazine->count.load(std::memory_order_relaxed);
+                while (allocated<count && magazineCount)
+                    outBlocks[allocated++] = magazine->blocks[--magazineCount];
+                magazine->count.store(magazineCount,std::memory_order_relaxed);
+                releaseMagazine(magazine);
+            }
+            return allocated;
+        }
+        inline void freeBlocks(const uint32_t count, const size_type* blocks)
+        {
+            if (Magazine* magazine=tryAcquireMagazine(getMagazineIndex()))
+            {
+                uint32_t magazineCount = magazine->count.load(std::memory_order_relaxed);
+                for (uint32_t i=0u; i<count; i++)
+                {
+                    // spill the older half back to the stack
+                    if (magazineCount==MagazineCapacity)
+                    {
+                        constexpr uint32_t spilled = MagazineCapacity/2u;
+                        pushChain(spilled,magazine->blocks);
+                        std::copy_n(magazine->blocks+spilled,MagazineCapacity-spilled,magazine->blocks);
+                        magazineCount -= spilled;
+                    }
+                    magazine->blocks[magazineCount++] = blocks[i];
+                }
+                magazine->count.store(magazineCount,std::memory_order_relaxed);
+                releaseMagazine(magazine);
+            }
+            else
+                pushChain(count,blocks);
+        }
+
+        //! not thread-safe
+        template<class F>
+        inline void forEachFreeBlock(F&& f) const
+        {
+            const auto* next = getNextLinks();
+            for (size_type block=headBlock(head.load()); block!=invalid_address; block=next[block].load(std::memory_order_relaxed))
+                f(block);
+            for (uint32_t i=0u; i<MagazineCount; i++)
+            {
+                const Magazine& magazine = getMagazines()[i];
+                std::for_each_n(magazine.blocks,magazine.count.load(std::memory_order_relaxed),f);
+            }
+        }
+
+        void copyState(const LockFreePoolAddressAllocator& other, _size_type newBuffSz)
+        {
+            #ifdef _NBL_DEBUG
+                assert(Base::checkResize(newBuffSz,Base::alignOffset));
+            #endif // _NBL_DEBUG
+            layoutReservedSpace();
+            for (uint32_t i=0u; i<MagazineCount; i++)
+                new (getMagazines()+i) Magazine();
+            auto* next = getNextLinks();
+            for (size_type i=0u; i<blockCount; i++)
+                new (next+i) std::atomic<size_type>(invalid_address);
+
+            size_type* freeList = getScratch();
+            size_type freeCount = 0u;
+            other.forEachFreeBlock([&](const size_type block)
+            {
+                // check in case of shrink
+                if (block<blockCount)
+                    freeList[freeCount++] = block;
+            });
+            for (size_type block=other.blockCount; block<blockCount; block++)
+                freeList[freeCount++] = block;
+
+            for (size_type i=1u; i<freeCount; i++)
+                next[freeList[i-1u]].store(freeList[i]);
+            head.store(packHead(0u,freeCount ? freeList[0]:invalid_address));
+            stackSize.store(freeCount);
+        }
+};
+
+
+// aliases
+template<typename size_type>
+using PoolAddressAllocatorLockFree = LockFreePoolAddressAllocator<size_type>;
+
+}
+}
+
+#endif
@@ -109,11 +109,8 @@ class FixedCapacityDoublyLinkedList : private impl::FixedCapacityDoublyLinkedLis
 			if (m_back == invalid_iterator)
 				return;
 
-			auto backNode = getBack();
-			if (backNode->prev != invalid_iterator)
-				get(backNode->prev)->next = invalid_iterator;
 			uint32_t temp = m_back;
-			m_back = backNode->prev;
+			common_detach(getBack());
 			common_delete(temp);
 		}
 
@@ -173,15 +170,13 @@ class FixedCapacityDoublyLinkedList : private impl::FixedCapacityDoublyLinkedLis
 		}
 		~FixedCapacityDoublyLinkedList()
 		{
-			if (m_dispose_f && m_begin != invalid_iterator)
+			for (uint32_t addr=m_begin; addr!=invalid_iterator; )
 			{
-				auto* begin = getBegin();
-				auto* back = getBack();
-				do 
-				{
-					m_dispose_f(begin->data);
-					begin = get(begin->next);
-				} while (begin != back);
+				node_t* node = get(addr);
+				addr = node->next;
+				if (m_dispose_f)
+					m_dispose_f(node->data);
+				node->~node_t();
 			}
 			_NBL_ALIGNED_FREE(m_reservedSpace);
 		}
@@ -232,8 +227,12 @@ class FixedCapacityDoublyLinkedList : private impl::FixedCapacityDoublyLinkedLis
 		{
 			if (node->next != invalid_iterator)
 				get(node->next)->prev = node->prev;
+			else
+				m_back = node->prev;
 			if (node->prev != invalid_iterator)
 				get(node->prev)->next = node->next;
+			else
+				m_begin = node->next;
 		}
 };
 
@@ -7,6 +7,9 @@
 
 #include "nbl/core/containers/FixedCapacityDoublyLinkedList.h"
 #include <iostream>
+#include <optional>
+#include <mutex>
+#include <atomic>
 #include "nbl/system/ILogger.h"
 
 namespace nbl
@@ -210,6 +213,175 @@ class LRUCache : private impl::LRUCacheBase<Key,Value,MapHash,MapEquals>
 				m_shortcut_map.erase(iterator);
 			}
 		}
+
+		//remove the least recently used element if there is any, returns false if the cache was empty
+		inline bool evictLeastRecentlyUsed()
+		{
+			if (m_shortcut_map.empty())
+				return false;
+			m_shortcut_map.erase(base_t::m_list.getLastAddress());
+			base_t::m_list.popBack();
+			return true;
+		}
+
+		inline uint32_t getSize() const { return m_shortcut_map.size(); }
+		inline uint32_t getCapacity() const { return base_t::m_list.getCapacity(); }
+};
+
+// Thread-safe Key-Value LRU cache, keys get hashed to one of `shardCount` independent `LRUCache`s each behind its own lock
+// Every shard holds at most `capacity/shardCount` entries and `weightBudget/shardCount` of weight as measured by the weigher,
+// inserting evicts the shard's least recently used entries until both limits are met. The disposal function is called on
+// evicted, erased and destroyed entries like with `LRUCache` and also on replaced ones, always under the shard's lock so it must not touch the cache.
+// Lookups hand out copies of the values since another thread may evict the entry right after, so `Value` should be cheap to copy.
+template<typename Key, typename Value, typename MapHash=std::hash<Key>, typename MapEquals=std::equal_to<Key> >
+class ConcurrentLRUCache
+{
+		using shard_cache_t = LRUCache<Key,Value,MapHash,MapEquals>;
+
+	public:
+		using disposal_func_t = typename shard_cache_t::disposal_func_t;
+		using assoc_t = typename shard_cache_t::assoc_t;
+		//! needs to return the same weight for the same entry every time
+		using weigher_func_t = std::function<size_t(const Key&,const Value&)>;
+
+		struct SStatistics
+		{
+			uint64_t hits = 0ull;
+			uint64_t misses = 0ull;
+			uint64_t evictions = 0ull;
+			size_t weight = 0ull;
+			uint32_t size = 0u;
+		};
+
+		//Constructor, a default weigher gives each entry a weight of 1
+		inline ConcurrentLRUCache(const uint32_t capacity, const size_t weightBudget, weigher_func_t&& _weigher=weigher_func_t(), disposal_func_t&& _df=disposal_func_t(), const uint32_t shardCount=16u, const MapHash& _hash=MapHash(), const MapEquals& _equals=MapEquals()) :
+			m_weigher(_weigher ? std::move(_weigher):weigher_func_t([](const Key&, const Value&) -> size_t {return 1ull;})), m_df(std::move(_df)), m_hash(_hash)
+		{
+			assert(shardCount);
+			m_shards.reserve(shardCount);
+			const uint32_t shardCapacity = std::max((capacity+shardCount-1u)/shardCount,2u);
+			const size_t shardBudget = (weightBudget+shardCount-1u)/shardCount;
+			for (uint32_t i=0u; i<shardCount; i++)
+				m_shards.push_back(std::make_unique<Shard>(this,shardCapacity,shardBudget,MapHash(_hash),MapEquals(_equals)));
+		}
+
+		//insert an element into the cache, or update an existing one with the same key
+		//entries heavier than a whole shard's budget are not cached at all
+		template<typename K, typename V>
+		inline void insert(K&& k, V&& v)
+		{
+			Shard& shard = getShard(k);
+			const size_t weight = m_weigher(k,v);
+			std::unique_lock lock(shard.mutex);
+			// drop the old entry first so its weight can't get subtracted twice
+			shard.erase(k);
+			if (weight>shard.budget)
+				return;
+			// make room for the new weight first, so the entry we're inserting can't be the one evicted
+			while (shard.weight+weight>shard.budget && shard.cache.evictLeastRecentlyUsed()) {}
+			shard.weight += weight;
+			shard.cache.insert(std::forward<K>(k),std::forward<V>(v));
+		}
+
+		//get a copy of the value at an associated Key, or nothing if Key is not contained within cache. Marks the value as most recently used
+		inline std::optional<Value> get(const Key& key)
+		{
+			Shard& shard = getShard(key);
+			std::unique_lock lock(shard.mutex);
+			return shard.countLookup(shard.cache.get(key));
+		}
+
+		//same as `get` but does not alter the value use order
+		inline std::optional<Value> peek(const Key& key)
+		{
+			Shard& shard = getShard(key);
+			// `LRUCache` lookups write to the cache, so even a peek needs the exclusive lock
+			std::unique_lock lock(shard.mutex);
+			return shard.countLookup(shard.cache.peek(key));
+		}
+
+		//remove element at key if present
+		inline void erase(const Key& key)
+		{
+			Shard& shard = getShard(key);
+			std::unique_lock lock(shard.mutex);
+			shard.erase(key);
+		}
+
+		//counters are summed over the shards one at a time, so they're only a snapshot while other threads use the cache
+		inline SStatistics getStatistics() const
+		{
+			SStatistics retval = {};
+			for (const auto& shard : m_shards)
+			{
+				retval.hits += shard->hits.load(std::memory_order_relaxed);
+				retval.misses += shard->misses.load(std::memory_order_relaxed);
+				retval.evictions += shard->evictions.load(std::memory_order_relaxed);
+				std::unique_lock lock(shard->mutex);
+				retval.weight += shard->weight;
+				retval.size += shard->cache.getSize();
+			}
+			return retval;
+		}
+
+	private:
+		struct Shard
+		{
+			Shard(ConcurrentLRUCache* owner, const uint32_t capacity, const size_t _budget, MapHash&& _hash, MapEquals&& _equals) : budget(_budget),
+				cache(capacity,disposal_func_t([this,owner](assoc_t& entry) -> void
+				{
+					weight -= owner->m_weigher(entry.first,entry.second);
+					if (!erasing)
+						evictions.fetch_add(1ull,std::memory_order_relaxed);
+					if (owner->m_df)
+						owner->m_df(entry);
+				}),std::move(_hash),std::move(_equals)) {}
+			~Shard()
+			{
+				// entries disposed of by the destructor weren't evicted
+				erasing = true;
+			}
+
+			inline std::optional<Value> countLookup(const Value* found)
+			{
+				if (!found)
+				{
+					misses.fetch_add(1ull,std::memory_order_relaxed);
+					return std::nullopt;
+				}
+				hits.fetch_add(1ull,std::memory_order_relaxed);
+				return *found;
+			}
+			inline void erase(const Key& key)
+			{
+				erasing = true;
+				cache.erase(key);
+				erasing = false;
+			}
+
+			mutable std::mutex mutex;
+			size_t weight = 0ull;
+			const size_t budget;
+			// distinguishes explicit erasure from eviction in the disposal callback
+			bool erasing = false;
+			std::atomic_uint64_t hits{0ull};
+			std::atomic_uint64_t misses{0ull};
+			std::atomic_uint64_t evictions{0ull};
+			// last so it gets destroyed while the counters the disposal callback updates are still alive
+			shard_cache_t cache;
+		};
+
+		inline Shard& getShard(const Key& key)
+		{
+			// high bits as the low ones may also pick the bucket inside the shard's map
+			const uint64_t hash = m_hash(key)*0x9E3779B97F4A7C15ull;
+			return *m_shards[(hash>>32ull)%m_shards.size()];
+		}
+
+		weigher_func_t m_weigher;
+		disposal_func_t m_df;
+		MapHash m_hash;
+		core::vector<std::unique_ptr<Shard>> m_shards;
 };
 
 
@@ -31,6 +31,7 @@
 #include "nbl/core/alloc/LinearAddressAllocator.h"
 #include "nbl/core/alloc/null_allocator.h"
 #include "nbl/core/alloc/PoolAddressAllocator.h"
+#include "nbl/core/alloc/LockFreePoolAddressAllocator.h"
 #include "nbl/core/alloc/IteratablePoolAddressAllocator.h"
 #include "nbl/core/alloc/StackAddressAllocator.h"
 #include "nbl/core/alloc/SimpleBlockBasedAllocator.h"
@@ -58,6 +59,7 @@
 // parallel
 #include "nbl/core/parallel/IThreadBound.h"
 #include "nbl/core/parallel/unlock_guard.h"
+#include "nbl/core/parallel/CTaskScheduler.h"
 // string
 #include "nbl/core/string/stringutil.h"
 #include "nbl/core/string/StringLiteral.h"
@@ -0,0 +1,377 @@
+// Copyright (C) 2018-2023 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#ifndef _NBL_CORE_C_TASK_SCHEDULER_H_INCLUDED_
+#define _NBL_CORE_C_TASK_SCHEDULER_H_INCLUDED_
+
+#include "nbl/core/decl/Types.h"
+#include "nbl/core/IReferenceCounted.h"
+#include "nbl/core/decl/smart_refctd_ptr.h"
+#include "nbl/core/execution.h"
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace nbl::core
+{
+
+//! Work-stealing thread pool shared by everything in the engine that wants to go wide.
+/**
+Every worker owns a deque, it pushes and pops its own tasks LIFO (for cache locality of nested work)
+while idle workers steal FIFO from the other end of everyone else's deque. Tasks spawned from threads
+which are not workers of this scheduler go onto a shared injection queue.
+
+Threads waiting on a `CTaskGroup` execute pending tasks instead of blocking, so nested parallelism
+(a parallel loader calling a parallel filter) never creates more threads than `getConcurrency()`.
+*/
+class NBL_API2 CTaskScheduler final : public IReferenceCounted
+{
+	public:
+		using task_t = std::function<void()>;
+
+		//! Counts outstanding tasks, `wait()` helps execute work until all tasks spawned through it complete.
+		/** Continuations registered with `then()` get enqueued the next time the group drains.
+		A task which throws still counts as completed, the first exception gets rethrown by `wait()`. */
+		class NBL_API2 CTaskGroup final : public Uncopyable
+		{
+			public:
+				inline CTaskGroup(CTaskScheduler* _scheduler) : m_scheduler(_scheduler) {}
+				inline ~CTaskGroup()
+				{
+					// can't throw from a destructor, whoever cared about the exception should have called `wait()`
+					drain();
+				}
+
+				inline CTaskScheduler* getScheduler() const {return m_scheduler;}
+
+				//! Returns true if no tasks spawned through this group are still pending or running
+				inline bool done() const {return m_pending.load()==0u;}
+
+				//!
+				template<typename F>
+				inline void run(F&& f)
+				{
+					m_pending++;
+					m_scheduler->enqueue(task_t(std::forward<F>(f)),this);
+				}
+
+				//! Schedule `f` to run (as a free task, not part of this group) once every task in the group has completed.
+				template<typename F>
+				inline void then(F&& f)
+				{
+					task_t continuation(std::forward<F>(f));
+					{
+						std::unique_lock lock(m_continuationMutex);
+						if (!done())
+						{
+							m_continuations.push_back(std::move(continuation));
+							return;
+						}
+					}
+					m_scheduler->enqueue(std::move(continuation));
+				}
+
+				//! Returns once all tasks have completed, executes other pending tasks while waiting.
+				/** Rethrows the first exception thrown by any of the tasks. */
+				void wait();
+
+			private:
+				friend class CTaskScheduler;
+				void drain();
+				void taskDone(std::exception_ptr&& exception);
+
+				CTaskScheduler* const m_scheduler;
+				std::atomic_uint32_t m_pending = 0u;
+				std::mutex m_continuationMutex;
+				core::vector<task_t> m_continuations;
+				std::exception_ptr m_exception;
+		};
+
+		template<typename T>
+		class promise_t;
+		//! Result of `async` or `promise_t`, waiting on it executes other pending tasks
+		/** Copies share the same state, `T` needs to be default constructible. `get()` rethrows whatever the producer failed with. */
+		template<typename T>
+		class future_t
+		{
+			public:
+				future_t() = default;
+
+				inline bool valid() const {return bool(m_state);}
+				inline bool ready() const {return m_state && m_state->ready.load();}
+
+				//! `helpOut=false` blocks without running other tasks, use it when the producer could be further down the stack of one of those tasks
+				inline void wait(const bool helpOut=true) const
+				{
+					assert(valid());
+					if (helpOut)
+						m_state->scheduler->waitUntil([this]()->bool{return ready();});
+					else
+						m_state->ready.wait(false);
+				}
+				inline const T& get(const bool helpOut=true) const
+				{
+					wait(helpOut);
+					if (m_state->exception)
+						std::rethrow_exception(m_state->exception);
+					return m_state->value;
+				}
+
+			private:
+				template<typename U>
+				friend class promise_t;
+
+				struct SState
+				{
+					CTaskScheduler* scheduler;
+					std::atomic_bool ready = false;
+					T value = {};
+					std::exception_ptr exception;
+				};
+				std::shared_ptr<SState> m_state;
+		};
+		//! For when the value is produced by something else than a task, such as a thread that was first to start a load
+		template<typename T>
+		class promise_t
+		{
+			public:
+				inline promise_t(CTaskScheduler* _scheduler)
+				{
+					m_future.m_state = std::make_shared<typename future_t<T>::SState>();
+					m_future.m_state->scheduler = _scheduler;
+				}
+
+				inline const future_t<T>& get_future() const {return m_future;}
+
+				//! Can only be called once, and not together with `set_exception`
+				inline void set_value(T&& value)
+				{
+					auto& state = *m_future.m_state;
+					assert(!state.ready.load());
+					state.value = std::move(value);
+					signal();
+				}
+				//!
+				inline void set_exception(std::exception_ptr exception)
+				{
+					auto& state = *m_future.m_state;
+					assert(!state.ready.load());
+					state.exception = std::move(exception);
+					signal();
+				}
+
+			private:
+				inline void signal()
+				{
+					auto& state = *m_future.m_state;
+					state.ready.store(true);
+					state.ready.notify_all();
+					state.scheduler->notifyWaiters();
+				}
+
+				future_t<T> m_future;
+		};
+
+		//! Adapter so that any `execute(ExecutionPolicy&&,state)` filter can run on the scheduler, see `core::for_each`
+		struct policy_t
+		{
+			CTaskScheduler* scheduler;
+			//! 0 means no limit other than `scheduler->getConcurrency()`
+			uint32_t maxConcurrency = 0u;
+		};
+
+		//! While alive, the current thread must not block on something another thread holds, and neither may any task it spawns in the meantime
+		/** For code which other threads could be blocked on, such as the owner of an in-flight asset load, two of those waiting on each other
+		would never wake up. The restriction follows the spawned tasks to whichever thread runs them, because the owner waits for them
+		(or runs them on top of its own stack). Waiting on a `CTaskGroup` or a `future_t` of a task is fine. */
+		class NBL_API2 CNoWaitScope final : public Uncopyable
+		{
+			public:
+				CNoWaitScope();
+				~CNoWaitScope();
+		};
+		//! Whether the current thread is inside of a `CNoWaitScope`, or runs a task spawned inside of one
+		static bool mustNotWait();
+
+		//! `workerCount==~0u` spawns one less worker than hardware threads, as the thread waiting on work participates too.
+		CTaskScheduler(const uint32_t workerCount=~0u);
+
+		//! Process-wide scheduler, created on first use.
+		static CTaskScheduler* getDefault();
+
+		//!
+		inline uint32_t getWorkerCount() const {return m_workerCount;}
+		//! Worker threads plus the calling thread, which always helps out while waiting
+		inline uint32_t getConcurrency() const {return m_workerCount+1u;}
+
+		//! Returned by reference, because filters pass `ExecutionPolicy` explicitly as a template argument to their helpers
+		inline const policy_t& policy() const {return m_policy;}
+		//! Store the result in a variable before handing it to a filter
+		inline policy_t policy(const uint32_t maxConcurrency) {return {this,maxConcurrency};}
+
+		//! Fire-and-forget unless `group` is provided, prefer `CTaskGroup::run`
+		/** Exceptions thrown by fire-and-forget tasks have nowhere to go and get swallowed, use `async` if you care about them. */
+		void enqueue(task_t&& task, CTaskGroup* group=nullptr);
+
+		//! Pops and executes one task if any is available, returns whether it did.
+		bool runPendingTask();
+
+		//! Executes pending tasks until `pred()` returns true, whoever makes it true must call `notifyWaiters()` afterwards.
+		template<typename Pred>
+		inline void waitUntil(Pred&& pred)
+		{
+			while (true)
+			{
+				// need to sample the epoch before checking the predicate, or we could miss a wakeup
+				const auto epoch = m_epoch.load();
+				if (pred())
+					return;
+				if (runPendingTask())
+					continue;
+				m_epoch.wait(epoch);
+			}
+		}
+		//!
+		inline void notifyWaiters() {notify(true);}
+
+		//!
+		template<typename F, typename R=std::invoke_result_t<F>>
+		inline future_t<R> async(F&& f)
+		{
+			promise_t<R> promise(this);
+			future_t<R> future = promise.get_future();
+			enqueue([promise,f=std::forward<F>(f)]() mutable -> void
+			{
+				try
+				{
+					promise.set_value(f());
+				}
+				catch (...)
+				{
+					promise.set_exception(std::current_exception());
+				}
+			});
+			return future;
+		}
+
+		//! Calls `f(rangeBegin,rangeEnd)` over disjoint subranges of `[0,count)` using at most `maxConcurrency` threads.
+		template<typename F>
+		inline void parallel_for_range(const size_t count, F&& f, const uint32_t maxConcurrency=0u, size_t grainSize=0u)
+		{
+			if (count==0ull)
+				return;
+			uint32_t runnerCount = getConcurrency();
+			if (maxConcurrency)
+				runnerCount = std::min(runnerCount,maxConcurrency);
+			// about 8 chunks per runner is enough to balance the load without hammering the atomic
+			if (grainSize==0ull)
+				grainSize = std::max<size_t>((count+runnerCount*8ull-1ull)/(runnerCount*8ull),1ull);
+			runnerCount = static_cast<uint32_t>(std::min<size_t>(runnerCount,(count+grainSize-1ull)/grainSize));
+			if (runnerCount<2u)
+			{
+				f(size_t(0ull),count);
+				return;
+			}
+
+			std::atomic<size_t> next = 0ull;
+			auto runner = [&f,&next,count,grainSize]() -> void
+			{
+				for (size_t rangeBegin; (rangeBegin=next.fetch_add(grainSize))<count; )
+					f(rangeBegin,std::min(rangeBegin+grainSize,count));
+			};
+			CTaskGroup group(this);
+			for (uint32_t i=1u; i<runnerCount; i++)
+				group.run(runner);
+			runner();
+			group.wait();
+		}
+		//! Calls `f(i)` for every `i` in `[0,count)`
+		template<typename F>
+		inline void parallel_for(const size_t count, F&& f, const uint32_t maxConcurrency=0u, const size_t grainSize=0u)
+		{
+			parallel_for_range(count,[&f](const size_t rangeBegin, const size_t rangeEnd)->void
+			{
+				for (size_t i=rangeBegin; i<rangeEnd; i++)
+					f(i);
+			},maxConcurrency,grainSize);
+		}
+
+	protected:
+		~CTaskScheduler();
+
+	private:
+		struct SItem
+		{
+			task_t task;
+			CTaskGroup* group = nullptr;
+			//! `CNoWaitScope`s the task inherited from whoever spawned it
+			uint32_t noWaitDepth = 0u;
+		};
+		struct SQueue
+		{
+			std::mutex mutex;
+			core::deque<SItem> items;
+		};
+
+		void workerLoop(const uint32_t workerIx);
+		bool pop(SItem& item);
+		void execute(SItem& item);
+		//! Wakes up both idle workers and threads stuck in `CTaskGroup::wait`
+		inline void notify(const bool all)
+		{
+			m_epoch++;
+			if (all)
+				m_epoch.notify_all();
+			else
+				m_epoch.notify_one();
+		}
+
+		const uint32_t m_workerCount;
+		const policy_t m_policy;
+		// one per worker, the last one is the injection queue for external threads
+		std::unique_ptr<SQueue[]> m_queues;
+		core::vector<std::thread> m_threads;
+		std::atomic_uint64_t m_epoch = 0u;
+		std::atomic_bool m_quit = false;
+};
+
+
+//! `execute(policy,state)` adapters, the standard parallel algorithms don't accept custom policies
+template<typename It, typename F>
+inline void for_each(const CTaskScheduler::policy_t& policy, It begin, It end, F f)
+{
+	if constexpr (std::is_base_of_v<std::random_access_iterator_tag,typename std::iterator_traits<It>::iterator_category>)
+	{
+		const auto count = static_cast<size_t>(end-begin);
+		policy.scheduler->parallel_for_range(count,[&](const size_t rangeBegin, const size_t rangeEnd)->void
+		{
+			auto it = begin+static_cast<typename std::iterator_traits<It>::difference_type>(rangeBegin);
+			for (auto i=rangeBegin; i<rangeEnd; i++,++it)
+				f(*it);
+		},policy.maxConcurrency);
+	}
+	else
+		std::for_each(begin,end,f);
+}
+template<typename It, typename Size, typename F>
+inline It for_each_n(const CTaskScheduler::policy_t& policy, It begin, Size n, F f)
+{
+	if constexpr (std::is_base_of_v<std::random_access_iterator_tag,typename std::iterator_traits<It>::iterator_category>)
+	{
+		const auto end = begin+static_cast<typename std::iterator_traits<It>::difference_type>(n);
+		for_each(policy,begin,end,f);
+		return end;
+	}
+	else
+		return std::for_each_n(begin,n,f);
+}
+
+}
+
+#endif
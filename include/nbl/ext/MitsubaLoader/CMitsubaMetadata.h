@@ -126,6 +126,10 @@ class CMitsubaMetadata : public asset::IAssetMetadata
 
 	private:
 		friend class CMitsubaLoader;
+		friend class ParserManager;
+
+		//! Keeps the parsed elements alive, `m_global` holds copies of some of them which point at others
+		core::smart_refctd_ptr<core::IReferenceCounted> m_elementPool;
 
 		meta_container_t<CRenderpassIndependentPipeline> m_metaPplnStorage;
 		core::smart_refctd_dynamic_array<asset::IRenderpassIndependentPipelineMetadata::ShaderInputSemantic> m_semanticStorage;
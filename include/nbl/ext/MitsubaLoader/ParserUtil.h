@@ -43,25 +43,53 @@ private:
 };
 
 
+//! Arena for the parsed elements, nothing is freed individually, everything gets released in one go when the last reference to the storage dies
 template<typename... types>
 class ElementPool // : public std::tuple<core::vector<types>...>
 {
-		core::SimpleBlockBasedAllocator<core::LinearAddressAllocator<uint32_t>,core::aligned_allocator> poolAllocator;
+		class CStorage final : public core::IReferenceCounted
+		{
+			public:
+				// no preallocated blocks so that `reset` releases all of them, 4096 blocks of 4MB cap the pool at 16GB
+				CStorage() : poolAllocator(4096u*1024u, 0u, 4096u) {}
+
+				core::SimpleBlockBasedAllocator<core::LinearAddressAllocator<uint32_t>,core::aligned_allocator> poolAllocator;
+				core::vector<IElement*> constructed;
+
+			protected:
+				~CStorage()
+				{
+					for (auto it=constructed.rbegin(); it!=constructed.rend(); it++)
+						(*it)->~IElement();
+					constructed.clear();
+					poolAllocator.reset();
+				}
+		};
+		core::smart_refctd_ptr<CStorage> storage;
 	public:
-		ElementPool() : poolAllocator(4096u*1024u, 256u, 256u) {} // TODO: is it correct?
+		ElementPool() : storage(core::make_smart_refctd_ptr<CStorage>()) {}
 
 		template<typename T, typename... Args>
 		inline T* construct(Args&& ... args)
 		{
-			T* ptr = reinterpret_cast<T*>(poolAllocator.allocate(sizeof(T), alignof(T)));
-			return new (ptr) T(std::forward<Args>(args)...);
+			T* ptr = reinterpret_cast<T*>(storage->poolAllocator.allocate(sizeof(T), alignof(T)));
+			if (!ptr)
+				return nullptr;
+			new (ptr) T(std::forward<Args>(args)...);
+			storage->constructed.push_back(ptr);
+			return ptr;
 		}
+
+		//! The elements stay alive for as long as anyone holds on to the storage
+		inline core::smart_refctd_ptr<core::IReferenceCounted> getStorage() const {return storage;}
 };
 
 //struct, which will be passed to expat handlers as user data (first argument) see: XML_StartElementHandler or XML_EndElementHandler in expat.h
 class ParserManager
 {
 	protected:
+		_NBL_STATIC_INLINE_CONSTEXPR size_t ParseChunkSize = 0x1u<<20u;
+
 		struct Context
 		{
 			ParserManager* manager;
@@ -74,6 +102,8 @@ class ParserManager
 								m_system(_system), m_override(_override), m_sceneDeclCount(0),
 								m_metadata(core::make_smart_refctd_ptr<CMitsubaMetadata>())
 		{
+			// the copies of elements in the metadata point at other elements (such as textures), which must outlive the parse
+			m_metadata->m_elementPool = objects.getStorage();
 		}
 
 		//
@@ -88,6 +118,7 @@ class ParserManager
 			XML_StopParser(ctx.parser, false);
 		}
 
+		//! Streams the file through expat in chunks of at most `ParseChunkSize` bytes, so memory use does not grow with the file size
 		bool parse(system::IFile* _file, const system::logger_opt_ptr& _logger);
 
 		void parseElement(const Context& ctx, const char* _el, const char** _atts);
@@ -51,6 +51,7 @@ namespace MitsubaLoader
 		using tex_ass_type = std::tuple<core::smart_refctd_ptr<asset::ICPUImageView>,core::smart_refctd_ptr<asset::ICPUSampler>>;
 		//image, scale
 		core::map<core::smart_refctd_ptr<asset::ICPUImage>,float> derivMapCache;
+		std::mutex derivMapCacheMutex; // textures get cached from multiple threads
 
 		//
 		static std::string imageViewCacheKey(const CElementTexture::Bitmap& bitmap, const CMitsubaMaterialCompilerFrontend::E_IMAGE_VIEW_SEMANTIC semantic)
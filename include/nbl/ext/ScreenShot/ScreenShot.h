@@ -333,7 +333,7 @@ inline bool createScreenShot(
 						state.inMipLevel = regionWithMipMap->imageSubresource.mipLevel;
 						state.outMipLevel = regionWithMipMap->imageSubresource.mipLevel;
 
-						const bool ok = convertFilter.execute(core::execution::par_unseq,&state);
+						const bool ok = convertFilter.execute(core::CTaskScheduler::getDefault()->policy(),&state);
 						assert(ok);
 					}
 				}
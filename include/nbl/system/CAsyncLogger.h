@@ -0,0 +1,90 @@
+#ifndef _NBL_SYSTEM_C_ASYNC_LOGGER_INCLUDED_
+#define _NBL_SYSTEM_C_ASYNC_LOGGER_INCLUDED_
+
+#include "nbl/system/ILogger.h"
+
+#include <atomic>
+#include <thread>
+
+namespace nbl::system
+{
+
+//! Formats messages on the calling thread and hands them to a background thread which writes them out through another logger
+/*
+	Logging threads never take a lock, the formatted messages go into a bounded lock-free queue and the
+	`sink` (any `ILogger`, usually an `IThreadsafeLogger`) only ever gets called from the background thread.
+	Timestamps are taken by the `sink`, so they're the time of writing out rather than of the `log` call.
+*/
+class NBL_API2 CAsyncLogger final : public ILogger
+{
+	public:
+		//! What a `log` call does when the queue is full, errors always wait for space regardless
+		enum E_OVERFLOW_POLICY : uint8_t
+		{
+			//! discard the message
+			EOP_DROP,
+			//! wait until the background thread makes space
+			EOP_BLOCK,
+			//! wait for space with one in every `sampleRate` overflowing messages, discard the rest
+			EOP_SAMPLE
+		};
+		struct SCreationParams
+		{
+			core::smart_refctd_ptr<ILogger> sink;
+			//! rounded up to a power of two
+			uint32_t queueCapacity = 4096u;
+			E_OVERFLOW_POLICY overflowPolicy = EOP_BLOCK;
+			uint32_t sampleRate = 16u;
+			//! installs a `std::terminate` handler which writes out the queues of all live async loggers before chaining to the previous handler
+			bool flushOnTerminate = true;
+		};
+		//! Only the levels enabled both in `logLevelMask` and in the sink's mask get queued
+		CAsyncLogger(SCreationParams&& params, const core::bitflag<E_LOG_LEVEL> logLevelMask=ILogger::DefaultLogMask());
+
+		//! Blocks until every message logged before the call has been handed to the sink
+		void flush();
+
+		//! Flushes every live `CAsyncLogger`, for use in crash handlers
+		static void flushAll();
+
+	protected:
+		~CAsyncLogger();
+
+		void log_impl(const std::string_view& fmtString, E_LOG_LEVEL logLevel, va_list args) override;
+
+	private:
+		struct alignas(64) SSlot
+		{
+			std::atomic<uint64_t> sequence;
+			E_LOG_LEVEL level;
+			// keeps its capacity between uses, so after warming up enqueuing doesn't allocate
+			std::string text;
+		};
+
+		bool tryEnqueue(const std::string_view& text, const E_LOG_LEVEL logLevel);
+		void enqueueBlocking(const std::string_view& text, const E_LOG_LEVEL logLevel);
+		void drain();
+
+		const core::smart_refctd_ptr<ILogger> m_sink;
+		const E_OVERFLOW_POLICY m_overflowPolicy;
+		const uint32_t m_sampleRate;
+
+		// bounded MPSC queue, a slot is ready to be written when `sequence==position` and ready to be read when `sequence==position+1`
+		core::vector<SSlot> m_slots;
+		uint64_t m_mask;
+		alignas(64) std::atomic<uint64_t> m_enqueuePos = 0ull;
+		// producers bump this after publishing a message, the background thread sleeps on it
+		alignas(64) std::atomic<uint64_t> m_published = 0ull;
+		// position the background thread has written out up to, producers waiting for space and `flush` sleep on it
+		alignas(64) std::atomic<uint64_t> m_dequeuePos = 0ull;
+		std::atomic<uint32_t> m_waiters = 0u;
+		std::atomic<uint32_t> m_overflows = 0u;
+		std::atomic<uint32_t> m_dropped = 0u;
+		std::atomic_bool m_quit = false;
+
+		std::thread m_thread;
+};
+
+}
+
+#endif
@@ -70,8 +70,8 @@ class CInnerArchiveFile : public CFileView<T>
 //!
 class NBL_API2 CFileArchive : public IFileArchive
 {
-		static inline constexpr size_t SIZEOF_INNER_ARCHIVE_FILE = std::max(sizeof(CInnerArchiveFile<CPlainHeapAllocator>), sizeof(CInnerArchiveFile<VirtualMemoryAllocator>));
-		static inline constexpr size_t ALIGNOF_INNER_ARCHIVE_FILE = std::max(alignof(CInnerArchiveFile<CPlainHeapAllocator>), alignof(CInnerArchiveFile<VirtualMemoryAllocator>));
+		static inline constexpr size_t SIZEOF_INNER_ARCHIVE_FILE = std::max({sizeof(CInnerArchiveFile<CPlainHeapAllocator>), sizeof(CInnerArchiveFile<VirtualMemoryAllocator>), sizeof(CInnerArchiveFile<CBorrowedBufferAllocator>)});
+		static inline constexpr size_t ALIGNOF_INNER_ARCHIVE_FILE = std::max({alignof(CInnerArchiveFile<CPlainHeapAllocator>), alignof(CInnerArchiveFile<VirtualMemoryAllocator>), alignof(CInnerArchiveFile<CBorrowedBufferAllocator>)});
 
 	protected:
 		inline CFileArchive(path&& _defaultAbsolutePath, system::logger_opt_smart_ptr&& logger, std::shared_ptr<core::vector<SFileList::SEntry>> _items) :
@@ -105,6 +105,9 @@ class NBL_API2 CFileArchive : public IFileArchive
 				case EAT_VIRTUAL_ALLOC:
 					return getFile_impl<VirtualMemoryAllocator>(found,flags);
 					break;
+				case EAT_BORROWED:
+					return getFile_impl<CBorrowedBufferAllocator>(found,flags);
+					break;
 				case EAT_APK_ALLOCATOR:
 					#ifdef _NBL_PLATFORM_ANDROID_
 					return getFile_impl<CFileViewAPKAllocator>(found,flags);
@@ -148,7 +151,7 @@ class NBL_API2 CFileArchive : public IFileArchive
 					flags, 
 					fileBuffer.buffer,
 					fileBuffer.size,
-					Allocator(fileBuffer.allocatorState) // no archive uses stateful allocators yet
+					Allocator(fileBuffer.allocatorState)
 				);
 			}
 			// don't grab because we've already grabbed
@@ -39,6 +39,9 @@ class CMountDirectoryArchive : public IFileArchive
             return IFileArchive::listAssets();
         }
 
+        // the directory contents can change at any time
+        inline bool hasStaticListing() const override {return false;}
+
     protected:		
 		inline core::smart_refctd_ptr<IFile> getFile_impl(const SFileList::found_t& found, const core::bitflag<IFile::E_CREATE_FLAGS> flags, const std::string_view& password) override
 		{
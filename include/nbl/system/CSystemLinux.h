@@ -12,7 +12,7 @@ namespace nbl::system
 class CSystemLinux final : public ISystemPOSIX
 {
 	public:
-		inline CSystemLinux() : ISystemPOSIX() {}
+		inline CSystemLinux(logger_opt_smart_ptr&& logger=nullptr) : ISystemPOSIX(std::move(logger)) {}
 
 		NBL_API2 SystemInfo getSystemInfo() const override;
 };
@@ -26,7 +26,7 @@ class NBL_API2 CSystemWin32 : public ISystem
         };
         
     public:
-        inline CSystemWin32() : ISystem(core::make_smart_refctd_ptr<CCaller>(this)) {}
+        inline CSystemWin32(logger_opt_smart_ptr&& logger=nullptr) : ISystem(core::make_smart_refctd_ptr<CCaller>(this),std::move(logger)) {}
 
         SystemInfo getSystemInfo() const override;
 
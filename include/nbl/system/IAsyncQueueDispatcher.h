@@ -45,6 +45,8 @@ class IAsyncQueueDispatcherBase
                 [[nodiscard]] future_base_t* wait();
                 //! WORKER THREAD: to call after request is done being processed, will deadlock if the request was not executed
                 void notify();
+                //! WORKER THREAD: to call instead of `notify` when the result will be provided later via `IAsyncQueueDispatcherBase::notify_detached`, recycles the request but leaves the future executing
+                void detach();
 
                 //! ANY THREAD [except worker]: via cancellable_future_t::cancel
                 inline void cancel()
@@ -95,6 +97,7 @@ class IAsyncQueueDispatcherBase
 
             protected:
                 friend struct request_base_t;
+                friend class IAsyncQueueDispatcherBase;
                 //! REQUESTING THREAD: done as part of filling out the request
                 virtual inline void associate_request(request_base_t* req)
                 {
@@ -367,6 +370,8 @@ class IAsyncQueueDispatcherBase
     protected:
         template<typename T>
         static inline core::StorageTrivializer<T>* future_storage_cast(future_base_t* _future_base) {return static_cast<future_t<T>*>(_future_base);}
+        //! ANY THREAD: completes a future whose request got detached, after its storage has been constructed
+        static inline void notify_detached(future_base_t* _future_base) {_future_base->notify();}
 };
 
 inline void IAsyncQueueDispatcherBase::request_base_t::finalize(future_base_t* fut)
@@ -393,6 +398,12 @@ inline void IAsyncQueueDispatcherBase::request_base_t::notify()
     // allow to be recycled
     state.exchangeNotify<false>(STATE::INITIAL,STATE::EXECUTING);
 }
+inline void IAsyncQueueDispatcherBase::request_base_t::detach()
+{
+    // the future stays in EXECUTING, so it can neither be cancelled nor consumed until someone notifies it
+    future = nullptr;
+    state.exchangeNotify<false>(STATE::INITIAL,STATE::EXECUTING);
+}
 
 }
 
@@ -405,6 +416,8 @@ inline void IAsyncQueueDispatcherBase::request_base_t::notify()
 * 
 * // no `state` parameter in case of no internal state
 * void process_request(future_base_t*, request_metadata_t&, internal_state_t&);
+* // or, if some requests complete asynchronously, return false for those and later construct the result and call `notify_detached` on the future
+* bool process_request(future_base_t*, request_metadata_t&, internal_state_t&);
 * 
 * void background_work() // optional, does nothing if not provided
 * 
@@ -491,6 +504,9 @@ class IAsyncQueueDispatcher : public IThreadHandler<CRTP,InternalStateType>, pro
         inline ~IAsyncQueueDispatcher() {}
         inline void background_work() {}
 
+        //! WORKER THREAD: number of requests in the queue, including the one being processed
+        inline counter_t backlog() const {return cb_end.load()-cb_begin.load();}
+
     private:
         template<typename... Args>
         void work(lock_t& lock, Args&&... optional_internal_state)
@@ -510,8 +526,19 @@ class IAsyncQueueDispatcher : public IThreadHandler<CRTP,InternalStateType>, pro
                 if (future_base_t* future=req.wait())
                 {
                     // if the request supports cancelling and got cancelled, then `wait()` function may return false
-                    static_cast<CRTP*>(this)->process_request(future,req.m_metadata,optional_internal_state...);
-                    req.notify();
+                    using process_retval_t = decltype(static_cast<CRTP*>(this)->process_request(future,req.m_metadata,optional_internal_state...));
+                    if constexpr (std::is_same_v<process_retval_t,bool>)
+                    {
+                        if (static_cast<CRTP*>(this)->process_request(future,req.m_metadata,optional_internal_state...))
+                            req.notify();
+                        else
+                            req.detach();
+                    }
+                    else
+                    {
+                        static_cast<CRTP*>(this)->process_request(future,req.m_metadata,optional_internal_state...);
+                        req.notify();
+                    }
                 }
                 // wake the waiter up
                 cb_begin++;
@@ -88,9 +88,70 @@ class IFile : public IFileBase, private ISystem::IFutureManipulator
 			fut.sizeToProcess = sizeToWrite;
 		}
 
+		//! Read-only window into a byte range of the file, so parsers can walk it with plain pointers
+		/**
+		Points straight into the mapping when the file has one, otherwise the whole range gets fetched
+		with a single bulk `read` into memory owned by the view. The file must outlive the view.
+		*/
+		class CReadView final
+		{
+			public:
+				CReadView() = default;
+				inline CReadView(IFile* file, const size_t offset=0ull, size_t size=~0ull)
+				{
+					const size_t fileSize = file->getSize();
+					if (offset>fileSize)
+						return;
+					size = std::min(size,fileSize-offset);
+					if (size==0ull)
+						return;
+
+					const IFileBase* constFile = file;
+					if (const auto* mapped=reinterpret_cast<const std::byte*>(constFile->getMappedPointer()); mapped)
+						m_data = mapped+offset;
+					else
+					{
+						// no value-initialization, this can be gigabytes
+						m_storage.reset(new std::byte[size]);
+						success_t success;
+						file->read(success,m_storage.get(),offset,size);
+						if (!success)
+						{
+							m_storage = nullptr;
+							return;
+						}
+						m_data = m_storage.get();
+					}
+					m_size = size;
+				}
+				CReadView(CReadView&&) = default;
+				CReadView& operator=(CReadView&&) = default;
+
+				//! False if the range was empty or the read failed
+				inline explicit operator bool() const {return m_data;}
+
+				inline const std::byte* data() const {return m_data;}
+				inline size_t size() const {return m_size;}
+
+				template<typename T=char>
+				inline const T* begin() const {return reinterpret_cast<const T*>(m_data);}
+				template<typename T=char>
+				inline const T* end() const {return reinterpret_cast<const T*>(m_data+m_size);}
+
+				//! Whether no copy was made
+				inline bool isMapped() const {return m_data && !m_storage;}
+
+			private:
+				const std::byte* m_data = nullptr;
+				size_t m_size = 0ull;
+				std::unique_ptr<std::byte[]> m_storage;
+		};
+
 	protected:
 		// this is an abstract interface class so this stays protected
 		using IFileBase::IFileBase;
+		// for implementations which service `unmappedRead` themselves
+		using ISystem::IFutureManipulator::set_result;
 
 		//
 		virtual void unmappedRead(ISystem::future_t<size_t>& fut, void* buffer, size_t offset, size_t sizeToRead)
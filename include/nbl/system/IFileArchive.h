@@ -31,7 +31,8 @@ class NBL_API2 IFileArchive : public core::IReferenceCounted
 			EAT_NULL, // read directly from archive's underlying mapped file
 			EAT_VIRTUAL_ALLOC, // decompress to RAM (with sparse paging)
 			EAT_APK_ALLOCATOR, // specialization to be able to call `AAsset_close`
-			EAT_MALLOC // decompress to RAM
+			EAT_MALLOC, // decompress to RAM
+			EAT_BORROWED // memory owned by the archive (e.g. its cache of decompressed entries), only handed back when the file dies
 		};
 		//! An entry in a list of items, can be a folder or a file.
 		class SFileList
@@ -114,6 +115,9 @@ class NBL_API2 IFileArchive : public core::IReferenceCounted
 		// List all files and directories in a specific dir of the archive
 		SFileList listAssets(path pathRelativeToArchive) const;
 
+		//! Whether the list of assets is fixed once the archive is created, `ISystem` can only index the files of such archives when mounting
+		virtual inline bool hasStaticListing() const {return true;}
+
 		//
 		inline core::smart_refctd_ptr<IFile> getFile(const path& pathRelativeToArchive, const core::bitflag<IFileBase::E_CREATE_FLAGS> flags, const std::string_view& password)
 		{
@@ -129,6 +133,9 @@ class NBL_API2 IFileArchive : public core::IReferenceCounted
 			return getFile_impl(item,flags,password);
 		}
 
+		//! Hint that the files will be opened soon, archives which need to decompress can start doing so in parallel
+		virtual void prefetch(std::span<const path> pathsRelativeToArchive) {}
+
 		//
 		const path& getDefaultAbsolutePath() const {return m_defaultAbsolutePath;}
 
@@ -56,6 +56,31 @@ class CNullAllocator : public IFileViewAllocator
 		}
 };
 
+
+// For memory owned by something which outlives the `IFile`, such as an archive's cache of decompressed entries,
+// the state is the owner which gets told that the file no longer uses the buffer
+class CBorrowedBufferAllocator : public IFileViewAllocator
+{
+	public:
+		class IOwner
+		{
+			public:
+				virtual void release(void* data) = 0;
+		};
+
+		using IFileViewAllocator::IFileViewAllocator;
+
+		void* alloc(size_t size) override
+		{
+			return nullptr;
+		}
+		bool dealloc(void* data, size_t size) override
+		{
+			static_cast<IOwner*>(m_state)->release(data);
+			return true;
+		}
+};
+
 }
 
 #ifdef _NBL_PLATFORM_WINDOWS_
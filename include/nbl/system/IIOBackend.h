@@ -0,0 +1,41 @@
+#ifndef _NBL_SYSTEM_I_IO_BACKEND_H_INCLUDED_
+#define _NBL_SYSTEM_I_IO_BACKEND_H_INCLUDED_
+
+#include "nbl/core/decl/smart_refctd_ptr.h"
+
+namespace nbl::system
+{
+
+class ISystemFile;
+
+//! Executes the reads and writes of an `ISystem`, its queue thread only hands the requests over
+/** A backend may keep any number of requests in flight and complete them in any order, from any thread. */
+class NBL_API2 IIOBackend : public core::IReferenceCounted
+{
+	public:
+		struct SRequest
+		{
+			ISystemFile* file;
+			void* buffer;
+			size_t offset;
+			size_t size;
+			bool write;
+			// opaque, identifies the future to complete
+			void* future;
+		};
+
+		//! Only ever called from the `ISystem`'s queue thread, `lastInBatch` is false if more requests are about to follow right away
+		virtual void submit(const SRequest& request, const bool lastInBatch) = 0;
+
+	protected:
+		virtual ~IIOBackend() = default;
+
+		//! Constructs the result in the request's future and makes it ready, must be called exactly once per submitted request
+		static void complete(const SRequest& request, const size_t bytesTransferred);
+		//! Executes the request synchronously on the calling thread using positional I/O, so any number of threads can do this concurrently
+		static size_t execute(const SRequest& request);
+};
+
+}
+
+#endif
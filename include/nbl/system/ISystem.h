@@ -9,6 +9,7 @@
 
 #include "nbl/system/IFileArchive.h"
 #include "nbl/system/IAsyncQueueDispatcher.h"
+#include "nbl/system/IIOBackend.h"
 
 #ifdef NBL_EMBED_BUILTIN_RESOURCES
 #include "nbl/builtin/builtinResources.h"
@@ -137,6 +138,7 @@ class NBL_API2 ISystem : public core::IReferenceCounted
                 m_cachedArchiveFiles.insert(archive->getDefaultAbsolutePath(),std::move(archive));
             else
                 m_cachedArchiveFiles.insert(pathAlias,std::move(archive));
+            rebuildArchiveIndex();
         }
 
         //
@@ -147,6 +149,7 @@ class NBL_API2 ISystem : public core::IReferenceCounted
                 m_cachedArchiveFiles.removeObject(dummy,archive->getDefaultAbsolutePath());
             else
                 m_cachedArchiveFiles.removeObject(dummy,pathAlias);
+            rebuildArchiveIndex();
         }
 
         //
@@ -190,7 +193,8 @@ class NBL_API2 ISystem : public core::IReferenceCounted
         };
 
         //
-        explicit ISystem(core::smart_refctd_ptr<ICaller>&& caller);
+        //! `logger` only receives errors of the reads and writes that the I/O backend executes
+        explicit ISystem(core::smart_refctd_ptr<ICaller>&& caller, logger_opt_smart_ptr&& logger=nullptr);
         virtual ~ISystem() {}
 
         // given an `absolutePath` find the archive it belongs to
@@ -211,6 +215,24 @@ class NBL_API2 ISystem : public core::IReferenceCounted
         } m_loaders;
         //
         core::CMultiObjectCache<system::path,core::smart_refctd_ptr<IFileArchive>> m_cachedArchiveFiles;
+        // Every file of the mounted archives keyed by its lexically normal path, so that `findFileInArchive` doesn't need to touch the filesystem.
+        // Needs to be rebuilt whenever `m_cachedArchiveFiles` changes.
+        void rebuildArchiveIndex();
+        // `mountRank` orders all the mounts by precedence, deeper mount points go first
+        struct SIndexedArchiveFile
+        {
+            FoundArchiveFile file;
+            uint32_t mountRank;
+        };
+        core::unordered_map<std::string,SIndexedArchiveFile> m_archiveFileIndex;
+        // mount points of the archives which can't be indexed, by ascending `mountRank`
+        struct SUnindexedMount
+        {
+            system::path mountPoint;
+            IFileArchive* archive;
+            uint32_t mountRank;
+        };
+        core::vector<SUnindexedMount> m_unindexedArchives;
 
     private:
         struct SRequestParams_NOOP
@@ -261,19 +283,35 @@ class NBL_API2 ISystem : public core::IReferenceCounted
                 using base_t = IAsyncQueueDispatcher<CAsyncQueue,SRequestType,CircularBufferSize>;
 
                 core::smart_refctd_ptr<ICaller> m_caller;
+                // reads and writes get handed over to the backend and complete out of order, everything else runs on the queue thread
+                core::smart_refctd_ptr<IIOBackend> m_io;
 
             public:
-                inline CAsyncQueue(core::smart_refctd_ptr<ICaller>&& caller) : base_t(base_t::start_on_construction), m_caller(std::move(caller))
+                inline CAsyncQueue(core::smart_refctd_ptr<ICaller>&& caller, core::smart_refctd_ptr<IIOBackend>&& io) : base_t(base_t::start_on_construction), m_caller(std::move(caller)), m_io(std::move(io))
                 {
                     //waitForInitComplete(); init is a NOOP
                 }
+                // the queue thread uses `m_io` and `m_caller`, so it needs to stop before they get destroyed
+                inline ~CAsyncQueue()
+                {
+                    base_t::terminate();
+                }
 
-                void process_request(base_t::future_base_t* _future_base, SRequestType& req);
+                bool process_request(base_t::future_base_t* _future_base, SRequestType& req);
 
                 void init() {}
+
+                //! for the `IIOBackend` to complete a read or write future
+                static inline void complete(void* _future_base, const size_t retval)
+                {
+                    auto* future = static_cast<base_t::future_base_t*>(_future_base);
+                    base_t::future_storage_cast<size_t>(future)->construct(retval);
+                    base_t::notify_detached(future);
+                }
         };
         // friendship needed to be able to know about the request types
         friend class ISystemFile;
+        friend class IIOBackend;
 
         CAsyncQueue m_dispatcher;
 };
@@ -48,6 +48,8 @@ class ISystemFile : public IFile
 		virtual size_t asyncRead(void* buffer, size_t offset, size_t sizeToRead) = 0;
 		friend struct ISystem::SRequestParams_WRITE;
 		virtual size_t asyncWrite(const void* buffer, size_t offset, size_t sizeToWrite) = 0;
+		// executes them on its own threads, so both must be safe to call concurrently
+		friend class IIOBackend;
 
 
 		core::smart_refctd_ptr<ISystem> m_system;
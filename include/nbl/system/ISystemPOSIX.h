@@ -21,7 +21,7 @@ class ISystemPOSIX : public ISystem
                 NBL_API2 core::smart_refctd_ptr<ISystemFile> createFile(const std::filesystem::path& filename, const core::bitflag<IFile::E_CREATE_FLAGS> flags) override;
         };
 
-        inline ISystemPOSIX() : ISystem(core::make_smart_refctd_ptr<CCaller>(this)) {}
+        inline ISystemPOSIX(logger_opt_smart_ptr&& logger=nullptr) : ISystem(core::make_smart_refctd_ptr<CCaller>(this),std::move(logger)) {}
 };
 #endif
 
@@ -125,6 +125,8 @@ class IThreadHandler
             m_initComplete.notify_one();
         }
 
+    protected:
+        //! Derived classes whose `work` uses their own members must call this in their destructor, the base one runs too late
         void terminate()
         {
             {
@@ -22,6 +22,7 @@
 // loggers
 #include "nbl/system/CStdoutLogger.h"
 #include "nbl/system/CFileLogger.h"
+#include "nbl/system/CAsyncLogger.h"
 
 //whole system
 #if defined(_NBL_PLATFORM_WINDOWS_)
@@ -139,6 +139,41 @@ IMeshManipulator* IAssetManager::getMeshManipulator()
 	return m_meshManipulator.get();
 }
 
+core::CTaskScheduler::future_t<bool> IAssetManager::claimInFlightLoad(const std::string& _key, CInFlightLoad& claim)
+{
+	assert(!claim.m_manager);
+	std::unique_lock lock(m_inFlightLoadMutex);
+	auto found = m_inFlightLoads.find(_key);
+	if (found!=m_inFlightLoads.end())
+	{
+		// the owners of claims never wait on other claims, so no cycle of loads waiting on each other can ever form
+		if (core::CTaskScheduler::mustNotWait())
+			return {};
+		return found->second;
+	}
+
+	claim.m_manager = this;
+	claim.m_key = _key;
+	claim.m_promise.emplace(m_scheduler.get());
+	claim.m_noWait.emplace();
+	m_inFlightLoads.emplace(_key,claim.m_promise->get_future());
+	return {};
+}
+
+void IAssetManager::CInFlightLoad::finish(const bool loaded)
+{
+	if (!m_manager)
+		return;
+	{
+		std::unique_lock lock(m_manager->m_inFlightLoadMutex);
+		m_manager->m_inFlightLoads.erase(m_key);
+	}
+	m_promise->set_value(bool(loaded));
+	m_promise.reset();
+	m_noWait.reset();
+	m_manager = nullptr;
+}
+
 void IAssetManager::addLoadersAndWriters()
 {
 #ifdef _NBL_COMPILE_WITH_STL_LOADER_
@@ -0,0 +1,368 @@
+// Copyright (C) 2018-2023 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#include "nbl/core/definitions.h"
+
+#include "nbl/asset/format/convertPixelRows.h"
+#include "nbl/asset/format/decodePixels.h"
+#include "nbl/asset/format/encodePixels.h"
+
+using namespace nbl;
+using namespace nbl::asset;
+
+namespace
+{
+
+constexpr uint32_t Channels = 4u;
+
+//! Every 8bit channel value decodes to one of 256 doubles, the sRGB curve included
+struct SByteLUTs
+{
+	SByteLUTs()
+	{
+		for (uint32_t i=0u; i<256u; i++)
+		{
+			unorm[i] = i/255.;
+			srgb[i] = core::srgb2lin(i/255.);
+		}
+	}
+
+	double unorm[256];
+	double srgb[256];
+};
+const SByteLUTs& getByteLUTs()
+{
+	static const SByteLUTs luts;
+	return luts;
+}
+
+template<bool BGRA, bool SRGB>
+void decodeRGBA8(const uint8_t* in, double* out, const uint32_t texelCount)
+{
+	const auto& luts = getByteLUTs();
+	const double* const color = SRGB ? luts.srgb:luts.unorm;
+	for (uint32_t i=0u; i<texelCount; i++, in+=4u, out+=Channels)
+	{
+		out[BGRA ? 2u:0u] = color[in[0]];
+		out[1] = color[in[1]];
+		out[BGRA ? 0u:2u] = color[in[2]];
+		out[3] = luts.unorm[in[3]];
+	}
+}
+
+template<bool BGRA>
+void encodeRGBA8(uint8_t* out, const double* in, const uint32_t texelCount)
+{
+#ifdef __NBL_COMPILE_WITH_X86_SIMD_
+	// `encodePixels` truncates and keeps the lowest byte, which is what we get as long as the scaled value fits in 32bits
+	const __m128d scale = _mm_set1_pd(255.0);
+	const __m128i byteMask = _mm_set1_epi32(0xff);
+	const __m128i gather = BGRA ? _mm_setr_epi8(8,4,0,12,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1):_mm_setr_epi8(0,4,8,12,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1);
+	for (uint32_t i=0u; i<texelCount; i++, in+=Channels, out+=4u)
+	{
+		const __m128i rg = _mm_cvttpd_epi32(_mm_mul_pd(_mm_loadu_pd(in),scale));
+		const __m128i ba = _mm_cvttpd_epi32(_mm_mul_pd(_mm_loadu_pd(in+2),scale));
+		const __m128i rgba = _mm_and_si128(_mm_unpacklo_epi64(rg,ba),byteMask);
+		const int32_t packed = _mm_cvtsi128_si32(_mm_shuffle_epi8(rgba,gather));
+		memcpy(out,&packed,4u);
+	}
+#else
+	for (uint32_t i=0u; i<texelCount; i++, in+=Channels, out+=4u)
+		encodePixels<BGRA ? EF_B8G8R8A8_UNORM:EF_R8G8B8A8_UNORM,double>(out,in);
+#endif
+}
+
+template<bool BGRA>
+void encodeRGBA8_SRGB(uint8_t* out, const double* in, const uint32_t texelCount)
+{
+	// the sRGB curve needs a `pow`, there's no exact way around it
+	for (uint32_t i=0u; i<texelCount; i++, in+=Channels, out+=4u)
+	{
+		out[BGRA ? 2u:0u] = static_cast<uint8_t>(uint64_t(core::lin2srgb(in[0])*255.));
+		out[1] = static_cast<uint8_t>(uint64_t(core::lin2srgb(in[1])*255.));
+		out[BGRA ? 0u:2u] = static_cast<uint8_t>(uint64_t(core::lin2srgb(in[2])*255.));
+		out[3] = static_cast<uint8_t>(uint64_t(in[3]*255.));
+	}
+}
+
+#ifdef __NBL_COMPILE_WITH_X86_SIMD_
+// same constants as `core::Float16Compressor`
+constexpr int32_t HalfShift = 13;
+constexpr int32_t InfN = 0x7F800000;
+constexpr int32_t MaxN = 0x477FE000;
+constexpr int32_t MinN = 0x38800000;
+constexpr int32_t InfC = InfN>>HalfShift;
+constexpr int32_t NanN = (InfC+1)<<HalfShift;
+constexpr int32_t MaxC = MaxN>>HalfShift;
+constexpr int32_t MinC = MinN>>HalfShift;
+constexpr int32_t MulN = 0x52000000;
+constexpr int32_t MulC = 0x33800000;
+constexpr int32_t SubC = 0x003FF;
+constexpr int32_t NorC = 0x00400;
+constexpr int32_t MaxD = InfC-MaxC-1;
+constexpr int32_t MinD = MinC-SubC-1;
+
+//! `core::Float16Compressor::compress` on 4 lanes at once, the result is in the low 16 bits of every lane
+inline __m128i compressHalf4(const __m128 value)
+{
+	__m128i v = _mm_castps_si128(value);
+	__m128i sign = _mm_and_si128(v,_mm_set1_epi32(0x80000000));
+	v = _mm_xor_si128(v,sign);
+	sign = _mm_srli_epi32(sign,16);
+	const __m128i s = _mm_cvttps_epi32(_mm_mul_ps(_mm_castsi128_ps(_mm_set1_epi32(MulN)),_mm_castsi128_ps(v)));
+	auto select = [](const __m128i a, const __m128i b, const __m128i mask) -> __m128i
+	{
+		return _mm_xor_si128(a,_mm_and_si128(_mm_xor_si128(b,a),mask));
+	};
+	v = select(v,s,_mm_cmpgt_epi32(_mm_set1_epi32(MinN),v));
+	v = select(v,_mm_set1_epi32(InfN),_mm_and_si128(_mm_cmpgt_epi32(_mm_set1_epi32(InfN),v),_mm_cmpgt_epi32(v,_mm_set1_epi32(MaxN))));
+	v = select(v,_mm_set1_epi32(NanN),_mm_and_si128(_mm_cmpgt_epi32(_mm_set1_epi32(NanN),v),_mm_cmpgt_epi32(v,_mm_set1_epi32(InfN))));
+	v = _mm_srli_epi32(v,HalfShift);
+	v = select(v,_mm_sub_epi32(v,_mm_set1_epi32(MaxD)),_mm_cmpgt_epi32(v,_mm_set1_epi32(MaxC)));
+	v = select(v,_mm_sub_epi32(v,_mm_set1_epi32(MinD)),_mm_cmpgt_epi32(v,_mm_set1_epi32(SubC)));
+	return _mm_or_si128(v,sign);
+}
+//! `core::Float16Compressor::decompress` on 4 lanes at once, expects the halves zero extended
+inline __m128 decompressHalf4(__m128i v)
+{
+	__m128i sign = _mm_and_si128(v,_mm_set1_epi32(0x8000));
+	v = _mm_xor_si128(v,sign);
+	sign = _mm_slli_epi32(sign,16);
+	auto select = [](const __m128i a, const __m128i b, const __m128i mask) -> __m128i
+	{
+		return _mm_xor_si128(a,_mm_and_si128(_mm_xor_si128(b,a),mask));
+	};
+	v = select(v,_mm_add_epi32(v,_mm_set1_epi32(MinD)),_mm_cmpgt_epi32(v,_mm_set1_epi32(SubC)));
+	v = select(v,_mm_add_epi32(v,_mm_set1_epi32(MaxD)),_mm_cmpgt_epi32(v,_mm_set1_epi32(MaxC)));
+	const __m128i s = _mm_castps_si128(_mm_mul_ps(_mm_castsi128_ps(_mm_set1_epi32(MulC)),_mm_cvtepi32_ps(v)));
+	const __m128i mask = _mm_cmpgt_epi32(_mm_set1_epi32(NorC),v);
+	v = _mm_slli_epi32(v,HalfShift);
+	v = select(v,s,mask);
+	return _mm_castsi128_ps(_mm_or_si128(v,sign));
+}
+
+inline void storeAsDoubles(double* out, const __m128 value)
+{
+	_mm_storeu_pd(out,_mm_cvtps_pd(value));
+	_mm_storeu_pd(out+2,_mm_cvtps_pd(_mm_movehl_ps(value,value)));
+}
+inline __m128 loadAsFloats(const double* in)
+{
+	return _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(in)),_mm_cvtpd_ps(_mm_loadu_pd(in+2)));
+}
+#endif
+
+void decodeRGBA16F(const uint8_t* in, double* out, const uint32_t texelCount)
+{
+#ifdef __NBL_COMPILE_WITH_X86_SIMD_
+	for (uint32_t i=0u; i<texelCount; i++, in+=8u, out+=Channels)
+		storeAsDoubles(out,decompressHalf4(_mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in)))));
+#else
+	for (uint32_t i=0u; i<texelCount; i++, in+=8u, out+=Channels)
+	{
+		const void* pix[4] = {in,nullptr,nullptr,nullptr};
+		decodePixels<EF_R16G16B16A16_SFLOAT,double>(pix,out,0u,0u);
+	}
+#endif
+}
+void encodeRGBA16F(uint8_t* out, const double* in, const uint32_t texelCount)
+{
+#ifdef __NBL_COMPILE_WITH_X86_SIMD_
+	for (uint32_t i=0u; i<texelCount; i++, in+=Channels, out+=8u)
+	{
+		const __m128i halves = compressHalf4(loadAsFloats(in));
+		_mm_storel_epi64(reinterpret_cast<__m128i*>(out),_mm_packus_epi32(halves,halves));
+	}
+#else
+	for (uint32_t i=0u; i<texelCount; i++, in+=Channels, out+=8u)
+		encodePixels<EF_R16G16B16A16_SFLOAT,double>(out,in);
+#endif
+}
+
+void decodeRGBA32F(const uint8_t* in, double* out, const uint32_t texelCount)
+{
+#ifdef __NBL_COMPILE_WITH_X86_SIMD_
+	for (uint32_t i=0u; i<texelCount; i++, in+=16u, out+=Channels)
+		storeAsDoubles(out,_mm_loadu_ps(reinterpret_cast<const float*>(in)));
+#else
+	for (uint32_t i=0u; i<texelCount; i++, in+=16u, out+=Channels)
+	{
+		const void* pix[4] = {in,nullptr,nullptr,nullptr};
+		decodePixels<EF_R32G32B32A32_SFLOAT,double>(pix,out,0u,0u);
+	}
+#endif
+}
+void encodeRGBA32F(uint8_t* out, const double* in, const uint32_t texelCount)
+{
+#ifdef __NBL_COMPILE_WITH_X86_SIMD_
+	for (uint32_t i=0u; i<texelCount; i++, in+=Channels, out+=16u)
+		_mm_storeu_ps(reinterpret_cast<float*>(out),loadAsFloats(in));
+#else
+	for (uint32_t i=0u; i<texelCount; i++, in+=Channels, out+=16u)
+		encodePixels<EF_R32G32B32A32_SFLOAT,double>(out,in);
+#endif
+}
+
+// the packed float formats are bit twiddling per texel either way, these just skip the per texel dispatch
+void decodeB10G11R11(const uint8_t* in, double* out, const uint32_t texelCount)
+{
+	for (uint32_t i=0u; i<texelCount; i++, in+=4u, out+=Channels)
+	{
+		uint32_t pix;
+		memcpy(&pix,in,4u);
+		out[0] = core::unpack11bitFloat(pix);
+		out[1] = core::unpack11bitFloat(pix>>11u);
+		out[2] = core::unpack10bitFloat(pix>>22u);
+		out[3] = 0.0;
+	}
+}
+void encodeB10G11R11(uint8_t* out, const double* in, const uint32_t texelCount)
+{
+	for (uint32_t i=0u; i<texelCount; i++, in+=Channels, out+=4u)
+	{
+		const uint32_t pix = core::to11bitFloat(static_cast<float>(in[0]))|(core::to11bitFloat(static_cast<float>(in[1]))<<11u)|(core::to10bitFloat(static_cast<float>(in[2]))<<22u);
+		memcpy(out,&pix,4u);
+	}
+}
+
+void decodeE5B9G9R9(const uint8_t* in, double* out, const uint32_t texelCount)
+{
+	for (uint32_t i=0u; i<texelCount; i++, in+=4u, out+=Channels)
+	{
+		uint32_t pix;
+		memcpy(&pix,in,4u);
+		const uint64_t exp = (static_cast<uint64_t>(pix>>27u)+(1023ull-15ull))<<52u;
+		for (uint32_t c=0u; c<3u; c++)
+		{
+			const uint64_t bits = (uint64_t((pix>>(9u*c))&0x1ffu)<<(52u-9u))|exp;
+			memcpy(out+c,&bits,8u);
+		}
+		out[3] = 0.0;
+	}
+}
+void encodeE5B9G9R9(uint8_t* out, const double* in, const uint32_t texelCount)
+{
+	for (uint32_t i=0u; i<texelCount; i++, in+=Channels, out+=4u)
+	{
+		uint64_t bits[3];
+		memcpy(bits,in,sizeof(bits));
+		// the shared exponent comes from the first channel, same as `encodePixels`
+		uint32_t pix = static_cast<uint32_t>(((bits[0]>>52u)&0x7ffull)-(1023ull-15ull))<<27u;
+		for (uint32_t c=0u; c<3u; c++)
+			pix |= static_cast<uint32_t>((bits[c]>>(52u-9u))&0x1ffu)<<(9u*c);
+		memcpy(out,&pix,4u);
+	}
+}
+
+}
+
+bool nbl::asset::hasPixelRowKernel(const E_FORMAT format)
+{
+	switch (format)
+	{
+		case EF_R8G8B8A8_UNORM:
+		case EF_R8G8B8A8_SRGB:
+		case EF_B8G8R8A8_UNORM:
+		case EF_B8G8R8A8_SRGB:
+		case EF_R16G16B16A16_SFLOAT:
+		case EF_R32G32B32A32_SFLOAT:
+		case EF_B10G11R11_UFLOAT_PACK32:
+		case EF_E5B9G9R9_UFLOAT_PACK32:
+			return true;
+		default:
+			break;
+	}
+	return false;
+}
+
+bool nbl::asset::decodePixelRow(const E_FORMAT format, const void* src, double* dst, const uint32_t texelCount)
+{
+	if (!isPixelRowConvertible(format))
+		return false;
+
+	const auto* in = reinterpret_cast<const uint8_t*>(src);
+	switch (format)
+	{
+		case EF_R8G8B8A8_UNORM:
+			decodeRGBA8<false,false>(in,dst,texelCount);
+			return true;
+		case EF_R8G8B8A8_SRGB:
+			decodeRGBA8<false,true>(in,dst,texelCount);
+			return true;
+		case EF_B8G8R8A8_UNORM:
+			decodeRGBA8<true,false>(in,dst,texelCount);
+			return true;
+		case EF_B8G8R8A8_SRGB:
+			decodeRGBA8<true,true>(in,dst,texelCount);
+			return true;
+		case EF_R16G16B16A16_SFLOAT:
+			decodeRGBA16F(in,dst,texelCount);
+			return true;
+		case EF_R32G32B32A32_SFLOAT:
+			decodeRGBA32F(in,dst,texelCount);
+			return true;
+		case EF_B10G11R11_UFLOAT_PACK32:
+			decodeB10G11R11(in,dst,texelCount);
+			return true;
+		case EF_E5B9G9R9_UFLOAT_PACK32:
+			decodeE5B9G9R9(in,dst,texelCount);
+			return true;
+		default:
+			break;
+	}
+
+	const uint32_t texelByteSize = getTexelOrBlockBytesize(format);
+	const uint32_t channelCount = getFormatChannelCount(format);
+	for (uint32_t i=0u; i<texelCount; i++, in+=texelByteSize, dst+=Channels)
+	{
+		const void* pix[4] = {in,nullptr,nullptr,nullptr};
+		double decoded[Channels];
+		decodePixels<double>(format,pix,decoded,0u,0u);
+		std::copy_n(decoded,channelCount,dst);
+		std::fill(dst+channelCount,dst+Channels,0.0);
+	}
+	return true;
+}
+
+bool nbl::asset::encodePixelRow(const E_FORMAT format, void* dst, const double* src, const uint32_t texelCount)
+{
+	if (!isPixelRowConvertible(format))
+		return false;
+
+	auto* out = reinterpret_cast<uint8_t*>(dst);
+	switch (format)
+	{
+		case EF_R8G8B8A8_UNORM:
+			encodeRGBA8<false>(out,src,texelCount);
+			return true;
+		case EF_R8G8B8A8_SRGB:
+			encodeRGBA8_SRGB<false>(out,src,texelCount);
+			return true;
+		case EF_B8G8R8A8_UNORM:
+			encodeRGBA8<true>(out,src,texelCount);
+			return true;
+		case EF_B8G8R8A8_SRGB:
+			encodeRGBA8_SRGB<true>(out,src,texelCount);
+			return true;
+		case EF_R16G16B16A16_SFLOAT:
+			encodeRGBA16F(out,src,texelCount);
+			return true;
+		case EF_R32G32B32A32_SFLOAT:
+			encodeRGBA32F(out,src,texelCount);
+			return true;
+		case EF_B10G11R11_UFLOAT_PACK32:
+			encodeB10G11R11(out,src,texelCount);
+			return true;
+		case EF_E5B9G9R9_UFLOAT_PACK32:
+			encodeE5B9G9R9(out,src,texelCount);
+			return true;
+		default:
+			break;
+	}
+
+	const uint32_t texelByteSize = getTexelOrBlockBytesize(format);
+	for (uint32_t i=0u; i<texelCount; i++, out+=texelByteSize, src+=Channels)
+		encodePixels<double>(format,out,src);
+	return true;
+}
@@ -0,0 +1,677 @@
+// Copyright (C) 2018-2023 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#include "nbl/core/definitions.h"
+
+#include "nbl/asset/format/encodeBlocks.h"
+#include "nbl/asset/format/decodePixels.h"
+
+#include <cfloat>
+
+using namespace nbl;
+using namespace nbl::asset;
+
+namespace
+{
+
+constexpr uint32_t TexelCount = 16u;
+// interpolation weights (out of 64) of the 4 bit indices of BC6H and BC7
+constexpr uint32_t Weights4[16] = {0u,4u,9u,13u,17u,21u,26u,30u,34u,38u,43u,47u,51u,55u,60u,64u};
+
+//! 128 bit blocks get filled LSB first
+class CBitWriter
+{
+	public:
+		inline CBitWriter(uint8_t* _dst) : m_dst(_dst)
+		{
+			std::fill_n(m_dst,16u,0u);
+		}
+
+		inline void write(const uint32_t value, const uint32_t bitCount)
+		{
+			for (uint32_t i=0u; i<bitCount; i++,m_offset++)
+				m_dst[m_offset>>3u] |= ((value>>i)&0x1u)<<(m_offset&0x7u);
+		}
+
+	private:
+		uint8_t* const m_dst;
+		uint32_t m_offset = 0u;
+};
+
+struct SEndpoints
+{
+	core::vectorSIMDf a,b;
+};
+
+inline float squaredLength(const core::vectorSIMDf& v)
+{
+	return core::dot(v,v).x;
+}
+
+//! Line through the block, either the diagonal of the bounding box or the principal axis of the points
+SEndpoints fitEndpoints(const core::vectorSIMDf* points, const uint32_t count, const E_BLOCK_ENCODE_QUALITY quality)
+{
+	core::vectorSIMDf minimum(FLT_MAX), maximum(-FLT_MAX), mean(0.f);
+	for (uint32_t i=0u; i<count; i++)
+	{
+		minimum = core::min(minimum,points[i]);
+		maximum = core::max(maximum,points[i]);
+		mean += points[i];
+	}
+	if (quality==EBEQ_FASTEST || count<3u)
+		return {maximum,minimum};
+	mean /= float(count);
+
+	// covariance matrix, one row per channel
+	core::vectorSIMDf covariance[4] = {core::vectorSIMDf(0.f),core::vectorSIMDf(0.f),core::vectorSIMDf(0.f),core::vectorSIMDf(0.f)};
+	for (uint32_t i=0u; i<count; i++)
+	{
+		const auto d = points[i]-mean;
+		for (uint32_t c=0u; c<4u; c++)
+			covariance[c] += d*d[c];
+	}
+	// power iteration, starting from the bounding box diagonal converges within a few steps
+	auto axis = maximum-minimum;
+	for (uint32_t i=0u; i<8u; i++)
+	{
+		const auto next = covariance[0]*axis.x+covariance[1]*axis.y+covariance[2]*axis.z+covariance[3]*axis.w;
+		const float lengthSq = squaredLength(next);
+		if (lengthSq<FLT_MIN)
+			break;
+		axis = next/std::sqrt(lengthSq);
+	}
+	const float axisLengthSq = squaredLength(axis);
+	if (axisLengthSq<FLT_MIN)
+		return {mean,mean};
+
+	float tMin = FLT_MAX, tMax = -FLT_MAX;
+	for (uint32_t i=0u; i<count; i++)
+	{
+		const float t = core::dot(points[i]-mean,axis).x;
+		tMin = std::min(tMin,t);
+		tMax = std::max(tMax,t);
+	}
+	tMin /= axisLengthSq;
+	tMax /= axisLengthSq;
+	return {mean+axis*tMax,mean+axis*tMin};
+}
+
+//! Least squares endpoints for the given interpolation weights of endpoint `a`, returns false if the system is singular
+bool refineEndpoints(const core::vectorSIMDf* points, const float* weights, const uint32_t count, SEndpoints& endpoints)
+{
+	float aa = 0.f, bb = 0.f, ab = 0.f;
+	core::vectorSIMDf ax(0.f), bx(0.f);
+	for (uint32_t i=0u; i<count; i++)
+	{
+		const float alpha = weights[i];
+		const float beta = 1.f-alpha;
+		aa += alpha*alpha;
+		bb += beta*beta;
+		ab += alpha*beta;
+		ax += points[i]*alpha;
+		bx += points[i]*beta;
+	}
+	const float determinant = aa*bb-ab*ab;
+	if (std::abs(determinant)<1e-6f)
+		return false;
+	const float invDeterminant = 1.f/determinant;
+	endpoints.a = (ax*bb-bx*ab)*invDeterminant;
+	endpoints.b = (bx*aa-ax*ab)*invDeterminant;
+	return true;
+}
+
+//! Nearest palette entry for every point, returns the summed squared error
+float selectIndices(const core::vectorSIMDf* points, const uint32_t count, const core::vectorSIMDf* palette, const uint32_t paletteSize, uint8_t* indices)
+{
+	float totalError = 0.f;
+	for (uint32_t i=0u; i<count; i++)
+	{
+		float bestError = FLT_MAX;
+		for (uint32_t j=0u; j<paletteSize; j++)
+		{
+			const float error = squaredLength(points[i]-palette[j]);
+			if (error<bestError)
+			{
+				bestError = error;
+				indices[i] = j;
+			}
+		}
+		totalError += bestError;
+	}
+	return totalError;
+}
+
+inline uint32_t refinementPasses(const E_BLOCK_ENCODE_QUALITY quality)
+{
+	switch (quality)
+	{
+		case EBEQ_FASTEST:
+			return 0u;
+		case EBEQ_NORMAL:
+			return 1u;
+		default:
+			return 4u;
+	}
+}
+
+//! RGB in [0,1] from the decoded linear values, optionally converted to sRGB
+void loadColors(const double texels[16][4], const bool srgb, const double scale, core::vectorSIMDf* colors)
+{
+	for (uint32_t i=0u; i<TexelCount; i++)
+	{
+		double rgba[4];
+		for (uint32_t c=0u; c<4u; c++)
+			rgba[c] = core::clamp(texels[i][c],0.0,1.0);
+		if (srgb)
+			asset::impl::lin2SRGB<double>(rgba);
+		colors[i] = core::vectorSIMDf(rgba[0]*scale,rgba[1]*scale,rgba[2]*scale,rgba[3]*scale);
+	}
+}
+
+/*
+	BC1 color part, also used by BC2 and BC3
+*/
+inline uint16_t quantize565(const core::vectorSIMDf& color)
+{
+	const auto clamped = core::min(core::max(color,core::vectorSIMDf(0.f)),core::vectorSIMDf(1.f));
+	const uint32_t r = static_cast<uint32_t>(clamped.x*31.f+0.5f);
+	const uint32_t g = static_cast<uint32_t>(clamped.y*63.f+0.5f);
+	const uint32_t b = static_cast<uint32_t>(clamped.z*31.f+0.5f);
+	return static_cast<uint16_t>((r<<11u)|(g<<5u)|b);
+}
+inline core::vectorSIMDf expand565(const uint16_t color)
+{
+	return core::vectorSIMDf(float(color>>11u)/31.f,float((color>>5u)&0x3fu)/63.f,float(color&0x1fu)/31.f,0.f);
+}
+
+//! `transparent` is only non-null for BC1 with 1 bit alpha, then the 3 color mode gets used if any texel is transparent
+void encodeColorBlock(uint8_t* dst, const core::vectorSIMDf* colors, const bool* transparent, const E_BLOCK_ENCODE_QUALITY quality)
+{
+	core::vectorSIMDf points[TexelCount];
+	uint32_t pointTexel[TexelCount];
+	uint32_t count = 0u;
+	for (uint32_t i=0u; i<TexelCount; i++)
+	if (!transparent || !transparent[i])
+	{
+		points[count] = colors[i];
+		points[count].w = 0.f;
+		pointTexel[count++] = i;
+	}
+	const bool threeColor = count!=TexelCount;
+
+	uint16_t bestC0 = 0u, bestC1 = 0u;
+	uint8_t bestIndices[TexelCount] = {};
+	if (count)
+	{
+		auto endpoints = fitEndpoints(points,count,quality);
+		float bestError = FLT_MAX;
+		const uint32_t passes = refinementPasses(quality);
+		for (uint32_t pass=0u; pass<=passes; pass++)
+		{
+			uint16_t c0 = quantize565(endpoints.a);
+			uint16_t c1 = quantize565(endpoints.b);
+			// the order of the endpoints selects the mode
+			if (threeColor ? (c0>c1):(c0<c1))
+				std::swap(c0,c1);
+
+			core::vectorSIMDf palette[4];
+			palette[0] = expand565(c0);
+			palette[1] = expand565(c1);
+			uint32_t paletteSize = 4u;
+			if (threeColor)
+			{
+				palette[2] = (palette[0]+palette[1])*0.5f;
+				paletteSize = 3u;
+			}
+			else if (c0==c1)
+				paletteSize = 1u;
+			else
+			{
+				palette[2] = (palette[0]*2.f+palette[1])/3.f;
+				palette[3] = (palette[0]+palette[1]*2.f)/3.f;
+			}
+
+			uint8_t indices[TexelCount];
+			const float error = selectIndices(points,count,palette,paletteSize,indices);
+			if (error<bestError)
+			{
+				bestError = error;
+				bestC0 = c0;
+				bestC1 = c1;
+				std::copy_n(indices,count,bestIndices);
+			}
+			if (pass==passes || error==0.f)
+				break;
+
+			float weights[TexelCount];
+			for (uint32_t i=0u; i<count; i++)
+			{
+				constexpr float FourColorWeights[4] = {1.f,0.f,2.f/3.f,1.f/3.f};
+				constexpr float ThreeColorWeights[3] = {1.f,0.f,0.5f};
+				weights[i] = threeColor ? ThreeColorWeights[indices[i]]:FourColorWeights[indices[i]];
+			}
+			if (!refineEndpoints(points,weights,count,endpoints))
+				break;
+		}
+	}
+
+	uint32_t lut = 0u;
+	for (uint32_t i=0u; i<TexelCount; i++)
+		lut |= 0x3u<<(2u*i);
+	for (uint32_t i=0u; i<count; i++)
+	{
+		const uint32_t shift = 2u*pointTexel[i];
+		lut = (lut&~(0x3u<<shift))|(uint32_t(bestIndices[i])<<shift);
+	}
+	memcpy(dst,&bestC0,2u);
+	memcpy(dst+2u,&bestC1,2u);
+	memcpy(dst+4u,&lut,4u);
+}
+
+/*
+	BC4 single channel part, also used by BC3 and BC5
+*/
+void buildSingleChannelPalette(const int32_t e0, const int32_t e1, const bool isSigned, float palette[8])
+{
+	palette[0] = float(e0);
+	palette[1] = float(e1);
+	if (e0>e1)
+	{
+		for (int32_t i=1; i<7; i++)
+			palette[i+1] = float((7-i)*e0+i*e1)/7.f;
+	}
+	else
+	{
+		for (int32_t i=1; i<5; i++)
+			palette[i+1] = float((5-i)*e0+i*e1)/5.f;
+		palette[6] = isSigned ? -127.f:0.f;
+		palette[7] = isSigned ? 127.f:255.f;
+	}
+}
+
+float selectSingleChannelIndices(const float* values, const float palette[8], uint8_t* indices)
+{
+	float totalError = 0.f;
+	for (uint32_t i=0u; i<TexelCount; i++)
+	{
+		float bestError = FLT_MAX;
+		for (uint32_t j=0u; j<8u; j++)
+		{
+			const float diff = values[i]-palette[j];
+			if (diff*diff<bestError)
+			{
+				bestError = diff*diff;
+				indices[i] = j;
+			}
+		}
+		totalError += bestError;
+	}
+	return totalError;
+}
+
+//! `values` are in [0,1] for unsigned and [-1,1] for signed
+void encodeSingleChannelBlock(uint8_t* dst, const float* values, const bool isSigned, const E_BLOCK_ENCODE_QUALITY quality)
+{
+	const float scale = isSigned ? 127.f:255.f;
+	const int32_t lowest = isSigned ? -127:0;
+	const int32_t highest = isSigned ? 127:255;
+
+	float scaled[TexelCount];
+	float minimum = FLT_MAX, maximum = -FLT_MAX;
+	// range of the values that the explicit extremes of the 6 value mode don't already cover
+	float innerMinimum = FLT_MAX, innerMaximum = -FLT_MAX;
+	for (uint32_t i=0u; i<TexelCount; i++)
+	{
+		scaled[i] = core::clamp(values[i]*scale,float(lowest),float(highest));
+		minimum = std::min(minimum,scaled[i]);
+		maximum = std::max(maximum,scaled[i]);
+		if (scaled[i]>float(lowest)+0.5f && scaled[i]<float(highest)-0.5f)
+		{
+			innerMinimum = std::min(innerMinimum,scaled[i]);
+			innerMaximum = std::max(innerMaximum,scaled[i]);
+		}
+	}
+
+	int32_t bestE0 = 0, bestE1 = 0;
+	uint8_t bestIndices[TexelCount] = {};
+	float bestError = FLT_MAX;
+	auto tryEndpoints = [&](const int32_t e0, const int32_t e1) -> void
+	{
+		float palette[8];
+		buildSingleChannelPalette(e0,e1,isSigned,palette);
+		uint8_t indices[TexelCount];
+		const float error = selectSingleChannelIndices(scaled,palette,indices);
+		if (error<bestError)
+		{
+			bestError = error;
+			bestE0 = e0;
+			bestE1 = e1;
+			std::copy_n(indices,TexelCount,bestIndices);
+		}
+	};
+	const int32_t roundedMin = static_cast<int32_t>(std::floor(minimum+0.5f));
+	const int32_t roundedMax = static_cast<int32_t>(std::floor(maximum+0.5f));
+	// 8 value mode needs e0>e1, with a flat block this degenerates to a single value which is fine too
+	tryEndpoints(roundedMax,roundedMin);
+	if (quality!=EBEQ_FASTEST && bestError>0.f)
+	{
+		if (innerMinimum<=innerMaximum)
+			tryEndpoints(static_cast<int32_t>(std::floor(innerMinimum+0.5f)),static_cast<int32_t>(std::floor(innerMaximum+0.5f)));
+		if (quality==EBEQ_BEST)
+		{
+			constexpr int32_t SearchRadius = 2;
+			for (int32_t d0=-SearchRadius; d0<=SearchRadius; d0++)
+			for (int32_t d1=-SearchRadius; d1<=SearchRadius; d1++)
+			{
+				const int32_t e0 = core::clamp(roundedMax+d0,lowest,highest);
+				const int32_t e1 = core::clamp(roundedMin+d1,lowest,highest);
+				tryEndpoints(std::max(e0,e1),std::min(e0,e1));
+			}
+		}
+	}
+
+	dst[0] = static_cast<uint8_t>(bestE0);
+	dst[1] = static_cast<uint8_t>(bestE1);
+	uint64_t bits = 0ull;
+	for (uint32_t i=0u; i<TexelCount; i++)
+		bits |= uint64_t(bestIndices[i])<<(3u*i);
+	for (uint32_t i=0u; i<6u; i++)
+		dst[2u+i] = static_cast<uint8_t>(bits>>(8u*i));
+}
+
+void encodeChannel(uint8_t* dst, const double texels[16][4], const uint32_t channel, const bool isSigned, const E_BLOCK_ENCODE_QUALITY quality)
+{
+	float values[TexelCount];
+	for (uint32_t i=0u; i<TexelCount; i++)
+		values[i] = static_cast<float>(texels[i][channel]);
+	encodeSingleChannelBlock(dst,values,isSigned,quality);
+}
+
+/*
+	BC6H, mode 11 only: one region, 10 bit endpoints without delta compression, 4 bit indices
+*/
+inline int32_t unquantizeBC6H(const int32_t e, const bool isSigned)
+{
+	if (isSigned)
+	{
+		const int32_t magnitude = std::abs(e);
+		int32_t retval;
+		if (magnitude==0)
+			retval = 0;
+		else if (magnitude>=(1<<9)-1)
+			retval = 0x7fff;
+		else
+			retval = ((magnitude<<15)+0x4000)>>9;
+		return e<0 ? -retval:retval;
+	}
+	if (e==0)
+		return 0;
+	if (e==(1<<10)-1)
+		return 0xffff;
+	return ((e<<16)+0x8000)>>10;
+}
+
+//! Nearest 10 bit endpoint value in the unquantized domain
+inline int32_t quantizeBC6H(const float value, const bool isSigned)
+{
+	const int32_t lowest = isSigned ? -511:0;
+	const int32_t highest = isSigned ? 511:1023;
+	// both variants unquantize to roughly 64 times the endpoint value
+	const int32_t guess = core::clamp(static_cast<int32_t>(std::floor(value/64.f+0.5f)),lowest,highest);
+	int32_t best = guess;
+	float bestError = FLT_MAX;
+	for (int32_t e=std::max(guess-1,lowest); e<=std::min(guess+1,highest); e++)
+	{
+		const float error = std::abs(float(unquantizeBC6H(e,isSigned))-value);
+		if (error<bestError)
+		{
+			bestError = error;
+			best = e;
+		}
+	}
+	return best;
+}
+
+void encodeBC6H(uint8_t* dst, const double texels[16][4], const bool isSigned, const E_BLOCK_ENCODE_QUALITY quality)
+{
+	// the hardware interpolates the unquantized integers and then rescales them to half float bits, so fit in that domain
+	core::vectorSIMDf points[TexelCount];
+	for (uint32_t i=0u; i<TexelCount; i++)
+	{
+		float unquantized[3];
+		for (uint32_t c=0u; c<3u; c++)
+		{
+			const float value = core::clamp(static_cast<float>(texels[i][c]),isSigned ? -65504.f:0.f,65504.f);
+			const uint16_t half = core::Float16Compressor::compress(value);
+			if (isSigned)
+			{
+				const float magnitude = float(half&0x7fffu)*32.f/31.f;
+				unquantized[c] = (half&0x8000u) ? -magnitude:magnitude;
+			}
+			else
+				unquantized[c] = float(half)*64.f/31.f;
+		}
+		points[i] = core::vectorSIMDf(unquantized[0],unquantized[1],unquantized[2],0.f);
+	}
+
+	auto endpoints = fitEndpoints(points,TexelCount,quality);
+	int32_t bestQuantized[2][3] = {};
+	uint8_t bestIndices[TexelCount] = {};
+	float bestError = FLT_MAX;
+	const uint32_t passes = refinementPasses(quality);
+	for (uint32_t pass=0u; pass<=passes; pass++)
+	{
+		int32_t quantized[2][3];
+		int32_t unquantized[2][3];
+		for (uint32_t c=0u; c<3u; c++)
+		{
+			quantized[0][c] = quantizeBC6H(endpoints.a[c],isSigned);
+			quantized[1][c] = quantizeBC6H(endpoints.b[c],isSigned);
+			unquantized[0][c] = unquantizeBC6H(quantized[0][c],isSigned);
+			unquantized[1][c] = unquantizeBC6H(quantized[1][c],isSigned);
+		}
+		core::vectorSIMDf palette[16];
+		for (uint32_t j=0u; j<16u; j++)
+		{
+			int32_t interpolated[3];
+			for (uint32_t c=0u; c<3u; c++)
+				interpolated[c] = (unquantized[0][c]*int32_t(64u-Weights4[j])+unquantized[1][c]*int32_t(Weights4[j])+32)>>6;
+			palette[j] = core::vectorSIMDf(float(interpolated[0]),float(interpolated[1]),float(interpolated[2]),0.f);
+		}
+
+		uint8_t indices[TexelCount];
+		const float error = selectIndices(points,TexelCount,palette,16u,indices);
+		if (error<bestError)
+		{
+			bestError = error;
+			memcpy(bestQuantized,quantized,sizeof(quantized));
+			std::copy_n(indices,TexelCount,bestIndices);
+		}
+		if (pass==passes || error==0.f)
+			break;
+
+		float weights[TexelCount];
+		for (uint32_t i=0u; i<TexelCount; i++)
+			weights[i] = 1.f-float(Weights4[indices[i]])/64.f;
+		if (!refineEndpoints(points,weights,TexelCount,endpoints))
+			break;
+	}
+
+	// the MSB of the first index is implicitly zero
+	if (bestIndices[0]&0x8u)
+	{
+		std::swap(bestQuantized[0],bestQuantized[1]);
+		for (auto& index : bestIndices)
+			index = 15u-index;
+	}
+
+	CBitWriter writer(dst);
+	writer.write(0x03u,5u);
+	for (uint32_t e=0u; e<2u; e++)
+	for (uint32_t c=0u; c<3u; c++)
+		writer.write(static_cast<uint32_t>(bestQuantized[e][c])&0x3ffu,10u);
+	writer.write(bestIndices[0],3u);
+	for (uint32_t i=1u; i<TexelCount; i++)
+		writer.write(bestIndices[i],4u);
+}
+
+/*
+	BC7, mode 6 only: one subset, RGBA 7 bit endpoints with a unique P-bit each, 4 bit indices
+*/
+//! Picks the P-bit with the lower error, returns the expanded 8 bit endpoint
+inline core::vectorSIMDf quantizeBC7Endpoint(const core::vectorSIMDf& endpoint, uint32_t quantized[4], uint32_t& pBit)
+{
+	const auto clamped = core::min(core::max(endpoint,core::vectorSIMDf(0.f)),core::vectorSIMDf(255.f));
+	float bestError = FLT_MAX;
+	core::vectorSIMDf retval;
+	for (uint32_t p=0u; p<2u; p++)
+	{
+		uint32_t candidate[4];
+		core::vectorSIMDf expanded;
+		for (uint32_t c=0u; c<4u; c++)
+		{
+			candidate[c] = static_cast<uint32_t>(core::clamp(std::floor((clamped[c]-float(p))*0.5f+0.5f),0.f,127.f));
+			expanded[c] = float((candidate[c]<<1u)|p);
+		}
+		const float error = squaredLength(expanded-clamped);
+		if (error<bestError)
+		{
+			bestError = error;
+			std::copy_n(candidate,4u,quantized);
+			pBit = p;
+			retval = expanded;
+		}
+	}
+	return retval;
+}
+
+void encodeBC7(uint8_t* dst, const double texels[16][4], const bool srgb, const E_BLOCK_ENCODE_QUALITY quality)
+{
+	core::vectorSIMDf points[TexelCount];
+	loadColors(texels,srgb,255.0,points);
+
+	auto endpoints = fitEndpoints(points,TexelCount,quality);
+	uint32_t bestQuantized[2][4] = {};
+	uint32_t bestPBits[2] = {};
+	uint8_t bestIndices[TexelCount] = {};
+	float bestError = FLT_MAX;
+	const uint32_t passes = refinementPasses(quality);
+	for (uint32_t pass=0u; pass<=passes; pass++)
+	{
+		uint32_t quantized[2][4];
+		uint32_t pBits[2];
+		const auto e0 = quantizeBC7Endpoint(endpoints.a,quantized[0],pBits[0]);
+		const auto e1 = quantizeBC7Endpoint(endpoints.b,quantized[1],pBits[1]);
+		core::vectorSIMDf palette[16];
+		for (uint32_t j=0u; j<16u; j++)
+		for (uint32_t c=0u; c<4u; c++)
+			palette[j][c] = float((uint32_t(e0[c])*(64u-Weights4[j])+uint32_t(e1[c])*Weights4[j]+32u)>>6u);
+
+		uint8_t indices[TexelCount];
+		const float error = selectIndices(points,TexelCount,palette,16u,indices);
+		if (error<bestError)
+		{
+			bestError = error;
+			memcpy(bestQuantized,quantized,sizeof(quantized));
+			std::copy_n(pBits,2u,bestPBits);
+			std::copy_n(indices,TexelCount,bestIndices);
+		}
+		if (pass==passes || error==0.f)
+			break;
+
+		float weights[TexelCount];
+		for (uint32_t i=0u; i<TexelCount; i++)
+			weights[i] = 1.f-float(Weights4[indices[i]])/64.f;
+		if (!refineEndpoints(points,weights,TexelCount,endpoints))
+			break;
+	}
+
+	// the MSB of the anchor index is implicitly zero
+	if (bestIndices[0]&0x8u)
+	{
+		std::swap(bestQuantized[0],bestQuantized[1]);
+		std::swap(bestPBits[0],bestPBits[1]);
+		for (auto& index : bestIndices)
+			index = 15u-index;
+	}
+
+	CBitWriter writer(dst);
+	writer.write(0x1u<<6u,7u);
+	for (uint32_t c=0u; c<4u; c++)
+	for (uint32_t e=0u; e<2u; e++)
+		writer.write(bestQuantized[e][c],7u);
+	writer.write(bestPBits[0],1u);
+	writer.write(bestPBits[1],1u);
+	writer.write(bestIndices[0],3u);
+	for (uint32_t i=1u; i<TexelCount; i++)
+		writer.write(bestIndices[i],4u);
+}
+
+}
+
+bool nbl::asset::encodeBlock(const E_FORMAT format, void* dst, const double texels[16][4], const E_BLOCK_ENCODE_QUALITY quality)
+{
+	auto* const out = reinterpret_cast<uint8_t*>(dst);
+	core::vectorSIMDf colors[TexelCount];
+	switch (format)
+	{
+		case EF_BC1_RGB_UNORM_BLOCK:
+		case EF_BC1_RGB_SRGB_BLOCK:
+			loadColors(texels,format==EF_BC1_RGB_SRGB_BLOCK,1.0,colors);
+			encodeColorBlock(out,colors,nullptr,quality);
+			return true;
+		case EF_BC1_RGBA_UNORM_BLOCK:
+		case EF_BC1_RGBA_SRGB_BLOCK:
+		{
+			loadColors(texels,format==EF_BC1_RGBA_SRGB_BLOCK,1.0,colors);
+			bool transparent[TexelCount];
+			for (uint32_t i=0u; i<TexelCount; i++)
+				transparent[i] = colors[i].w<0.5f;
+			encodeColorBlock(out,colors,transparent,quality);
+			return true;
+		}
+		case EF_BC2_UNORM_BLOCK:
+		case EF_BC2_SRGB_BLOCK:
+		{
+			loadColors(texels,format==EF_BC2_SRGB_BLOCK,1.0,colors);
+			uint64_t alpha = 0ull;
+			for (uint32_t i=0u; i<TexelCount; i++)
+				alpha |= uint64_t(colors[i].w*15.f+0.5f)<<(4u*i);
+			memcpy(out,&alpha,8u);
+			encodeColorBlock(out+8u,colors,nullptr,quality);
+			return true;
+		}
+		case EF_BC3_UNORM_BLOCK:
+		case EF_BC3_SRGB_BLOCK:
+		{
+			loadColors(texels,format==EF_BC3_SRGB_BLOCK,1.0,colors);
+			float alpha[TexelCount];
+			for (uint32_t i=0u; i<TexelCount; i++)
+				alpha[i] = colors[i].w;
+			encodeSingleChannelBlock(out,alpha,false,quality);
+			encodeColorBlock(out+8u,colors,nullptr,quality);
+			return true;
+		}
+		case EF_BC4_UNORM_BLOCK:
+		case EF_BC4_SNORM_BLOCK:
+			encodeChannel(out,texels,0u,format==EF_BC4_SNORM_BLOCK,quality);
+			return true;
+		case EF_BC5_UNORM_BLOCK:
+		case EF_BC5_SNORM_BLOCK:
+			encodeChannel(out,texels,0u,format==EF_BC5_SNORM_BLOCK,quality);
+			encodeChannel(out+8u,texels,1u,format==EF_BC5_SNORM_BLOCK,quality);
+			return true;
+		case EF_BC6H_UFLOAT_BLOCK:
+		case EF_BC6H_SFLOAT_BLOCK:
+			encodeBC6H(out,texels,format==EF_BC6H_SFLOAT_BLOCK,quality);
+			return true;
+		case EF_BC7_UNORM_BLOCK:
+		case EF_BC7_SRGB_BLOCK:
+			encodeBC7(out,texels,format==EF_BC7_SRGB_BLOCK,quality);
+			return true;
+		default:
+			break;
+	}
+	return false;
+}
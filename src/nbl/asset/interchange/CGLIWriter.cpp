@@ -205,7 +205,7 @@ bool CGLIWriter::writeGLIFile(system::IFile* file, const asset::ICPUImageView* i
 	};
 
 	const auto& regions = image->getRegions();
-	CBasicImageFilterCommon::executePerRegion<const core::execution::parallel_unsequenced_policy&,decltype(writeTexel),decltype(updateState)>(core::execution::par_unseq,image.get(),writeTexel,regions.begin(),regions.end(),updateState);
+	CBasicImageFilterCommon::executePerRegion<const core::CTaskScheduler::policy_t&,decltype(writeTexel),decltype(updateState)>(core::CTaskScheduler::getDefault()->policy(),image.get(),writeTexel,regions.begin(),regions.end(),updateState);
 
 	return performSavingAsIFile(texture, file, m_system.get(), logger);
 }
@@ -9,6 +9,7 @@
 #include "nbl/asset/IAssetManager.h"
 #include "nbl/asset/utils/CDerivativeMapCreator.h"
 #include "nbl/asset/utils/IMeshManipulator.h"
+#include "nbl/system/CFileView.h"
 
 #include "simdjson/singleheader/simdjson.h"
 #include <algorithm>
@@ -36,6 +37,90 @@ using namespace nbl::asset;
 			_NBL_STATIC_INLINE_CONSTEXPR uint8_t WEIGHTS_ATTRIBUTE_LAYOUT_ID = 5;
 		}
 
+		namespace SEmbeddedData
+		{
+			//! Keeps whatever owns the memory (the mapped file or a copy of its contents) alive while an `ICPUBuffer` aliases it.
+			//! Note that a mapping made for reading is read-only, such buffers must not be written to in-place.
+			class CAliasingAllocator : public core::null_allocator<uint8_t>
+			{
+				public:
+					CAliasingAllocator(core::smart_refctd_ptr<const core::IReferenceCounted>&& _owner) : owner(std::move(_owner)) {}
+
+				private:
+					core::smart_refctd_ptr<const core::IReferenceCounted> owner;
+			};
+
+			static inline core::smart_refctd_ptr<ICPUBuffer> createAlias(const uint8_t* data, const size_t size, core::smart_refctd_ptr<const core::IReferenceCounted>&& owner)
+			{
+				return core::make_smart_refctd_ptr<CCustomAllocatorCPUBuffer<CAliasingAllocator,true>>(size,const_cast<uint8_t*>(data),core::adopt_memory,CAliasingAllocator(std::move(owner)));
+			}
+
+			static inline bool isDataURI(const std::string_view uri)
+			{
+				return uri.substr(0u,5u)=="data:";
+			}
+
+			//! splits a `data:[<mediatype>];base64,<data>` URI, other encodings are not valid for glTF
+			static inline bool parseDataURI(const std::string_view uri, std::string_view& mediaType, std::string_view& payload)
+			{
+				constexpr std::string_view scheme = "data:";
+				constexpr std::string_view base64 = ";base64";
+
+				const auto comma = uri.find(',');
+				if (!isDataURI(uri) || comma==std::string_view::npos)
+					return false;
+				const auto header = uri.substr(scheme.size(),comma-scheme.size());
+				if (header.size()<base64.size() || header.substr(header.size()-base64.size())!=base64)
+					return false;
+				mediaType = header.substr(0u,header.size()-base64.size());
+				payload = uri.substr(comma+1u);
+				return true;
+			}
+
+			static inline core::smart_refctd_ptr<ICPUBuffer> decodeDataURI(const std::string_view uri, std::string_view& mediaType)
+			{
+				std::string_view payload;
+				if (!parseDataURI(uri,mediaType,payload))
+					return nullptr;
+
+				while (!payload.empty() && payload.back()=='=')
+					payload.remove_suffix(1u);
+
+				auto decodeSextet = [](const char c) -> int32_t
+				{
+					if (c>='A' && c<='Z')
+						return c-'A';
+					if (c>='a' && c<='z')
+						return c-'a'+26;
+					if (c>='0' && c<='9')
+						return c-'0'+52;
+					if (c=='+' || c=='-')
+						return 62;
+					if (c=='/' || c=='_')
+						return 63;
+					return -1;
+				};
+
+				auto buffer = core::make_smart_refctd_ptr<ICPUBuffer>((payload.size()*3u)/4u);
+				auto* out = reinterpret_cast<uint8_t*>(buffer->getPointer());
+				uint32_t accumulator = 0u, accumulatedBits = 0u;
+				for (const char c : payload)
+				{
+					const int32_t sextet = decodeSextet(c);
+					if (sextet<0)
+						return nullptr;
+					accumulator = (accumulator<<6u)|uint32_t(sextet);
+					accumulatedBits += 6u;
+					if (accumulatedBits>=8u)
+					{
+						accumulatedBits -= 8u;
+						*(out++) = static_cast<uint8_t>(accumulator>>accumulatedBits);
+					}
+				}
+				return buffer;
+			}
+		}
+
 		/*
 			Each glTF asset must have an asset property. 
 			In fact, it's the only required top-level property
@@ -113,6 +198,15 @@ using namespace nbl::asset;
 		
 		bool CGLTFLoader::isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger) const
 		{
+			if (_file->getSize()>=sizeof(SGLBHeader))
+			{
+				SGLBHeader header;
+				system::IFile::success_t success;
+				_file->read(success, &header, 0u, sizeof(header));
+				if (success && header.magic==SGLBHeader::Magic)
+					return header.version==SGLBHeader::Version;
+			}
+
 			simdjson::dom::parser parser;
 
 			auto jsonBuffer = core::make_smart_refctd_ptr<ICPUBuffer>(_file->getSize());
@@ -155,83 +249,280 @@ using namespace nbl::asset;
 			if(!loadAndGetGLTF(glTF, context))
 				return {};
 
-			core::vector<core::smart_refctd_ptr<ICPUBuffer>> cpuBuffers;
-			for (auto& glTFBuffer : glTF.buffers)
+			// buffers and images don't depend on each other's loads, so they get fetched on the scheduler and joined before anything reads them
+			auto* const scheduler = assetManager->getScheduler();
+			// most of the tasks call into `_override` (and all of them log), a single runner makes `parallel_for` run them one after another on this thread
+			const uint32_t maxConcurrency = _override->allowConcurrentLoads(context.loadContext,_hierarchyLevel) ? 0u:1u;
+
+			core::vector<core::smart_refctd_ptr<ICPUBuffer>> cpuBuffers(glTF.buffers.size());
+			std::atomic_bool bufferLoadFailed = false;
+			scheduler->parallel_for(glTF.buffers.size(),[&](const size_t i) -> void
 			{
-				// FarFuture TODO: handle buffer embedded in glTF
-				auto buffer_bundle = interm_getAssetInHierarchy(assetManager,glTFBuffer.uri.value(),context.loadContext.params,_hierarchyLevel+ICPUMesh::BUFFER_HIERARCHYLEVELS_BELOW,_override);
-				if (buffer_bundle.getContents().empty())
+				auto fail = [&](const char* message) -> void
+				{
+					if (message)
+						context.loadContext.params.logger.log(message,system::ILogger::ELL_ERROR);
+					bufferLoadFailed = true;
+				};
+
+				const auto& glTFBuffer = glTF.buffers[i];
+				auto& cpuBuffer = cpuBuffers[i];
+				// EXT_meshopt_compression fallbacks are never read from, all the views referencing them get decoded below
+				if (glTFBuffer.meshoptFallback && !glTFBuffer.uri.has_value())
+					return;
+				else if (!glTFBuffer.uri.has_value())
+				{
+					// only the first buffer of a GLB may live in its BIN chunk
+					if (i!=0u || !context.glbBinaryChunk)
+						return fail("GLTF: BUFFER WITHOUT URI OUTSIDE OF A GLB BIN CHUNK!");
+					cpuBuffer = context.glbBinaryChunk;
+				}
+				else if (SEmbeddedData::isDataURI(glTFBuffer.uri.value()))
+				{
+					std::string_view mediaType;
+					cpuBuffer = SEmbeddedData::decodeDataURI(glTFBuffer.uri.value(),mediaType);
+					if (!cpuBuffer)
+						return fail("GLTF: COULD NOT DECODE BUFFER DATA URI!");
+				}
+				else
+				{
+					auto buffer_bundle = interm_getAssetInHierarchy(assetManager,glTFBuffer.uri.value(),context.loadContext.params,_hierarchyLevel+ICPUMesh::BUFFER_HIERARCHYLEVELS_BELOW,_override);
+					if (buffer_bundle.getContents().empty())
+						return fail(nullptr);
+
+					cpuBuffer = core::smart_refctd_ptr_static_cast<ICPUBuffer>(buffer_bundle.getContents().begin()[0]);
+				}
+
+				if (glTFBuffer.byteLength.has_value() && cpuBuffer->getSize()<glTFBuffer.byteLength.value())
+					return fail("GLTF: BUFFER IS SMALLER THAN ITS DECLARED BYTE LENGTH!");
+			},maxConcurrency);
+			if (bufferLoadFailed)
+				return {};
+
+			// EXT_meshopt_compression, decode into fresh buffers and redirect the views so accessors never see the compressed data
+			{
+				core::vector<core::smart_refctd_ptr<ICPUBuffer>> decodedBuffers(glTF.bufferViews.size());
+				std::atomic_bool decodeFailed = false;
+				scheduler->parallel_for(glTF.bufferViews.size(),[&](const size_t viewID) -> void
+				{
+					auto fail = [&](const char* message) -> void
+					{
+						context.loadContext.params.logger.log(message,system::ILogger::ELL_ERROR);
+						decodeFailed = true;
+					};
+
+					const auto& glTFBufferView = glTF.bufferViews[viewID];
+					if (!glTFBufferView.meshoptCompression.has_value())
+					{
+						if (glTFBufferView.buffer.has_value() && glTFBufferView.buffer.value()<cpuBuffers.size() && !cpuBuffers[glTFBufferView.buffer.value()])
+							fail("GLTF: UNCOMPRESSED BUFFER VIEW REFERENCES A MESHOPT FALLBACK BUFFER!");
+						return;
+					}
+
+					const auto& compression = glTFBufferView.meshoptCompression.value();
+					if (compression.buffer>=cpuBuffers.size() || !cpuBuffers[compression.buffer] || compression.byteOffset+compression.byteLength>cpuBuffers[compression.buffer]->getSize())
+						return fail("GLTF: MESHOPT COMPRESSED BUFFER VIEW OUT OF BOUNDS!");
+
+					const size_t decodedSize = size_t(compression.count)*compression.byteStride;
+					if (glTFBufferView.byteLength.has_value() && glTFBufferView.byteLength.value()!=decodedSize)
+						return fail("GLTF: MESHOPT COMPRESSED BUFFER VIEW HAS A MISMATCHED BYTE LENGTH!");
+
+					auto decodedBuffer = core::make_smart_refctd_ptr<ICPUBuffer>(decodedSize);
+					const auto* compressedData = reinterpret_cast<const uint8_t*>(cpuBuffers[compression.buffer]->getPointer())+compression.byteOffset;
+					if (!CMeshoptDecoder::decode(decodedBuffer->getPointer(),compression.count,compression.byteStride,compressedData,compression.byteLength,compression.mode,compression.filter))
+						return fail("GLTF: COULD NOT DECODE MESHOPT COMPRESSED BUFFER VIEW!");
+					decodedBuffers[viewID] = std::move(decodedBuffer);
+				},maxConcurrency);
+				if (decodeFailed)
 					return {};
 
-				auto cpuBuffer = core::smart_refctd_ptr_static_cast<ICPUBuffer>(buffer_bundle.getContents().begin()[0]);
-				cpuBuffers.emplace_back() = core::smart_refctd_ptr<ICPUBuffer>(cpuBuffer);
+				for (auto viewID=0u; viewID<glTF.bufferViews.size(); viewID++)
+				{
+					if (!decodedBuffers[viewID])
+						continue;
+
+					auto& glTFBufferView = glTF.bufferViews[viewID];
+					glTFBufferView.buffer = static_cast<uint32_t>(cpuBuffers.size());
+					glTFBufferView.byteOffset = 0u;
+					glTFBufferView.byteLength = decodedBuffers[viewID]->getSize();
+					// indices are tightly packed, only attribute streams carry a stride
+					if (glTFBufferView.meshoptCompression->mode==CMeshoptDecoder::EM_ATTRIBUTES)
+						glTFBufferView.byteStride = glTFBufferView.meshoptCompression->byteStride;
+					cpuBuffers.push_back(std::move(decodedBuffers[viewID]));
+				}
 			}
 
 			const auto imageViewHierarchyLevel = _hierarchyLevel+ICPUMesh::IMAGEVIEW_HIERARCHYLEVELS_BELOW;
 			core::vector<core::smart_refctd_ptr<ICPUImageView>> cpuImageViews;
 			{
-				for (auto& glTFImage : glTF.images)
+				// TODO: factor this out to be common for all PipelineLoaders https://github.com/Devsh-Graphics-Programming/Nabla/issues/270
+				auto resolveImageView = [&](const std::string& cpuImageViewCacheKey, auto loadImage) -> core::smart_refctd_ptr<ICPUImageView>
 				{
-					auto& cpuImageView = cpuImageViews.emplace_back();
-
-					// FarFuture TODO: handle image embedded in glTF 
-					// TODO: factor this out to be common for all PipelineLoaders https://github.com/Devsh-Graphics-Programming/Nabla/issues/270
-					if (glTFImage.uri.has_value())
+					const IAsset::E_TYPE types[]{ IAsset::ET_IMAGE_VIEW, static_cast<IAsset::E_TYPE>(0u) };
+					// other threads (also ones loading other glTF files) may want the same view right now, only one of them gets to create and cache it
+					auto bundle = interm_findOrCreateCachedAsset(assetManager,cpuImageViewCacheKey,types,context.loadContext,imageViewHierarchyLevel,_override,[&]() -> SAssetBundle
 					{
-						// TODO: THIS IS AN ABSOLUTELY WRONG CACHE PRE-PATH KEY TO USE!
-						const std::string cpuImageViewCacheKey = getImageViewCacheKey(glTFImage.uri.value());
+						auto image_bundle = loadImage();
+						if (image_bundle.getContents().empty())
+							return {};
+
+						auto cpuAsset = image_bundle.getContents().begin()[0];
 
-						cpuImageView = _override->findDefaultAsset<ICPUImageView>(cpuImageViewCacheKey,context.loadContext,imageViewHierarchyLevel).first;
-						if (!cpuImageView)
+						core::smart_refctd_ptr<ICPUImageView> cpuImageView;
+						switch (cpuAsset->getAssetType())
 						{
-							auto image_bundle = interm_getAssetInHierarchy(assetManager,glTFImage.uri.value(),context.loadContext.params,imageViewHierarchyLevel,_override);
-							if (image_bundle.getContents().empty())
+							case IAsset::ET_IMAGE:
+							{
+								ICPUImageView::SCreationParams viewParams;
+								viewParams.flags = static_cast<ICPUImageView::E_CREATE_FLAGS>(0u);
+								viewParams.image = core::smart_refctd_ptr_static_cast<asset::ICPUImage>(cpuAsset);
+								viewParams.format = viewParams.image->getCreationParameters().format;
+								viewParams.viewType = IImageView<ICPUImage>::ET_2D;
+								viewParams.subresourceRange.baseArrayLayer = 0u;
+								viewParams.subresourceRange.layerCount = 1u;
+								viewParams.subresourceRange.baseMipLevel = 0u;
+								viewParams.subresourceRange.levelCount = 1u;
+
+								cpuImageView = ICPUImageView::create(std::move(viewParams));
+							} break;
+
+							case IAsset::ET_IMAGE_VIEW:
+							{
+								cpuImageView = core::smart_refctd_ptr_static_cast<asset::ICPUImageView>(cpuAsset);
+							} break;
+
+							default:
+							{
+								context.loadContext.params.logger.log("GLTF: EXPECTED IMAGE ASSET TYPE!",system::ILogger::ELL_ERROR);
 								return {};
+							}
+						}
 
-							auto cpuAsset = image_bundle.getContents().begin()[0];
+						// TODO: this is wrong, it adds a loaded image view (the second switch case) to the cache again, move this insertion to the first switch case
+						SAssetBundle samplerBundle = SAssetBundle(nullptr, { core::smart_refctd_ptr(cpuImageView) });
+						_override->insertAssetIntoCache(samplerBundle,cpuImageViewCacheKey,context.loadContext,imageViewHierarchyLevel);
+						return samplerBundle;
+					});
+					return core::smart_refctd_ptr_static_cast<ICPUImageView>(_override->chooseDefaultAsset(bundle,context.loadContext));
+				};
 
-							switch (cpuAsset->getAssetType())
-							{
-								case IAsset::ET_IMAGE:
-								{
-									ICPUImageView::SCreationParams viewParams;
-									viewParams.flags = static_cast<ICPUImageView::E_CREATE_FLAGS>(0u);
-									viewParams.image = core::smart_refctd_ptr_static_cast<asset::ICPUImage>(cpuAsset);
-									viewParams.format = viewParams.image->getCreationParameters().format;
-									viewParams.viewType = IImageView<ICPUImage>::ET_2D;
-									viewParams.subresourceRange.baseArrayLayer = 0u;
-									viewParams.subresourceRange.layerCount = 1u;
-									viewParams.subresourceRange.baseMipLevel = 0u;
-									viewParams.subresourceRange.levelCount = 1u;
-
-									cpuImageView = ICPUImageView::create(std::move(viewParams));
-								} break;
+				// cheap first pass working out the cache keys, images sharing a key get resolved once
+				struct SImageSource
+				{
+					std::string cacheKey;
+					//! embedded images get loaded from a view of their bytes named like this
+					std::string imageName;
+				};
+				core::vector<SImageSource> imageSources(glTF.images.size());
+				core::vector<uint32_t> imageSlots(glTF.images.size());
+				core::vector<uint32_t> slotImageIDs;
+				{
+					core::unordered_map<std::string,uint32_t> keyToSlot;
+					for (auto imageID=0u; imageID<glTF.images.size(); imageID++)
+					{
+						const auto& glTFImage = glTF.images[imageID];
+						auto& source = imageSources[imageID];
+						if (glTFImage.uri.has_value() && !SEmbeddedData::isDataURI(glTFImage.uri.value()))
+						{
+							// TODO: THIS IS AN ABSOLUTELY WRONG CACHE PRE-PATH KEY TO USE!
+							source.cacheKey = getImageViewCacheKey(glTFImage.uri.value());
+						}
+						else
+						{
+							std::string_view mimeType = glTFImage.mimeType.has_value() ? std::string_view(glTFImage.mimeType.value()):std::string_view();
+							std::string_view uriMediaType, payload;
+							if (mimeType.empty() && glTFImage.uri.has_value() && SEmbeddedData::parseDataURI(glTFImage.uri.value(),uriMediaType,payload))
+								mimeType = uriMediaType;
+
+							// the extension only decides which loader gets asked first
+							source.imageName = _file->getFileName().string()+"/images/"+std::to_string(imageID);
+							if (mimeType==SGLTF::SGLTFImage::SMIMEType::PNG)
+								source.imageName += ".png";
+							else if (mimeType==SGLTF::SGLTFImage::SMIMEType::JPEG)
+								source.imageName += ".jpg";
+							source.cacheKey = getImageViewCacheKey(source.imageName);
+						}
 
-								case IAsset::ET_IMAGE_VIEW:
-								{
-									cpuImageView = core::smart_refctd_ptr_static_cast<asset::ICPUImageView>(cpuAsset);
-								} break;
+						const auto found = keyToSlot.try_emplace(source.cacheKey,static_cast<uint32_t>(slotImageIDs.size()));
+						if (found.second)
+							slotImageIDs.push_back(imageID);
+						imageSlots[imageID] = found.first->second;
+					}
+				}
 
-								default:
-								{
-									context.loadContext.params.logger.log("GLTF: EXPECTED IMAGE ASSET TYPE!",system::ILogger::ELL_ERROR);
-									return {};
-								}
-							}
+				// the decodes are the expensive part of loading a glTF, so every distinct image gets its own task
+				core::vector<core::smart_refctd_ptr<ICPUImageView>> slotImageViews(slotImageIDs.size());
+				scheduler->parallel_for(slotImageIDs.size(),[&](const size_t slot) -> void
+				{
+					const auto imageID = slotImageIDs[slot];
+					const auto& glTFImage = glTF.images[imageID];
+					const auto& source = imageSources[imageID];
+					auto& cpuImageView = slotImageViews[slot];
 
-							// TODO: this is wrong, it adds a loaded image view (the second switch case) to the cache again, move this insertion to the first switch case
-							SAssetBundle samplerBundle = SAssetBundle(nullptr, { core::smart_refctd_ptr(cpuImageView) });
-							_override->insertAssetIntoCache(samplerBundle,cpuImageViewCacheKey,context.loadContext,imageViewHierarchyLevel);
-						}	
+					if (source.imageName.empty())
+					{
+						cpuImageView = resolveImageView(source.cacheKey,[&]() -> SAssetBundle
+						{
+							return interm_getAssetInHierarchy(assetManager,glTFImage.uri.value(),context.loadContext.params,imageViewHierarchyLevel,_override);
+						});
+						return;
+					}
+
+					// embedded image, either in a buffer view (usually backed by the GLB BIN chunk) or a base64 data URI
+					core::smart_refctd_ptr<ICPUBuffer> dataURIBuffer;
+					const uint8_t* imageData = nullptr;
+					size_t imageSize = 0u;
+					if (glTFImage.uri.has_value())
+					{
+						std::string_view uriMediaType;
+						dataURIBuffer = SEmbeddedData::decodeDataURI(glTFImage.uri.value(),uriMediaType);
+						if (!dataURIBuffer)
+						{
+							context.loadContext.params.logger.log("GLTF: COULD NOT DECODE IMAGE DATA URI!",system::ILogger::ELL_ERROR);
+							return;
+						}
+						imageData = reinterpret_cast<const uint8_t*>(dataURIBuffer->getPointer());
+						imageSize = dataURIBuffer->getSize();
 					}
 					else
 					{
-						if (!glTFImage.mimeType.has_value() || !glTFImage.bufferView.has_value())
-							return {};
-						
-						_NBL_DEBUG_BREAK_IF(true);
-						return {}; // TODO FUTURE: load image where it's data is embeded in memory
+						if (!glTFImage.bufferView.has_value() || glTFImage.bufferView.value()>=glTF.bufferViews.size())
+						{
+							context.loadContext.params.logger.log("GLTF: IMAGE WITHOUT A VALID URI OR BUFFER VIEW!",system::ILogger::ELL_ERROR);
+							return;
+						}
+						const auto& glTFBufferView = glTF.bufferViews[glTFImage.bufferView.value()];
+						if (!glTFBufferView.buffer.has_value() || glTFBufferView.buffer.value()>=cpuBuffers.size() || !glTFBufferView.byteLength.has_value())
+						{
+							context.loadContext.params.logger.log("GLTF: IMAGE BUFFER VIEW IS INVALID!",system::ILogger::ELL_ERROR);
+							return;
+						}
+
+						const auto& cpuBuffer = cpuBuffers[glTFBufferView.buffer.value()];
+						const size_t bufferViewOffset = glTFBufferView.byteOffset.has_value() ? glTFBufferView.byteOffset.value() : 0u;
+						imageSize = glTFBufferView.byteLength.value();
+						if (bufferViewOffset+imageSize>cpuBuffer->getSize())
+						{
+							context.loadContext.params.logger.log("GLTF: IMAGE BUFFER VIEW OUT OF BOUNDS!",system::ILogger::ELL_ERROR);
+							return;
+						}
+						imageData = reinterpret_cast<const uint8_t*>(cpuBuffer->getPointer())+bufferViewOffset;
 					}
+
+					cpuImageView = resolveImageView(source.cacheKey,[&]() -> SAssetBundle
+					{
+						// the view doesn't own the bytes, they're kept alive by `cpuBuffers` or `dataURIBuffer` until we're done
+						auto imageFile = core::make_smart_refctd_ptr<system::CFileView<system::CNullAllocator>>(system::path(source.imageName),system::IFile::ECF_READ,const_cast<uint8_t*>(imageData),imageSize);
+						return interm_getAssetInHierarchy(assetManager,imageFile.get(),source.imageName,context.loadContext.params,imageViewHierarchyLevel,_override);
+					});
+				},maxConcurrency);
+
+				cpuImageViews.resize(glTF.images.size());
+				for (auto imageID=0u; imageID<glTF.images.size(); imageID++)
+				{
+					auto& cpuImageView = cpuImageViews[imageID] = slotImageViews[imageSlots[imageID]];
+					if (!cpuImageView)
+						return {};
 				}
 			}
 			
@@ -710,7 +1001,10 @@ using namespace nbl::asset;
 
 							auto handleAccessor = [&](SGLTF::SGLTFAccessor& glTFAccessor, const std::optional<uint32_t> queryAttributeId = {}) -> bool
 							{
-								const E_FORMAT format = SGLTF::SGLTFAccessor::getFormat(glTFAccessor.componentType.value(), glTFAccessor.type.value());
+								const bool normalized = glTFAccessor.normalized.has_value() && glTFAccessor.normalized.value();
+								const E_FORMAT format = queryAttributeId.has_value() ?
+									SGLTF::SGLTFAccessor::getVertexFormat(glTFAccessor.componentType.value(), glTFAccessor.type.value(), normalized):
+									SGLTF::SGLTFAccessor::getFormat(glTFAccessor.componentType.value(), glTFAccessor.type.value());
 								if (format == EF_UNKNOWN)
 								{
 									context.loadContext.params.logger.log("GLTF: COULD NOT SPECIFY NABLA FORMAT!",system::ILogger::ELL_ERROR);
@@ -1658,15 +1952,88 @@ using namespace nbl::asset;
 			simdjson::dom::parser parser;
 			auto* _file = context.loadContext.mainFile;
 
-			auto jsonBuffer = core::make_smart_refctd_ptr<ICPUBuffer>(_file->getSize());
+			SGLBHeader glbHeader = {};
+			if (_file->getSize()>=sizeof(SGLBHeader))
+			{
+				system::IFile::success_t success;
+				_file->read(success, &glbHeader, 0u, sizeof(glbHeader));
+				if (!success)
+					return false;
+			}
+
+			core::smart_refctd_ptr<ICPUBuffer> jsonBuffer;
+			if (glbHeader.magic==SGLBHeader::Magic)
+			{
+				if (glbHeader.version!=SGLBHeader::Version || glbHeader.length>_file->getSize())
+				{
+					context.loadContext.params.logger.log("GLTF: UNSUPPORTED OR TRUNCATED GLB CONTAINER!",system::ILogger::ELL_ERROR);
+					return false;
+				}
+
+				// map the whole container once, the BIN chunk gets aliased by the buffers instead of copied
+				core::smart_refctd_ptr<const core::IReferenceCounted> fileOwner;
+				const uint8_t* fileData = reinterpret_cast<const uint8_t*>(static_cast<const system::IFile*>(_file)->getMappedPointer());
+				if (fileData)
+					fileOwner = core::smart_refctd_ptr<const system::IFile>(_file);
+				else
+				{
+					// the asset manager doesn't open files as mappable
+					system::ISystem::future_t<core::smart_refctd_ptr<system::IFile>> future;
+					assetManager->getSystem()->createFile(future, _file->getFileName(), core::bitflag(system::IFileBase::ECF_READ) | system::IFileBase::ECF_MAPPABLE);
+					if (future.wait())
+					if (auto mappedFile=future.copy(); mappedFile && mappedFile->getSize()==_file->getSize())
+					{
+						fileData = reinterpret_cast<const uint8_t*>(static_cast<const system::IFile*>(mappedFile.get())->getMappedPointer());
+						fileOwner = std::move(mappedFile);
+					}
+				}
+				if (!fileData)
+				{
+					// not a real file on disk, fall back to reading it in once
+					auto fileContents = core::make_smart_refctd_ptr<ICPUBuffer>(glbHeader.length);
+					system::IFile::success_t success;
+					_file->read(success, fileContents->getPointer(), 0u, fileContents->getSize());
+					if (!success)
+						return false;
+					fileData = reinterpret_cast<const uint8_t*>(fileContents->getPointer());
+					fileOwner = std::move(fileContents);
+				}
+
+				// unknown chunk types must be skipped, the first JSON and BIN chunks are the ones that count
+				for (size_t offset=sizeof(SGLBHeader); offset+sizeof(SGLBChunkHeader)<=glbHeader.length;)
+				{
+					SGLBChunkHeader chunkHeader;
+					memcpy(&chunkHeader, fileData+offset, sizeof(chunkHeader));
+					offset += sizeof(chunkHeader);
+					if (offset+chunkHeader.length>glbHeader.length)
+					{
+						context.loadContext.params.logger.log("GLTF: GLB CHUNK OUT OF BOUNDS!",system::ILogger::ELL_ERROR);
+						return false;
+					}
+
+					if (chunkHeader.type==SGLBChunkHeader::JSON && !jsonBuffer)
+						jsonBuffer = SEmbeddedData::createAlias(fileData+offset, chunkHeader.length, core::smart_refctd_ptr(fileOwner));
+					else if (chunkHeader.type==SGLBChunkHeader::BIN && !context.glbBinaryChunk)
+						context.glbBinaryChunk = SEmbeddedData::createAlias(fileData+offset, chunkHeader.length, core::smart_refctd_ptr(fileOwner));
+					offset += chunkHeader.length;
+				}
+
+				if (!jsonBuffer)
+				{
+					context.loadContext.params.logger.log("GLTF: GLB CONTAINER HAS NO JSON CHUNK!",system::ILogger::ELL_ERROR);
+					return false;
+				}
+			}
+			else
 			{
+				jsonBuffer = core::make_smart_refctd_ptr<ICPUBuffer>(_file->getSize());
 				system::IFile::success_t success;
 				_file->read(success, jsonBuffer->getPointer(), 0u, jsonBuffer->getSize());
 				if (!success)
 					return false;
 			}
 
-			simdjson::dom::object tweets = parser.parse(reinterpret_cast<uint8_t*>(jsonBuffer->getPointer()), jsonBuffer->getSize());
+			simdjson::dom::object tweets = parser.parse(reinterpret_cast<const uint8_t*>(jsonBuffer->getPointer()), jsonBuffer->getSize());
 			simdjson::dom::element element;
 
 			//std::filesystem::path filePath(_file->getFileName().c_str());
@@ -1717,6 +2084,7 @@ using namespace nbl::asset;
 					auto& glTFBuffer = glTF.buffers.emplace_back();
 
 					const auto& uri = jsonBuffer.at_key("uri");
+					const auto& byteLength = jsonBuffer.at_key("byteLength");
 					const auto& name = jsonBuffer.at_key("name");
 					const auto& extensions = jsonBuffer.at_key("extensions");
 					const auto& extras = jsonBuffer.at_key("extras");
@@ -1724,8 +2092,22 @@ using namespace nbl::asset;
 					if (uri.error() != simdjson::error_code::NO_SUCH_FIELD)
 						glTFBuffer.uri = uri.get_string().value().data();
 
+					if (byteLength.error() != simdjson::error_code::NO_SUCH_FIELD)
+						glTFBuffer.byteLength = static_cast<uint32_t>(byteLength.get_uint64().value());
+
 					if (name.error() != simdjson::error_code::NO_SUCH_FIELD)
 						glTFBuffer.name = name.get_string().value();
+
+					if (extensions.error() != simdjson::error_code::NO_SUCH_FIELD)
+					{
+						const auto& meshoptCompression = extensions.at_key("EXT_meshopt_compression");
+						if (meshoptCompression.error() != simdjson::error_code::NO_SUCH_FIELD)
+						{
+							const auto& fallback = meshoptCompression.at_key("fallback");
+							if (fallback.error() != simdjson::error_code::NO_SUCH_FIELD)
+								glTFBuffer.meshoptFallback = fallback.get_bool().value();
+						}
+					}
 				}
 			}
 
@@ -1762,6 +2144,55 @@ using namespace nbl::asset;
 
 					if (name.error() != simdjson::error_code::NO_SUCH_FIELD)
 						glTFBufferView.name = name.get_string().value();
+
+					if (extensions.error() != simdjson::error_code::NO_SUCH_FIELD)
+					{
+						const auto& meshoptCompression = extensions.at_key("EXT_meshopt_compression");
+						if (meshoptCompression.error() != simdjson::error_code::NO_SUCH_FIELD)
+						{
+							const auto& compressedBuffer = meshoptCompression.at_key("buffer");
+							const auto& compressedByteOffset = meshoptCompression.at_key("byteOffset");
+							const auto& compressedByteLength = meshoptCompression.at_key("byteLength");
+							const auto& compressedByteStride = meshoptCompression.at_key("byteStride");
+							const auto& compressedCount = meshoptCompression.at_key("count");
+							const auto& compressedMode = meshoptCompression.at_key("mode");
+							const auto& compressedFilter = meshoptCompression.at_key("filter");
+
+							// all but `byteOffset` and `filter` are required, an incomplete extension object is ignored and fails later on the fallback buffer
+							const bool complete = compressedBuffer.error() != simdjson::error_code::NO_SUCH_FIELD && compressedByteLength.error() != simdjson::error_code::NO_SUCH_FIELD &&
+								compressedByteStride.error() != simdjson::error_code::NO_SUCH_FIELD && compressedCount.error() != simdjson::error_code::NO_SUCH_FIELD &&
+								compressedMode.error() != simdjson::error_code::NO_SUCH_FIELD;
+							if (complete)
+							{
+								auto& compression = glTFBufferView.meshoptCompression.emplace();
+								compression.buffer = static_cast<uint32_t>(compressedBuffer.get_uint64().value());
+								if (compressedByteOffset.error() != simdjson::error_code::NO_SUCH_FIELD)
+									compression.byteOffset = compressedByteOffset.get_uint64().value();
+								compression.byteLength = compressedByteLength.get_uint64().value();
+								compression.byteStride = static_cast<uint32_t>(compressedByteStride.get_uint64().value());
+								compression.count = static_cast<uint32_t>(compressedCount.get_uint64().value());
+
+								const std::string_view mode = compressedMode.get_string().value();
+								if (mode == "TRIANGLES")
+									compression.mode = CMeshoptDecoder::EM_TRIANGLES;
+								else if (mode == "INDICES")
+									compression.mode = CMeshoptDecoder::EM_INDICES;
+								else
+									compression.mode = CMeshoptDecoder::EM_ATTRIBUTES;
+
+								if (compressedFilter.error() != simdjson::error_code::NO_SUCH_FIELD)
+								{
+									const std::string_view filter = compressedFilter.get_string().value();
+									if (filter == "OCTAHEDRAL")
+										compression.filter = CMeshoptDecoder::EFT_OCTAHEDRAL;
+									else if (filter == "QUATERNION")
+										compression.filter = CMeshoptDecoder::EFT_QUATERNION;
+									else if (filter == "EXPONENTIAL")
+										compression.filter = CMeshoptDecoder::EFT_EXPONENTIAL;
+								}
+							}
+						}
+					}
 				}
 			}
 
@@ -1783,10 +2214,10 @@ using namespace nbl::asset;
 						glTFImage.uri = uri.get_string().value();
 
 					if (mimeType.error() != simdjson::error_code::NO_SUCH_FIELD)
-						glTFImage.mimeType = uri.get_string().value();
+						glTFImage.mimeType = mimeType.get_string().value();
 
 					if (bufferViewId.error() != simdjson::error_code::NO_SUCH_FIELD)
-						glTFImage.bufferView = uri.get_uint64().value();
+						glTFImage.bufferView = bufferViewId.get_uint64().value();
 
 					if (name.error() != simdjson::error_code::NO_SUCH_FIELD)
 						glTFImage.name = name.get_string().value();
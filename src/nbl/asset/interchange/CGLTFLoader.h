@@ -14,11 +14,12 @@
 #include "nbl/asset/interchange/IAssetLoader.h"
 #include "nbl/asset/interchange/IRenderpassIndependentPipelineLoader.h"
 #include "nbl/asset/metadata/CGLTFMetadata.h"
+#include "nbl/asset/utils/CMeshoptDecoder.h"
 
 namespace nbl::asset
 {
 
-//! glTF Loader capable of loading .gltf files
+//! glTF Loader capable of loading .gltf files and binary .glb containers
 /*
 	glTF bridges the gap between 3D content creation tools and modern 3D applications 
 	by providing an efficient, extensible, interoperable format for the transmission and loading of 3D content.
@@ -32,7 +33,7 @@ class CGLTFLoader final : public IRenderpassIndependentPipelineLoader
 
 		const char** getAssociatedFileExtensions() const override
 		{
-			static const char* extensions[]{ "gltf", nullptr };
+			static const char* extensions[]{ "gltf", "glb", nullptr };
 			return extensions;
 		}
 
@@ -57,6 +58,27 @@ class CGLTFLoader final : public IRenderpassIndependentPipelineLoader
 			SAssetLoadContext loadContext;
 			asset::IAssetLoader::IAssetLoaderOverride* loaderOverride;
 			uint32_t hierarchyLevel;
+			//! BIN chunk of a GLB container, aliases the mapped file so accessors reference it without copies
+			core::smart_refctd_ptr<ICPUBuffer> glbBinaryChunk;
+		};
+
+		//! Binary glTF container, a 12 byte header followed by a JSON chunk and an optional BIN chunk
+		struct SGLBHeader
+		{
+			_NBL_STATIC_INLINE_CONSTEXPR uint32_t Magic = 0x46546C67u; // "glTF"
+			_NBL_STATIC_INLINE_CONSTEXPR uint32_t Version = 2u;
+
+			uint32_t magic;
+			uint32_t version;
+			uint32_t length;
+		};
+		struct SGLBChunkHeader
+		{
+			_NBL_STATIC_INLINE_CONSTEXPR uint32_t JSON = 0x4E4F534Au;
+			_NBL_STATIC_INLINE_CONSTEXPR uint32_t BIN = 0x004E4942u;
+
+			uint32_t length;
+			uint32_t type;
 		};
 
 	private:
@@ -483,6 +505,61 @@ class CGLTFLoader final : public IRenderpassIndependentPipelineLoader
 					}
 					return EF_UNKNOWN;
 				}
+
+				//! Vertex attribute variant of `getFormat`, integer components are fetched as floats (KHR_mesh_quantization) so they can stay quantized in memory
+				static inline E_FORMAT getVertexFormat(SCompomentType componentType, SGLTFType type, bool normalized)
+				{
+					uint32_t componentCount;
+					switch (type)
+					{
+						case SGLTF::SGLTFAccessor::SGLTFT_SCALAR:
+							componentCount = 1u;
+							break;
+						case SGLTF::SGLTFAccessor::SGLTFT_VEC2:
+							componentCount = 2u;
+							break;
+						case SGLTF::SGLTFAccessor::SGLTFT_VEC3:
+							componentCount = 3u;
+							break;
+						case SGLTF::SGLTFAccessor::SGLTFT_VEC4:
+							componentCount = 4u;
+							break;
+						default:
+							return getFormat(componentType, type);
+					}
+
+					constexpr E_FORMAT byteFormats[2][4] = {
+						{ EF_R8_SSCALED, EF_R8G8_SSCALED, EF_R8G8B8_SSCALED, EF_R8G8B8A8_SSCALED },
+						{ EF_R8_SNORM, EF_R8G8_SNORM, EF_R8G8B8_SNORM, EF_R8G8B8A8_SNORM }
+					};
+					constexpr E_FORMAT ubyteFormats[2][4] = {
+						{ EF_R8_USCALED, EF_R8G8_USCALED, EF_R8G8B8_USCALED, EF_R8G8B8A8_USCALED },
+						{ EF_R8_UNORM, EF_R8G8_UNORM, EF_R8G8B8_UNORM, EF_R8G8B8A8_UNORM }
+					};
+					constexpr E_FORMAT shortFormats[2][4] = {
+						{ EF_R16_SSCALED, EF_R16G16_SSCALED, EF_R16G16B16_SSCALED, EF_R16G16B16A16_SSCALED },
+						{ EF_R16_SNORM, EF_R16G16_SNORM, EF_R16G16B16_SNORM, EF_R16G16B16A16_SNORM }
+					};
+					constexpr E_FORMAT ushortFormats[2][4] = {
+						{ EF_R16_USCALED, EF_R16G16_USCALED, EF_R16G16B16_USCALED, EF_R16G16B16A16_USCALED },
+						{ EF_R16_UNORM, EF_R16G16_UNORM, EF_R16G16B16_UNORM, EF_R16G16B16A16_UNORM }
+					};
+
+					switch (componentType)
+					{
+						case SGLTF::SGLTFAccessor::SCT_BYTE:
+							return byteFormats[normalized][componentCount - 1u];
+						case SGLTF::SGLTFAccessor::SCT_UNSIGNED_BYTE:
+							return ubyteFormats[normalized][componentCount - 1u];
+						case SGLTF::SGLTFAccessor::SCT_SHORT:
+							return shortFormats[normalized][componentCount - 1u];
+						case SGLTF::SGLTFAccessor::SCT_UNSIGNED_SHORT:
+							return ushortFormats[normalized][componentCount - 1u];
+						default:
+							break;
+					}
+					return getFormat(componentType, type);
+				}
 			};
 
 			struct SGLTFBuffer
@@ -490,12 +567,12 @@ class CGLTFLoader final : public IRenderpassIndependentPipelineLoader
 				std::optional<std::string> uri;
 				std::optional<uint32_t> byteLength;
 				std::optional<std::string> name;
+				//! EXT_meshopt_compression, the buffer only exists for loaders without the extension and may have no `uri`
+				bool meshoptFallback = false;
 
 				bool validate()
 				{
-					if (!uri.has_value())
-						return false;
-
+					// only the buffer stored in the BIN chunk of a GLB or a meshopt fallback may omit the `uri`
 					if (!byteLength.has_value())
 						return false;
 					else
@@ -515,6 +592,19 @@ class CGLTFLoader final : public IRenderpassIndependentPipelineLoader
 				std::optional<uint32_t> target;
 				std::optional<std::string> name;
 
+				//! EXT_meshopt_compression, once decoded the view gets redirected to the uncompressed data
+				struct SMeshoptCompression
+				{
+					uint32_t buffer;
+					size_t byteOffset = 0u;
+					size_t byteLength;
+					uint32_t byteStride;
+					uint32_t count;
+					CMeshoptDecoder::E_MODE mode;
+					CMeshoptDecoder::E_FILTER filter = CMeshoptDecoder::EFT_NONE;
+				};
+				std::optional<SMeshoptCompression> meshoptCompression;
+
 				enum SGLTFTarget
 				{
 					SGLTFT_ARRAY_BUFFER = 34962,
@@ -548,7 +638,10 @@ class CGLTFLoader final : public IRenderpassIndependentPipelineLoader
 
 				bool validate()
 				{
-					if (!uri.has_value() || (mimeType.has_value() && !bufferView.has_value()))
+					if (uri.has_value() == bufferView.has_value())
+						return false;
+
+					if (bufferView.has_value() && !mimeType.has_value())
 						return false;
 
 					return true;
@@ -532,22 +532,28 @@ CGraphicsPipelineLoaderMTL::image_views_set_t CGraphicsPipelineLoaderMTL::loadIm
     images_set_t images;
     image_views_set_t views;
 
+    // issue all the loads first, so the images decode concurrently
+    std::array<core::CTaskScheduler::future_t<SAssetBundle>,CMTLMetadata::CRenderpassIndependentPipeline::EMP_COUNT> bundles;
     for (uint32_t i = 0u; i < images.size(); ++i)
     {
         SAssetLoadParams lp = _ctx.inner.params;
         if (_mtl.maps[i].size() )
         {
             const uint32_t hierarchyLevel = _ctx.topHierarchyLevel + ICPURenderpassIndependentPipeline::IMAGE_HIERARCHYLEVELS_BELOW; // this is weird actually, we're not sure if we're loading image or image view
-            SAssetBundle bundle;
-            if (i != CMTLMetadata::CRenderpassIndependentPipeline::EMP_BUMP)
-                bundle = interm_getAssetInHierarchy(m_assetMgr, _mtl.maps[i], lp, hierarchyLevel, _ctx.loaderOverride);
-            else // TODO: you should attempt to get derivative map FIRST, then restore and regenerate! (right now you're always restoring!)
+            if (i == CMTLMetadata::CRenderpassIndependentPipeline::EMP_BUMP) // TODO: you should attempt to get derivative map FIRST, then restore and regenerate! (right now you're always restoring!)
             {
                 // we need bumpmap restored to create derivative map from it
                 const uint32_t restoreLevels = 3u; // 2 in case of image (image, texel buffer) and 3 in case of image view (view, image, texel buffer)
                 lp.restoreLevels = std::max(lp.restoreLevels, hierarchyLevel + restoreLevels);
-                bundle = interm_getAssetInHierarchy(m_assetMgr, _mtl.maps[i], lp, hierarchyLevel, _ctx.loaderOverride);
             }
+            bundles[i] = interm_getAssetInHierarchyAsync(m_assetMgr, _mtl.maps[i], lp, hierarchyLevel, _ctx.loaderOverride);
+        }
+    }
+    for (uint32_t i = 0u; i < images.size(); ++i)
+    {
+        if (bundles[i].valid())
+        {
+            const SAssetBundle& bundle = bundles[i].get();
             auto asset = _ctx.loaderOverride->chooseDefaultAsset(bundle,_ctx.inner);
             if (asset)
             switch (bundle.getAssetType())
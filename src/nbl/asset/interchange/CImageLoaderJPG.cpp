@@ -173,14 +173,23 @@ asset::SAssetBundle CImageLoaderJPG::loadAsset(system::IFile* _file, const asset
 	if (!_file || _file->getSize()>0xffffffffull)
         return {};
 
-	const std::filesystem::path& Filename = _file->getFileName();
+	const std::string filename = _file->getFileName().string();
 
-	uint8_t* input = new uint8_t[_file->getSize()];
-
-	system::IFile::success_t success;
-	_file->read(success, input, 0, _file->getSize());
-	if (!success)
-		return {};
+	// decode straight from the mapping when there is one
+	const auto* input = reinterpret_cast<const uint8_t*>(static_cast<const system::IFile*>(_file)->getMappedPointer());
+	core::vector<uint8_t> fileContents;
+	if (!input)
+	{
+		fileContents.resize(_file->getSize());
+		system::IFile::success_t success;
+		_file->read(success, fileContents.data(), 0, _file->getSize());
+		if (!success)
+			return {};
+		input = fileContents.data();
+	}
+	// declared before the `setjmp` so the `longjmp` doesn't skip their destructors
+	core::vector<uint8_t*> rowPtr;
+	core::vector<uint8_t> skippedRow;
 
 	// allocate and initialize JPEG decompression object
 	struct jpeg_decompress_struct cinfo;
@@ -191,7 +200,7 @@ asset::SAssetBundle CImageLoaderJPG::loadAsset(system::IFile* _file, const asset
 	//This routine fills in the contents of struct jerr, and returns jerr's
 	//address which we place into the link field in cinfo.
 	SContext ctx;
-	ctx.filename = const_cast<char*>(Filename.string().c_str());
+	ctx.filename = const_cast<char*>(filename.c_str());
 	ctx.logger = _params.logger;
 	cinfo.err = jpeg_std_error(&jerr.pub);
 	cinfo.err->error_exit = jpeg::error_exit;
@@ -201,7 +210,6 @@ asset::SAssetBundle CImageLoaderJPG::loadAsset(system::IFile* _file, const asset
 
 	auto exitRoutine = [&] {
 		jpeg_destroy_decompress(&cinfo);
-		delete[] input;
 	};
 	auto exiter = core::makeRAIIExiter(exitRoutine);
 	// compatibility fudge:
@@ -222,7 +230,7 @@ asset::SAssetBundle CImageLoaderJPG::loadAsset(system::IFile* _file, const asset
 
 	// Set up data pointer
 	jsrc.bytes_in_buffer = _file->getSize();
-	jsrc.next_input_byte = (JOCTET*)input;
+	jsrc.next_input_byte = (const JOCTET*)input;
 	cinfo.src = &jsrc;
 
 	jsrc.init_source = jpeg::init_source;
@@ -239,14 +247,40 @@ asset::SAssetBundle CImageLoaderJPG::loadAsset(system::IFile* _file, const asset
 	// read _file parameters with jpeg_read_header()
 	jpeg_read_header(&cinfo, TRUE);
 
-    uint32_t imageSize[3] = { cinfo.image_width,cinfo.image_height,1 };
-    const uint32_t& width = imageSize[0];
-    const uint32_t& height = imageSize[1];
+	// the requested part of the image, in texels of the full resolution
+	const auto& subset = _params.imageSubset;
+	uint32_t rect[4] = { 0u,0u,cinfo.image_width,cinfo.image_height };
+	if (subset.extent[0] && subset.extent[1])
+	{
+		if (subset.offset[0]+subset.extent[0]>cinfo.image_width || subset.offset[1]+subset.extent[1]>cinfo.image_height)
+		{
+			_params.logger.log("LOAD JPG: requested rectangle is out of bounds of %s", system::ILogger::ELL_ERROR, filename.c_str());
+			return {};
+		}
+		rect[0] = subset.offset[0];
+		rect[1] = subset.offset[1];
+		rect[2] = subset.extent[0];
+		rect[3] = subset.extent[1];
+	}
+	// DCT scaling makes the decoder skip most of the work for the discarded texels, it goes down to 1/8
+	uint32_t scaleDenom = 1u;
+	if (subset.maxExtent)
+	{
+		auto fits = [&]() -> bool
+		{
+			using subset_t = IAssetLoader::SAssetLoadParams::SImageSubset;
+			return core::max(subset_t::scaledExtent(rect[0],rect[2],scaleDenom),subset_t::scaledExtent(rect[1],rect[3],scaleDenom))<=subset.maxExtent;
+		};
+		while (scaleDenom<8u && !fits())
+			scaleDenom <<= 1u;
+		if (!fits())
+			_params.logger.log("LOAD JPG: can't downscale %s by more than 8 to fit into %u texels", system::ILogger::ELL_WARNING, filename.c_str(), subset.maxExtent);
+	}
+	cinfo.scale_num = 1u;
+	cinfo.scale_denom = scaleDenom;
 
     ICPUImage::SCreationParams imgInfo;
     imgInfo.type = ICPUImage::ET_2D;
-    imgInfo.extent.width = width;
-    imgInfo.extent.height = height;
     imgInfo.extent.depth = 1u;
     imgInfo.mipLevels = 1u;
     imgInfo.arrayLayers = 1u;
@@ -291,14 +325,46 @@ asset::SAssetBundle CImageLoaderJPG::loadAsset(system::IFile* _file, const asset
 	// Start decompressor
 	jpeg_start_decompress(&cinfo);
 
+	// the rectangle in the scaled output, the output dimensions are rounded up the same way so it never goes out of bounds
+	const uint32_t outputX = rect[0]/scaleDenom;
+	const uint32_t outputY = rect[1]/scaleDenom;
+	const uint32_t width = IAssetLoader::SAssetLoadParams::SImageSubset::scaledExtent(rect[0],rect[2],scaleDenom);
+	const uint32_t height = IAssetLoader::SAssetLoadParams::SImageSubset::scaledExtent(rect[1],rect[3],scaleDenom);
+	assert(outputX+width<=cinfo.output_width && outputY+height<=cinfo.output_height);
+	imgInfo.extent.width = width;
+	imgInfo.extent.height = height;
+
+	// only decode the columns and rows we need, cropping is aligned to iMCU boundaries so a few extra columns can come out
+	JDIMENSION decodedX = 0u;
+	#ifdef LIBJPEG_TURBO_VERSION
+	if (width!=cinfo.output_width)
+	{
+		JDIMENSION decodedWidth = width;
+		decodedX = outputX;
+		jpeg_crop_scanline(&cinfo, &decodedX, &decodedWidth);
+	}
+	#endif
+	const uint32_t texelBytesize = getTexelOrBlockBytesize(imgInfo.format);
+	if (outputY)
+	{
+		#ifdef LIBJPEG_TURBO_VERSION
+		jpeg_skip_scanlines(&cinfo, outputY);
+		#else
+		skippedRow.resize(cinfo.output_width*texelBytesize);
+		JSAMPROW skippedRowPtr = skippedRow.data();
+		while (cinfo.output_scanline<outputY)
+			jpeg_read_scanlines(&cinfo, &skippedRowPtr, 1);
+		#endif
+	}
+
 	auto regions = core::make_refctd_dynamic_array<core::smart_refctd_dynamic_array<ICPUImage::SBufferCopy>>(1u);
 	ICPUImage::SBufferCopy& region = regions->front();
 	region.imageSubresource.aspectMask = IImage::E_ASPECT_FLAGS::EAF_COLOR_BIT;
 	region.imageSubresource.mipLevel = 0u;
 	region.imageSubresource.baseArrayLayer = 0u;
 	region.imageSubresource.layerCount = 1u;
-	region.bufferOffset = 0u;
-	region.bufferRowLength = asset::IImageAssetHandlerBase::calcPitchInBlocks(width, getTexelOrBlockBytesize(imgInfo.format));
+	region.bufferOffset = (outputX-decodedX)*texelBytesize;
+	region.bufferRowLength = asset::IImageAssetHandlerBase::calcPitchInBlocks(cinfo.output_width, texelBytesize);
 	region.bufferImageHeight = 0u; //tightly packed
 	region.imageOffset = { 0u, 0u, 0u };
 	region.imageExtent = imgInfo.extent;
@@ -309,21 +375,21 @@ asset::SAssetBundle CImageLoaderJPG::loadAsset(system::IFile* _file, const asset
 	// Allocate memory for buffer
 	auto buffer = core::make_smart_refctd_ptr<asset::ICPUBuffer>(rowspan*height);
 
-	// Here we use the library's state variable cinfo.output_scanline as the
-	// loop counter, so that we don't have to keep track ourselves.
 	// Create array of row pointers for lib
-	constexpr uint32_t MaxJPEGResolution = 65535u;
-	uint8_t* rowPtr[MaxJPEGResolution];
+	rowPtr.resize(height);
 	for (uint32_t i = 0; i < height; ++i)
 		rowPtr[i] = &reinterpret_cast<uint8_t*>(buffer->getPointer())[i*rowspan];
 
-	// Read rows from bottom order to match OpenGL coords
+	// the library returns as many rows at once as it can
 	uint32_t rowsRead = 0;
-	while (cinfo.output_scanline < cinfo.output_height)
-		rowsRead += jpeg_read_scanlines(&cinfo, &rowPtr[rowsRead], 1);
+	while (rowsRead < height)
+		rowsRead += jpeg_read_scanlines(&cinfo, &rowPtr[rowsRead], height-rowsRead);
 	
-	// Finish decompression
-	jpeg_finish_decompress(&cinfo);
+	// Finish decompression, it would complain about the rows below the rectangle not being read
+	if (cinfo.output_scanline < cinfo.output_height)
+		jpeg_abort_decompress(&cinfo);
+	else
+		jpeg_finish_decompress(&cinfo);
 
 	core::smart_refctd_ptr<ICPUImage> image = ICPUImage::create(std::move(imgInfo));
 	image->setBufferAndRegions(std::move(buffer), regions);
@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 
@@ -12,18 +13,18 @@
 
 #ifdef _NBL_COMPILE_WITH_OPENEXR_LOADER_
 
-#include "nbl/asset/filters/CRegionBlockFunctorFilter.h"
 #include "nbl/asset/metadata/COpenEXRMetadata.h"
 
 #include "CImageLoaderOpenEXR.h"
 
-#include "ImfRgbaFile.h"
 #include "ImfInputFile.h"
+#include "ImfTiledInputFile.h"
+#include "ImfThreading.h"
+#include "ImfVersion.h"
 #include "ImfChannelList.h"
 #include "ImfChannelListAttribute.h"
 #include "ImfStringAttribute.h"
 #include "ImfMatrixAttribute.h"
-#include "ImfArray.h"
 
 #include "ImfNamespace.h"
 namespace IMF = Imf;
@@ -123,10 +124,7 @@ using channelName = std::string;	     									// sytnax if as follows
 using mapOfChannels = std::unordered_map<channelName, Channel>;				// suffix.channel, where channel are "R", "G", "B", "A"
 
 class SContext;
-bool readVersionField(IMF::IStream* nblIStream, SContext& ctx, const system::logger_opt_ptr);
-bool readHeader(IMF::IStream* nblIStream, SContext& ctx);
-template<typename rgbaFormat>
-void readRgba(InputFile& file, std::array<Array2D<rgbaFormat>, 4>& pixelRgbaMapArray, int& width, int& height, E_FORMAT& format, const suffixOfChannelBundle suffixOfChannels);
+bool readVersionField(const int version, SContext& ctx, const std::string& fileName, const system::logger_opt_ptr);
 E_FORMAT specifyIrrlichtEndFormat(const mapOfChannels& mapOfChannels, const suffixOfChannelBundle suffixName, const std::string fileName, const system::logger_opt_ptr logger);
 
 //! A helpful struct for handling OpenEXR layout
@@ -212,46 +210,11 @@ struct SContext
 };
 
 constexpr uint8_t availableChannels = 4;
-struct PerImageData
-{
-	ICPUImage::SCreationParams params;
-	std::array<Array2D<half>, availableChannels> halfPixelMapArray;
-	std::array<Array2D<float>, availableChannels> fullFloatPixelMapArray;
-	std::array<Array2D<uint32_t>, availableChannels> uint32_tPixelMapArray;
-};
-template<typename IlmType>
-struct ReadTexels
-{
-		ReadTexels(ICPUImage* image, const std::array<Array2D<IlmType>, availableChannels>& _pixelMapArray) :
-			data(reinterpret_cast<uint8_t*>(image->getBuffer()->getPointer())), pixelMapArray(_pixelMapArray)
-		{
-			using StreamFromEXR = CRegionBlockFunctorFilter<ReadTexels<IlmType>,false>;
-			typename StreamFromEXR::state_type state(*this,image,image->getRegions().begin());
-			StreamFromEXR::execute(core::execution::par_unseq,&state);
-		}
-
-		inline void operator()(uint32_t ptrOffset, const core::vectorSIMDu32& texelCoord)
-		{
-			assert(texelCoord.w==0u && texelCoord.z==0u);
-
-			uint8_t* texelPtr = data+ptrOffset;
-			for (auto channelIndex=0; channelIndex<availableChannels; channelIndex++)
-			{
-				const auto& element = pixelMapArray[channelIndex][texelCoord.y][texelCoord.x];
-				reinterpret_cast<typename std::decay<decltype(element)>::type*>(texelPtr)[channelIndex] = element;
-			}
-		}
-
-	private:
-		uint8_t* const data;
-		const std::array<Array2D<IlmType>, availableChannels>& pixelMapArray;
-};
-
-auto getChannels(const InputFile& file)
+auto getChannels(const Header& header)
 {
 	std::unordered_map<suffixOfChannelBundle, mapOfChannels> irrChannels;		    // example: G, albedo.R, color.space.B
 	{
-		auto channels = file.header().channels();
+		const auto& channels = header.channels();
 		for (auto mapItr = channels.begin(); mapItr != channels.end(); ++mapItr)
 		{
 			std::string fetchedChannelName = mapItr.name();
@@ -282,113 +245,232 @@ auto doesTheChannelExist(const std::string channelName, const mapOfChannels& map
 		return false;
 }
 
+//! Where a mip level of the file ends up in the texel buffer, rectangles are in the pixel space of the level
+struct SLevelToLoad
+{
+	int level;
+	// part of the level the image region covers
+	Box2i rect;
+	// part of the level stored in the buffer, contains `rect` because the decoder always outputs whole scanlines or tiles
+	Box2i stored;
+	// tile range covering `rect`, unused for scanline files
+	int tiles[4];
+	size_t bufferOffset;
+};
+
 SAssetBundle CImageLoaderOpenEXR::loadAsset(system::IFile* _file, const asset::IAssetLoader::SAssetLoadParams& _params, asset::IAssetLoader::IAssetLoaderOverride* _override, uint32_t _hierarchyLevel)
 {
 	if (!_file)
 		return {};
 
-	SContext ctx;
-
-	IMF::IStream* nblIStream = _NBL_NEW(impl::nblIStream, _file); // TODO: THIS NEEDS TESTING
-	InputFile file(*nblIStream);
+	// OpenEXR decodes line buffers and tiles on its own thread pool, size it after ours
+	static std::once_flag threadCountSet;
+	std::call_once(threadCountSet,[this]()->void{IMF::setGlobalThreadCount(m_manager->getScheduler()->getConcurrency());});
 
-	if (file.isComplete())
-		static_cast<impl::nblIStream*>(nblIStream)->resetFileOffset();
-	else
+	SContext ctx;
 	{
-		_NBL_DELETE(nblIStream);
-		return {};
+		int32_t version;
+		system::IFile::success_t success;
+		_file->read(success,&version,sizeof(SContext::magicNumber),sizeof(version));
+		if (!success || !readVersionField(version,ctx,_file->getFileName().string(),_params.logger))
+			return {};
 	}
+	const bool tiled = ctx.versionField.Compoment.singlePartFileCompomentSubTypes==SContext::VersionField::Compoment::TILES;
 
-	if (readVersionField(nblIStream, ctx, _params.logger))
-		static_cast<impl::nblIStream*>(nblIStream)->resetFileOffset();
-	else
+	impl::nblIStream stream(_file);
+	core::vector<core::smart_refctd_ptr<ICPUImage>> images;
+	core::smart_refctd_ptr<COpenEXRMetadata> meta;
+	try
 	{
-		_NBL_DELETE(nblIStream);
-		return {};
-	}
+		// only one of these gets created, `InputFile` could read tiled files too but only their first level
+		std::unique_ptr<InputFile> scanlineFile;
+		std::unique_ptr<TiledInputFile> tiledFile;
+		if (tiled)
+			tiledFile = std::make_unique<TiledInputFile>(stream);
+		else
+			scanlineFile = std::make_unique<InputFile>(stream);
+		const Header& header = tiled ? tiledFile->header():scanlineFile->header();
+		const char* const fileName = tiled ? tiledFile->fileName():scanlineFile->fileName();
+		if (!(tiled ? tiledFile->isComplete():scanlineFile->isComplete()))
+			return {};
+
+		// ripmaps have the mip chain on their diagonal, round-up level sizes don't match our mip chain so only the first level gets used then
+		int fileLevelCount = 1;
+		if (tiled && tiledFile->levelMode()!=ONE_LEVEL && tiledFile->levelRoundingMode()==ROUND_DOWN)
+			fileLevelCount = std::min(tiledFile->numXLevels(),tiledFile->numYLevels());
+		auto getLevelWindow = [&](const int level) -> Box2i
+		{
+			return tiled ? tiledFile->dataWindowForLevel(level,level):header.dataWindow();
+		};
 
-	if (readHeader(nblIStream, ctx))
-		static_cast<impl::nblIStream*>(nblIStream)->resetFileOffset();
-	else
-	{
-		_NBL_DELETE(nblIStream);
-		return {};
-	}
+		// figure out what to load
+		const auto& subset = _params.imageSubset;
+		if (subset.baseMipLevel>=static_cast<uint32_t>(fileLevelCount))
+		{
+			_params.logger.log("LOAD EXR: requested base mip level %u but %s only has %d", system::ILogger::ELL_ERROR, subset.baseMipLevel, fileName, fileLevelCount);
+			return {};
+		}
+		if (subset.mipLevelCount==0u)
+		{
+			_params.logger.log("LOAD EXR: requested zero mip levels of %s", system::ILogger::ELL_ERROR, fileName);
+			return {};
+		}
+		const int baseLevel = subset.baseMipLevel;
+		const Box2i baseWindow = getLevelWindow(baseLevel);
+		Box2i baseRect = baseWindow;
+		if (subset.extent[0] && subset.extent[1])
+		{
+			baseRect.min = baseWindow.min+V2i(subset.offset[0],subset.offset[1]);
+			baseRect.max = baseRect.min+V2i(subset.extent[0]-1u,subset.extent[1]-1u);
+			if (baseRect.max.x>baseWindow.max.x || baseRect.max.y>baseWindow.max.y)
+			{
+				_params.logger.log("LOAD EXR: requested rectangle is out of bounds of %s", system::ILogger::ELL_ERROR, fileName);
+				return {};
+			}
+		}
+		const uint32_t width = baseRect.max.x-baseRect.min.x+1;
+		const uint32_t height = baseRect.max.y-baseRect.min.y+1;
 
-	core::vector<core::smart_refctd_ptr<ICPUImage>> images;
-	const auto channelsData = getChannels(file);
-	auto meta = core::make_smart_refctd_ptr<COpenEXRMetadata>(channelsData.size());
-	{
+		core::vector<SLevelToLoad> levels;
+		{
+			const int levelCount = std::min<int64_t>(subset.mipLevelCount,fileLevelCount-baseLevel);
+			for (int i=0; i<levelCount; i++)
+			{
+				SLevelToLoad level = {};
+				level.level = baseLevel+i;
+				const Box2i window = getLevelWindow(level.level);
+				level.rect.min = window.min+V2i((baseRect.min.x-baseWindow.min.x)>>i,(baseRect.min.y-baseWindow.min.y)>>i);
+				level.rect.max = level.rect.min+V2i(std::max(width>>i,1u)-1u,std::max(height>>i,1u)-1u);
+				// the rectangle doesn't downsample cleanly anymore (the image would need a texel the level doesn't have)
+				if (level.rect.max.x>window.max.x || level.rect.max.y>window.max.y)
+					break;
+
+				if (tiled)
+				{
+					const int tileWidth = tiledFile->tileXSize();
+					const int tileHeight = tiledFile->tileYSize();
+					level.tiles[0] = (level.rect.min.x-window.min.x)/tileWidth;
+					level.tiles[1] = (level.rect.max.x-window.min.x)/tileWidth;
+					level.tiles[2] = (level.rect.min.y-window.min.y)/tileHeight;
+					level.tiles[3] = (level.rect.max.y-window.min.y)/tileHeight;
+					level.stored.min = window.min+V2i(level.tiles[0]*tileWidth,level.tiles[2]*tileHeight);
+					level.stored.max.x = std::min(window.max.x,window.min.x+(level.tiles[1]+1)*tileWidth-1);
+					level.stored.max.y = std::min(window.max.y,window.min.y+(level.tiles[3]+1)*tileHeight-1);
+				}
+				else
+				{
+					level.stored.min = V2i(window.min.x,level.rect.min.y);
+					level.stored.max = V2i(window.max.x,level.rect.max.y);
+				}
+				levels.push_back(level);
+			}
+		}
+
+		const auto channelsData = getChannels(header);
+		meta = core::make_smart_refctd_ptr<COpenEXRMetadata>(channelsData.size());
 		uint32_t metaOffset = 0u;
 		for (const auto& data : channelsData)
 		{
 			const auto suffixOfChannels = data.first;
 			const auto mapOfChannels = data.second;
-			PerImageData perImageData;
-
-			int width;
-			int height;
 
-			auto params = perImageData.params;
-			params.format = specifyIrrlichtEndFormat(mapOfChannels, suffixOfChannels, file.fileName(), _params.logger);
-			params.type = ICPUImage::ET_2D;;
+			ICPUImage::SCreationParams params;
+			params.format = specifyIrrlichtEndFormat(mapOfChannels, suffixOfChannels, fileName, _params.logger);
+			params.type = ICPUImage::ET_2D;
 			params.flags = static_cast<ICPUImage::E_CREATE_FLAGS>(0u);
 			params.samples = ICPUImage::ESCF_1_BIT;
-			params.extent.depth = 1u;
-			params.mipLevels = 1u;
+			params.extent = {width,height,1u};
+			params.mipLevels = levels.size();
 			params.arrayLayers = 1u;
 
 			if (params.format == EF_UNKNOWN)
 			{
 				#ifndef  _NBL_PLATFORM_ANDROID_
-				_params.logger.log("LOAD EXR: incorrect format specified for " + suffixOfChannels + " channels - skipping the file %s", system::ILogger::ELL_INFO, file.fileName());
+				_params.logger.log("LOAD EXR: incorrect format specified for " + suffixOfChannels + " channels - skipping the file %s", system::ILogger::ELL_INFO, fileName);
 				#endif // ! _NBL_PLATFORM_ANDROID_
 				continue;
 			}
+			const PixelType pixelType = params.format==EF_R16G16B16A16_SFLOAT ? PixelType::HALF:(params.format==EF_R32G32B32A32_SFLOAT ? PixelType::FLOAT:PixelType::UINT);
+			const size_t channelByteSize = pixelType==PixelType::HALF ? sizeof(half):sizeof(float);
+			const size_t texelByteSize = channelByteSize*availableChannels;
+
+			// lay the levels out in the buffer exactly as the decoder writes them, regions then skip the excess texels
+			auto regions = core::make_refctd_dynamic_array<core::smart_refctd_dynamic_array<ICPUImage::SBufferCopy>>(levels.size());
+			size_t bufferSize = 0ull;
+			for (auto i=0u; i<levels.size(); i++)
+			{
+				auto& level = levels[i];
+				const uint32_t storedWidth = level.stored.max.x-level.stored.min.x+1;
+				level.bufferOffset = bufferSize;
+				bufferSize += size_t(storedWidth)*(level.stored.max.y-level.stored.min.y+1)*texelByteSize;
 
-			if (params.format == EF_R16G16B16A16_SFLOAT)
-				readRgba(file, perImageData.halfPixelMapArray, width, height, params.format, suffixOfChannels);
-			else if (params.format == EF_R32G32B32A32_SFLOAT)
-				readRgba(file, perImageData.fullFloatPixelMapArray, width, height, params.format, suffixOfChannels);
-			else if (params.format == EF_R32G32B32A32_UINT)
-				readRgba(file, perImageData.uint32_tPixelMapArray, width, height, params.format, suffixOfChannels);
-
-			params.extent.width = width;
-			params.extent.height = height;
-
-			auto image = ICPUImage::create(std::move(params));
-			{ // create image and buffer that backs it
-				const uint32_t texelFormatByteSize = getTexelOrBlockBytesize(image->getCreationParameters().format);
-				auto texelBuffer = core::make_smart_refctd_ptr<ICPUBuffer>(image->getImageDataSizeInBytes());
-				auto regions = core::make_refctd_dynamic_array<core::smart_refctd_dynamic_array<ICPUImage::SBufferCopy>>(1u);
-				ICPUImage::SBufferCopy& region = regions->front();
+				ICPUImage::SBufferCopy& region = regions->operator[](i);
 				region.imageSubresource.aspectMask = IImage::E_ASPECT_FLAGS::EAF_COLOR_BIT;
-				region.imageSubresource.mipLevel = 0u;
+				region.imageSubresource.mipLevel = i;
 				region.imageSubresource.baseArrayLayer = 0u;
 				region.imageSubresource.layerCount = 1u;
-				region.bufferOffset = 0u;
-				region.bufferRowLength = calcPitchInBlocks(width, texelFormatByteSize);
+				region.bufferOffset = level.bufferOffset+(size_t(level.rect.min.y-level.stored.min.y)*storedWidth+(level.rect.min.x-level.stored.min.x))*texelByteSize;
+				region.bufferRowLength = storedWidth;
 				region.bufferImageHeight = 0u;
 				region.imageOffset = { 0u, 0u, 0u };
-				region.imageExtent = image->getCreationParameters().extent;
+				region.imageExtent = { static_cast<uint32_t>(level.rect.max.x-level.rect.min.x+1), static_cast<uint32_t>(level.rect.max.y-level.rect.min.y+1), 1u };
+			}
+			auto texelBuffer = core::make_smart_refctd_ptr<ICPUBuffer>(bufferSize);
 
-				image->setBufferAndRegions(std::move(texelBuffer), regions);
+			constexpr const char* rgbaSignatureAsText[] = {"R", "G", "B", "A"};
+			for (const auto& level : levels)
+			{
+				const size_t rowPitch = size_t(level.stored.max.x-level.stored.min.x+1)*texelByteSize;
+				// OpenEXR addresses the slices with absolute pixel coordinates of the level
+				char* const origin = reinterpret_cast<char*>(texelBuffer->getPointer())+level.bufferOffset-ptrdiff_t(level.stored.min.x)*ptrdiff_t(texelByteSize)-ptrdiff_t(level.stored.min.y)*ptrdiff_t(rowPitch);
+
+				FrameBuffer frameBuffer;
+				for (uint8_t rgbaChannelIndex = 0; rgbaChannelIndex < availableChannels; ++rgbaChannelIndex)
+				{
+					std::string name = suffixOfChannels.empty() ? rgbaSignatureAsText[rgbaChannelIndex] : suffixOfChannels + "." + rgbaSignatureAsText[rgbaChannelIndex];
+					frameBuffer.insert
+					(
+						name.c_str(),																// name
+						Slice(pixelType,															// type
+							origin+rgbaChannelIndex*channelByteSize,								// base
+							texelByteSize,															// xStride
+							rowPitch,																// yStride
+							1, 1,																	// x/y sampling
+							rgbaChannelIndex == 3 ? 1 : 0											// default fillValue for channels that aren't present in file - 1 for alpha, otherwise 0
+						));
+				}
+
+				if (tiled)
+				{
+					tiledFile->setFrameBuffer(frameBuffer);
+					tiledFile->readTiles(level.tiles[0],level.tiles[1],level.tiles[2],level.tiles[3],level.level,level.level);
+				}
+				else
+				{
+					scanlineFile->setFrameBuffer(frameBuffer);
+					scanlineFile->readPixels(level.stored.min.y,level.stored.max.y);
+				}
 			}
 
-			if (params.format == EF_R16G16B16A16_SFLOAT)
-				ReadTexels(image.get(),perImageData.halfPixelMapArray);
-			else if (params.format == EF_R32G32B32A32_SFLOAT)
-				ReadTexels(image.get(), perImageData.fullFloatPixelMapArray);
-			else if (params.format == EF_R32G32B32A32_UINT)
-				ReadTexels(image.get(), perImageData.uint32_tPixelMapArray);
+			auto image = ICPUImage::create(std::move(params));
+			if (!image)
+			{
+				_params.logger.log("LOAD EXR: failed to create an image for " + suffixOfChannels + " channels of %s", system::ILogger::ELL_ERROR, fileName);
+				return {};
+			}
+			image->setBufferAndRegions(std::move(texelBuffer), regions);
 
 			meta->placeMeta(metaOffset++,image.get(),std::string(suffixOfChannels),IImageMetadata::ColorSemantic{ ECP_SRGB,EOTF_IDENTITY });
 
 			images.push_back(std::move(image));
 		}
-	}	
-	_NBL_DELETE(nblIStream);
+	}
+	catch (const std::exception& e)
+	{
+		// OpenEXR reports corrupt and truncated files by throwing
+		_params.logger.log("LOAD EXR: failed to read %s: %s", system::ILogger::ELL_ERROR, _file->getFileName().string().c_str(), e.what());
+		return {};
+	}
 	return SAssetBundle(std::move(meta),std::move(images));
 }
 
@@ -405,46 +487,6 @@ bool CImageLoaderOpenEXR::isALoadableFileFormat(system::IFile* _file, const syst
 	return success && isImfMagic(magicNumberBuffer);
 }
 
-template<typename rgbaFormat>
-void readRgba(InputFile& file, std::array<Array2D<rgbaFormat>, 4>& pixelRgbaMapArray, int& width, int& height, E_FORMAT& format, const suffixOfChannelBundle suffixOfChannels)
-{
-	Box2i dw = file.header().dataWindow();
-	width = dw.max.x - dw.min.x + 1;
-	height = dw.max.y - dw.min.y + 1;
-
-	constexpr const char* rgbaSignatureAsText[] = {"R", "G", "B", "A"};
-	for (auto& pixelChannelBuffer : pixelRgbaMapArray)
-		pixelChannelBuffer.resizeErase(height, width);
-
-	FrameBuffer frameBuffer;
-	PixelType pixelType;
-
-	if (format == EF_R16G16B16A16_SFLOAT)
-		pixelType = PixelType::HALF;
-	else if (format == EF_R32G32B32A32_SFLOAT)
-		pixelType = PixelType::FLOAT;
-	else if (format == EF_R32G32B32A32_UINT)
-		pixelType = PixelType::UINT;
-
-	for (uint8_t rgbaChannelIndex = 0; rgbaChannelIndex < availableChannels; ++rgbaChannelIndex)
-	{
-		std::string name = suffixOfChannels.empty() ? rgbaSignatureAsText[rgbaChannelIndex] : suffixOfChannels + "." + rgbaSignatureAsText[rgbaChannelIndex];
-		frameBuffer.insert
-		(
-			name.c_str(),																					// name
-			Slice(pixelType,																				// type
-			(char*)(&(pixelRgbaMapArray[rgbaChannelIndex])[0][0] - dw.min.x - dw.min.y * width),			// base
-				sizeof((pixelRgbaMapArray[rgbaChannelIndex])[0][0]) * 1,                                    // xStride
-				sizeof((pixelRgbaMapArray[rgbaChannelIndex])[0][0]) * width,                                // yStride
-				1, 1,                                                                                       // x/y sampling
-				rgbaChannelIndex == 3 ? 1 : 0                                                               // default fillValue for channels that aren't present in file - 1 for alpha, otherwise 0
-			));
-	}
-
-	file.setFrameBuffer(frameBuffer);
-	file.readPixels(dw.min.y, dw.max.y);
-}
-
 E_FORMAT specifyIrrlichtEndFormat(const mapOfChannels& mapOfChannels, const suffixOfChannelBundle suffixName, const std::string fileName, const system::logger_opt_ptr logger)
 {
 	E_FORMAT retVal;
@@ -487,110 +529,41 @@ E_FORMAT specifyIrrlichtEndFormat(const mapOfChannels& mapOfChannels, const suff
 	return retVal;
 }
 
-bool readVersionField(IMF::IStream* nblIStream, SContext& ctx, const system::logger_opt_ptr logger)
+bool readVersionField(const int version, SContext& ctx, const std::string& fileName, const system::logger_opt_ptr logger)
 {
-	RgbaInputFile file(*nblIStream);
-
-	if (!file.isComplete())
-		return false;
-
 	auto& versionField = ctx.versionField;
-			
-	versionField.mainDataRegisterField = file.version();
-
-	auto isTheBitActive = [&](uint16_t bitToCheck)
-	{		
-		bool readVersionField(IMF::IStream* nblIStream, SContext& ctx);
-		bool readHeader(IMF::IStream* nblIStream, SContext& ctx);
-		return (versionField.mainDataRegisterField & (1 << (bitToCheck - 1)));
-	};
-
-	versionField.fileFormatVersionNumber |= isTheBitActive(1) | isTheBitActive(2) | isTheBitActive(3) | isTheBitActive(4) | isTheBitActive(5) | isTheBitActive(6) | isTheBitActive(7) | isTheBitActive(8);
+	versionField.mainDataRegisterField = version;
+	versionField.fileFormatVersionNumber = getVersion(version);
+	versionField.doesFileContainLongNames = hasLongNames(version);
+	versionField.doesItSupportDeepData = isNonImage(version);
 
-	if (!isTheBitActive(11) && !isTheBitActive(12))
+	if (!supportsFlags(getFlags(version)))
 	{
-		versionField.Compoment.type = SContext::VersionField::Compoment::SINGLE_PART_FILE;
-
-		if (isTheBitActive(9))
-		{
-			versionField.Compoment.singlePartFileCompomentSubTypes = SContext::VersionField::Compoment::TILES;
-			#ifndef _NBL_PLATFORM_ANDROID_
-			logger.log("LOAD EXR: the file consist of not supported tiles %s", system::ILogger::ELL_ERROR, file.fileName());
-			#endif // !_NBL_PLATFORM_ANDROID_
-			return false;
-		}
-		else
-			versionField.Compoment.singlePartFileCompomentSubTypes = SContext::VersionField::Compoment::SCAN_LINES;
+		#ifndef _NBL_PLATFORM_ANDROID_
+		logger.log("LOAD EXR: the file %s has an unknown version %d", system::ILogger::ELL_ERROR, fileName.c_str(), version);
+		#endif // !_NBL_PLATFORM_ANDROID_
+		return false;
 	}
-	else if (!isTheBitActive(9) && !isTheBitActive(11) && isTheBitActive(12))
+
+	if (isMultiPart(version))
 	{
 		versionField.Compoment.type = SContext::VersionField::Compoment::MULTI_PART_FILE;
 		versionField.Compoment.singlePartFileCompomentSubTypes = SContext::VersionField::Compoment::SCAN_LINES_OR_TILES;
 		#ifndef  _NBL_PLATFORM_ANDROID_
-		logger.log("LOAD EXR: the file is a not supported multi part file %s", system::ILogger::ELL_ERROR, file.fileName());
+		logger.log("LOAD EXR: the file is a not supported multi part file %s", system::ILogger::ELL_ERROR, fileName.c_str());
 		#endif // ! _NBL_PLATFORM_ANDROID_
 		return false;
 	}
+	versionField.Compoment.type = SContext::VersionField::Compoment::SINGLE_PART_FILE;
+	versionField.Compoment.singlePartFileCompomentSubTypes = isTiled(version) ? SContext::VersionField::Compoment::TILES:SContext::VersionField::Compoment::SCAN_LINES;
 
-	if (!isTheBitActive(9) && isTheBitActive(11) && isTheBitActive(12))
+	if (versionField.doesItSupportDeepData)
 	{
-		versionField.doesItSupportDeepData = true;
 		#ifndef  _NBL_PLATFORM_ANDROID_
-		logger.log("LOAD EXR: the file consist of not supported deep data%s", system::ILogger::ELL_ERROR, file.fileName());
+		logger.log("LOAD EXR: the file consist of not supported deep data%s", system::ILogger::ELL_ERROR, fileName.c_str());
 		#endif // ! _NBL_PLATFORM_ANDROID_
 		return false;
 	}
-	else
-		versionField.doesItSupportDeepData = false;
-
-	if (isTheBitActive(10))
-		versionField.doesFileContainLongNames = true;
-	else
-		versionField.doesFileContainLongNames = false;
-
-	return true;
-}
-
-bool readHeader(IMF::IStream* nblIStream, SContext& ctx)
-{
-	RgbaInputFile file(*nblIStream);
-
-	if (!file.isComplete())
-		return false;
-
-	auto& attribs = ctx.attributes;
-	auto& versionField = ctx.versionField;
-
-	/*
-
-	// There is an OpenEXR library implementation error associated with dynamic_cast<> probably
-	// Since OpenEXR loader only cares about RGB and RGBA, there is no need for bellow at the moment
-
-	attribs.channels = file.header().findTypedAttribute<Channel>("channels");
-	attribs.compression = file.header().findTypedAttribute<Compression>("compression");
-	attribs.dataWindow = file.header().findTypedAttribute<Box2i>("dataWindow");
-	attribs.displayWindow = file.header().findTypedAttribute<Box2i>("displayWindow");
-	attribs.lineOrder = file.header().findTypedAttribute<LineOrder>("lineOrder");
-	attribs.pixelAspectRatio = file.header().findTypedAttribute<float>("pixelAspectRatio");
-	attribs.screenWindowCenter = file.header().findTypedAttribute<V2f>("screenWindowCenter");
-	attribs.screenWindowWidth = file.header().findTypedAttribute<float>("screenWindowWidth");
-
-	if (versionField.Compoment.singlePartFileCompomentSubTypes == SContext::VersionField::Compoment::TILES)
-		attribs.tiles = file.header().findTypedAttribute<TileDescription>("tiles");
-
-	if (versionField.Compoment.type == SContext::VersionField::Compoment::MULTI_PART_FILE)
-		attribs.view = file.header().findTypedAttribute<std::string>("view");
-
-	if (versionField.Compoment.type == SContext::VersionField::Compoment::MULTI_PART_FILE || versionField.doesItSupportDeepData)
-	{
-		attribs.name = file.header().findTypedAttribute<std::string>("name");
-		attribs.type = file.header().findTypedAttribute<std::string>("type");
-		attribs.version = file.header().findTypedAttribute<int>("version");
-		attribs.chunkCount = file.header().findTypedAttribute<int>("chunkCount");
-		attribs.maxSamplesPerPixel = file.header().findTypedAttribute<int>("maxSamplesPerPixel");
-	}
-
-	*/
 
 	return true;
 }
@@ -17,6 +17,10 @@ namespace asset
 {	
 
 //! OpenEXR loader capable of loading .exr files
+/*
+	Scanline and tiled single part files are supported, the mip chain of tiled files gets loaded too.
+	Honours `SAssetLoadParams::imageSubset` by only decoding the scanlines or tiles it covers.
+*/
 class CImageLoaderOpenEXR final : public IImageLoader
 {
 	protected:
@@ -31,12 +31,6 @@ namespace asset
 #ifdef _NBL_COMPILE_WITH_LIBPNG_
 // PNG function for error handling
 
-void updateFilePos(png_structp png_pt, size_t new_file_pos)
-{
-	auto ptr = (CImageLoaderPng::SContext*)png_get_user_chunk_ptr(png_pt);
-	ptr->file_pos = new_file_pos;
-	png_set_read_user_chunk_fn(png_pt, ptr, nullptr);
-}
 static void png_cpexcept_error(png_structp png_ptr, png_const_charp msg)
 {
 	auto ctx = (CImageLoaderPng::SContext*)png_get_user_chunk_ptr(png_ptr);
@@ -54,21 +48,46 @@ static void png_cpexcept_warn(png_structp png_ptr, png_const_charp msg)
 // PNG function for file reading
 void PNGAPI user_read_data_fcn(png_structp png_pt, png_bytep data, png_size_t length)
 {
-	png_size_t check;
-
-	auto* userData = (CImageLoaderPng::SContext*)png_get_user_chunk_ptr(png_pt);
-	size_t file_pos = userData->file_pos;
-
-	system::IFile* file=(system::IFile*)png_get_io_ptr(png_pt);
+	auto* ctx = (CImageLoaderPng::SContext*)png_get_io_ptr(png_pt);
+	const size_t fileSize = ctx->file->getSize();
+	if (ctx->file_pos+length>fileSize)
+		png_error(png_pt, "Read Error");
 
-	system::IFile::success_t success;
-	file->read(success, data, file_pos, length);
-	check = success.getBytesProcessed();
-	file_pos += length;
-	updateFilePos(png_pt, file_pos);
+	if (ctx->mapped)
+	{
+		memcpy(data, ctx->mapped+ctx->file_pos, length);
+		ctx->file_pos += length;
+		return;
+	}
 
-	if (check != length)
-		png_error(png_pt, "Read Error");
+	while (length)
+	{
+		// refill the window if the read doesn't start in it
+		if (ctx->file_pos<ctx->windowOffset || ctx->file_pos>=ctx->windowOffset+ctx->windowSize)
+		{
+			// reads as large as the window gain nothing from going through it
+			if (length>=ctx->window.size())
+			{
+				system::IFile::success_t success;
+				ctx->file->read(success, data, ctx->file_pos, length);
+				if (success.getBytesProcessed()!=length)
+					png_error(png_pt, "Read Error");
+				ctx->file_pos += length;
+				return;
+			}
+			system::IFile::success_t success;
+			ctx->windowOffset = ctx->file_pos;
+			ctx->windowSize = core::min(ctx->window.size(), fileSize-ctx->file_pos);
+			ctx->file->read(success, ctx->window.data(), ctx->windowOffset, ctx->windowSize);
+			if (success.getBytesProcessed()!=ctx->windowSize)
+				png_error(png_pt, "Read Error");
+		}
+		const size_t count = core::min<size_t>(length, ctx->windowOffset+ctx->windowSize-ctx->file_pos);
+		memcpy(data, ctx->window.data()+(ctx->file_pos-ctx->windowOffset), count);
+		data += count;
+		length -= count;
+		ctx->file_pos += count;
+	}
 }
 #endif // _NBL_COMPILE_WITH_LIBPNG_
 
@@ -128,6 +147,15 @@ asset::SAssetBundle CImageLoaderPng::loadAsset(system::IFile* _file, const asset
         return {};
 	}
 
+	// declared before any `setjmp` so the `longjmp` doesn't skip their destructors
+	SContext usrData(_params.logger);
+	usrData.file = _file;
+	usrData.mapped = reinterpret_cast<const uint8_t*>(static_cast<const system::IFile*>(_file)->getMappedPointer());
+	if (!usrData.mapped)
+		usrData.window.resize(core::min<size_t>(_file->getSize(), 64u<<10u));
+	core::vector<uint8_t> scratchRow;
+	core::vector<double> accumulator;
+
 	// Allocate the png read struct
 	png_structp png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING,
 		nullptr, (png_error_ptr)png_cpexcept_error, (png_error_ptr)png_cpexcept_warn);
@@ -154,10 +182,9 @@ asset::SAssetBundle CImageLoaderPng::loadAsset(system::IFile* _file, const asset
 			_NBL_DELETE_ARRAY(RowPointers, Height);
         return {};
 	}
-	SContext usrData(_params.logger);
 	png_set_read_user_chunk_fn(png_ptr, &usrData, nullptr);
 
-	png_set_read_fn(png_ptr, _file, user_read_data_fcn);
+	png_set_read_fn(png_ptr, &usrData, user_read_data_fcn);
 
 	png_set_sig_bytes(png_ptr, 8); // Tell png that we read the signature
 
@@ -226,11 +253,44 @@ asset::SAssetBundle CImageLoaderPng::loadAsset(system::IFile* _file, const asset
 		Height = h;
 	}
 
+	// the requested part of the image, in texels of the full resolution
+	using subset_t = IAssetLoader::SAssetLoadParams::SImageSubset;
+	const auto& subset = _params.imageSubset;
+	uint32_t rect[4] = { 0u,0u,Width,Height };
+	uint32_t boxSize = 1u;
+	if (png_get_interlace_type(png_ptr, info_ptr)!=PNG_INTERLACE_NONE)
+	{
+		// every pass covers the whole image, so there's nothing to skip
+		if ((subset.extent[0] && subset.extent[1]) || subset.maxExtent)
+			_params.logger.log("LOAD PNG: %s is interlaced, loading all of it", system::ILogger::ELL_PERFORMANCE, _file->getFileName().string().c_str());
+	}
+	else
+	{
+		if (subset.extent[0] && subset.extent[1])
+		{
+			if (subset.offset[0]+subset.extent[0]>Width || subset.offset[1]+subset.extent[1]>Height)
+			{
+				_params.logger.log("LOAD PNG: requested rectangle is out of bounds of %s", system::ILogger::ELL_ERROR, _file->getFileName().string().c_str());
+				png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
+				return {};
+			}
+			rect[0] = subset.offset[0];
+			rect[1] = subset.offset[1];
+			rect[2] = subset.extent[0];
+			rect[3] = subset.extent[1];
+		}
+		// box filter while decoding
+		if (subset.maxExtent)
+		while (core::max(subset_t::scaledExtent(rect[0],rect[2],boxSize),subset_t::scaledExtent(rect[1],rect[3],boxSize))>subset.maxExtent)
+			boxSize <<= 1u;
+	}
+	const bool decodeRows = rect[2]!=Width || rect[3]!=Height || boxSize!=1u;
+
 	// Create the image structure to be filled by png data
     ICPUImage::SCreationParams imgInfo;
     imgInfo.type = ICPUImage::ET_2D;
-    imgInfo.extent.width = Width;
-    imgInfo.extent.height = Height;
+    imgInfo.extent.width = subset_t::scaledExtent(rect[0],rect[2],boxSize);
+    imgInfo.extent.height = subset_t::scaledExtent(rect[1],rect[3],boxSize);
     imgInfo.extent.depth = 1u;
     imgInfo.mipLevels = 1u;
     imgInfo.arrayLayers = 1u;
@@ -281,7 +341,7 @@ asset::SAssetBundle CImageLoaderPng::loadAsset(system::IFile* _file, const asset
     region.imageSubresource.baseArrayLayer = 0u;
     region.imageSubresource.layerCount = 1u;
     region.bufferOffset = 0u;
-    region.bufferRowLength = asset::IImageAssetHandlerBase::calcPitchInBlocks(Width, texelFormatBytesize);
+    region.bufferRowLength = asset::IImageAssetHandlerBase::calcPitchInBlocks(imgInfo.extent.width, texelFormatBytesize);
     region.bufferImageHeight = 0u; //tightly packed
     region.imageOffset = { 0u, 0u, 0u };
     region.imageExtent = imgInfo.extent;
@@ -291,7 +351,7 @@ asset::SAssetBundle CImageLoaderPng::loadAsset(system::IFile* _file, const asset
 	// Fill array of pointers to rows in image data
 	const uint32_t pitch = region.bufferRowLength*texelFormatBytesize;
 	uint8_t* data = reinterpret_cast<uint8_t*>(texelBuffer->getPointer());
-	for (uint32_t i=0; i<Height; ++i)
+	for (uint32_t i=0; i<region.imageExtent.height; ++i)
 	{
 		RowPointers[i] = (png_bytep)data;
 		data += pitch;
@@ -305,11 +365,105 @@ asset::SAssetBundle CImageLoaderPng::loadAsset(system::IFile* _file, const asset
         return {};
 	}
 
-	// Read data using the library function that handles all transformations including interlacing
-	png_read_image(png_ptr, RowPointers);
+	if (decodeRows)
+	{
+		const uint32_t channels = png_get_channels(png_ptr, info_ptr);
+		const bool hasAlpha = channels==2u || channels==4u;
+		const uint32_t colorChannels = hasAlpha ? (channels-1u):channels;
+		const uint32_t outWidth = region.imageExtent.width;
+		auto writeTexel = [&](uint8_t*& out, const uint8_t* texel) -> void
+		{
+			if (lumaAlphaType)
+			{
+				out[0] = out[1] = out[2] = texel[0];
+				out[3] = texel[1];
+				out += 4u;
+			}
+			else
+			{
+				memcpy(out, texel, channels);
+				out += channels;
+			}
+		};
+		scratchRow.resize(png_get_rowbytes(png_ptr, info_ptr));
+		// the texels are sRGB encoded so they get averaged in linear space, with the colour weighted by alpha so transparent texels don't bleed into the rest
+		// every box holds the weighted colour and alpha, then the plain colour for boxes which end up fully transparent
+		const uint32_t boxStride = hasAlpha ? (channels+colorChannels):channels;
+		accumulator.resize(outWidth*boxStride);
+		std::fill(accumulator.begin(), accumulator.end(), 0.0);
+		std::array<double,256> toLinear;
+		for (uint32_t i=0u; i<toLinear.size(); ++i)
+			toLinear[i] = core::srgb2lin(double(i)/255.0);
+
+		// boxes follow the grid of the whole image downscaled, so the ones on the edges of the rectangle can be partial
+		const uint32_t firstBoxX = rect[0]/boxSize;
+		const uint32_t firstBoxY = rect[1]/boxSize;
+		const uint32_t rectEndX = rect[0]+rect[2];
+		const uint32_t rectEndY = rect[1]+rect[3];
+		uint32_t rowsInBox = 0u;
+		for (uint32_t y=0u; y<rectEndY; ++y)
+		{
+			// rows above the rectangle still need decoding, the filters reference the previous row
+			png_read_row(png_ptr, scratchRow.data(), nullptr);
+			if (y<rect[1])
+				continue;
 
-	png_read_end(png_ptr, nullptr);
-	if (lumaAlphaType)
+			const uint8_t* in = scratchRow.data()+rect[0]*channels;
+			if (boxSize==1u)
+			{
+				uint8_t* out = RowPointers[y-rect[1]];
+				for (uint32_t x=rect[0]; x<rectEndX; ++x, in+=channels)
+					writeTexel(out, in);
+				continue;
+			}
+			for (uint32_t x=rect[0]; x<rectEndX; ++x, in+=channels)
+			{
+				double* box = accumulator.data()+(x/boxSize-firstBoxX)*boxStride;
+				const double alpha = hasAlpha ? (in[colorChannels]/255.0):1.0;
+				for (uint32_t c=0u; c<colorChannels; ++c)
+				{
+					box[c] += toLinear[in[c]]*alpha;
+					if (hasAlpha)
+						box[channels+c] += toLinear[in[c]];
+				}
+				if (hasAlpha)
+					box[colorChannels] += alpha;
+			}
+			rowsInBox++;
+
+			if ((y+1u)%boxSize!=0u && y+1u!=rectEndY)
+				continue;
+			uint8_t* out = RowPointers[y/boxSize-firstBoxY];
+			for (uint32_t x=0u; x<outWidth; ++x)
+			{
+				const uint32_t boxBeginX = core::max((firstBoxX+x)*boxSize,rect[0]);
+				const uint32_t boxEndX = core::min((firstBoxX+x+1u)*boxSize,rectEndX);
+				const double texelCount = double((boxEndX-boxBeginX)*rowsInBox);
+				const double* box = accumulator.data()+x*boxStride;
+				const double alphaSum = hasAlpha ? box[colorChannels]:texelCount;
+
+				uint8_t texel[4];
+				for (uint32_t c=0u; c<colorChannels; ++c)
+				{
+					const double linear = alphaSum>0.0 ? (box[c]/alphaSum):(box[channels+c]/texelCount);
+					texel[c] = static_cast<uint8_t>(core::lin2srgb(core::min(linear,1.0))*255.0+0.5);
+				}
+				if (hasAlpha)
+					texel[colorChannels] = static_cast<uint8_t>(alphaSum/texelCount*255.0+0.5);
+				writeTexel(out, texel);
+			}
+			rowsInBox = 0u;
+			std::fill(accumulator.begin(), accumulator.end(), 0.0);
+		}
+		// rows below the rectangle never get decoded, so no `png_read_end`
+	}
+	else
+	{
+		// Read data using the library function that handles all transformations including interlacing
+		png_read_image(png_ptr, RowPointers);
+		png_read_end(png_ptr, nullptr);
+	}
+	if (lumaAlphaType && !decodeRows)
 	{
 		assert(imgInfo.format==asset::EF_R8G8B8A8_SRGB);
 		for (uint32_t i=0u; i<Height; ++i)
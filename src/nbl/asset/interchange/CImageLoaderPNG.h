@@ -31,6 +31,12 @@ public:
         // and set to 8 but you cannot access this struct from there
         size_t file_pos = 8;
         system::logger_opt_ptr logger;
+        system::IFile* file = nullptr;
+        // whole file when it's mapped, otherwise a read-ahead window so libpng's many small reads don't each go to the file
+        const uint8_t* mapped = nullptr;
+        core::vector<uint8_t> window;
+        size_t windowOffset = 0u;
+        size_t windowSize = 0u;
     };
     explicit CImageLoaderPng() {}
     virtual bool isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger) const override;
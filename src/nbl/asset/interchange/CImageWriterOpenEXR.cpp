@@ -154,7 +154,7 @@ bool createAndWriteImage(std::array<ilmType*, availableChannels>& pixelsArrayIlm
 			continue;
 
 		state.regionIterator = rit;
-		StreamToEXR::execute(core::execution::par_unseq, &state);
+		StreamToEXR::execute(core::CTaskScheduler::getDefault()->policy(), &state);
 	}
 
 	constexpr std::array<const char*, availableChannels> rgbaSignatureAsText = { "R", "G", "B", "A" };
@@ -19,6 +19,8 @@
 #include "COBJMeshFileLoader.h"
 
 #include <filesystem>
+#include <bit>
+#include <charconv>
 
 namespace nbl
 {
@@ -29,13 +31,401 @@ namespace asset
 #define _NBL_DEBUG_OBJ_LOADER_
 //#endif
 
-static const uint32_t WORD_BUFFER_LENGTH = 512;
-
 constexpr uint32_t POSITION = 0u;
 constexpr uint32_t UV = 2u;
 constexpr uint32_t NORMAL = 3u;
 constexpr uint32_t BND_NUM = 0u;
 
+namespace
+{
+//! Open addressing (linear probing) table of indices into the output vertices, welds corners with bitwise identical attributes and the same smoothing group
+class CVertexWelder final
+{
+	public:
+		inline CVertexWelder(core::vector<SObjVertex>& _vertices, core::vector<uint32_t>& _smoothingGroups) : m_vertices(_vertices), m_smoothingGroups(_smoothingGroups)
+		{
+			rehash(10u);
+		}
+
+		//! Returns the index of an existing identical vertex, or appends a new one
+		inline uint32_t weld(const SObjVertex& vertex, const uint32_t smoothingGroup)
+		{
+			// keep the load factor under 1/2
+			if ((m_vertices.size()+1ull)*2ull>m_slots.size())
+				rehash(m_log2SlotCount+1u);
+
+			const size_t mask = m_slots.size()-1ull;
+			for (size_t slot=hash(vertex,smoothingGroup); ; slot=(slot+1ull)&mask)
+			{
+				const uint32_t ix = m_slots[slot];
+				if (ix==Empty)
+				{
+					m_slots[slot] = static_cast<uint32_t>(m_vertices.size());
+					m_vertices.push_back(vertex);
+					m_smoothingGroups.push_back(smoothingGroup);
+					return m_slots[slot];
+				}
+				// bitwise, so that the NaN UVs of untextured vertices compare equal
+				if (m_smoothingGroups[ix]==smoothingGroup && memcmp(&m_vertices[ix],&vertex,sizeof(SObjVertex))==0)
+					return ix;
+			}
+		}
+
+	private:
+		static inline constexpr uint32_t Empty = ~0u;
+
+		inline size_t hash(const SObjVertex& vertex, const uint32_t smoothingGroup) const
+		{
+			static_assert(sizeof(SObjVertex)%sizeof(uint32_t)==0u);
+			uint32_t words[sizeof(SObjVertex)/sizeof(uint32_t)];
+			memcpy(words,&vertex,sizeof(SObjVertex));
+			uint64_t retval = smoothingGroup;
+			for (const auto word : words)
+				retval = (retval^word)*0x9E3779B97F4A7C15ull;
+			// multiplication only mixes upwards, so take the top bits
+			return static_cast<size_t>(retval>>(64u-m_log2SlotCount));
+		}
+
+		inline void rehash(const uint32_t log2SlotCount)
+		{
+			m_log2SlotCount = log2SlotCount;
+			m_slots.assign(0x1ull<<log2SlotCount,Empty);
+			const size_t mask = m_slots.size()-1ull;
+			for (uint32_t ix=0u; ix<m_vertices.size(); ix++)
+			{
+				size_t slot = hash(m_vertices[ix],m_smoothingGroups[ix]);
+				while (m_slots[slot]!=Empty)
+					slot = (slot+1ull)&mask;
+				m_slots[slot] = ix;
+			}
+		}
+
+		core::vector<SObjVertex>& m_vertices;
+		core::vector<uint32_t>& m_smoothingGroups;
+		core::vector<uint32_t> m_slots;
+		uint32_t m_log2SlotCount;
+};
+
+inline bool isBlank(const char c)
+{
+	return c==' ' || c=='\t' || c=='\v' || c=='\f';
+}
+
+//! Returns the first '\n' or '\r' at or after `ptr`, or `end`
+inline const char* findLineEnd(const char* ptr, const char* const end)
+{
+#ifdef __NBL_COMPILE_WITH_X86_SIMD_
+	const __m128i newline = _mm_set1_epi8('\n');
+	const __m128i carriageReturn = _mm_set1_epi8('\r');
+	for (; end-ptr>=16; ptr+=16)
+	{
+		const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+		const uint32_t mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chars,newline),_mm_cmpeq_epi8(chars,carriageReturn)));
+		if (mask)
+			return ptr+std::countr_zero(mask);
+	}
+#endif
+	while (ptr!=end && *ptr!='\n' && *ptr!='\r')
+		++ptr;
+	return ptr;
+}
+
+inline const char* skipBlanks(const char* ptr, const char* const end)
+{
+	while (ptr!=end && isBlank(*ptr))
+		++ptr;
+	return ptr;
+}
+
+inline const char* skipWord(const char* ptr, const char* const end)
+{
+	while (ptr!=end && !isBlank(*ptr))
+		++ptr;
+	return ptr;
+}
+
+//! Returns the first word after the keyword the line starts with
+inline std::string_view getArgument(const char* const line, const char* const lineEnd)
+{
+	const char* const begin = skipBlanks(skipWord(line,lineEnd),lineEnd);
+	return std::string_view(begin,skipWord(begin,lineEnd)-begin);
+}
+
+//! 'p', 't' or 'n' for `v`, `vt` and `vn` lines, 0 for anything else
+inline char getVertexDataType(const char* const line, const char* const lineEnd)
+{
+	if (lineEnd-line<2 || line[0]!='v')
+		return 0;
+	switch (line[1])
+	{
+		case ' ':
+			return 'p';
+		case 't':
+		case 'n':
+			return line[1];
+		default:
+			break;
+	}
+	return 0;
+}
+
+//! Decimal float parsing with Clinger's fast path, anything it can't round exactly (long mantissas, huge exponents, inf, nan) goes through `strtof`
+/** The fast path computes in `double`, rounding that to `float` again is only wrong when the `double` landed exactly halfway between two floats. */
+const char* parseFloat(const char* const begin, const char* const end, float& out)
+{
+	constexpr double powersOf10[] = {
+		1e0,1e1,1e2,1e3,1e4,1e5,1e6,1e7,1e8,1e9,1e10,1e11,
+		1e12,1e13,1e14,1e15,1e16,1e17,1e18,1e19,1e20,1e21,1e22
+	};
+	constexpr uint32_t MaxDigits = 19u;
+
+	const char* ptr = begin;
+	const bool negative = ptr!=end && *ptr=='-';
+	if (ptr!=end && (*ptr=='-' || *ptr=='+'))
+		++ptr;
+
+	uint64_t mantissa = 0ull;
+	int32_t exponent = 0;
+	uint32_t significantDigits = 0u;
+	bool anyDigits = false, exact = true;
+	auto accumulate = [&](const char c) -> bool
+	{
+		anyDigits = true;
+		if (significantDigits<MaxDigits)
+		{
+			mantissa = mantissa*10ull+(c-'0');
+			// leading zeroes are free
+			if (mantissa)
+				significantDigits++;
+			return true;
+		}
+		exact &= c=='0';
+		return false;
+	};
+	for (; ptr!=end && core::isdigit(*ptr); ++ptr)
+	if (!accumulate(*ptr))
+		exponent++;
+	if (ptr!=end && *ptr=='.')
+	for (++ptr; ptr!=end && core::isdigit(*ptr); ++ptr)
+	if (accumulate(*ptr))
+		exponent--;
+	if (anyDigits && ptr!=end && (*ptr=='e' || *ptr=='E'))
+	{
+		const char* expPtr = ptr+1;
+		const bool negativeExp = expPtr!=end && *expPtr=='-';
+		if (expPtr!=end && (*expPtr=='-' || *expPtr=='+'))
+			++expPtr;
+		if (expPtr!=end && core::isdigit(*expPtr))
+		{
+			int32_t explicitExp = 0;
+			for (; expPtr!=end && core::isdigit(*expPtr); ++expPtr)
+			if (explicitExp<100000)
+				explicitExp = explicitExp*10+(*expPtr-'0');
+			exponent += negativeExp ? -explicitExp:explicitExp;
+			ptr = expPtr;
+		}
+	}
+
+	if (anyDigits && exact && mantissa<=(0x1ull<<53) && exponent>=-22 && exponent<=22)
+	{
+		double value = static_cast<double>(mantissa);
+		if (exponent<0)
+			value /= powersOf10[-exponent];
+		else
+			value *= powersOf10[exponent];
+		// the result is always a normal float, so these are the 29 mantissa bits the conversion drops
+		constexpr uint64_t DroppedBits = (0x1ull<<29u)-1ull;
+		if ((std::bit_cast<uint64_t>(value)&DroppedBits)!=(0x1ull<<28u))
+		{
+			out = static_cast<float>(negative ? -value:value);
+			return ptr;
+		}
+	}
+
+	// slow path needs a null terminated copy
+	char word[64];
+	const size_t length = std::min<size_t>(skipWord(begin,end)-begin,sizeof(word)-1ull);
+	memcpy(word,begin,length);
+	word[length] = 0;
+	char* wordEnd;
+	out = strtof(word,&wordEnd);
+	return begin+(wordEnd-word);
+}
+
+//! Reads up to `N` whitespace separated floats, missing ones stay 0
+template<uint32_t N>
+inline void readFloats(const char* ptr, const char* const lineEnd, float (&out)[N])
+{
+	for (uint32_t i=0u; i<N; i++)
+	{
+		out[i] = 0.f;
+		ptr = skipBlanks(ptr,lineEnd);
+		if (ptr==lineEnd)
+			continue;
+		parseFloat(ptr,lineEnd,out[i]);
+		ptr = skipWord(ptr,lineEnd);
+	}
+}
+}
+
+core::vector<COBJMeshFileLoader::SChunk> COBJMeshFileLoader::splitIntoChunks(const char* const begin, const char* const end, const uint32_t maxChunks)
+{
+	// below this it's not worth going wide
+	constexpr size_t MinChunkSize = 0x1ull<<20;
+
+	const size_t size = end-begin;
+	const size_t chunkCount = std::clamp<size_t>(size/MinChunkSize,1ull,maxChunks);
+	core::vector<SChunk> chunks;
+	chunks.reserve(chunkCount);
+	const char* chunkBegin = begin;
+	for (size_t i=1ull; i<=chunkCount && chunkBegin!=end; i++)
+	{
+		const char* chunkEnd = end;
+		if (i!=chunkCount)
+		{
+			// cut right after a line break, so a line never straddles two chunks
+			chunkEnd = std::max(begin+size*i/chunkCount,chunkBegin);
+			const void* newline = memchr(chunkEnd,'\n',end-chunkEnd);
+			chunkEnd = newline ? (reinterpret_cast<const char*>(newline)+1):end;
+		}
+		auto& chunk = chunks.emplace_back();
+		chunk.begin = chunkBegin;
+		chunk.end = chunkEnd;
+		chunkBegin = chunkEnd;
+	}
+	return chunks;
+}
+
+void COBJMeshFileLoader::countVertexData(SChunk& chunk)
+{
+	for (const char* line=chunk.begin; line!=chunk.end; )
+	{
+		line = skipBlanks(line,chunk.end);
+		const char* const lineEnd = findLineEnd(line,chunk.end);
+		switch (getVertexDataType(line,lineEnd))
+		{
+			case 'p':
+				chunk.positionCount++;
+				break;
+			case 't':
+				chunk.uvCount++;
+				break;
+			case 'n':
+				chunk.normalCount++;
+				break;
+			default:
+				break;
+		}
+		line = lineEnd!=chunk.end ? (lineEnd+1):lineEnd;
+	}
+}
+
+void COBJMeshFileLoader::parseChunk(SChunk& chunk, SVertexData& data, const bool rightHanded)
+{
+	uint32_t positionIx = chunk.positionBase, uvIx = chunk.uvBase, normalIx = chunk.normalBase;
+	// 1-based, negative ones are relative to the vertex data so far, 0 means absent
+	auto resolve = [&chunk](const int64_t ix, const uint32_t definedSoFar, const size_t total, const bool required) -> int32_t
+	{
+		const int64_t retval = ix<0ll ? (definedSoFar+ix):(ix-1ll);
+		if (ix==0ll && !required)
+			return -1;
+		if (retval<0ll || retval>=static_cast<int64_t>(total))
+		{
+			chunk.valid = false;
+			return required ? 0:-1;
+		}
+		return static_cast<int32_t>(retval);
+	};
+
+	bool inVertexDataRun = false;
+	for (const char* line=chunk.begin; line!=chunk.end; )
+	{
+		line = skipBlanks(line,chunk.end);
+		const char* const lineEnd = findLineEnd(line,chunk.end);
+		if (line==lineEnd)
+		{
+			line = lineEnd!=chunk.end ? (lineEnd+1):lineEnd;
+			continue;
+		}
+
+		const auto faceIx = static_cast<uint32_t>(chunk.faceCornerCounts.size());
+		if (line[0]=='v')
+		{
+			if (!inVertexDataRun)
+				chunk.statements.push_back({faceIx,'v',{}});
+			inVertexDataRun = true;
+			const char* const values = line+2;
+			switch (getVertexDataType(line,lineEnd))
+			{
+				case 'p':
+				{
+					auto& position = data.positions[positionIx++].data;
+					readFloats(values,lineEnd,position);
+					// change handedness, unless the user asked us not to
+					if (!rightHanded)
+						position[0] = -position[0];
+					break;
+				}
+				case 't':
+				{
+					auto& uv = data.uvs[uvIx++].data;
+					readFloats(values,lineEnd,uv);
+					uv[1] = 1.f-uv[1];
+					break;
+				}
+				case 'n':
+				{
+					auto& normal = data.normals[normalIx++].data;
+					readFloats(values,lineEnd,normal);
+					if (!rightHanded)
+						normal[0] = -normal[0];
+					break;
+				}
+				default:
+					break;
+			}
+		}
+		else
+		{
+			inVertexDataRun = false;
+			switch (line[0])
+			{
+				case 'f':
+				{
+					uint32_t cornerCount = 0u;
+					for (const char* ptr=skipBlanks(skipWord(line,lineEnd),lineEnd); ptr!=lineEnd; ptr=skipBlanks(skipWord(ptr,lineEnd),lineEnd))
+					{
+						int64_t ix[3] = {0ll,0ll,0ll};
+						for (uint32_t type=0u; type<3u; type++)
+						{
+							ptr = std::from_chars(ptr,lineEnd,ix[type]).ptr;
+							if (ptr==lineEnd || *ptr!='/')
+								break;
+							++ptr;
+						}
+						chunk.corners.push_back(resolve(ix[0],positionIx,data.positions.size(),true));
+						chunk.corners.push_back(resolve(ix[1],uvIx,data.uvs.size(),false));
+						chunk.corners.push_back(resolve(ix[2],normalIx,data.normals.size(),false));
+						cornerCount++;
+					}
+					chunk.faceCornerCounts.push_back(cornerCount);
+					break;
+				}
+				case 'm':
+				case 'g':
+				case 's':
+				case 'u':
+					chunk.statements.push_back({faceIx,line[0],getArgument(line,lineEnd)});
+					break;
+				case '#': // comment
+				default:
+					break;
+			}
+		}
+		line = lineEnd!=chunk.end ? (lineEnd+1):lineEnd;
+	}
+}
+
 //! Constructor
 COBJMeshFileLoader::COBJMeshFileLoader(IAssetManager* _manager) : AssetManager(_manager), System(_manager->getSystem())
 {
@@ -70,9 +460,6 @@ asset::SAssetBundle COBJMeshFileLoader::loadAsset(system::IFile* _file, const as
 	if (!filesize)
         return {};
 
-	const uint32_t WORD_BUFFER_LENGTH = 512u;
-    char tmpbuf[WORD_BUFFER_LENGTH]{};
-
 	uint32_t smoothingGroup=0;
 
 	const std::filesystem::path fullName = _file->getFileName();
@@ -100,170 +487,163 @@ asset::SAssetBundle COBJMeshFileLoader::loadAsset(system::IFile* _file, const as
 	};
     core::unordered_multiset<pipeline_meta_pair_t,hash_t,key_equal_t> pipelines;
 
-	// TODO: map the file whenever possible
-    std::string fileContents;
-    fileContents.resize(filesize);
-	char* const buf = fileContents.data();
-
-	system::IFile::success_t success;
-	_file->read(success, buf, 0, filesize);
-	if (!success)
+	// parses straight out of the mapping when there is one
+	const system::IFile::CReadView fileContents(_file,0ull,filesize);
+	if (!fileContents)
 		return {};
 
-	const char* const bufEnd = buf+filesize;
-	// Process obj information
-	const char* bufPtr = buf;
+	// two parallel passes over line aligned chunks, the first one only counts vertex data so the second can resolve relative indices and write straight into place
+	auto* const scheduler = AssetManager->getScheduler();
+	core::vector<SChunk> chunks = splitIntoChunks(fileContents.begin(),fileContents.end(),scheduler->getConcurrency()*4u);
+	scheduler->parallel_for(chunks.size(),[&chunks](const size_t i)->void{countVertexData(chunks[i]);},0u,1u);
+
+	SVertexData vertexData;
+	{
+		uint32_t positionCount = 0u, uvCount = 0u, normalCount = 0u;
+		for (auto& chunk : chunks)
+		{
+			chunk.positionBase = positionCount;
+			chunk.uvBase = uvCount;
+			chunk.normalBase = normalCount;
+			positionCount += chunk.positionCount;
+			uvCount += chunk.uvCount;
+			normalCount += chunk.normalCount;
+		}
+		vertexData.positions.resize(positionCount);
+		vertexData.uvs.resize(uvCount);
+		vertexData.normals.resize(normalCount);
+	}
+	const bool rightHanded = _params.loaderFlags & E_LOADER_PARAMETER_FLAGS::ELPF_RIGHT_HANDED_MESHES;
+	scheduler->parallel_for(chunks.size(),[&](const size_t i)->void{parseChunk(chunks[i],vertexData,rightHanded);},0u,1u);
+
 	std::string grpName, mtlName;
 
 	auto performActionBasedOnOrientationSystem = [&](auto performOnRightHanded, auto performOnLeftHanded)
 	{
-		if (_params.loaderFlags & E_LOADER_PARAMETER_FLAGS::ELPF_RIGHT_HANDED_MESHES)
+		if (rightHanded)
 			performOnRightHanded();
 		else
 			performOnLeftHanded();
 	};
 
-
-    struct vec3 {
-        float data[3];
-    };
-    struct vec2 {
-        float data[2];
-    };
-    core::vector<vec3> vertexBuffer;
-    core::vector<vec3> normalsBuffer;
-    core::vector<vec2> textureCoordBuffer;
-
     core::vector<core::smart_refctd_ptr<ICPUMeshBuffer>> submeshes;
     core::vector<core::vector<uint32_t>> indices;
     core::vector<SObjVertex> vertices;
-    core::map<SObjVertex, uint32_t> map_vtx2ix;
     core::vector<bool> recalcNormals;
     core::vector<bool> submeshWasLoadedFromCache;
     core::vector<std::string> submeshCacheKeys;
     core::vector<std::string> submeshMaterialNames;
     core::vector<uint32_t> vtxSmoothGrp;
+    CVertexWelder welder(vertices,vtxSmoothGrp);
 
 	// TODO: handle failures much better!
 	constexpr const char* NO_MATERIAL_MTL_NAME = "#";
 	bool noMaterial = true;
 	bool dummyMaterialCreated = false;
-	while(bufPtr != bufEnd)
+	core::vector<uint32_t> faceCorners;
+	faceCorners.reserve(32ull);
+	// replay the chunks in file order, welding is cheap enough to not need going wide
+	for (const auto& chunk : chunks)
 	{
-		switch(bufPtr[0])
+		if (!chunk.valid)
 		{
-		case 'm':	// mtllib (material)
+			_params.logger.log("OBJ file %s references vertex data which doesn't exist", system::ILogger::ELL_ERROR, _file->getFileName().string().c_str());
+			return {};
+		}
+
+		auto statement = chunk.statements.begin();
+		const int32_t* corner = chunk.corners.data();
+		for (uint32_t faceIx=0u; ; faceIx++)
 		{
-			if (ctx.useMaterials)
+			for (; statement!=chunk.statements.end() && statement->faceIx==faceIx; statement++)
+			switch (statement->type)
 			{
-				bufPtr = goAndCopyNextWord(tmpbuf, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-				_params.logger.log("Reading material _file %s", system::ILogger::ELL_DEBUG, tmpbuf);
-
-                std::string mtllib = tmpbuf;
-                std::replace(mtllib.begin(), mtllib.end(), '\\', '/');
-                SAssetLoadParams loadParams(_params);
-				loadParams.workingDirectory = _file->getFileName().parent_path();
-                auto bundle = interm_getAssetInHierarchy(AssetManager, mtllib, loadParams, _hierarchyLevel+ICPUMesh::PIPELINE_HIERARCHYLEVELS_BELOW, _override);
-                
-				if (bundle.getContents().empty())
-					break;
-
-				if (bundle.getMetadata())
+			case 'm':	// mtllib (material)
+			{
+				if (ctx.useMaterials && !statement->argument.empty())
 				{
-					auto meta = bundle.getMetadata()->selfCast<const CMTLMetadata>();
-					if (bundle.getAssetType()==IAsset::ET_RENDERPASS_INDEPENDENT_PIPELINE)
-					for (auto ass : bundle.getContents())
-					{
-						auto ppln = core::smart_refctd_ptr_static_cast<ICPURenderpassIndependentPipeline>(ass);
-						const auto pplnMeta = meta->getAssetSpecificMetadata(ppln.get());
-						if (!pplnMeta)
-							continue;
+					std::string mtllib(statement->argument);
+					_params.logger.log("Reading material _file %s", system::ILogger::ELL_DEBUG, mtllib.c_str());
+
+					std::replace(mtllib.begin(), mtllib.end(), '\\', '/');
+					SAssetLoadParams loadParams(_params);
+					loadParams.workingDirectory = _file->getFileName().parent_path();
+					auto bundle = interm_getAssetInHierarchy(AssetManager, mtllib, loadParams, _hierarchyLevel+ICPUMesh::PIPELINE_HIERARCHYLEVELS_BELOW, _override);
 
-						pipelines.emplace(std::move(ppln),pplnMeta);
+					if (bundle.getContents().empty())
+						break;
+
+					if (bundle.getMetadata())
+					{
+						auto meta = bundle.getMetadata()->selfCast<const CMTLMetadata>();
+						if (bundle.getAssetType()==IAsset::ET_RENDERPASS_INDEPENDENT_PIPELINE)
+						for (auto ass : bundle.getContents())
+						{
+							auto ppln = core::smart_refctd_ptr_static_cast<ICPURenderpassIndependentPipeline>(ass);
+							const auto pplnMeta = meta->getAssetSpecificMetadata(ppln.get());
+							if (!pplnMeta)
+								continue;
+
+							pipelines.emplace(std::move(ppln),pplnMeta);
+						}
 					}
 				}
 			}
-		}
-			break;
+				break;
 
-		case 'v':               // v, vn, vt
-			//reset flags
-			noMaterial = true;
-			dummyMaterialCreated = false;
-			switch(bufPtr[1])
-			{
-			case ' ':          // vertex
-				{
-					vec3 vec;
-					bufPtr = readVec3(bufPtr, vec.data, bufEnd);
-					performActionBasedOnOrientationSystem([&]() {vec.data[0] = -vec.data[0];}, [&]() {});
-					vertexBuffer.push_back(vec);
-				}
+			case 'v':	// start of a run of v, vn, vt
+				//reset flags
+				noMaterial = true;
+				dummyMaterialCreated = false;
 				break;
 
-			case 'n':       // normal
+			case 'g': // group name
+				grpName = statement->argument;
+				break;
+			case 's': // smoothing can be a group or off (equiv. to 0)
 				{
-					vec3 vec;
-					bufPtr = readVec3(bufPtr, vec.data, bufEnd);
-					performActionBasedOnOrientationSystem([&]() {vec.data[0] = -vec.data[0]; }, [&]() {});
-					normalsBuffer.push_back(vec);
+					const auto& word = statement->argument;
+					_params.logger.log("Loaded smoothing group start %s",system::ILogger::ELL_DEBUG, std::string(word).c_str());
+					if (word=="off")
+						smoothingGroup=0u;
+					else
+						std::from_chars(word.data(),word.data()+word.size(),smoothingGroup);
 				}
 				break;
 
-			case 't':       // texcoord
+			case 'u': // usemtl
+				// get name of material
 				{
-					vec2 vec;
-					bufPtr = readUV(bufPtr, vec.data, bufEnd);
-					textureCoordBuffer.push_back(vec);
+					noMaterial = false;
+					mtlName = statement->argument;
+					_params.logger.log("Loaded material start %s", system::ILogger::ELL_DEBUG, mtlName.c_str());
+
+					if (ctx.useMaterials && !ctx.useGroups)
+					{
+						asset::IAsset::E_TYPE types[] {asset::IAsset::ET_SUB_MESH, (asset::IAsset::E_TYPE)0u };
+						auto mb_bundle = _override->findCachedAsset(genKeyForMeshBuf(ctx, _file->getFileName().string(), mtlName, grpName), types, ctx.inner, _hierarchyLevel+ICPUMesh::MESHBUFFER_HIERARCHYLEVELS_BELOW);
+						auto mbs = mb_bundle.getContents();
+						bool notempty = mbs.size()!=0ull;
+						{
+							auto mb = notempty ? core::smart_refctd_ptr_static_cast<ICPUMeshBuffer>(*mbs.begin()) : core::make_smart_refctd_ptr<ICPUMeshBuffer>();
+							submeshes.push_back(std::move(mb));
+						}
+						indices.emplace_back();
+						recalcNormals.push_back(false);
+						submeshWasLoadedFromCache.push_back(notempty);
+						//if submesh was loaded from cache - insert empty "cache key" (submesh loaded from cache won't be added to cache again)
+						submeshCacheKeys.push_back(submeshWasLoadedFromCache.back() ? "" : genKeyForMeshBuf(ctx, _file->getFileName().string(), mtlName, grpName));
+						submeshMaterialNames.push_back(mtlName);
+					}
 				}
 				break;
+			default:
+				break;
 			}
-			break;
-
-		case 'g': // group name
-            bufPtr = goAndCopyNextWord(tmpbuf, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-            grpName = tmpbuf;
-			break;
-		case 's': // smoothing can be a group or off (equiv. to 0)
-			{
-				bufPtr = goAndCopyNextWord(tmpbuf, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-				_params.logger.log("Loaded smoothing group start %s",system::ILogger::ELL_DEBUG, tmpbuf);
-				if (strcmp("off", tmpbuf)==0)
-					smoothingGroup=0u;
-				else
-                    sscanf(tmpbuf,"%u",&smoothingGroup);
-			}
-			break;
-
-		case 'u': // usemtl
-			// get name of material
-			{
-				noMaterial = false;
-				bufPtr = goAndCopyNextWord(tmpbuf, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-				_params.logger.log("Loaded material start %s", system::ILogger::ELL_DEBUG, tmpbuf);
-				mtlName=tmpbuf;
+			if (faceIx==chunk.faceCornerCounts.size())
+				break;
 
-                if (ctx.useMaterials && !ctx.useGroups)
-                {
-                    asset::IAsset::E_TYPE types[] {asset::IAsset::ET_SUB_MESH, (asset::IAsset::E_TYPE)0u };
-                    auto mb_bundle = _override->findCachedAsset(genKeyForMeshBuf(ctx, _file->getFileName().string(), mtlName, grpName), types, ctx.inner, _hierarchyLevel+ICPUMesh::MESHBUFFER_HIERARCHYLEVELS_BELOW);
-                    auto mbs = mb_bundle.getContents();
-					bool notempty = mbs.size()!=0ull;
-                    {
-                        auto mb = notempty ? core::smart_refctd_ptr_static_cast<ICPUMeshBuffer>(*mbs.begin()) : core::make_smart_refctd_ptr<ICPUMeshBuffer>();
-                        submeshes.push_back(std::move(mb));
-                    }
-                    indices.emplace_back();
-                    recalcNormals.push_back(false);
-                    submeshWasLoadedFromCache.push_back(notempty);
-                    //if submesh was loaded from cache - insert empty "cache key" (submesh loaded from cache won't be added to cache again)
-                    submeshCacheKeys.push_back(submeshWasLoadedFromCache.back() ? "" : genKeyForMeshBuf(ctx, _file->getFileName().string(), mtlName, grpName));
-                    submeshMaterialNames.push_back(mtlName);
-                }
-			}
-			break;
-		case 'f':               // face
-		{
+			// face
 			if (noMaterial && !dummyMaterialCreated)
 			{
 				dummyMaterialCreated = true;
@@ -277,77 +657,41 @@ asset::SAssetBundle COBJMeshFileLoader::loadAsset(system::IFile* _file, const as
 			}
 
 			SObjVertex v;
-
-			// get all vertices data in this face (current line of obj _file)
-			const std::string wordBuffer = copyLine(bufPtr, bufEnd);
-			const char* linePtr = wordBuffer.c_str();
-			const char* const endPtr = linePtr + wordBuffer.size();
-
-			core::vector<uint32_t> faceCorners;
-			faceCorners.reserve(32ull);
-
-			// read in all vertices
-			linePtr = goNextWord(linePtr, endPtr);
-			while (0 != linePtr[0])
+			faceCorners.clear();
+			for (const int32_t* const cornersEnd=corner+3u*chunk.faceCornerCounts[faceIx]; corner!=cornersEnd; corner+=3)
 			{
-				// Array to communicate with retrieveVertexIndices()
-				// sends the buffer sizes and gets the actual indices
-				// if index not set returns -1
-				int32_t Idx[3];
-				Idx[1] = Idx[2] = -1;
-
-				// read in next vertex's data
-				uint32_t wlength = copyWord(tmpbuf, linePtr, WORD_BUFFER_LENGTH, endPtr);
-				// this function will also convert obj's 1-based index to c++'s 0-based index
-				retrieveVertexIndices(tmpbuf, Idx, tmpbuf+wlength+1, vertexBuffer.size(), textureCoordBuffer.size(), normalsBuffer.size());
-				v.pos[0] = vertexBuffer[Idx[0]].data[0];
-				v.pos[1] = vertexBuffer[Idx[0]].data[1];
-				v.pos[2] = vertexBuffer[Idx[0]].data[2];
+				const auto& position = vertexData.positions[corner[0]].data;
+				std::copy_n(position,3,v.pos);
 				//set texcoord
-				if ( -1 != Idx[1] )
-                {
-					v.uv[0] = textureCoordBuffer[Idx[1]].data[0];
-					v.uv[1] = textureCoordBuffer[Idx[1]].data[1];
-                }
+				if (corner[1]!=-1)
+				{
+					v.uv[0] = vertexData.uvs[corner[1]].data[0];
+					v.uv[1] = vertexData.uvs[corner[1]].data[1];
+				}
 				else
-                {
+				{
 					v.uv[0] = core::nan<float>();
 					v.uv[1] = core::nan<float>();
-                }
-                //set normal
-				if ( -1 != Idx[2] )
-                {
+				}
+				//set normal
+				if (corner[2]!=-1)
+				{
 					core::vectorSIMDf simdNormal;
-					simdNormal.set(normalsBuffer[Idx[2]].data);
-                    simdNormal.makeSafe3D();
+					simdNormal.set(vertexData.normals[corner[2]].data);
+					simdNormal.makeSafe3D();
 					v.normal32bit = quantNormalCache->quantize<EF_A2B10G10R10_SNORM_PACK32>(simdNormal);
-                }
-				else
-				{
-					v.normal32bit = core::vectorSIMDu32(0u);
-                    recalcNormals.back() = true;
 				}
-
-				uint32_t ix;
-				auto vtx_ix = map_vtx2ix.find(v);
-				if (vtx_ix != map_vtx2ix.end() && smoothingGroup==vtxSmoothGrp[vtx_ix->second])
-					ix = vtx_ix->second;
 				else
 				{
-					ix = vertices.size();
-					vertices.push_back(v);
-                    vtxSmoothGrp.push_back(smoothingGroup);
-					map_vtx2ix.insert({v, ix});
+					v.normal32bit = core::vectorSIMDu32(0u);
+					recalcNormals.back() = true;
 				}
 
-				faceCorners.push_back(ix);
-
-				// go to next vertex
-				linePtr = goNextWord(linePtr, endPtr);
+				faceCorners.push_back(welder.weld(v,smoothingGroup));
 			}
 
             // triangulate the face
-            for (uint32_t i = 1u; i < faceCorners.size()-1u; ++i)
+            for (uint32_t i = 1u; i+1u < faceCorners.size(); ++i)
             {
                 // Add a triangle
                 performActionBasedOnOrientationSystem
@@ -367,15 +711,7 @@ asset::SAssetBundle COBJMeshFileLoader::loadAsset(system::IFile* _file, const as
                 );
             }
 		}
-		break;
-
-		case '#': // comment
-		default:
-			break;
-		}	// end switch(bufPtr[0])
-		// eat up rest of line
-		bufPtr = goNextLine(bufPtr, bufEnd);
-	}	// end while(bufPtr && (bufPtr-buf<filesize))
+	}
 
 	// prune out invalid empty shape groups (TODO: convert to AoS and use an erase_if)
 	for (size_t i = 0ull; i < submeshes.size(); ++i)
@@ -528,212 +864,6 @@ asset::SAssetBundle COBJMeshFileLoader::loadAsset(system::IFile* _file, const as
 }
 
 
-//! Read 3d vector of floats
-const char* COBJMeshFileLoader::readVec3(const char* bufPtr, float vec[3], const char* const bufEnd)
-{
-	const uint32_t WORD_BUFFER_LENGTH = 256;
-	char wordBuffer[WORD_BUFFER_LENGTH];
-
-	bufPtr = goAndCopyNextWord(wordBuffer, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-	sscanf(wordBuffer,"%f",vec);
-	bufPtr = goAndCopyNextWord(wordBuffer, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-	sscanf(wordBuffer,"%f",vec+1);
-	bufPtr = goAndCopyNextWord(wordBuffer, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-	sscanf(wordBuffer,"%f",vec+2);
-
-    vec[0] = -vec[0]; // change handedness
-	return bufPtr;
-}
-
-
-//! Read 2d vector of floats
-const char* COBJMeshFileLoader::readUV(const char* bufPtr, float vec[2], const char* const bufEnd)
-{
-	const uint32_t WORD_BUFFER_LENGTH = 256;
-	char wordBuffer[WORD_BUFFER_LENGTH];
-
-	bufPtr = goAndCopyNextWord(wordBuffer, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-	sscanf(wordBuffer,"%f",vec);
-	bufPtr = goAndCopyNextWord(wordBuffer, bufPtr, WORD_BUFFER_LENGTH, bufEnd);
-	sscanf(wordBuffer,"%f",vec+1);
-
-	vec[1] = 1.f-vec[1]; // change handedness
-	return bufPtr;
-}
-
-
-//! Read boolean value represented as 'on' or 'off'
-const char* COBJMeshFileLoader::readBool(const char* bufPtr, bool& tf, const char* const bufEnd)
-{
-	const uint32_t BUFFER_LENGTH = 8;
-	char tfStr[BUFFER_LENGTH];
-
-	bufPtr = goAndCopyNextWord(tfStr, bufPtr, BUFFER_LENGTH, bufEnd);
-	tf = strcmp(tfStr, "off") != 0;
-	return bufPtr;
-}
-
-//! skip space characters and stop on first non-space
-const char* COBJMeshFileLoader::goFirstWord(const char* buf, const char* const bufEnd, bool acrossNewlines)
-{
-	// skip space characters
-	if (acrossNewlines)
-		while((buf != bufEnd) && core::isspace(*buf))
-			++buf;
-	else
-		while((buf != bufEnd) && core::isspace(*buf) && (*buf != '\n'))
-			++buf;
-
-	return buf;
-}
-
-
-//! skip current word and stop at beginning of next one
-const char* COBJMeshFileLoader::goNextWord(const char* buf, const char* const bufEnd, bool acrossNewlines)
-{
-	// skip current word
-	while(( buf != bufEnd ) && !core::isspace(*buf))
-		++buf;
-
-	return goFirstWord(buf, bufEnd, acrossNewlines);
-}
-
-
-//! Read until line break is reached and stop at the next non-space character
-const char* COBJMeshFileLoader::goNextLine(const char* buf, const char* const bufEnd)
-{
-	// look for newline characters
-	while(buf != bufEnd)
-	{
-		// found it, so leave
-		if (*buf=='\n' || *buf=='\r')
-			break;
-		++buf;
-	}
-	return goFirstWord(buf, bufEnd);
-}
-
-
-uint32_t COBJMeshFileLoader::copyWord(char* outBuf, const char* const inBuf, uint32_t outBufLength, const char* const bufEnd)
-{
-	if (!outBufLength)
-		return 0;
-	if (!inBuf)
-	{
-		*outBuf = 0;
-		return 0;
-	}
-
-	uint32_t i = 0;
-	while(inBuf[i])
-	{
-		if (core::isspace(inBuf[i]) || &(inBuf[i]) == bufEnd)
-			break;
-		++i;
-	}
-
-	uint32_t length = core::min(i, outBufLength-1);
-	for (uint32_t j=0; j<length; ++j)
-		outBuf[j] = inBuf[j];
-
-	outBuf[length] = 0;
-	return length;
-}
-
-
-std::string COBJMeshFileLoader::copyLine(const char* inBuf, const char* bufEnd)
-{
-	if (!inBuf)
-		return std::string();
-
-	const char* ptr = inBuf;
-	while (ptr<bufEnd)
-	{
-		if (*ptr=='\n' || *ptr=='\r')
-			break;
-		++ptr;
-	}
-	// we must avoid the +1 in case the array is used up
-	return std::string(inBuf, (uint32_t)(ptr-inBuf+((ptr < bufEnd) ? 1 : 0)));
-}
-
-
-const char* COBJMeshFileLoader::goAndCopyNextWord(char* outBuf, const char* inBuf, uint32_t outBufLength, const char* bufEnd)
-{
-	inBuf = goNextWord(inBuf, bufEnd, false);
-	copyWord(outBuf, inBuf, outBufLength, bufEnd);
-	return inBuf;
-}
-
-
-bool COBJMeshFileLoader::retrieveVertexIndices(char* vertexData, int32_t* idx, const char* bufEnd, uint32_t vbsize, uint32_t vtsize, uint32_t vnsize)
-{
-	char word[16] = "";
-	const char* p = goFirstWord(vertexData, bufEnd);
-	uint32_t idxType = 0;	// 0 = posIdx, 1 = texcoordIdx, 2 = normalIdx
-
-	uint32_t i = 0;
-	while ( p != bufEnd )
-	{
-		if ( ( core::isdigit(*p)) || (*p == '-') )
-		{
-			// build up the number
-			word[i++] = *p;
-		}
-		else if ( *p == '/' || *p == ' ' || *p == '\0' )
-		{
-			// number is completed. Convert and store it
-			word[i] = '\0';
-			// if no number was found index will become 0 and later on -1 by decrement
-			sscanf(word,"%d",idx+idxType);
-			if (idx[idxType]<0)
-			{
-				switch (idxType)
-				{
-					case 0:
-						idx[idxType] += vbsize;
-						break;
-					case 1:
-						idx[idxType] += vtsize;
-						break;
-					case 2:
-						idx[idxType] += vnsize;
-						break;
-				}
-			}
-			else
-				idx[idxType]-=1;
-
-			// reset the word
-			word[0] = '\0';
-			i = 0;
-
-			// go to the next kind of index type
-			if (*p == '/')
-			{
-				if ( ++idxType > 2 )
-				{
-					// error checking, shouldn't reach here unless file is wrong
-					idxType = 0;
-				}
-			}
-			else
-			{
-				// set all missing values to disable (=-1)
-				while (++idxType < 3)
-					idx[idxType]=-1;
-				++p;
-				break; // while
-			}
-		}
-
-		// go to the next char
-		++p;
-	}
-
-	return true;
-}
-
 std::string COBJMeshFileLoader::genKeyForMeshBuf(const SContext& _ctx, const std::string& _baseKey, const std::string& _mtlName, const std::string& _grpName) const
 {
     return _baseKey + "?" + _grpName + "?" + _mtlName;
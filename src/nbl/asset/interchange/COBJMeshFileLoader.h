@@ -96,31 +96,52 @@ public:
     virtual asset::SAssetBundle loadAsset(system::IFile* _file, const asset::IAssetLoader::SAssetLoadParams& _params, asset::IAssetLoader::IAssetLoaderOverride* _override = nullptr, uint32_t _hierarchyLevel = 0u) override;
 
 private:
-	// returns a pointer to the first printable character available in the buffer
-	const char* goFirstWord(const char* buf, const char* const bufEnd, bool acrossNewlines=true);
-	// returns a pointer to the first printable character after the first non-printable
-	const char* goNextWord(const char* buf, const char* const bufEnd, bool acrossNewlines=true);
-	// returns a pointer to the next printable character after the first line break
-	const char* goNextLine(const char* buf, const char* const bufEnd);
-	// copies the current word from the inBuf to the outBuf
-	uint32_t copyWord(char* outBuf, const char* inBuf, uint32_t outBufLength, const char* const pBufEnd);
-	// copies the current line from the inBuf to the outBuf
-	std::string copyLine(const char* inBuf, const char* const bufEnd);
-
-	// combination of goNextWord followed by copyWord
-	const char* goAndCopyNextWord(char* outBuf, const char* inBuf, uint32_t outBufLength, const char* const pBufEnd);
-
-	//! Read 3d vector of floats
-	const char* readVec3(const char* bufPtr, float vec[3], const char* const pBufEnd);
-	//! Read 2d vector of floats
-	const char* readUV(const char* bufPtr, float vec[2], const char* const pBufEnd);
-	//! Read boolean value represented as 'on' or 'off'
-	const char* readBool(const char* bufPtr, bool& tf, const char* const bufEnd);
-
-	// reads and convert to integer the vertex indices in a line of obj file's face statement
-	// -1 for the index if it doesn't exist
-	// indices are changed to 0-based index instead of 1-based from the obj file
-	bool retrieveVertexIndices(char* vertexData, int32_t* idx, const char* bufEnd, uint32_t vbsize, uint32_t vtsize, uint32_t vnsize);
+    struct SVec3
+    {
+        float data[3];
+    };
+    struct SVec2
+    {
+        float data[2];
+    };
+    //! Attribute arrays, sized up front so that chunks can be parsed straight into them in parallel
+    struct SVertexData
+    {
+        core::vector<SVec3> positions;
+        core::vector<SVec2> uvs;
+        core::vector<SVec3> normals;
+    };
+    //! Line aligned slice of the file, slices get parsed in parallel and then replayed in file order
+    struct SChunk
+    {
+        //! Any non-face statement which changes the state faces get emitted with, `v` marks the start of a run of vertex data
+        struct SStatement
+        {
+            // number of faces in the chunk preceding the statement
+            uint32_t faceIx;
+            char type;
+            std::string_view argument;
+        };
+
+        const char* begin;
+        const char* end;
+        // `v`, `vt` and `vn` statements before this chunk, needed to resolve relative indices while parsing
+        uint32_t positionBase = 0u, uvBase = 0u, normalBase = 0u;
+        uint32_t positionCount = 0u, uvCount = 0u, normalCount = 0u;
+
+        core::vector<SStatement> statements;
+        // 0-based `{position,uv,normal}` index triplets, -1 where uv or normal are absent
+        core::vector<int32_t> corners;
+        core::vector<uint32_t> faceCornerCounts;
+        bool valid = true;
+    };
+
+    // splits the file into chunks ending on line breaks, small files stay in one piece
+    static core::vector<SChunk> splitIntoChunks(const char* const begin, const char* const end, const uint32_t maxChunks);
+    // first pass, counts the `v`, `vt` and `vn` statements
+    static void countVertexData(SChunk& chunk);
+    // second pass, parses vertex data into `data` and records faces and statements in the chunk
+    static void parseChunk(SChunk& chunk, SVertexData& data, const bool rightHanded);
 
     std::string genKeyForMeshBuf(const SContext& _ctx, const std::string& _baseKey, const std::string& _mtlName, const std::string& _grpName) const;
 
@@ -324,6 +324,16 @@ asset::SAssetBundle CPLYMeshFileLoader::loadAsset(system::IFile* _file, const as
 				if (ctx.IsBinaryFile)
 				{
 					ctx.StartPointer = ctx.LineEndPointer + 1;
+					// the binary payload never gets tokenized in place, so read it straight from the mapping (or one bulk read) instead of in chunks
+					const size_t payloadOffset = ctx.fileOffset - (ctx.EndPointer - ctx.StartPointer);
+					ctx.Payload = system::IFile::CReadView(ctx.inner.mainFile, payloadOffset);
+					if (ctx.Payload)
+					{
+						ctx.StartPointer = const_cast<char*>(ctx.Payload.begin());
+						ctx.EndPointer = const_cast<char*>(ctx.Payload.end());
+						ctx.fileOffset = ctx.inner.mainFile->getSize();
+						ctx.EndOfFile = true;
+					}
 				}
 			}
 			else if (strcmp(word, "comment") == 0)
@@ -402,7 +412,8 @@ asset::SAssetBundle CPLYMeshFileLoader::loadAsset(system::IFile* _file, const as
 						}			
 					}
 
-					// loop through vertex properties
+					// loop through vertex properties, unless the whole element can be streamed at once
+					if (!ctx.IsBinaryFile || !readVertices(ctx, plyVertexElement, attributes, _params))
 					for (uint32_t j=0; j<ctx.ElementList[i]->Count; ++j)
 						hasNormals &= readVertex(ctx, plyVertexElement, attributes, j, _params);
 				}
@@ -627,6 +638,157 @@ bool CPLYMeshFileLoader::readVertex(SContext& _ctx, const SPLYElement& Element,
 }
 
 
+namespace
+{
+// decodes `count` values `srcStride` bytes apart and writes them `dstStride` floats apart
+using convert_component_t = void(*)(const uint8_t* src, const size_t srcStride, float* dst, const size_t dstStride, const size_t count, const float scale);
+
+template<typename T, bool WrongEndian>
+void convertComponent(const uint8_t* src, const size_t srcStride, float* dst, const size_t dstStride, const size_t count, const float scale)
+{
+	for (const float* const dstEnd=dst+count*dstStride; dst!=dstEnd; src+=srcStride, dst+=dstStride)
+	{
+		T value;
+		memcpy(&value, src, sizeof(T));
+		if constexpr (WrongEndian)
+			value = core::Byteswap::byteswap(value);
+		*dst = static_cast<float>(value) * scale;
+	}
+}
+
+template<typename T>
+convert_component_t getComponentConverter(const bool wrongEndian)
+{
+	return wrongEndian ? convertComponent<T,true>:convertComponent<T,false>;
+}
+}
+
+bool CPLYMeshFileLoader::readVertices(SContext& _ctx, const SPLYElement& Element, asset::SBufferBinding<asset::ICPUBuffer> outAttributes[4], const IAssetLoader::SAssetLoadParams& _params)
+{
+	// everything needs to be in memory already and at known offsets
+	if (!_ctx.Payload || !Element.IsFixedWidth || Element.KnownSize == 0u)
+		return false;
+	const size_t elementBytes = size_t(Element.KnownSize) * Element.Count;
+	if (size_t(_ctx.EndPointer - _ctx.StartPointer) < elementBytes)
+		return false;
+
+	// compile the layout once, instead of matching property names per vertex
+	struct SComponent
+	{
+		convert_component_t convert;
+		uint32_t srcOffset;
+		float* dst;
+		uint32_t dstStride;
+		float scale;
+	};
+	core::vector<SComponent> components;
+	{
+		const bool rightHanded = _params.loaderFlags & E_LOADER_PARAMETER_FLAGS::ELPF_RIGHT_HANDED_MESHES;
+		auto getAttribute = [&](const E_TYPE attribute, const uint32_t component) -> float*
+		{
+			return reinterpret_cast<float*>(outAttributes[attribute].buffer->getPointer()) + component;
+		};
+
+		uint32_t srcOffset = 0u;
+		for (const auto& property : Element.Properties)
+		{
+			SComponent item = {nullptr, srcOffset, nullptr, 0u, 1.f};
+			srcOffset += property.size();
+
+			const auto& name = property.Name;
+			bool isColor = false;
+			if (name == "x" || name == "y" || name == "z")
+			{
+				item.dst = getAttribute(ET_POS, name[0] - 'x');
+				item.dstStride = 3u;
+				if (name == "x" && rightHanded)
+					item.scale = -1.f;
+			}
+			else if (name == "nx" || name == "ny" || name == "nz")
+			{
+				item.dst = getAttribute(ET_NORM, name[1] - 'x');
+				item.dstStride = 3u;
+				if (name == "nx" && rightHanded)
+					item.scale = -1.f;
+			}
+			// there isn't a single convention for the UV, some softwares like Blender or Assimp use "st" instead of "uv"
+			else if (name == "u" || name == "s" || name == "v" || name == "t")
+			{
+				item.dst = getAttribute(ET_UV, (name == "v" || name == "t") ? 1u : 0u);
+				item.dstStride = 2u;
+			}
+			else if (name == "red" || name == "green" || name == "blue" || name == "alpha")
+			{
+				constexpr const char* channels[] = { "red","green","blue","alpha" };
+				const uint32_t channel = std::find(channels, channels + 4, name) - channels;
+				item.dst = getAttribute(ET_COL, channel);
+				item.dstStride = 4u;
+				isColor = true;
+			}
+			else
+				continue;
+
+			// integer colors are normalized, and unlike the per-vertex path always treated as unsigned
+			if (isColor && !property.isFloat())
+			{
+				item.scale = 1.f / 255.f;
+				switch (property.Type)
+				{
+					case EPLYPT_INT8:
+						item.convert = getComponentConverter<uint8_t>(_ctx.IsWrongEndian);
+						break;
+					case EPLYPT_INT16:
+						item.convert = getComponentConverter<uint16_t>(_ctx.IsWrongEndian);
+						break;
+					case EPLYPT_INT32:
+						item.convert = getComponentConverter<uint32_t>(_ctx.IsWrongEndian);
+						break;
+					default:
+						return false;
+				}
+			}
+			else switch (property.Type)
+			{
+				case EPLYPT_INT8:
+					item.convert = getComponentConverter<int8_t>(_ctx.IsWrongEndian);
+					break;
+				case EPLYPT_INT16:
+					item.convert = getComponentConverter<int16_t>(_ctx.IsWrongEndian);
+					break;
+				case EPLYPT_INT32:
+					item.convert = getComponentConverter<int32_t>(_ctx.IsWrongEndian);
+					break;
+				case EPLYPT_FLOAT32:
+					item.convert = getComponentConverter<float>(_ctx.IsWrongEndian);
+					break;
+				case EPLYPT_FLOAT64:
+					item.convert = getComponentConverter<double>(_ctx.IsWrongEndian);
+					break;
+				default:
+					return false;
+			}
+			components.push_back(item);
+		}
+	}
+
+	// strided gather over vertex ranges in parallel, one component at a time over small blocks so the source stays in L1
+	const auto* const src = reinterpret_cast<const uint8_t*>(_ctx.StartPointer);
+	const size_t stride = Element.KnownSize;
+	m_assetMgr->getScheduler()->parallel_for_range(Element.Count, [&](const size_t rangeBegin, const size_t rangeEnd) -> void
+	{
+		constexpr size_t BlockSize = 1024u;
+		for (size_t blockBegin = rangeBegin; blockBegin < rangeEnd; blockBegin += BlockSize)
+		{
+			const size_t count = std::min(BlockSize, rangeEnd - blockBegin);
+			for (const auto& component : components)
+				component.convert(src + blockBegin * stride + component.srcOffset, stride, component.dst + blockBegin * component.dstStride, component.dstStride, count, component.scale);
+		}
+	}, 0u, 0x1u << 16);
+
+	_ctx.StartPointer += elementBytes;
+	return true;
+}
+
 bool CPLYMeshFileLoader::readFace(SContext& _ctx, const SPLYElement& Element, core::vector<uint32_t>& _outIndices)
 {
 	if (!_ctx.IsBinaryFile)
@@ -1121,10 +1283,15 @@ uint32_t CPLYMeshFileLoader::getInt(SContext& _ctx, E_PLY_PROPERTY_TYPE t)
 				_ctx.StartPointer += 4;
 				break;
 			case EPLYPT_FLOAT64:
-				// todo: byteswap 64-bit
-				retVal = (uint32_t)(*(reinterpret_cast<double*>(_ctx.StartPointer)));
+			{
+				double value;
+				memcpy(&value, _ctx.StartPointer, sizeof(double));
+				if (_ctx.IsWrongEndian)
+					value = core::Byteswap::byteswap(value);
+				retVal = (uint32_t)value;
 				_ctx.StartPointer += 8;
 				break;
+			}
 			case EPLYPT_LIST:
 			case EPLYPT_UNKNOWN:
 			default:
@@ -18,7 +18,7 @@ namespace asset
 {
 
 // input buffer must be at least twice as long as the longest line in the file
-#define PLY_INPUT_BUFFER_SIZE 51200 // file is loaded in 50k chunks
+#define PLY_INPUT_BUFFER_SIZE 51200 // header and ascii files are loaded in 50k chunks
 
 enum E_PLY_PROPERTY_TYPE
 {
@@ -186,6 +186,8 @@ private:
         int32_t LineLength = 0, WordLength = 0;
 		char* StartPointer = nullptr, *EndPointer = nullptr, *LineEndPointer = nullptr;
 		size_t fileOffset = {};
+		// binary files get parsed directly from here once the header is done, instead of through `Buffer`
+		system::IFile::CReadView Payload;
     };
 
 	bool allocateBuffer(SContext& _ctx);
@@ -195,6 +197,8 @@ private:
 	E_PLY_PROPERTY_TYPE getPropertyType(const char* typeString) const;
 
  	bool readVertex(SContext& _ctx, const SPLYElement &Element, asset::SBufferBinding<asset::ICPUBuffer> outAttributes[4], const uint32_t& currentVertexIndex, const IAssetLoader::SAssetLoadParams& _params);
+	//! Streams all vertices of a fixed width binary element at once, returns false without consuming anything if that's not possible
+	bool readVertices(SContext& _ctx, const SPLYElement &Element, asset::SBufferBinding<asset::ICPUBuffer> outAttributes[4], const IAssetLoader::SAssetLoadParams& _params);
 	bool readFace(SContext& _ctx, const SPLYElement &Element, core::vector<uint32_t>& _outIndices);
 
 	void skipElement(SContext& _ctx, const SPLYElement &Element);
@@ -148,6 +148,10 @@ SAssetBundle CSTLMeshFileLoader::loadAsset(system::IFile* _file, const IAssetLoa
 	const size_t filesize = context.inner.mainFile->getSize();
 	if (filesize < 6ull) // we need a header
 		return {};
+	// one bulk read (or none at all when mapped) instead of a queue round-trip per float
+	context.view = system::IFile::CReadView(context.inner.mainFile);
+	if (!context.view)
+		return {};
 
 	bool hasColor = false;
 
@@ -172,11 +176,9 @@ SAssetBundle CSTLMeshFileLoader::loadAsset(system::IFile* _file, const IAssetLoa
 		context.fileOffset = headerOffset; //! skip header
 
 		uint32_t vertexCount = 0u;
-
-		system::IFile::success_t success;
-		context.inner.mainFile->read(success, &vertexCount, context.fileOffset, sizeof(vertexCount));
-		if (!success)
+		if (context.fileOffset+sizeof(vertexCount) > filesize)
 			return {};
+		memcpy(&vertexCount, context.view.data() + context.fileOffset, sizeof(vertexCount));
 		context.fileOffset += sizeof(vertexCount);
 
 		positions.reserve(3 * vertexCount);
@@ -242,10 +244,9 @@ SAssetBundle CSTLMeshFileLoader::loadAsset(system::IFile* _file, const IAssetLoa
 		}
 		else
 		{
-			system::IFile::success_t success;
-			context.inner.mainFile->read(success, &attrib, context.fileOffset, sizeof(attrib));
-			if (!success)
+			if (context.fileOffset+sizeof(attrib) > filesize)
 				return {};
+			memcpy(&attrib, context.view.data() + context.fileOffset, sizeof(attrib));
 			context.fileOffset += sizeof(attrib);
 		}
 
@@ -353,23 +354,10 @@ void CSTLMeshFileLoader::getNextVector(SContext* context, core::vectorSIMDf& vec
 {
 	if (binary)
 	{
-		{
-			system::IFile::success_t success;
-			context->inner.mainFile->read(success, &vec.X, context->fileOffset, 4);
-			context->fileOffset += success.getBytesProcessed();
-		}
-		
-		{
-			system::IFile::success_t success;
-			context->inner.mainFile->read(success, &vec.Y, context->fileOffset, 4);
-			context->fileOffset += success.getBytesProcessed();
-		}
-
-		{
-			system::IFile::success_t success;
-			context->inner.mainFile->read(success, &vec.Z, context->fileOffset, 4);
-			context->fileOffset += success.getBytesProcessed();
-		}
+		constexpr size_t vecSize = 3ull*sizeof(float);
+		const size_t bytes = std::min(vecSize, context->view.size() - context->fileOffset);
+		memcpy(vec.pointer, context->view.data() + context->fileOffset, bytes);
+		context->fileOffset += bytes;
 	}
 	else
 	{
@@ -390,53 +378,33 @@ void CSTLMeshFileLoader::getNextVector(SContext* context, core::vectorSIMDf& vec
 const std::string& CSTLMeshFileLoader::getNextToken(SContext* context, std::string& token) const
 {
 	goNextWord(context);
-	char c;
-	token = "";
-
-	while (context->fileOffset != context->inner.mainFile->getSize())
-	{
-		system::IFile::success_t success;
-		context->inner.mainFile->read(success, &c, context->fileOffset, sizeof(c));
-		context->fileOffset += success.getBytesProcessed();
-
-		// found it, so leave
-		if (core::isspace(c))
-			break;
-		token += c;
-	}
+	const char* const begin = context->view.begin() + context->fileOffset;
+	const char* const end = context->view.end();
+	const char* c = begin;
+	while (c != end && !core::isspace(*c))
+		++c;
+	token.assign(begin, c);
+	// skip the whitespace which terminated the token
+	context->fileOffset = c - context->view.begin() + (c != end ? 1 : 0);
 	return token;
 }
 
 //! skip to next word
 void CSTLMeshFileLoader::goNextWord(SContext* context) const
 {
-	uint8_t c;
-	while (context->fileOffset != context->inner.mainFile->getSize()) // TODO: check it
-	{
-		system::IFile::success_t success;
-		context->inner.mainFile->read(success, &c, context->fileOffset, sizeof(c));
-		context->fileOffset += success.getBytesProcessed();
-
-		// found it, so leave
-		if (!core::isspace(c))
-		{
-			context->fileOffset -= success.getBytesProcessed();
-			break;
-		}
-	}
+	const char* const buf = context->view.begin();
+	while (context->fileOffset != context->view.size() && core::isspace(buf[context->fileOffset]))
+		++context->fileOffset;
 }
 
 //! Read until line break is reached and stop at the next non-space character
 void CSTLMeshFileLoader::goNextLine(SContext* context) const
 {
-	uint8_t c;
+	const char* const buf = context->view.begin();
 	// look for newline characters
-	while (context->fileOffset != context->inner.mainFile->getSize()) // TODO: check it
+	while (context->fileOffset != context->view.size())
 	{
-		system::IFile::success_t success;
-		context->inner.mainFile->read(success, &c, context->fileOffset, sizeof(c));
-		context->fileOffset += success.getBytesProcessed();
-
+		const char c = buf[context->fileOffset++];
 		// found it, so leave
 		if (c == '\n' || c == '\r')
 			break;
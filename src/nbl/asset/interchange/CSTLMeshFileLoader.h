@@ -44,6 +44,7 @@ class CSTLMeshFileLoader final : public IRenderpassIndependentPipelineLoader
 			uint32_t topHierarchyLevel;
 			IAssetLoader::IAssetLoaderOverride* loaderOverride;
 
+			system::IFile::CReadView view;
 			size_t fileOffset = {};
 		};
 
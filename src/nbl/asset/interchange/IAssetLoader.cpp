@@ -89,6 +89,42 @@ SAssetBundle IAssetLoader::interm_getAssetInHierarchy(IAssetManager* _mgr, const
     return _mgr->getAssetInHierarchy(_filename, _params, _hierarchyLevel);
 }
 
+core::CTaskScheduler::future_t<SAssetBundle> IAssetLoader::interm_getAssetInHierarchyAsync(IAssetManager* _mgr, const std::string& _filename, const IAssetLoader::SAssetLoadParams& _params, uint32_t _hierarchyLevel, IAssetLoader::IAssetLoaderOverride* _override)
+{
+    return _mgr->getAssetInHierarchyAsync(_filename, _params, _hierarchyLevel, _override);
+}
+
+SAssetBundle IAssetLoader::interm_findOrCreateCachedAsset(IAssetManager* _mgr, const std::string& _key, const IAsset::E_TYPE* _types, const SAssetLoadContext& _ctx, uint32_t _hierarchyLevel, IAssetLoader::IAssetLoaderOverride* _override, const std::function<SAssetBundle()>& _create)
+{
+    auto bundle = _override->findCachedAsset(_key, _types, _ctx, _hierarchyLevel);
+    if (!bundle.getContents().empty())
+        return bundle;
+
+    // nothing to deduplicate against if we're not allowed to use the cache, for example when loading part of an image
+    const auto levelFlags = _ctx.params.cacheFlags>>(uint64_t(_hierarchyLevel)*2ull);
+    if ((levelFlags&ECF_DUPLICATE_TOP_LEVEL)==ECF_DUPLICATE_TOP_LEVEL)
+        return _create();
+
+    // same protocol as the loads in `IAssetManager::getAssetInHierarchy_impl`, the keys of derived assets never collide with file paths
+    IAssetManager::CInFlightLoad inFlight;
+    const auto otherCreation = _mgr->claimInFlightLoad(_key, inFlight);
+    // if they failed we try ourselves, if we got the claim the previous owner could have finished right before we did
+    // only ever waits when the file being loaded wasn't claimed itself (such as with `restoreLevels`), otherwise we're in its `CNoWaitScope`
+    if (!otherCreation.valid() || IAssetManager::waitForInFlightLoad(otherCreation))
+    {
+        bundle = _override->findCachedAsset(_key, _types, _ctx, _hierarchyLevel);
+        if (!bundle.getContents().empty())
+        {
+            inFlight.finish(true);
+            return bundle;
+        }
+    }
+
+    bundle = _create();
+    inFlight.finish(!bundle.getContents().empty());
+    return bundle;
+}
+
 SAssetBundle IAssetLoader::interm_getAssetInHierarchyWholeBundleRestore(IAssetManager* _mgr, system::IFile* _file, const std::string& _supposedFilename, const IAssetLoader::SAssetLoadParams& _params, uint32_t _hierarchyLevel, IAssetLoader::IAssetLoaderOverride* _override)
 {
     return _mgr->getAssetInHierarchyWholeBundleRestore(_file, _supposedFilename, _params, _hierarchyLevel, _override);
@@ -49,6 +49,7 @@
 #include "nbl/asset/utils/CForsythVertexCacheOptimizer.h"
 #include "nbl/asset/utils/CSmoothNormalGenerator.h"
 #include "nbl/asset/utils/COverdrawMeshOptimizer.h"
+#include "nbl/asset/utils/CMeshoptDecoder.h"
 #include "nbl/asset/utils/CMeshManipulator.h"
 
 // baw file format - not valid anymore
@@ -114,7 +114,7 @@ core::smart_refctd_ptr<ICPUImage> CDerivativeMapCreator::createDerivativeMapFrom
 	state.scratchMemory = reinterpret_cast<uint8_t*>(_NBL_ALIGNED_MALLOC(state.scratchMemoryByteSize, _NBL_SIMD_ALIGNMENT));
 
 	state.recomputeScaledKernelPhasedLUT();
-	const bool result = DerivativeMapFilter::execute(core::execution::par_unseq,&state);
+	const bool result = DerivativeMapFilter::execute(core::CTaskScheduler::getDefault()->policy(),&state);
 	if (result)
 	{
 		out_normalizationFactor[0] = state.normalization.maxAbsPerChannel[0];
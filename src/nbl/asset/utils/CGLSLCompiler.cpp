@@ -178,6 +178,14 @@ core::smart_refctd_ptr<ICPUShader> CGLSLCompiler::compileToSPIRV(const char* cod
 
     auto newCode = preprocessShader(std::string(code), glslOptions.stage, glslOptions.preprocessorOptions);
 
+    IShaderCompiler::CCache::key_t cacheKey;
+    if (glslOptions.spirvCache)
+    {
+        cacheKey = IShaderCompiler::CCache::computeKey(IShader::E_CONTENT_TYPE::ECT_GLSL, newCode, glslOptions.stage, glslOptions);
+        if (auto cachedSpirv = glslOptions.spirvCache->find(cacheKey))
+            return core::make_smart_refctd_ptr<asset::ICPUShader>(std::move(cachedSpirv), glslOptions.stage, IShader::E_CONTENT_TYPE::ECT_SPIRV, glslOptions.preprocessorOptions.sourceIdentifier.data());
+    }
+
     shaderc::Compiler comp;
     shaderc::CompileOptions shadercOptions; //default options
     shadercOptions.SetTargetSpirv(static_cast<shaderc_spirv_version>(glslOptions.targetSpirvVersion));
@@ -194,6 +202,8 @@ core::smart_refctd_ptr<ICPUShader> CGLSLCompiler::compileToSPIRV(const char* cod
 
         if (glslOptions.spirvOptimizer)
             outSpirv = glslOptions.spirvOptimizer->optimize(outSpirv.get(), glslOptions.preprocessorOptions.logger);
+        if (glslOptions.spirvCache)
+            glslOptions.spirvCache->insert(cacheKey, outSpirv.get());
         return core::make_smart_refctd_ptr<asset::ICPUShader>(std::move(outSpirv), glslOptions.stage, IShader::E_CONTENT_TYPE::ECT_SPIRV, glslOptions.preprocessorOptions.sourceIdentifier.data());
     }
     else
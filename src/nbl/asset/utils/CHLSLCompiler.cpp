@@ -212,6 +212,14 @@ core::smart_refctd_ptr<ICPUShader> CHLSLCompiler::compileToSPIRV(const char* cod
     auto stage = hlslOptions.stage;
     auto newCode = preprocessShader(code, stage, hlslOptions.preprocessorOptions);
 
+    IShaderCompiler::CCache::key_t cacheKey;
+    if (hlslOptions.spirvCache)
+    {
+        cacheKey = IShaderCompiler::CCache::computeKey(IShader::E_CONTENT_TYPE::ECT_HLSL, newCode, stage, hlslOptions);
+        if (auto cachedSpirv = hlslOptions.spirvCache->find(cacheKey))
+            return core::make_smart_refctd_ptr<asset::ICPUShader>(std::move(cachedSpirv), stage, IShader::E_CONTENT_TYPE::ECT_SPIRV, hlslOptions.preprocessorOptions.sourceIdentifier.data());
+    }
+
     // Suffix is the shader model version
     // TODO: Figure out a way to get the shader model version automatically
     // 
@@ -313,6 +321,8 @@ core::smart_refctd_ptr<ICPUShader> CHLSLCompiler::compileToSPIRV(const char* cod
     if (hlslOptions.spirvOptimizer)
         outSpirv = hlslOptions.spirvOptimizer->optimize(outSpirv.get(), hlslOptions.preprocessorOptions.logger);
 
+    if (hlslOptions.spirvCache)
+        hlslOptions.spirvCache->insert(cacheKey, outSpirv.get());
 
     return core::make_smart_refctd_ptr<asset::ICPUShader>(std::move(outSpirv), stage, IShader::E_CONTENT_TYPE::ECT_SPIRV, hlslOptions.preprocessorOptions.sourceIdentifier.data());
 }
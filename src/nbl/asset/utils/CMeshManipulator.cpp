@@ -1377,8 +1377,11 @@ bool CMeshManipulator::calcMaxQuantizationError(const SAttribTypeChoice& _srcTyp
     using namespace video;
 
 	using QuantF_t = core::vectorSIMDf(*)(const core::vectorSIMDf&, E_FORMAT, E_FORMAT, CQuantNormalCache & _cache);
+	// fills the cache for a whole chunk in parallel, so the per-attribute checks below only do lookups
+	using PrefetchF_t = void(*)(std::span<const core::vectorSIMDf>, CQuantNormalCache& _cache);
 
 	QuantF_t quantFunc = nullptr;
+	PrefetchF_t prefetchFunc = nullptr;
 
 	if (_errMetric.method == EEM_ANGLES)
 	{
@@ -1397,6 +1400,10 @@ bool CMeshManipulator::calcMaxQuantizationError(const SAttribTypeChoice& _srcTyp
 				retval.w = 1.f;
 				return retval;
 			};
+			prefetchFunc = [](std::span<const core::vectorSIMDf> _chunk, CQuantNormalCache& _cache) -> void {
+				core::vector<CQuantNormalCache::value_type_t<EF_R8G8B8_SNORM>> tmp(_chunk.size());
+				_cache.quantize<EF_R8G8B8_SNORM>(core::CTaskScheduler::getDefault()->policy(),_chunk,tmp.data());
+			};
 			break;
 		case EF_A2R10G10B10_SNORM_PACK32:
 		case EF_A2B10G10R10_SNORM_PACK32: // bgra
@@ -1409,6 +1416,10 @@ bool CMeshManipulator::calcMaxQuantizationError(const SAttribTypeChoice& _srcTyp
 				retval.w = 1.f;
 				return retval;
 			};
+			prefetchFunc = [](std::span<const core::vectorSIMDf> _chunk, CQuantNormalCache& _cache) -> void {
+				core::vector<CQuantNormalCache::value_type_t<EF_A2B10G10R10_SNORM_PACK32>> tmp(_chunk.size());
+				_cache.quantize<EF_A2B10G10R10_SNORM_PACK32>(core::CTaskScheduler::getDefault()->policy(),_chunk,tmp.data());
+			};
 			break;
         case EF_R16_SNORM:
         case EF_R16G16_SNORM:
@@ -1423,6 +1434,10 @@ bool CMeshManipulator::calcMaxQuantizationError(const SAttribTypeChoice& _srcTyp
 				retval.w = 1.f;
 				return retval;
 			};
+			prefetchFunc = [](std::span<const core::vectorSIMDf> _chunk, CQuantNormalCache& _cache) -> void {
+				core::vector<CQuantNormalCache::value_type_t<EF_R16G16B16_SNORM>> tmp(_chunk.size());
+				_cache.quantize<EF_R16G16B16_SNORM>(core::CTaskScheduler::getDefault()->policy(),_chunk,tmp.data());
+			};
 			break;
         default: 
             quantFunc = nullptr;
@@ -1444,11 +1459,19 @@ bool CMeshManipulator::calcMaxQuantizationError(const SAttribTypeChoice& _srcTyp
 	if (!quantFunc)
 		return false;
 
-	for (const core::vectorSIMDf& d : _srcData)
+	// chunked so that a format which fails early doesn't pay for quantizing the whole attribute
+	constexpr size_t prefetchChunkSize = 0x1000u;
+	for (size_t chunkBegin=0u; chunkBegin<_srcData.size(); chunkBegin+=prefetchChunkSize)
 	{
-		const core::vectorSIMDf quantized = quantFunc(d, _srcType.type, _dstType.type, _cache);
-        if (!compareFloatingPointAttribute(d, quantized, getFormatChannelCount(_srcType.type), _errMetric))
-            return false;
+		const std::span<const core::vectorSIMDf> chunk(_srcData.data()+chunkBegin,core::min(prefetchChunkSize,_srcData.size()-chunkBegin));
+		if (prefetchFunc)
+			prefetchFunc(chunk,_cache);
+		for (const core::vectorSIMDf& d : chunk)
+		{
+			const core::vectorSIMDf quantized = quantFunc(d, _srcType.type, _dstType.type, _cache);
+			if (!compareFloatingPointAttribute(d, quantized, getFormatChannelCount(_srcType.type), _errMetric))
+				return false;
+		}
 	}
 
 	return true;
@@ -0,0 +1,504 @@
+// Copyright (C) 2018-2020 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#include "nbl/core/declarations.h"
+
+#include "CMeshoptDecoder.h"
+
+#include <cmath>
+
+namespace nbl::asset
+{
+
+namespace
+{
+
+inline uint32_t decodeVByte(const uint8_t*& data)
+{
+	const uint8_t lead = *data++;
+	if (lead<0x80u)
+		return lead;
+
+	uint32_t result = lead&0x7fu;
+	uint32_t shift = 7u;
+	for (auto i=0; i<4; i++)
+	{
+		const uint8_t group = *data++;
+		result |= uint32_t(group&0x7fu)<<shift;
+		shift += 7u;
+		if (group<0x80u)
+			break;
+	}
+	return result;
+}
+
+inline uint32_t unzigzag(const uint32_t v)
+{
+	return (v>>1u)^(0u-(v&1u));
+}
+
+inline uint32_t decodeIndex(const uint8_t*& data, const uint32_t last)
+{
+	return last+unzigzag(decodeVByte(data));
+}
+
+inline void writeIndex(void* dst, const size_t offset, const size_t indexSize, const uint32_t index)
+{
+	if (indexSize==sizeof(uint16_t))
+		reinterpret_cast<uint16_t*>(dst)[offset] = static_cast<uint16_t>(index);
+	else
+		reinterpret_cast<uint32_t*>(dst)[offset] = index;
+}
+
+// fifos are 16 entries long and indexed with wraparound, their state has to follow the encoder's exactly
+struct SFifos
+{
+	uint32_t vertex[16];
+	uint32_t edge[16][2];
+	size_t vertexOffset = 0u;
+	size_t edgeOffset = 0u;
+
+	SFifos()
+	{
+		std::fill_n(vertex,16u,~0u);
+		std::fill_n(&edge[0][0],32u,~0u);
+	}
+
+	inline void pushVertex(const uint32_t v, const bool cond=true)
+	{
+		vertex[vertexOffset] = v;
+		vertexOffset = (vertexOffset+(cond ? 1u:0u))&15u;
+	}
+	inline void pushEdge(const uint32_t a, const uint32_t b)
+	{
+		edge[edgeOffset][0] = a;
+		edge[edgeOffset][1] = b;
+		edgeOffset = (edgeOffset+1u)&15u;
+	}
+};
+
+template<typename T>
+void decodeFilterOct(T* data, const size_t count)
+{
+	const float maxval = float((1u<<(sizeof(T)*8u-1u))-1u);
+	for (size_t i=0u; i<count; i++,data+=4)
+	{
+		// z is stored with the same bit count as 1.f, so we can reconstruct it
+		float x = float(data[0]);
+		float y = float(data[1]);
+		const float z = float(data[2])-std::abs(x)-std::abs(y);
+
+		// unfold the lower hemisphere
+		const float t = z>=0.f ? 0.f:z;
+		x += x>=0.f ? t:-t;
+		y += y>=0.f ? t:-t;
+
+		const float s = maxval/std::sqrt(x*x+y*y+z*z);
+		data[0] = T(int32_t(x*s+(x>=0.f ? 0.5f:-0.5f)));
+		data[1] = T(int32_t(y*s+(y>=0.f ? 0.5f:-0.5f)));
+		data[2] = T(int32_t(z*s+(z>=0.f ? 0.5f:-0.5f)));
+	}
+}
+
+void decodeFilterQuat(int16_t* data, const size_t count)
+{
+	const float scale = 1.f/std::sqrt(2.f);
+	for (size_t i=0u; i<count; i++,data+=4)
+	{
+		// scale is recovered from the high bits of the 4th component, the lowest 2 bits say which component got dropped
+		const int32_t sf = data[3]|3;
+		const float ss = scale/float(sf);
+
+		const float x = float(data[0])*ss;
+		const float y = float(data[1])*ss;
+		const float z = float(data[2])*ss;
+		// clamp to avoid NaN due to precision errors
+		const float ww = 1.f-x*x-y*y-z*z;
+		const float w = std::sqrt(ww>=0.f ? ww:0.f);
+
+		const int32_t qc = data[3]&3;
+		data[(qc+1)&3] = int16_t(x*32767.f+(x>=0.f ? 0.5f:-0.5f));
+		data[(qc+2)&3] = int16_t(y*32767.f+(y>=0.f ? 0.5f:-0.5f));
+		data[(qc+3)&3] = int16_t(z*32767.f+(z>=0.f ? 0.5f:-0.5f));
+		data[(qc+0)&3] = int16_t(w*32767.f+0.5f);
+	}
+}
+
+void decodeFilterExp(uint32_t* data, const size_t count)
+{
+	size_t i = 0u;
+#ifdef __NBL_COMPILE_WITH_SSE3
+	for (; i+4u<=count; i+=4u)
+	{
+		const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data+i));
+		// 24 bit signed mantissa, 8 bit signed exponent
+		const __m128i m = _mm_srai_epi32(_mm_slli_epi32(v,8),8);
+		const __m128i e = _mm_srai_epi32(v,24);
+		// ldexp(float(m),e) by building 2^e directly
+		const __m128 pow2 = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(e,_mm_set1_epi32(127)),23));
+		_mm_storeu_ps(reinterpret_cast<float*>(data+i),_mm_mul_ps(pow2,_mm_cvtepi32_ps(m)));
+	}
+#endif
+	for (; i<count; i++)
+	{
+		const uint32_t v = data[i];
+		const int32_t m = int32_t(v<<8u)>>8;
+		const int32_t e = int32_t(v)>>24;
+		const uint32_t pow2 = uint32_t(e+127)<<23u;
+		data[i] = core::IR(core::FR(pow2)*float(m));
+	}
+}
+
+}
+
+bool CMeshoptDecoder::decode(void* _dst, const size_t _count, const size_t _stride, const uint8_t* _src, const size_t _srcSize, const E_MODE _mode, const E_FILTER _filter)
+{
+	switch (_mode)
+	{
+		case EM_ATTRIBUTES:
+			return decodeVertexBuffer(_dst,_count,_stride,_src,_srcSize) && applyFilter(_dst,_count,_stride,_filter);
+		case EM_TRIANGLES:
+			// filters are only allowed on attribute streams
+			return _filter==EFT_NONE && decodeIndexBuffer(_dst,_count,_stride,_src,_srcSize);
+		case EM_INDICES:
+			return _filter==EFT_NONE && decodeIndexSequence(_dst,_count,_stride,_src,_srcSize);
+		default:
+			break;
+	}
+	return false;
+}
+
+const uint8_t* CMeshoptDecoder::decodeBytesGroup(const uint8_t* _data, uint8_t* _buffer, const uint32_t _bitslog2)
+{
+	// packed values are read MSB first, values equal to the all-ones sentinel get replaced by the next escaped byte
+	auto decodePacked = [&](const uint32_t bits) -> const uint8_t*
+	{
+		const uint32_t sentinel = (1u<<bits)-1u;
+		const size_t headerSize = (ByteGroupSize*bits)/8u;
+		const uint8_t* escaped = _data+headerSize;
+		for (size_t i=0u; i<headerSize; i++)
+		{
+			uint8_t byte = _data[i];
+			for (uint32_t j=0u; j<8u; j+=bits)
+			{
+				const uint8_t enc = byte>>(8u-bits);
+				byte = static_cast<uint8_t>(byte<<bits);
+				const bool escape = enc==sentinel;
+				*(_buffer++) = escape ? *escaped:enc;
+				escaped += escape ? 1:0;
+			}
+		}
+		return escaped;
+	};
+
+	switch (_bitslog2)
+	{
+		case 0u:
+			memset(_buffer,0,ByteGroupSize);
+			return _data;
+		case 1u:
+			return decodePacked(2u);
+		case 2u:
+			return decodePacked(4u);
+		default:
+			memcpy(_buffer,_data,ByteGroupSize);
+			return _data+ByteGroupSize;
+	}
+}
+
+const uint8_t* CMeshoptDecoder::decodeBytes(const uint8_t* _data, const uint8_t* _dataEnd, uint8_t* _buffer, const size_t _bufferSize)
+{
+	assert(_bufferSize%ByteGroupSize==0u);
+
+	// 2 bits of mode per group
+	const size_t headerSize = (_bufferSize/ByteGroupSize+3u)/4u;
+	if (size_t(_dataEnd-_data)<headerSize)
+		return nullptr;
+
+	const uint8_t* header = _data;
+	_data += headerSize;
+	for (size_t i=0u; i<_bufferSize; i+=ByteGroupSize)
+	{
+		// guarantees the group can be decoded without further bounds checks
+		if (size_t(_dataEnd-_data)<ByteGroupDecodeLimit)
+			return nullptr;
+
+		const size_t headerOffset = i/ByteGroupSize;
+		const uint32_t bitslog2 = (header[headerOffset/4u]>>((headerOffset%4u)*2u))&3u;
+		_data = decodeBytesGroup(_data,_buffer+i,bitslog2);
+	}
+	return _data;
+}
+
+const uint8_t* CMeshoptDecoder::decodeVertexBlock(const uint8_t* _data, const uint8_t* _dataEnd, uint8_t* _vertexData, const size_t _vertexCount, const size_t _vertexSize, uint8_t* _lastVertex)
+{
+	assert(_vertexCount<=VertexBlockMaxSize);
+
+	uint8_t buffer[VertexBlockMaxSize];
+	uint8_t transposed[VertexBlockSizeBytes];
+
+	const size_t vertexCountAligned = core::roundUp(_vertexCount,ByteGroupSize);
+	// every byte of the vertex is its own stream of deltas against the previous vertex
+	for (size_t k=0u; k<_vertexSize; k++)
+	{
+		_data = decodeBytes(_data,_dataEnd,buffer,vertexCountAligned);
+		if (!_data)
+			return nullptr;
+
+		uint8_t p = _lastVertex[k];
+		size_t i = 0u;
+#ifdef __NBL_COMPILE_WITH_SSE3
+		// unzigzag and prefix sum 16 deltas at a time, only the transposed scatter stays scalar
+		for (; i<_vertexCount; i+=ByteGroupSize)
+		{
+			const __m128i one = _mm_set1_epi8(1);
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer+i));
+			const __m128i halved = _mm_and_si128(_mm_srli_epi16(v,1),_mm_set1_epi8(0x7f));
+			v = _mm_xor_si128(halved,_mm_sub_epi8(_mm_setzero_si128(),_mm_and_si128(v,one)));
+			v = _mm_add_epi8(v,_mm_slli_si128(v,1));
+			v = _mm_add_epi8(v,_mm_slli_si128(v,2));
+			v = _mm_add_epi8(v,_mm_slli_si128(v,4));
+			v = _mm_add_epi8(v,_mm_slli_si128(v,8));
+			v = _mm_add_epi8(v,_mm_set1_epi8(static_cast<char>(p)));
+
+			alignas(16) uint8_t sums[ByteGroupSize];
+			_mm_store_si128(reinterpret_cast<__m128i*>(sums),v);
+			const size_t groupSize = core::min(ByteGroupSize,_vertexCount-i);
+			for (size_t j=0u; j<groupSize; j++)
+				transposed[(i+j)*_vertexSize+k] = sums[j];
+			p = sums[groupSize-1u];
+		}
+#else
+		for (; i<_vertexCount; i++)
+		{
+			p += static_cast<uint8_t>(unzigzag(buffer[i]));
+			transposed[i*_vertexSize+k] = p;
+		}
+#endif
+		_lastVertex[k] = p;
+	}
+
+	memcpy(_vertexData,transposed,_vertexCount*_vertexSize);
+	return _data;
+}
+
+bool CMeshoptDecoder::decodeVertexBuffer(void* _dst, const size_t _vertexCount, const size_t _vertexSize, const uint8_t* _src, const size_t _srcSize)
+{
+	if (_vertexSize==0u || _vertexSize>MaxVertexSize || _vertexSize%4u)
+		return false;
+
+	const uint8_t* data = _src;
+	const uint8_t* const dataEnd = _src+_srcSize;
+	if (_srcSize<1u+_vertexSize)
+		return false;
+
+	const uint8_t header = *(data++);
+	if ((header&0xf0u)!=VertexHeader || (header&0x0fu)>0u)
+		return false;
+
+	// the tail holds the first vertex which seeds the deltas
+	uint8_t lastVertex[MaxVertexSize];
+	memcpy(lastVertex,dataEnd-_vertexSize,_vertexSize);
+
+	const size_t blockSize = core::min<size_t>((VertexBlockSizeBytes/_vertexSize)&~(ByteGroupSize-1u),VertexBlockMaxSize);
+	uint8_t* const vertexData = reinterpret_cast<uint8_t*>(_dst);
+	for (size_t offset=0u; offset<_vertexCount; offset+=blockSize)
+	{
+		data = decodeVertexBlock(data,dataEnd,vertexData+offset*_vertexSize,core::min(blockSize,_vertexCount-offset),_vertexSize,lastVertex);
+		if (!data)
+			return false;
+	}
+
+	const size_t tailSize = core::max(_vertexSize,VertexTailMinSize);
+	return size_t(dataEnd-data)==tailSize;
+}
+
+bool CMeshoptDecoder::decodeIndexBuffer(void* _dst, const size_t _indexCount, const size_t _indexSize, const uint8_t* _src, const size_t _srcSize)
+{
+	if (_indexCount%3u || (_indexSize!=sizeof(uint16_t) && _indexSize!=sizeof(uint32_t)))
+		return false;
+	// header, at least one code byte per triangle and the 16 byte auxiliary code table
+	if (_srcSize<1u+_indexCount/3u+16u)
+		return false;
+
+	const uint8_t header = _src[0];
+	const uint32_t version = header&0x0fu;
+	if ((header&0xf0u)!=IndexHeader || version>1u)
+		return false;
+
+	SFifos fifos;
+	uint32_t next = 0u;
+	uint32_t last = 0u;
+	// version 1 reserves edge codes 13 and 14 for +-1 deltas of the last free index
+	const int32_t fecmax = version>=1u ? 13:15;
+
+	const uint8_t* code = _src+1u;
+	const uint8_t* data = code+_indexCount/3u;
+	const uint8_t* const dataSafeEnd = _src+_srcSize-16u;
+	const uint8_t* const codeauxTable = dataSafeEnd;
+
+	auto writeTriangle = [&](const size_t offset, const uint32_t a, const uint32_t b, const uint32_t c) -> void
+	{
+		writeIndex(_dst,offset+0u,_indexSize,a);
+		writeIndex(_dst,offset+1u,_indexSize,b);
+		writeIndex(_dst,offset+2u,_indexSize,c);
+	};
+
+	for (size_t i=0u; i<_indexCount; i+=3u)
+	{
+		// a triangle reads at most 16 bytes, and the codeaux table is 16 bytes
+		if (data>dataSafeEnd)
+			return false;
+
+		const uint8_t codetri = *(code++);
+		if (codetri<0xf0u)
+		{
+			// triangle shares an edge with one from the fifo
+			const int32_t fe = codetri>>4;
+			const auto& edge = fifos.edge[(fifos.edgeOffset-1u-fe)&15u];
+			const uint32_t a = edge[0];
+			const uint32_t b = edge[1];
+
+			const int32_t fec = codetri&15;
+			uint32_t c;
+			if (fec<fecmax)
+			{
+				const bool fec0 = fec==0;
+				c = fec0 ? next:fifos.vertex[(fifos.vertexOffset-1u-fec)&15u];
+				next += fec0 ? 1u:0u;
+				fifos.pushVertex(c,fec0);
+			}
+			else
+			{
+				// fec-(fec^3) decodes 13,14 into -1,1
+				last = c = fec!=15 ? last+uint32_t(fec-(fec^3)):decodeIndex(data,last);
+				fifos.pushVertex(c);
+			}
+			writeTriangle(i,a,b,c);
+			fifos.pushEdge(c,b);
+			fifos.pushEdge(a,c);
+		}
+		else if (codetri<0xfeu)
+		{
+			// the common vertex patterns come from the table, it can't encode free indices
+			const uint8_t codeaux = codeauxTable[codetri&15u];
+			const int32_t feb = codeaux>>4;
+			const int32_t fec = codeaux&15;
+
+			// next is incremented for all three vertices before the fifo reads, same as the encoder
+			const uint32_t a = next++;
+			const bool feb0 = feb==0;
+			const uint32_t b = feb0 ? next:fifos.vertex[(fifos.vertexOffset-feb)&15u];
+			next += feb0 ? 1u:0u;
+			const bool fec0 = fec==0;
+			const uint32_t c = fec0 ? next:fifos.vertex[(fifos.vertexOffset-fec)&15u];
+			next += fec0 ? 1u:0u;
+
+			writeTriangle(i,a,b,c);
+			fifos.pushVertex(a);
+			fifos.pushVertex(b,feb0);
+			fifos.pushVertex(c,fec0);
+			fifos.pushEdge(b,a);
+			fifos.pushEdge(c,b);
+			fifos.pushEdge(a,c);
+		}
+		else
+		{
+			// codeaux is stored inline, which also allows for free indices and resets
+			const uint8_t codeaux = *(data++);
+			const int32_t fea = codetri==0xfeu ? 0:15;
+			const int32_t feb = codeaux>>4;
+			const int32_t fec = codeaux&15;
+
+			if (codeaux==0u)
+				next = 0u;
+
+			uint32_t a = fea==0 ? next++:0u;
+			uint32_t b = feb==0 ? next++:fifos.vertex[(fifos.vertexOffset-feb)&15u];
+			uint32_t c = fec==0 ? next++:fifos.vertex[(fifos.vertexOffset-fec)&15u];
+			// free indices are delta encoded against the previous free index
+			if (fea==15)
+				last = a = decodeIndex(data,last);
+			if (feb==15)
+				last = b = decodeIndex(data,last);
+			if (fec==15)
+				last = c = decodeIndex(data,last);
+
+			writeTriangle(i,a,b,c);
+			fifos.pushVertex(a);
+			fifos.pushVertex(b,feb==0||feb==15);
+			fifos.pushVertex(c,fec==0||fec==15);
+			fifos.pushEdge(b,a);
+			fifos.pushEdge(c,b);
+			fifos.pushEdge(a,c);
+		}
+	}
+
+	// all of the data must have been consumed exactly up to the codeaux table
+	return data==dataSafeEnd;
+}
+
+bool CMeshoptDecoder::decodeIndexSequence(void* _dst, const size_t _indexCount, const size_t _indexSize, const uint8_t* _src, const size_t _srcSize)
+{
+	if (_indexSize!=sizeof(uint16_t) && _indexSize!=sizeof(uint32_t))
+		return false;
+	// header, at least one byte per index and a 4 byte tail
+	if (_srcSize<1u+_indexCount+4u)
+		return false;
+
+	const uint8_t header = _src[0];
+	if ((header&0xf0u)!=SequenceHeader || (header&0x0fu)>1u)
+		return false;
+
+	const uint8_t* data = _src+1u;
+	const uint8_t* const dataSafeEnd = _src+_srcSize-4u;
+
+	// two baselines, the lowest bit of every value picks the one the delta is against
+	uint32_t last[2] = {0u,0u};
+	for (size_t i=0u; i<_indexCount; i++)
+	{
+		// a vbyte is at most 5 bytes, the tail covers the overrun
+		if (data>=dataSafeEnd)
+			return false;
+
+		const uint32_t v = decodeVByte(data);
+		const uint32_t current = v&1u;
+		last[current] += unzigzag(v>>1u);
+		writeIndex(_dst,i,_indexSize,last[current]);
+	}
+
+	return data==dataSafeEnd;
+}
+
+bool CMeshoptDecoder::applyFilter(void* _data, const size_t _count, const size_t _stride, const E_FILTER _filter)
+{
+	switch (_filter)
+	{
+		case EFT_NONE:
+			return true;
+		case EFT_OCTAHEDRAL:
+			if (_stride==4u)
+				decodeFilterOct(reinterpret_cast<int8_t*>(_data),_count);
+			else if (_stride==8u)
+				decodeFilterOct(reinterpret_cast<int16_t*>(_data),_count);
+			else
+				return false;
+			return true;
+		case EFT_QUATERNION:
+			if (_stride!=8u)
+				return false;
+			decodeFilterQuat(reinterpret_cast<int16_t*>(_data),_count);
+			return true;
+		case EFT_EXPONENTIAL:
+			if (_stride%4u)
+				return false;
+			decodeFilterExp(reinterpret_cast<uint32_t*>(_data),_count*_stride/sizeof(uint32_t));
+			return true;
+		default:
+			break;
+	}
+	return false;
+}
+
+}
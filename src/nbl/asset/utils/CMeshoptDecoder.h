@@ -0,0 +1,75 @@
+// Copyright (C) 2018-2020 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#ifndef __NBL_ASSET_C_MESHOPT_DECODER_H_INCLUDED__
+#define __NBL_ASSET_C_MESHOPT_DECODER_H_INCLUDED__
+
+#include "nbl/core/declarations.h"
+
+// Based on zeux's meshoptimizer (https://github.com/zeux/meshoptimizer) available under MIT license
+
+namespace nbl::asset
+{
+
+//! Decoder for the meshoptimizer vertex and index codecs, as used by the EXT_meshopt_compression glTF extension
+/*
+	All decode functions validate the stream and return false on malformed or truncated input,
+	the destination is left in an unspecified state in that case.
+*/
+class CMeshoptDecoder
+{
+		// private, undefined constructor
+		CMeshoptDecoder() = delete;
+
+	public:
+		//! glTF `mode` of a compressed buffer view
+		enum E_MODE : uint8_t
+		{
+			EM_ATTRIBUTES,
+			EM_TRIANGLES,
+			EM_INDICES
+		};
+		//! glTF `filter` of a compressed buffer view, applied on top of decoded attributes
+		enum E_FILTER : uint8_t
+		{
+			EFT_NONE,
+			EFT_OCTAHEDRAL,
+			EFT_QUATERNION,
+			EFT_EXPONENTIAL
+		};
+
+		//! Decodes `count` elements of `stride` bytes each, then runs the `filter` over them in-place
+		static bool decode(void* _dst, const size_t _count, const size_t _stride, const uint8_t* _src, const size_t _srcSize, const E_MODE _mode, const E_FILTER _filter);
+
+		//! `_vertexSize` must be a multiple of 4 no larger than 256
+		static bool decodeVertexBuffer(void* _dst, const size_t _vertexCount, const size_t _vertexSize, const uint8_t* _src, const size_t _srcSize);
+		//! `_indexSize` is 2 or 4, `_indexCount` must be a multiple of 3
+		static bool decodeIndexBuffer(void* _dst, const size_t _indexCount, const size_t _indexSize, const uint8_t* _src, const size_t _srcSize);
+		//! `_indexSize` is 2 or 4
+		static bool decodeIndexSequence(void* _dst, const size_t _indexCount, const size_t _indexSize, const uint8_t* _src, const size_t _srcSize);
+
+		//! In-place filters, `_count` is the number of `_stride` sized elements
+		static bool applyFilter(void* _data, const size_t _count, const size_t _stride, const E_FILTER _filter);
+
+	private:
+		_NBL_STATIC_INLINE_CONSTEXPR uint8_t VertexHeader = 0xa0u;
+		_NBL_STATIC_INLINE_CONSTEXPR uint8_t IndexHeader = 0xe0u;
+		_NBL_STATIC_INLINE_CONSTEXPR uint8_t SequenceHeader = 0xd0u;
+
+		_NBL_STATIC_INLINE_CONSTEXPR size_t ByteGroupSize = 16u;
+		// largest group is 8 bytes of 4 bit values followed by 16 escaped bytes
+		_NBL_STATIC_INLINE_CONSTEXPR size_t ByteGroupDecodeLimit = 24u;
+		_NBL_STATIC_INLINE_CONSTEXPR size_t VertexBlockSizeBytes = 8192u;
+		_NBL_STATIC_INLINE_CONSTEXPR size_t VertexBlockMaxSize = 256u;
+		_NBL_STATIC_INLINE_CONSTEXPR size_t VertexTailMinSize = 32u;
+		_NBL_STATIC_INLINE_CONSTEXPR size_t MaxVertexSize = 256u;
+
+		static const uint8_t* decodeBytesGroup(const uint8_t* _data, uint8_t* _buffer, const uint32_t _bitslog2);
+		static const uint8_t* decodeBytes(const uint8_t* _data, const uint8_t* _dataEnd, uint8_t* _buffer, const size_t _bufferSize);
+		static const uint8_t* decodeVertexBlock(const uint8_t* _data, const uint8_t* _dataEnd, uint8_t* _vertexData, const size_t _vertexCount, const size_t _vertexSize, uint8_t* _lastVertex);
+};
+
+}
+
+#endif
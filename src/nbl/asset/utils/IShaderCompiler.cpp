@@ -4,10 +4,12 @@
 #include "nbl/asset/utils/IShaderCompiler.h"
 #include "nbl/asset/utils/shadercUtils.h"
 #include "nbl/asset/utils/CGLSLVirtualTexturingBuiltinIncludeGenerator.h"
+#include "nbl/core/xxHash256.h"
 
 #include <sstream>
 #include <regex>
 #include <iterator>
+#include <random>
 
 using namespace nbl;
 using namespace nbl::asset;
@@ -289,3 +291,222 @@ auto IShaderCompiler::CIncludeFinder::tryIncludeGenerators(const std::string& in
 
     return {};
 }
+
+
+namespace
+{
+struct SSPIRVCacheEntryHeader
+{
+    static inline constexpr uint32_t Magic = 0x43565053u; // "SPVC"
+
+    uint32_t magic;
+    uint32_t version;
+    IShaderCompiler::CCache::key_t key;
+    uint64_t size;
+};
+// no padding anywhere, so no need to pack
+static_assert(sizeof(SSPIRVCacheEntryHeader)==48ull);
+
+template<typename T>
+inline void appendKeyMaterial(std::string& out, const T& value)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    out.append(reinterpret_cast<const char*>(&value),sizeof(T));
+}
+// length prefixed, so that moving characters between adjacent strings changes the key
+inline void appendKeyMaterial(std::string& out, const std::string_view str)
+{
+    appendKeyMaterial(out,uint64_t(str.size()));
+    out.append(str);
+}
+}
+
+IShaderCompiler::CCache::CCache(core::smart_refctd_ptr<system::ISystem>&& system, system::path&& directory, const size_t maxSize)
+    : m_system(std::move(system)), m_directory(std::move(directory)), m_maxSize(maxSize), m_nonce((uint64_t(std::random_device{}())<<32ull)^std::random_device{}())
+{
+    if (!m_system->isDirectory(m_directory))
+        m_system->createDirectory(m_directory);
+    // get the initial size
+    trim();
+}
+
+auto IShaderCompiler::CCache::computeKey(const IShader::E_CONTENT_TYPE sourceType, const std::string_view preprocessedCode, const IShader::E_SHADER_STAGE stage, const SCompilerOptions& options) -> key_t
+{
+    std::string material;
+    material.reserve(preprocessedCode.size()+1024ull);
+    appendKeyMaterial(material,VERSION);
+    appendKeyMaterial(material,sourceType);
+    appendKeyMaterial(material,stage);
+    appendKeyMaterial(material,options.targetSpirvVersion);
+    appendKeyMaterial(material,options.debugInfoFlags.value);
+    // debug info embeds the file name
+    if (options.debugInfoFlags.value!=E_DEBUG_INFO_FLAGS::EDIF_NONE)
+        appendKeyMaterial(material,options.preprocessorOptions.sourceIdentifier);
+    // already expanded into the preprocessed code, but cheap enough to not rely on it
+    appendKeyMaterial(material,uint64_t(options.preprocessorOptions.extraDefines.size()));
+    for (const auto& define : options.preprocessorOptions.extraDefines)
+    {
+        appendKeyMaterial(material,define.identifier);
+        appendKeyMaterial(material,define.definition);
+    }
+    if (options.spirvOptimizer)
+    {
+        const auto passes = options.spirvOptimizer->getPasses();
+        appendKeyMaterial(material,uint64_t(passes.size()));
+        for (const auto pass : passes)
+            appendKeyMaterial(material,pass);
+    }
+    else
+        appendKeyMaterial(material,~0ull);
+    appendKeyMaterial(material,preprocessedCode);
+
+    key_t key;
+    core::XXHash_256(material.data(),material.size(),key.data());
+    return key;
+}
+
+core::smart_refctd_ptr<ICPUBuffer> IShaderCompiler::CCache::find(const key_t& key)
+{
+    const auto entryPath = getEntryPath(key);
+    core::smart_refctd_ptr<ICPUBuffer> spirv;
+    if (m_system->exists(entryPath,system::IFileBase::ECF_READ))
+    {
+        system::ISystem::future_t<core::smart_refctd_ptr<system::IFile>> future;
+        m_system->createFile(future,entryPath,system::IFileBase::ECF_READ);
+        // could have been evicted by another process in the meantime
+        if (auto file=future.acquire(); file&&bool(*file))
+        {
+            SSPIRVCacheEntryHeader header;
+            system::IFile::success_t headerSuccess;
+            (*file)->read(headerSuccess,&header,0ull,sizeof(header));
+            // anything that doesn't check out is treated as a miss, and will be overwritten by the following insert
+            if (headerSuccess && header.magic==SSPIRVCacheEntryHeader::Magic && header.version==VERSION && header.key==key && header.size==(*file)->getSize()-sizeof(header))
+            {
+                spirv = core::make_smart_refctd_ptr<ICPUBuffer>(header.size);
+                system::IFile::success_t success;
+                (*file)->read(success,spirv->getPointer(),sizeof(header),header.size);
+                if (!success)
+                    spirv = nullptr;
+            }
+        }
+    }
+
+    if (!spirv)
+    {
+        m_misses++;
+        return nullptr;
+    }
+    m_hits++;
+    // the modification time is what the LRU eviction goes by, failing to bump it is harmless
+    std::error_code ec;
+    std::filesystem::last_write_time(entryPath,std::filesystem::file_time_type::clock::now(),ec);
+    return spirv;
+}
+
+void IShaderCompiler::CCache::insert(const key_t& key, const ICPUBuffer* spirv)
+{
+    if (!spirv)
+        return;
+    const size_t entrySize = sizeof(SSPIRVCacheEntryHeader)+spirv->getSize();
+    if (entrySize>m_maxSize)
+        return;
+
+    const auto entryPath = getEntryPath(key);
+    auto tmpPath = entryPath;
+    tmpPath += "."+std::to_string(m_nonce)+"_"+std::to_string(m_tmpCounter++)+".tmp";
+    {
+        system::ISystem::future_t<core::smart_refctd_ptr<system::IFile>> future;
+        m_system->createFile(future,tmpPath,system::IFileBase::ECF_WRITE);
+        auto file = future.acquire();
+        if (!file || !bool(*file))
+            return;
+
+        SSPIRVCacheEntryHeader header;
+        header.magic = SSPIRVCacheEntryHeader::Magic;
+        header.version = VERSION;
+        header.key = key;
+        header.size = spirv->getSize();
+        system::IFile::success_t headerSuccess;
+        (*file)->write(headerSuccess,&header,0ull,sizeof(header));
+        system::IFile::success_t success;
+        (*file)->write(success,spirv->getPointer(),sizeof(header),header.size);
+        if (!headerSuccess || !success)
+        {
+            *file = nullptr;
+            std::error_code ec;
+            std::filesystem::remove(tmpPath,ec);
+            return;
+        }
+        // file gets closed before the rename
+    }
+    // atomic, so concurrent readers see either the old entry, the new one or nothing at all
+    if (m_system->moveFileOrDirectory(tmpPath,entryPath))
+    {
+        std::error_code ec;
+        std::filesystem::remove(tmpPath,ec);
+        return;
+    }
+    m_insertions++;
+
+    if (m_approximateSize.fetch_add(entrySize)+entrySize>m_maxSize)
+        trim();
+}
+
+system::path IShaderCompiler::CCache::getEntryPath(const key_t& key) const
+{
+    constexpr char digits[] = "0123456789abcdef";
+    std::string name;
+    name.reserve(sizeof(key_t)*2ull+4ull);
+    for (const auto word : key)
+    for (int32_t shift=60; shift>=0; shift-=4)
+        name.push_back(digits[(word>>shift)&0xfull]);
+    name += ".spv";
+    return m_directory/name;
+}
+
+void IShaderCompiler::CCache::trim()
+{
+    // someone else is already at it
+    std::unique_lock lock(m_trimMutex,std::try_to_lock);
+    if (!lock.owns_lock())
+        return;
+
+    struct SEntry
+    {
+        system::path path;
+        std::filesystem::file_time_type lastUse;
+        size_t size;
+    };
+    core::vector<SEntry> entries;
+    size_t totalSize = 0ull;
+    std::error_code ec;
+    for (const auto& item : std::filesystem::directory_iterator(m_directory,ec))
+    {
+        if (!item.is_regular_file(ec) || item.path().extension()!=".spv")
+            continue;
+        const size_t size = item.file_size(ec);
+        if (ec)
+            continue;
+        const auto lastUse = item.last_write_time(ec);
+        if (ec)
+            continue;
+        entries.push_back({item.path(),lastUse,size});
+        totalSize += size;
+    }
+
+    if (totalSize>m_maxSize)
+    {
+        std::sort(entries.begin(),entries.end(),[](const SEntry& lhs, const SEntry& rhs)->bool{return lhs.lastUse<rhs.lastUse;});
+        // leave some headroom, so that we don't rescan the directory on every insert
+        const size_t targetSize = m_maxSize-m_maxSize/4ull;
+        for (auto it=entries.begin(); it!=entries.end() && totalSize>targetSize; it++)
+        {
+            // might be open or already gone in another process, its fine
+            if (!std::filesystem::remove(it->path,ec))
+                continue;
+            totalSize -= it->size;
+            m_evictions++;
+        }
+    }
+    m_approximateSize = totalSize;
+}
@@ -0,0 +1,190 @@
+// Copyright (C) 2018-2023 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+#include "nbl/core/parallel/CTaskScheduler.h"
+#include "nbl/core/def/smart_refctd_ptr.h"
+
+using namespace nbl;
+using namespace core;
+
+namespace
+{
+// which scheduler (if any) owns the current thread and its queue index
+thread_local const CTaskScheduler* tl_scheduler = nullptr;
+thread_local uint32_t tl_workerIx = 0u;
+// `CNoWaitScope`s of the current thread plus the ones inherited by the tasks it's running
+thread_local uint32_t tl_noWaitDepth = 0u;
+}
+
+CTaskScheduler::CTaskScheduler(const uint32_t workerCount) :
+	m_workerCount(workerCount!=~0u ? workerCount:(std::max(std::thread::hardware_concurrency(),1u)-1u)),
+	m_policy({this,0u}), m_queues(std::make_unique<SQueue[]>(m_workerCount+1u))
+{
+	m_threads.reserve(m_workerCount);
+	for (uint32_t i=0u; i<m_workerCount; i++)
+		m_threads.emplace_back(&CTaskScheduler::workerLoop,this,i);
+}
+
+CTaskScheduler::~CTaskScheduler()
+{
+	m_quit = true;
+	notify(true);
+	for (auto& thread : m_threads)
+		thread.join();
+	// anything still in the queues was fire-and-forget, run it so continuations don't get lost
+	for (SItem item; pop(item); )
+		execute(item);
+}
+
+CTaskScheduler* CTaskScheduler::getDefault()
+{
+	static const smart_refctd_ptr<CTaskScheduler> scheduler = make_smart_refctd_ptr<CTaskScheduler>();
+	return scheduler.get();
+}
+
+void CTaskScheduler::enqueue(task_t&& task, CTaskGroup* group)
+{
+	const uint32_t queueIx = tl_scheduler==this ? tl_workerIx:m_workerCount;
+	{
+		auto& queue = m_queues[queueIx];
+		std::unique_lock lock(queue.mutex);
+		queue.items.push_back({std::move(task),group,tl_noWaitDepth});
+	}
+	// whoever wakes up will try to run a task first, so waking a single thread is enough
+	notify(false);
+}
+
+bool CTaskScheduler::runPendingTask()
+{
+	SItem item;
+	if (!pop(item))
+		return false;
+	execute(item);
+	return true;
+}
+
+bool CTaskScheduler::pop(SItem& item)
+{
+	const bool isOwnWorker = tl_scheduler==this;
+	// own deque from the back first
+	if (isOwnWorker)
+	{
+		auto& queue = m_queues[tl_workerIx];
+		std::unique_lock lock(queue.mutex);
+		if (!queue.items.empty())
+		{
+			item = std::move(queue.items.back());
+			queue.items.pop_back();
+			return true;
+		}
+	}
+	// then steal from the front of everyone else's, starting from the injection queue
+	const uint32_t queueCount = m_workerCount+1u;
+	const uint32_t start = isOwnWorker ? (tl_workerIx+1u):m_workerCount;
+	for (uint32_t i=0u; i<queueCount; i++)
+	{
+		const uint32_t victimIx = (start+i)%queueCount;
+		if (isOwnWorker && victimIx==tl_workerIx)
+			continue;
+		auto& queue = m_queues[victimIx];
+		std::unique_lock lock(queue.mutex,std::try_to_lock);
+		// don't spin on a contended lock, somebody else is already taking care of it
+		if (!lock.owns_lock() || queue.items.empty())
+			continue;
+		item = std::move(queue.items.front());
+		queue.items.pop_front();
+		return true;
+	}
+	return false;
+}
+
+void CTaskScheduler::execute(SItem& item)
+{
+	// a throwing task must still count as done, otherwise whoever waits on its group would hang forever
+	std::exception_ptr exception;
+	// whatever is further down our stack still holds its scopes, so the inherited ones go on top
+	const uint32_t prevNoWaitDepth = tl_noWaitDepth;
+	tl_noWaitDepth += item.noWaitDepth;
+	try
+	{
+		item.task();
+	}
+	catch (...)
+	{
+		exception = std::current_exception();
+	}
+	tl_noWaitDepth = prevNoWaitDepth;
+	item.task = nullptr;
+	if (item.group)
+		item.group->taskDone(std::move(exception));
+}
+
+void CTaskScheduler::workerLoop(const uint32_t workerIx)
+{
+	tl_scheduler = this;
+	tl_workerIx = workerIx;
+	while (true)
+	{
+		// need to sample the epoch before looking for work, or we could miss a wakeup
+		const auto epoch = m_epoch.load();
+		if (m_quit.load())
+			break;
+		if (runPendingTask())
+			continue;
+		m_epoch.wait(epoch);
+	}
+	tl_scheduler = nullptr;
+}
+
+
+CTaskScheduler::CNoWaitScope::CNoWaitScope()
+{
+	tl_noWaitDepth++;
+}
+
+CTaskScheduler::CNoWaitScope::~CNoWaitScope()
+{
+	assert(tl_noWaitDepth);
+	tl_noWaitDepth--;
+}
+
+bool CTaskScheduler::mustNotWait()
+{
+	return tl_noWaitDepth!=0u;
+}
+
+
+void CTaskScheduler::CTaskGroup::wait()
+{
+	drain();
+	// only the first exception gets reported, the group can be reused afterwards
+	if (auto exception=std::exchange(m_exception,nullptr))
+		std::rethrow_exception(exception);
+}
+
+void CTaskScheduler::CTaskGroup::drain()
+{
+	m_scheduler->waitUntil([this]()->bool{return done();});
+	// the thread which completed the last task might still be holding the lock, the group could get destroyed right after we return
+	std::unique_lock lock(m_continuationMutex);
+}
+
+void CTaskScheduler::CTaskGroup::taskDone(std::exception_ptr&& exception)
+{
+	// after the last decrement the group can die at any moment, so copy out everything we need while holding the lock
+	CTaskScheduler* const scheduler = m_scheduler;
+	core::vector<task_t> continuations;
+	{
+		std::unique_lock lock(m_continuationMutex);
+		if (exception && !m_exception)
+			m_exception = std::move(exception);
+		if (--m_pending!=0u)
+			return;
+		continuations.swap(m_continuations);
+	}
+	for (auto& continuation : continuations)
+		scheduler->enqueue(std::move(continuation));
+	// there may be threads waiting on the group to complete
+	scheduler->notify(true);
+}
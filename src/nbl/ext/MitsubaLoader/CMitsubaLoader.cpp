@@ -288,7 +288,10 @@ static core::smart_refctd_ptr<asset::ICPUImage> createDerivMap(SContext& ctx, as
 	if (!derivmap_img)
 		return nullptr;
 
-	ctx.derivMapCache.insert({derivmap_img,scale});
+	{
+		std::lock_guard<std::mutex> lock(ctx.derivMapCacheMutex);
+		ctx.derivMapCache.insert({derivmap_img,scale});
+	}
 
 	return derivmap_img;
 }
@@ -352,7 +355,7 @@ static core::smart_refctd_ptr<asset::ICPUImage> createSingleChannelImage(const a
 			conv.swizzle[i] = asset::ICPUImageView::SComponentMapping::E_SWIZZLE::ES_R;
 	}
 
-	if (!convert_filter_t::execute(core::execution::par_unseq,&conv))
+	if (!convert_filter_t::execute(core::CTaskScheduler::getDefault()->policy(),&conv))
 	{
 		_logger.log("Mitsuba XML Loader: blend weight texture creation failed!", system::ILogger::E_LOG_LEVEL::ELL_ERROR);
 		_NBL_DEBUG_BREAK_IF(true);
@@ -477,6 +480,127 @@ const char** CMitsubaLoader::getAssociatedFileExtensions() const
 	return ext;
 }
 
+//! Calls `f(shape)` for every basic shape `getMesh` would load for a top level `shape`, in the same order
+template<typename F>
+static void forEachBasicShapeInGroup(const CElementShape::ShapeGroup* shapegroup, F& f)
+{
+	for (auto i=0u; i<shapegroup->childCount; i++)
+	{
+		auto child = shapegroup->children[i];
+		if (!child)
+			continue;
+
+		if (child->type!=CElementShape::Type::SHAPEGROUP)
+			f(child);
+		else
+			forEachBasicShapeInGroup(&child->shapegroup,f);
+	}
+}
+template<typename F>
+static void forEachBasicShape(CElementShape* shape, F&& f)
+{
+	if (!shape)
+		return;
+
+	if (shape->type!=CElementShape::Type::INSTANCE)
+		f(shape);
+	else if (const CElementShape* parent=shape->instance.parent)
+		forEachBasicShapeInGroup(&parent->shapegroup,f);
+}
+//! Returns the file backing the geometry of a basic shape, or nullptr for the built-in primitives
+static const char* getShapeFilename(const CElementShape* shape)
+{
+	switch (shape->type)
+	{
+		case CElementShape::Type::OBJ:
+			return shape->obj.filename.svalue;
+		case CElementShape::Type::PLY:
+			return shape->ply.filename.svalue;
+		case CElementShape::Type::SERIALIZED:
+			return shape->serialized.filename.svalue;
+		default:
+			return nullptr;
+	}
+}
+//! Calls `f(texture,semantic)` for every texture the BSDF tree references
+template<typename F>
+static void forEachBSDFTexture(const CElementBSDF* _bsdf, F&& f)
+{
+	auto visitPropertyTexture = [&](const auto& const_or_tex, const CMitsubaMaterialCompilerFrontend::E_IMAGE_VIEW_SEMANTIC semantic=CMitsubaMaterialCompilerFrontend::EIVS_IDENTITIY) -> void
+	{
+		if (const_or_tex.value.type==SPropertyElementData::INVALID)
+			f(const_or_tex.texture,semantic);
+	};
+
+	core::stack<const CElementBSDF*> stack;
+	stack.push(_bsdf);
+
+	while (!stack.empty())
+	{
+		auto* bsdf = stack.top();
+		stack.pop();
+		//
+		switch (bsdf->type)
+		{
+			case CElementBSDF::COATING:
+				for (uint32_t i = 0u; i < bsdf->coating.childCount; ++i)
+					stack.push(bsdf->coating.bsdf[i]);
+				break;
+			case CElementBSDF::ROUGHCOATING:
+			case CElementBSDF::BUMPMAP:
+			case CElementBSDF::BLEND_BSDF:
+			case CElementBSDF::MIXTURE_BSDF:
+			case CElementBSDF::MASK:
+			case CElementBSDF::TWO_SIDED:
+				for (uint32_t i = 0u; i < bsdf->meta_common.childCount; ++i)
+					stack.push(bsdf->meta_common.bsdf[i]);
+			default:
+				break;
+		}
+		//
+		switch (bsdf->type)
+		{
+			case CElementBSDF::DIFFUSE:
+			case CElementBSDF::ROUGHDIFFUSE:
+				visitPropertyTexture(bsdf->diffuse.reflectance);
+				visitPropertyTexture(bsdf->diffuse.alpha);
+				break;
+			case CElementBSDF::DIFFUSE_TRANSMITTER:
+				visitPropertyTexture(bsdf->difftrans.transmittance);
+				break;
+			case CElementBSDF::DIELECTRIC:
+			case CElementBSDF::THINDIELECTRIC:
+			case CElementBSDF::ROUGHDIELECTRIC:
+				visitPropertyTexture(bsdf->dielectric.alphaU);
+				if (bsdf->dielectric.distribution == CElementBSDF::RoughSpecularBase::ASHIKHMIN_SHIRLEY)
+					visitPropertyTexture(bsdf->dielectric.alphaV);
+				break;
+			case CElementBSDF::CONDUCTOR:
+				visitPropertyTexture(bsdf->conductor.alphaU);
+				if (bsdf->conductor.distribution == CElementBSDF::RoughSpecularBase::ASHIKHMIN_SHIRLEY)
+					visitPropertyTexture(bsdf->conductor.alphaV);
+				break;
+			case CElementBSDF::PLASTIC:
+			case CElementBSDF::ROUGHPLASTIC:
+				visitPropertyTexture(bsdf->plastic.diffuseReflectance);
+				visitPropertyTexture(bsdf->plastic.alphaU);
+				if (bsdf->plastic.distribution == CElementBSDF::RoughSpecularBase::ASHIKHMIN_SHIRLEY)
+					visitPropertyTexture(bsdf->plastic.alphaV);
+				break;
+			case CElementBSDF::BUMPMAP:
+				f(bsdf->bumpmap.texture,bsdf->bumpmap.wasNormal ? CMitsubaMaterialCompilerFrontend::EIVS_NORMAL_MAP:CMitsubaMaterialCompilerFrontend::EIVS_BUMP_MAP);
+				break;
+			case CElementBSDF::BLEND_BSDF:
+				visitPropertyTexture(bsdf->blendbsdf.weight,CMitsubaMaterialCompilerFrontend::EIVS_BLEND_WEIGHT);
+				break;
+			case CElementBSDF::MASK:
+				visitPropertyTexture(bsdf->mask.opacity,CMitsubaMaterialCompilerFrontend::EIVS_BLEND_WEIGHT);
+				break;
+			default: break;
+		}
+	}
+}
+
 asset::SAssetBundle CMitsubaLoader::loadAsset(system::IFile* _file, const asset::IAssetLoader::SAssetLoadParams& _params, asset::IAssetLoader::IAssetLoaderOverride* _override, uint32_t _hierarchyLevel)
 {
 	//ParserLog::setLogger(_params.logger);
@@ -509,6 +633,100 @@ asset::SAssetBundle CMitsubaLoader::loadAsset(system::IFile* _file, const asset:
 			createAndCacheVertexShader(m_assetMgr, DUMMY_VERTEX_SHADER);
 		}
 
+		// Load all geometry and textures upfront on the task scheduler, the ordered passes below then only hit the caches.
+		// Shapes and textures backed by the same file always go into the same task, so no task ever waits on another's in-flight load.
+		{
+			auto* const scheduler = m_assetMgr->getScheduler();
+
+			core::vector<CElementShape*> basicShapes;
+			core::vector<const CElementBSDF*> bsdfs;
+			{
+				core::unordered_set<const CElementShape*> seenShapes;
+				core::unordered_set<const CElementBSDF*> seenBSDFs;
+				for (auto& shapepair : parserManager.shapegroups)
+				{
+					auto* shapedef = shapepair.first;
+					if (shapedef->type == CElementShape::Type::SHAPEGROUP)
+						continue;
+
+					forEachBasicShape(shapedef,[&](CElementShape* shape) -> void
+					{
+						if (!seenShapes.insert(shape).second)
+							return;
+						basicShapes.push_back(shape);
+						if (shape->bsdf && seenBSDFs.insert(shape->bsdf).second)
+							bsdfs.push_back(shape->bsdf);
+					});
+				}
+			}
+
+			core::vector<core::vector<uint32_t>> geometryBatches;
+			{
+				core::unordered_map<std::string,uint32_t> fileToBatch;
+				for (uint32_t i=0u; i<basicShapes.size(); i++)
+				{
+					const char* filename = getShapeFilename(basicShapes[i]);
+					if (!filename)
+					{
+						geometryBatches.push_back({i});
+						continue;
+					}
+					auto found = fileToBatch.try_emplace(filename,geometryBatches.size());
+					if (found.second)
+						geometryBatches.emplace_back();
+					geometryBatches[found.first->second].push_back(i);
+				}
+			}
+			// both the geometry and the texture loads go through `ctx.override_`, which might not be thread-safe
+			const bool concurrentLoads = ctx.override_->allowConcurrentLoads(ctx.inner,_hierarchyLevel);
+			core::vector<SContext::shape_ass_type> loadedShapes(basicShapes.size());
+			core::CTaskScheduler::CTaskGroup geometry(scheduler);
+			for (const auto& batch : geometryBatches)
+			{
+				auto loadBatch = [&]() -> void
+				{
+					for (const auto i : batch)
+						loadedShapes[i] = loadBasicShapeGeometry(ctx,_hierarchyLevel,basicShapes[i],_params.logger);
+				};
+				if (concurrentLoads)
+					geometry.run(std::move(loadBatch));
+				else
+					loadBatch();
+			}
+
+			using texture_t = std::pair<const CElementTexture*,CMitsubaMaterialCompilerFrontend::E_IMAGE_VIEW_SEMANTIC>;
+			core::vector<core::vector<texture_t>> textureBatches;
+			{
+				core::unordered_set<std::string> seenViews;
+				core::unordered_map<std::string,uint32_t> fileToBatch;
+				for (const auto* bsdf : bsdfs)
+				forEachBSDFTexture(bsdf,[&](const CElementTexture* tex, const CMitsubaMaterialCompilerFrontend::E_IMAGE_VIEW_SEMANTIC semantic) -> void
+				{
+					while (tex && tex->type==CElementTexture::Type::SCALE)
+						tex = tex->scale.texture;
+					if (!tex || tex->type!=CElementTexture::Type::BITMAP || !seenViews.insert(SContext::imageViewCacheKey(tex->bitmap,semantic)).second)
+						return;
+					auto found = fileToBatch.try_emplace(tex->bitmap.filename.svalue,textureBatches.size());
+					if (found.second)
+						textureBatches.emplace_back();
+					textureBatches[found.first->second].emplace_back(tex,semantic);
+				});
+			}
+			scheduler->parallel_for(textureBatches.size(),[&](const size_t i) -> void
+			{
+				for (const auto& texture : textureBatches[i])
+					cacheTexture(ctx,0u,texture.first,texture.second);
+			},concurrentLoads ? 0u:1u,1u);
+
+			// the material compiler frontend is not thread-safe, but it can overlap with the geometry still loading
+			for (const auto* bsdf : bsdfs)
+				getBSDFtreeTraversal(ctx,bsdf,_params.logger);
+
+			geometry.wait();
+			for (uint32_t i=0u; i<basicShapes.size(); i++)
+				ctx.shapeCache.insert({basicShapes[i],std::move(loadedShapes[i])});
+		}
+
 		core::map<core::smart_refctd_ptr<asset::ICPUMesh>,std::pair<std::string,CElementShape::Type>> meshes;
 		for (auto& shapepair : parserManager.shapegroups)
 		{
@@ -693,8 +911,6 @@ static core::smart_refctd_ptr<ICPUMesh> createMeshFromGeomCreatorReturnType(IGeo
 
 SContext::shape_ass_type CMitsubaLoader::loadBasicShape(SContext& ctx, uint32_t hierarchyLevel, CElementShape* shape, const core::matrix3x4SIMD& relTform, const system::logger_opt_ptr& logger)
 {
-	constexpr uint32_t UV_ATTRIB_ID = 2u;
-
 	auto addInstance = [shape,&ctx,&relTform,&logger,this](SContext::shape_ass_type& mesh)
 	{
 		auto bsdf = getBSDFtreeTraversal(ctx, shape->bsdf, logger);
@@ -713,11 +929,25 @@ SContext::shape_ass_type CMitsubaLoader::loadBasicShape(SContext& ctx, uint32_t
 
 	auto found = ctx.shapeCache.find(shape);
 	if (found != ctx.shapeCache.end()) {
-		addInstance(found->second);
+		// shapes that failed to load are cached as well
+		if (found->second)
+			addInstance(found->second);
 
 		return found->second;
 	}
 
+	auto mesh = loadBasicShapeGeometry(ctx, hierarchyLevel, shape, logger);
+	if (mesh)
+		addInstance(mesh);
+	// cache and return
+	ctx.shapeCache.insert({ shape,mesh });
+	return mesh;
+}
+
+SContext::shape_ass_type CMitsubaLoader::loadBasicShapeGeometry(SContext& ctx, uint32_t hierarchyLevel, CElementShape* shape, const system::logger_opt_ptr& logger)
+{
+	constexpr uint32_t UV_ATTRIB_ID = 2u;
+
 	auto loadModel = [&](const ext::MitsubaLoader::SPropertyElementData& filename, int64_t index=-1) -> core::smart_refctd_ptr<asset::ICPUMesh>
 	{
 		assert(filename.type==ext::MitsubaLoader::SPropertyElementData::Type::STRING);
@@ -928,12 +1158,7 @@ SContext::shape_ass_type CMitsubaLoader::loadBasicShape(SContext& ctx, uint32_t
 		meshbuffer = std::move(newMeshBuffer);
 	}
 	IMeshManipulator::recalculateBoundingBox(newMesh.get());
-	mesh = std::move(newMesh);
-
-	addInstance(mesh);
-	// cache and return
-	ctx.shapeCache.insert({ shape,mesh });
-	return mesh;
+	return newMesh;
 }
 
 void CMitsubaLoader::cacheTexture(SContext& ctx, uint32_t hierarchyLevel, const CElementTexture* tex, const CMitsubaMaterialCompilerFrontend::E_IMAGE_VIEW_SEMANTIC semantic)
@@ -1053,12 +1278,13 @@ void CMitsubaLoader::cacheTexture(SContext& ctx, uint32_t hierarchyLevel, const
 				{
 					const std::string samplerCacheKey = ctx.samplerCacheKey(samplerParams);
 					const asset::IAsset::E_TYPE types[] = {asset::IAsset::ET_SAMPLER,asset::IAsset::ET_TERMINATING_ZERO};
-					// not found in cache
-					if (ctx.override_->findCachedAsset(samplerCacheKey,types,ctx.inner,hierarchyLevel).getContents().empty())
+					// textures get cached concurrently, so make sure only one of them creates the sampler
+					interm_findOrCreateCachedAsset(m_assetMgr,samplerCacheKey,types,ctx.inner,hierarchyLevel,ctx.override_,[&]() -> SAssetBundle
 					{
 						SAssetBundle samplerBundle(nullptr,{core::make_smart_refctd_ptr<ICPUSampler>(samplerParams)});
-						ctx.override_->insertAssetIntoCache(std::move(samplerBundle),samplerCacheKey,ctx.inner,hierarchyLevel);
-					}
+						ctx.override_->insertAssetIntoCache(samplerBundle,samplerCacheKey,ctx.inner,hierarchyLevel);
+						return samplerBundle;
+					});
 				}
 			}
 			break;
@@ -1086,81 +1312,10 @@ auto CMitsubaLoader::getBSDFtreeTraversal(SContext& ctx, const CElementBSDF* bsd
 
 auto CMitsubaLoader::genBSDFtreeTraversal(SContext& ctx, const CElementBSDF* _bsdf, const system::logger_opt_ptr& _logger) -> SContext::bsdf_type
 {
+	forEachBSDFTexture(_bsdf,[&](const CElementTexture* tex, const CMitsubaMaterialCompilerFrontend::E_IMAGE_VIEW_SEMANTIC semantic) -> void
 	{
-		auto cachePropertyTexture = [&](const auto& const_or_tex, const CMitsubaMaterialCompilerFrontend::E_IMAGE_VIEW_SEMANTIC semantic=CMitsubaMaterialCompilerFrontend::EIVS_IDENTITIY) -> void
-		{
-			if (const_or_tex.value.type==SPropertyElementData::INVALID)
-				cacheTexture(ctx,0u,const_or_tex.texture,semantic);
-		};
-
-		core::stack<const CElementBSDF*> stack;
-		stack.push(_bsdf);
-
-		while (!stack.empty())
-		{
-			auto* bsdf = stack.top();
-			stack.pop();
-			//
-			switch (bsdf->type)
-			{
-				case CElementBSDF::COATING:
-					for (uint32_t i = 0u; i < bsdf->coating.childCount; ++i)
-						stack.push(bsdf->coating.bsdf[i]);
-					break;
-				case CElementBSDF::ROUGHCOATING:
-				case CElementBSDF::BUMPMAP:
-				case CElementBSDF::BLEND_BSDF:
-				case CElementBSDF::MIXTURE_BSDF:
-				case CElementBSDF::MASK:
-				case CElementBSDF::TWO_SIDED:
-					for (uint32_t i = 0u; i < bsdf->meta_common.childCount; ++i)
-						stack.push(bsdf->meta_common.bsdf[i]);
-				default:
-					break;
-			}
-			//
-			switch (bsdf->type)
-			{
-				case CElementBSDF::DIFFUSE:
-				case CElementBSDF::ROUGHDIFFUSE:
-					cachePropertyTexture(bsdf->diffuse.reflectance);
-					cachePropertyTexture(bsdf->diffuse.alpha);
-					break;
-				case CElementBSDF::DIFFUSE_TRANSMITTER:
-					cachePropertyTexture(bsdf->difftrans.transmittance);
-					break;
-				case CElementBSDF::DIELECTRIC:
-				case CElementBSDF::THINDIELECTRIC:
-				case CElementBSDF::ROUGHDIELECTRIC:
-					cachePropertyTexture(bsdf->dielectric.alphaU);
-					if (bsdf->dielectric.distribution == CElementBSDF::RoughSpecularBase::ASHIKHMIN_SHIRLEY)
-						cachePropertyTexture(bsdf->dielectric.alphaV);
-					break;
-				case CElementBSDF::CONDUCTOR:
-					cachePropertyTexture(bsdf->conductor.alphaU);
-					if (bsdf->conductor.distribution == CElementBSDF::RoughSpecularBase::ASHIKHMIN_SHIRLEY)
-						cachePropertyTexture(bsdf->conductor.alphaV);
-					break;
-				case CElementBSDF::PLASTIC:
-				case CElementBSDF::ROUGHPLASTIC:
-					cachePropertyTexture(bsdf->plastic.diffuseReflectance);
-					cachePropertyTexture(bsdf->plastic.alphaU);
-					if (bsdf->plastic.distribution == CElementBSDF::RoughSpecularBase::ASHIKHMIN_SHIRLEY)
-						cachePropertyTexture(bsdf->plastic.alphaV);
-					break;
-				case CElementBSDF::BUMPMAP:
-					cacheTexture(ctx,0u,bsdf->bumpmap.texture,bsdf->bumpmap.wasNormal ? CMitsubaMaterialCompilerFrontend::EIVS_NORMAL_MAP:CMitsubaMaterialCompilerFrontend::EIVS_BUMP_MAP);
-					break;
-				case CElementBSDF::BLEND_BSDF:
-					cachePropertyTexture(bsdf->blendbsdf.weight,CMitsubaMaterialCompilerFrontend::EIVS_BLEND_WEIGHT);
-					break;
-				case CElementBSDF::MASK:
-					cachePropertyTexture(bsdf->mask.opacity,CMitsubaMaterialCompilerFrontend::EIVS_BLEND_WEIGHT);
-					break;
-				default: break;
-			}
-		}
-	}
+		cacheTexture(ctx,0u,tex,semantic);
+	});
 
 	return ctx.frontend.compileToIRTree(ctx.ir.get(), _bsdf, _logger);
 }
@@ -59,6 +59,66 @@ using unaligned_vec3 = unaligned_gvecN<float,3ull>;
 using unaligned_dvec2 = unaligned_gvecN<double,2ull>;
 using unaligned_dvec3 = unaligned_gvecN<double,3ull>;
 
+//! Copies the positions verbatim and returns their bounding box
+template<typename T>
+static core::aabbox3df readPositions(const uint8_t* src, void* dst, const size_t vertexCount)
+{
+	using vec_t = unaligned_gvecN<T,3ull>;
+	memcpy(dst,src,sizeof(vec_t)*vertexCount);
+
+	const auto* pos = reinterpret_cast<const vec_t*>(src);
+	auto load = [pos](const size_t i) -> core::vectorSIMDf
+	{
+		return core::vectorSIMDf(static_cast<float>(pos[i].pointer[0]),static_cast<float>(pos[i].pointer[1]),static_cast<float>(pos[i].pointer[2]));
+	};
+	core::vectorSIMDf minEdge = load(0ull);
+	core::vectorSIMDf maxEdge = minEdge;
+	for (size_t i=1ull; i<vertexCount; i++)
+	{
+		const auto p = load(i);
+		minEdge = core::min(minEdge,p);
+		maxEdge = core::max(maxEdge,p);
+	}
+	return core::aabbox3df(minEdge.x,minEdge.y,minEdge.z,maxEdge.x,maxEdge.y,maxEdge.z);
+}
+
+template<typename T>
+static void readNormals(const uint8_t* src, CQuantNormalCache::value_type_t<EF_A2B10G10R10_SNORM_PACK32>* dst, const size_t vertexCount, CQuantNormalCache* quantNormalCache)
+{
+	const auto* nml = reinterpret_cast<const unaligned_gvecN<T,3ull>*>(src);
+	for (size_t i=0ull; i<vertexCount; i++)
+	{
+		const core::vectorSIMDf simdNormal(static_cast<float>(nml[i].pointer[0]),static_cast<float>(nml[i].pointer[1]),static_cast<float>(nml[i].pointer[2]));
+		dst[i] = quantNormalCache->quantize<EF_A2B10G10R10_SNORM_PACK32>(simdNormal);
+	}
+}
+
+static void convertDoublesToFloats(const double* src, float* dst, const size_t count)
+{
+	size_t i = 0ull;
+#ifdef __NBL_COMPILE_WITH_SSE3
+	for (; i+4ull<=count; i+=4ull)
+	{
+		const __m128 lo = _mm_cvtpd_ps(_mm_loadu_pd(src+i));
+		const __m128 hi = _mm_cvtpd_ps(_mm_loadu_pd(src+i+2ull));
+		_mm_storeu_ps(dst+i,_mm_movelh_ps(lo,hi));
+	}
+#endif
+	for (; i<count; i++)
+		dst[i] = static_cast<float>(src[i]);
+}
+
+template<typename T>
+static void readColors(const uint8_t* src, uint32_t* dst, const size_t vertexCount)
+{
+	const auto* color = reinterpret_cast<const unaligned_gvecN<T,3ull>*>(src);
+	for (size_t i=0ull; i<vertexCount; i++)
+	{
+		const double colors[3] = {color[i].pointer[0],color[i].pointer[1],color[i].pointer[2]};
+		asset::encodePixels<asset::EF_B10G11R11_UFLOAT_PACK32,double>(dst+i,colors);
+	}
+}
+
 
 //! creates/loads an animated mesh from the file.
 asset::SAssetBundle CSerializedLoader::loadAsset(system::IFile* _file, const asset::IAssetLoader::SAssetLoadParams& _params, asset::IAssetLoader::IAssetLoaderOverride* _override, uint32_t _hierarchyLevel)
@@ -117,17 +177,14 @@ asset::SAssetBundle CSerializedLoader::loadAsset(system::IFile* _file, const ass
 	if (maxSize==0u)
 		return {};
 
-	auto meta = core::make_smart_refctd_ptr<CMitsubaSerializedMetadata>(ctx.meshCount,core::smart_refctd_ptr(IRenderpassIndependentPipelineLoader::m_basicViewParamsSemantics));
-	core::vector<core::smart_refctd_ptr<ICPUMesh>> meshes; meshes.reserve(ctx.meshCount);
-
-	uint8_t* data = reinterpret_cast<uint8_t*>(_NBL_ALIGNED_MALLOC(maxSize,alignof(double)));
+	// every mesh is a separate deflate stream at a known offset, so they can all be inflated and converted concurrently
 	constexpr size_t CHUNK = 256ull*1024ull;
-	core::vector<Page_t> decompressed(CHUNK/sizeof(Page_t));
-	system::future<size_t> future;
-	for (uint32_t i=0; i<ctx.meshCount; i++)
+	auto loadMesh = [&](const uint32_t i, uint8_t* data, core::vector<Page_t>& decompressed, std::string& name) -> core::smart_refctd_ptr<ICPUMesh>
 	{
 		auto localSize = ctx.meshOffsets->operator[](i+ctx.meshCount);
+		system::future<size_t> future;
 		ctx.inner.mainFile->read(future,data,sizeof(FileHeader)+ctx.meshOffsets->operator[](i),localSize);
+		future.get();
 		// decompress
 		size_t decompressSize;
 		{
@@ -167,12 +224,12 @@ asset::SAssetBundle CSerializedLoader::loadAsset(system::IFile* _file, const ass
 				std::string msg("Error decompressing mesh ix ");
 				msg += std::to_string(i);
 				_params.logger.log(msg, system::ILogger::E_LOG_LEVEL::ELL_ERROR);
-				continue;
+				return nullptr;
 			}
 		}
 		// too small to hold anything
 		if (decompressSize < sizeof(uint8_t)+sizeof(uint64_t)*2ull)
-			continue;
+			return nullptr;
 
 		// some tracking
 		uint8_t* ptr = reinterpret_cast<uint8_t*>(decompressed.data());
@@ -186,7 +243,7 @@ asset::SAssetBundle CSerializedLoader::loadAsset(system::IFile* _file, const ass
 			else if (flags & MF_DOUBLE_FLOAT)
 				typeSize = sizeof(double);
 			else
-				continue;
+				return nullptr;
 		}
 		const bool sourceIsDoubles = typeSize==sizeof(double);
 		const bool requiresNormals = (flags&MF_PER_VERTEX_NORMALS) || (flags&MF_FACE_NORMALS);
@@ -201,15 +258,15 @@ asset::SAssetBundle CSerializedLoader::loadAsset(system::IFile* _file, const ass
 		// name too long
 		const size_t stringLen = reinterpret_cast<char*>(ptr)-stringPtr;
 		if (ptr+sizeof(uint64_t)*2ull > streamEnd)
-			continue;
+			return nullptr;
 
 		// 
 		const uint64_t vertexCount = *(reinterpret_cast<uint64_t*&>(ptr)++);
 		if (vertexCount<3ull || vertexCount>0xFFFFFFFFull)
-			continue;
+			return nullptr;
 		const uint64_t triangleCount = *(reinterpret_cast<uint64_t*&>(ptr)++);
 		if (triangleCount<1ull)
-			continue;
+			return nullptr;
 		const size_t indexDataSize = sizeof(uint32_t)*3ull*triangleCount;
 		{
 			size_t vertexDataSize = 3ull;
@@ -221,10 +278,10 @@ asset::SAssetBundle CSerializedLoader::loadAsset(system::IFile* _file, const ass
 				vertexDataSize += 3ull;
 			vertexDataSize *= typeSize*vertexCount;
 			if (ptr+vertexDataSize > streamEnd)
-				continue;
+				return nullptr;
 			size_t totalDataSize = vertexDataSize+indexDataSize;
 			if (ptr+totalDataSize > streamEnd)
-				continue;
+				return nullptr;
 		}
 
 		auto indexbuf = core::make_smart_refctd_ptr<asset::ICPUBuffer>(indexDataSize);
@@ -294,101 +351,41 @@ asset::SAssetBundle CSerializedLoader::loadAsset(system::IFile* _file, const ass
 
 		meshBuffer->setPositionAttributeIx(POSITION_ATTRIBUTE);
 		enableAttribute(POSITION_ATTRIBUTE,sourceIsDoubles ? asset::EF_R64G64B64_SFLOAT:asset::EF_R32G32B32_SFLOAT,posbuf);
-		{
-			core::aabbox3df aabb;
-			auto readPositions = [&aabb,ptr,posPtr](const auto& pos) -> void
-			{
-				size_t vertexIx = std::distance(reinterpret_cast<decltype(&pos)>(ptr),&pos);
-				const auto* coords = pos.pointer;
-				if (vertexIx)
-					aabb.addInternalPoint(coords[0],coords[1],coords[2]);
-				else
-					aabb.reset(coords[0],coords[1],coords[2]);
-				reinterpret_cast<std::remove_const_t<std::remove_reference_t<decltype(pos)>>*>(posPtr)[vertexIx] = pos;
-			};
-			if (sourceIsDoubles)
-			{
-				auto*& typedPtr = reinterpret_cast<unaligned_dvec3*&>(ptr);
-				std::for_each_n(core::execution::seq,typedPtr,vertexCount,readPositions);
-				typedPtr += vertexCount;
-			}
-			else
-			{
-				auto*& typedPtr = reinterpret_cast<unaligned_vec3*&>(ptr);
-				std::for_each_n(core::execution::seq,typedPtr,vertexCount,readPositions);
-				typedPtr += vertexCount;
-			}
-			meshBuffer->setBoundingBox(aabb);
-		}
+		if (sourceIsDoubles)
+			meshBuffer->setBoundingBox(readPositions<double>(ptr,posPtr,vertexCount));
+		else
+			meshBuffer->setBoundingBox(readPositions<float>(ptr,posPtr,vertexCount));
+		ptr += posAttrSize*vertexCount;
 		if (requiresNormals)
 		{
 			enableAttribute(NORMAL_ATTRIBUTE,asset::EF_A2B10G10R10_SNORM_PACK32,normalbuf);
-			auto readNormals = [quantNormalCache,ptr,normalPtr](const auto& nml) -> void
-			{
-				size_t vertexIx = std::distance(reinterpret_cast<decltype(&nml)>(ptr),&nml);
-				core::vectorSIMDf simdNormal(nml.pointer[0],nml.pointer[1],nml.pointer[2]);
-				normalPtr[vertexIx] = quantNormalCache->quantize<EF_A2B10G10R10_SNORM_PACK32>(simdNormal);
-			};
-			const bool read = flags&MF_PER_VERTEX_NORMALS;
-			if (sourceIsDoubles)
+			if (flags&MF_PER_VERTEX_NORMALS)
 			{
-				auto*& typedPtr = reinterpret_cast<unaligned_dvec3*&>(ptr);
-				if (read)
-					std::for_each_n(core::execution::seq,typedPtr,vertexCount,readNormals);
-				typedPtr += vertexCount;
-			}
-			else
-			{
-				auto*& typedPtr = reinterpret_cast<unaligned_vec3*&>(ptr);
-				if (read)
-					std::for_each_n(core::execution::seq,typedPtr,vertexCount,readNormals);
-				typedPtr += vertexCount;
+				if (sourceIsDoubles)
+					readNormals<double>(ptr,normalPtr,vertexCount,quantNormalCache);
+				else
+					readNormals<float>(ptr,normalPtr,vertexCount,quantNormalCache);
 			}
+			ptr += typeSize*3ull*vertexCount;
 			meshBuffer->setNormalAttributeIx(NORMAL_ATTRIBUTE);
 		}
 		if (hasUVs)
 		{
 			enableAttribute(UV_ATTRIBUTE,asset::EF_R32G32_SFLOAT,uvbuf);
-			auto readUVs = [ptr,uvPtr](const auto& uv) -> void
-			{
-				size_t vertexIx = std::distance(reinterpret_cast<decltype(&uv)>(ptr),&uv);
-				for (auto k=0u; k<2u; k++)
-					uvPtr[vertexIx].pointer[k] = uv.pointer[k];
-			};
 			if (sourceIsDoubles)
-			{
-				auto*& typedPtr = reinterpret_cast<unaligned_dvec2*&>(ptr);
-				std::for_each_n(core::execution::seq,typedPtr,vertexCount,readUVs);
-				typedPtr += vertexCount;
-			}
+				convertDoublesToFloats(reinterpret_cast<const double*>(ptr),uvPtr->pointer,vertexCount*2ull);
 			else
-			{
-				auto*& typedPtr = reinterpret_cast<unaligned_vec2*&>(ptr);
-				std::for_each_n(core::execution::seq,typedPtr,vertexCount,readUVs);
-				typedPtr += vertexCount;
-			}
+				memcpy(uvPtr,ptr,uvAttrSize*vertexCount);
+			ptr += typeSize*2ull*vertexCount;
 		}
 		if (hasColors)
 		{
 			enableAttribute(COLOR_ATTRIBUTE,asset::EF_B10G11R11_UFLOAT_PACK32,colorbuf);
-			auto readColors = [ptr,colorPtr](const auto& color) -> void
-			{
-				size_t vertexIx = std::distance(reinterpret_cast<decltype(&color)>(ptr),&color);
-				const double colors[3] = {color.pointer[0],color.pointer[1],color.pointer[2]};
-				asset::encodePixels<asset::EF_B10G11R11_UFLOAT_PACK32,double>(colorPtr+vertexIx,colors);
-			};
 			if (sourceIsDoubles)
-			{
-				auto*& typedPtr = reinterpret_cast<unaligned_dvec3*&>(ptr);
-				std::for_each_n(core::execution::seq,typedPtr,vertexCount,readColors);
-				typedPtr += vertexCount;
-			}
+				readColors<double>(ptr,colorPtr,vertexCount);
 			else
-			{
-				auto*& typedPtr = reinterpret_cast<unaligned_vec3*&>(ptr);
-				std::for_each_n(core::execution::seq,typedPtr,vertexCount,readColors);
-				typedPtr += vertexCount;
-			}
+				readColors<float>(ptr,colorPtr,vertexCount);
+			ptr += typeSize*3ull*vertexCount;
 		}
 
 		auto mbPipeline = core::make_smart_refctd_ptr<asset::ICPURenderpassIndependentPipeline>(std::move(mbPipelineLayout), nullptr, nullptr, inputParams, blendParams, primitiveAssemblyParams, rastarizationParams);
@@ -427,20 +424,42 @@ asset::SAssetBundle CSerializedLoader::loadAsset(system::IFile* _file, const ass
 			return true;
 		};
 		if (!readIndices())
-			continue;
+			return nullptr;
 
 
 		auto mesh = core::make_smart_refctd_ptr<asset::ICPUMesh>();
 
-		meta->placeMeta(meshes.size(),mbPipeline.get(),mesh.get(),{std::string(stringPtr,stringLen),i});
+		name = std::string(stringPtr,stringLen);
 
 		meshBuffer->setPipeline(std::move(mbPipeline));
 
 		mesh->setBoundingBox(meshBuffer->getBoundingBox());
 		mesh->getMeshBufferVector().emplace_back(std::move(meshBuffer));
+		return mesh;
+	};
+
+	core::vector<core::smart_refctd_ptr<ICPUMesh>> loadedMeshes(ctx.meshCount);
+	core::vector<std::string> names(ctx.meshCount);
+	m_assetMgr->getScheduler()->parallel_for_range(ctx.meshCount,[&](const size_t rangeBegin, const size_t rangeEnd) -> void
+	{
+		uint8_t* data = reinterpret_cast<uint8_t*>(_NBL_ALIGNED_MALLOC(maxSize,alignof(double)));
+		core::vector<Page_t> decompressed(CHUNK/sizeof(Page_t));
+		for (size_t i=rangeBegin; i<rangeEnd; i++)
+			loadedMeshes[i] = loadMesh(i,data,decompressed,names[i]);
+		_NBL_ALIGNED_FREE(data);
+	});
+
+	auto meta = core::make_smart_refctd_ptr<CMitsubaSerializedMetadata>(ctx.meshCount,core::smart_refctd_ptr(IRenderpassIndependentPipelineLoader::m_basicViewParamsSemantics));
+	core::vector<core::smart_refctd_ptr<ICPUMesh>> meshes; meshes.reserve(ctx.meshCount);
+	for (uint32_t i=0; i<ctx.meshCount; i++)
+	{
+		auto& mesh = loadedMeshes[i];
+		if (!mesh)
+			continue;
+
+		meta->placeMeta(meshes.size(),mesh->getMeshBuffers().begin()[0]->getPipeline(),mesh.get(),{std::move(names[i]),i});
 		meshes.push_back(std::move(mesh));
 	}
-	_NBL_ALIGNED_FREE(data);
 
 	return SAssetBundle(std::move(meta),std::move(meshes));
 }
@@ -59,14 +59,35 @@ bool ParserManager::parse(system::IFile* _file, const system::logger_opt_ptr& _l
 	XML_SetUserData(parser, &ctx);
 
 
-	char* buff = (char*)_NBL_ALIGNED_MALLOC(_file->getSize(), 4096u);
+	// read straight into expat's own buffer, one bounded chunk at a time
+	XML_Status parseStatus = XML_STATUS_OK;
+	const size_t fileSize = _file->getSize();
+	for (size_t offset=0u; parseStatus==XML_STATUS_OK && offset<fileSize;)
+	{
+		const size_t chunkSize = std::min<size_t>(fileSize-offset,ParseChunkSize);
+		void* buff = XML_GetBuffer(parser,static_cast<int>(chunkSize));
+		if (!buff)
+		{
+			_logger.log("Could not allocate XML Parser buffer!", system::ILogger::E_LOG_LEVEL::ELL_ERROR);
+			parseStatus = XML_STATUS_ERROR;
+			break;
+		}
 
-	system::future<size_t> future;
-	_file->read(future, (void*)buff, 0u, _file->getSize());
-	future.get();
+		system::future<size_t> future;
+		_file->read(future, buff, offset, chunkSize);
+		const size_t bytesRead = future.get();
+		if (bytesRead==0u)
+		{
+			_logger.log("Could not read %s", system::ILogger::E_LOG_LEVEL::ELL_ERROR, _file->getFileName().string().c_str());
+			parseStatus = XML_STATUS_ERROR;
+			break;
+		}
+		offset += bytesRead;
 
-	XML_Status parseStatus = XML_Parse(parser, buff, _file->getSize(), 0);
-	_NBL_ALIGNED_FREE(buff);
+		parseStatus = XML_ParseBuffer(parser, static_cast<int>(bytesRead), XML_FALSE);
+	}
+	if (parseStatus==XML_STATUS_OK)
+		parseStatus = XML_Parse(parser, nullptr, 0, XML_TRUE);
 	XML_ParserFree(parser);
 	switch (parseStatus)
 	{
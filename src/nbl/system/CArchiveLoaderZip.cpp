@@ -1,5 +1,6 @@
 #include "nbl/system/IFileViewAllocator.h"
 #include "nbl/system/CArchiveLoaderZip.h"
+#include "nbl/core/parallel/CTaskScheduler.h"
 
 
 #include <aesGladman/fileenc.h>
@@ -124,7 +125,7 @@ core::smart_refctd_ptr<IFileArchive> CArchiveLoaderZip::createArchive_impl(core:
 			item.size = meta.DataDescriptor.UncompressedSize;
 			item.offset = offset;
 			item.ID = itemsMetadata.size();
-			item.allocatorType = meta.CompressionMethod ? IFileArchive::EAT_VIRTUAL_ALLOC:IFileArchive::EAT_NULL;
+			item.allocatorType = meta.CompressionMethod ? IFileArchive::EAT_BORROWED:IFileArchive::EAT_NULL;
 			itemsMetadata.push_back(meta);
 		};
 
@@ -337,7 +338,7 @@ core::smart_refctd_ptr<IFileArchive> CArchiveLoaderZip::createArchive_impl(core:
 	if (items->empty())
 		return nullptr;
 
-	return core::make_smart_refctd_ptr<CArchive>(std::move(file),core::smart_refctd_ptr(m_logger.get()), items, std::move(itemsMetadata));
+	return core::make_smart_refctd_ptr<CArchive>(std::move(file),core::smart_refctd_ptr(m_logger.get()),items,std::move(itemsMetadata),m_decompressedCacheBudget);
 }
 
 #if 0
@@ -367,7 +368,7 @@ bool CFileArchiveZip::scanCentralDirectoryHeader(size_t& offset)
 }
 #endif
 
-CFileArchive::file_buffer_t CArchiveLoaderZip::CArchive::getFileBuffer(const IFileArchive::SFileList::found_t& item)
+CArchiveLoaderZip::CEntryCache::SBuffer CArchiveLoaderZip::CArchive::decompress(const IFileArchive::SFileList::found_t& item)
 {
 	const auto& header = m_itemsMetadata[item->ID];
 	// Nabla supports 0, 8, 12, 14, 99
@@ -390,12 +391,12 @@ CFileArchive::file_buffer_t CArchiveLoaderZip::CArchive::getFileBuffer(const IFi
 	//99 - AES encryption, WinZip 9
 	int16_t actualCompressionMethod = header.CompressionMethod;
 
-	CFileArchive::file_buffer_t retval = { nullptr,item->size,nullptr };
+	CEntryCache::SBuffer retval = {nullptr,item->size,0ull};
 	//
 	void* decrypted = nullptr;
 	size_t decryptedSize = header.DataDescriptor.CompressedSize;
 	auto freeOnFail = core::makeRAIIExiter([&actualCompressionMethod,&retval,&decrypted,&decryptedSize](){
-		if (decrypted && retval.buffer!=decrypted)
+		if (decrypted && retval.data!=decrypted)
 		{
 			if (actualCompressionMethod)
 				CPlainHeapAllocator(nullptr).dealloc(decrypted,decryptedSize);
@@ -406,13 +407,11 @@ CFileArchive::file_buffer_t CArchiveLoaderZip::CArchive::getFileBuffer(const IFi
 	//
 	void* decompressed = nullptr;
 	auto freeMMappedOnFail = core::makeRAIIExiter([item,&retval,&decompressed](){
-		if (decompressed && retval.buffer!=decompressed)
+		if (decompressed && retval.data!=decompressed)
 			VirtualMemoryAllocator(nullptr).dealloc(decompressed,item->size);
 	});
 
-	const auto* const cFile = m_file.get();
-	void* const filePtr = const_cast<void*>(cFile->getMappedPointer());
-	std::byte* mmapPtr = reinterpret_cast<std::byte*>(filePtr)+item->offset;
+	std::byte* mmapPtr = const_cast<std::byte*>(getCompressedData(item));
 
 	// decrypt
 	if ((header.GeneralBitFlag&ZIP_FILE_ENCRYPTED) && (header.CompressionMethod==99))
@@ -500,9 +499,12 @@ CFileArchive::file_buffer_t CArchiveLoaderZip::CArchive::getFileBuffer(const IFi
 	{
 		case 0: // no compression
 			if (decrypted)
-				retval.buffer = decrypted;
+			{
+				retval.data = decrypted;
+				retval.allocationSize = decryptedSize;
+			}
 			else
-				retval.buffer = mmapPtr;
+				retval.data = mmapPtr;
 			break;
 		case 8:
 		{
@@ -529,7 +531,10 @@ CFileArchive::file_buffer_t CArchiveLoaderZip::CArchive::getFileBuffer(const IFi
 			}
 
 			if (err==Z_OK)
-				retval.buffer = decompressed;
+			{
+				retval.data = decompressed;
+				retval.allocationSize = item->size;
+			}
 		#else
 			m_logger.log("ZLIB decompression not supported. File cannot be read.",ILogger::ELL_ERROR);
 		#endif
@@ -555,7 +560,10 @@ CFileArchive::file_buffer_t CArchiveLoaderZip::CArchive::getFileBuffer(const IFi
 			}
 			
 			if (err==BZ_OK)
-				retval.buffer = decompressed;
+			{
+				retval.data = decompressed;
+				retval.allocationSize = item->size;
+			}
 		#else
 			m_logger.log("bzip2 decompression not supported. File cannot be read.", ILogger::ELL_ERROR);
 		#endif
@@ -582,8 +590,9 @@ CFileArchive::file_buffer_t CArchiveLoaderZip::CArchive::getFileBuffer(const IFi
 
 			if (err==SZ_OK)
 			{
-				retval.buffer = decompressed;
+				retval.data = decompressed;
 				retval.size = tmpDstSize; // may be different to expected value
+				retval.allocationSize = item->size;
 			}
 		#else
 					m_logger.log("lzma decompression not supported. File cannot be read.", ILogger::ELL_ERROR);
@@ -599,7 +608,7 @@ CFileArchive::file_buffer_t CArchiveLoaderZip::CArchive::getFileBuffer(const IFi
 			break;
 	}
 
-	if (!retval.buffer)
+	if (!retval.data)
 	{
 		if (actualCompressionMethod)
 			m_logger.log("Error decompressing %s",ILogger::ELL_ERROR,item->pathRelativeToArchive.string().c_str());
@@ -611,6 +620,250 @@ CFileArchive::file_buffer_t CArchiveLoaderZip::CArchive::getFileBuffer(const IFi
 }
 
 
+CArchiveLoaderZip::CEntryCache::~CEntryCache()
+{
+	for (const auto& entry : m_entries)
+	{
+		// a file over our memory would have had to outlive the archive
+		assert(entry.pinCount==0u);
+		if (entry.buffer.allocationSize)
+			VirtualMemoryAllocator(nullptr).dealloc(entry.buffer.data,entry.buffer.allocationSize);
+	}
+}
+
+CArchiveLoaderZip::CEntryCache::SBuffer CArchiveLoaderZip::CEntryCache::acquire(const uint32_t entryID)
+{
+	std::unique_lock lock(m_mutex);
+	auto& entry = m_entries[entryID];
+	if (!entry.buffer.data)
+		return {};
+	if (entry.pinCount++==0u)
+		m_lru.erase(entry.lruIt);
+	return entry.buffer;
+}
+
+CArchiveLoaderZip::CEntryCache::SBuffer CArchiveLoaderZip::CEntryCache::insert(const uint32_t entryID, const SBuffer& buffer)
+{
+	SBuffer retval;
+	core::vector<SBuffer> toFree;
+	{
+		std::unique_lock lock(m_mutex);
+		auto& entry = m_entries[entryID];
+		if (entry.buffer.data)
+		{
+			// lost the race to decompress, use the resident copy
+			toFree.push_back(buffer);
+			if (entry.pinCount++==0u)
+				m_lru.erase(entry.lruIt);
+		}
+		else
+		{
+			entry.buffer = buffer;
+			entry.pinCount = 1u;
+			m_entryOfBuffer.emplace(buffer.data,entryID);
+			m_residentSize += buffer.allocationSize;
+			toFree = evict();
+		}
+		retval = entry.buffer;
+	}
+	deallocate(toFree);
+	return retval;
+}
+
+void CArchiveLoaderZip::CEntryCache::release(void* data)
+{
+	core::vector<SBuffer> toFree;
+	{
+		std::unique_lock lock(m_mutex);
+		const auto found = m_entryOfBuffer.find(data);
+		if (found==m_entryOfBuffer.end())
+		{
+			assert(false);
+			return;
+		}
+		auto& entry = m_entries[found->second];
+		assert(entry.pinCount);
+		if (--entry.pinCount)
+			return;
+		entry.lruIt = m_lru.insert(m_lru.end(),found->second);
+		toFree = evict();
+	}
+	deallocate(toFree);
+}
+
+core::vector<CArchiveLoaderZip::CEntryCache::SBuffer> CArchiveLoaderZip::CEntryCache::evict()
+{
+	core::vector<SBuffer> evicted;
+	while (m_residentSize>m_budget && !m_lru.empty())
+	{
+		auto& entry = m_entries[m_lru.front()];
+		m_lru.pop_front();
+		m_residentSize -= entry.buffer.allocationSize;
+		m_entryOfBuffer.erase(entry.buffer.data);
+		evicted.push_back(entry.buffer);
+		entry.buffer = {};
+	}
+	return evicted;
+}
+
+void CArchiveLoaderZip::CEntryCache::deallocate(const core::vector<SBuffer>& buffers)
+{
+	for (const auto& buffer : buffers)
+	if (buffer.allocationSize)
+		VirtualMemoryAllocator(nullptr).dealloc(buffer.data,buffer.allocationSize);
+}
+
+
+#ifdef _NBL_COMPILE_WITH_ZLIB_
+namespace
+{
+//! Inflates a deflated entry progressively as reads reach further into it, so opening a large entry costs nothing upfront
+class CInflatingFile final : public IFile
+{
+		// don't bother calling into zlib for tiny amounts, sequential small reads would thrash
+		static inline constexpr size_t MinInflateSize = 0x1u<<16u;
+
+	public:
+		inline CInflatingFile(path&& _filename, const core::bitflag<E_CREATE_FLAGS> _flags, core::smart_refctd_ptr<IFile>&& _archiveFile, const std::byte* compressed, const size_t compressedSize, const size_t size) :
+			IFile(std::move(_filename),_flags), m_archiveFile(std::move(_archiveFile)), m_size(size)
+		{
+			// reserved but only committed as pages get written
+			m_buffer = reinterpret_cast<std::byte*>(VirtualMemoryAllocator(nullptr).alloc(m_size));
+			if (!m_buffer)
+				return;
+			m_stream.next_in = (Bytef*)compressed;
+			m_stream.avail_in = (uInt)compressedSize;
+			m_stream.next_out = (Bytef*)m_buffer;
+			m_stream.avail_out = 0u;
+			m_stream.zalloc = (alloc_func)0;
+			m_stream.zfree = (free_func)0;
+			m_stream.opaque = (voidpf)0;
+			// wbits < 0 indicates no zlib header inside the data
+			m_streamOpen = inflateInit2(&m_stream,-MAX_WBITS)==Z_OK;
+		}
+
+		inline size_t getSize() const override {return m_size;}
+
+	protected:
+		inline ~CInflatingFile()
+		{
+			if (m_streamOpen)
+				inflateEnd(&m_stream);
+			if (m_buffer)
+				VirtualMemoryAllocator(nullptr).dealloc(m_buffer,m_size);
+		}
+
+		inline void* getMappedPointer_impl() override {return nullptr;}
+		inline const void* getMappedPointer_impl() const override {return nullptr;}
+
+		inline void unmappedRead(ISystem::future_t<size_t>& fut, void* buffer, size_t offset, size_t sizeToRead) override
+		{
+			size_t bytesRead = 0ull;
+			if (offset<m_size)
+			{
+				const size_t end = offset+std::min(sizeToRead,m_size-offset);
+				const size_t available = std::min(inflateUpTo(end),end);
+				if (available>offset)
+				{
+					bytesRead = available-offset;
+					memcpy(buffer,m_buffer+offset,bytesRead);
+				}
+			}
+			set_result(fut,bytesRead);
+		}
+
+	private:
+		// returns how many bytes are available, anything below that never changes so it can be read without the lock
+		inline size_t inflateUpTo(const size_t end)
+		{
+			if (const size_t inflated=m_inflated.load(); inflated>=end)
+				return inflated;
+
+			std::unique_lock lock(m_mutex);
+			size_t inflated = m_inflated.load();
+			while (m_streamOpen && inflated<end)
+			{
+				m_stream.avail_out = (uInt)std::min(std::max(end-inflated,MinInflateSize),m_size-inflated);
+				const int err = inflate(&m_stream,Z_SYNC_FLUSH);
+				const size_t produced = reinterpret_cast<std::byte*>(m_stream.next_out)-m_buffer;
+				// corrupt, truncated or simply done, either way there's nothing more coming out of the stream
+				if (err!=Z_OK || produced==inflated)
+				{
+					inflateEnd(&m_stream);
+					m_streamOpen = false;
+				}
+				inflated = produced;
+				m_inflated.store(inflated);
+			}
+			return inflated;
+		}
+
+		// keeps the mapping of compressed data alive
+		const core::smart_refctd_ptr<IFile> m_archiveFile;
+		const size_t m_size;
+		std::byte* m_buffer = nullptr;
+		std::mutex m_mutex;
+		z_stream m_stream = {};
+		bool m_streamOpen = false;
+		std::atomic<size_t> m_inflated = 0ull;
+};
+}
+#endif
+
+core::smart_refctd_ptr<IFile> CArchiveLoaderZip::CArchive::getFile_impl(const IFileArchive::SFileList::found_t& found, const core::bitflag<IFile::E_CREATE_FLAGS> flags, const std::string_view& password)
+{
+#ifdef _NBL_COMPILE_WITH_ZLIB_
+	const auto& header = m_itemsMetadata[found->ID];
+	const bool isStreamable = header.CompressionMethod==8 && !(header.GeneralBitFlag&ZIP_FILE_ENCRYPTED);
+	// an entry which is already resident is cheaper to hand out from the cache
+	if (isStreamable && found->size>=StreamingThreshold && !flags.hasFlags(IFile::ECF_MAPPABLE) && !m_cache.contains(found->ID))
+	{
+		return core::make_smart_refctd_ptr<CInflatingFile>(
+			getDefaultAbsolutePath()/found->pathRelativeToArchive,flags,core::smart_refctd_ptr(m_file),
+			getCompressedData(found),header.DataDescriptor.CompressedSize,found->size
+		);
+	}
+#endif
+	return CFileArchive::getFile_impl(found,flags,password);
+}
+
+CFileArchive::file_buffer_t CArchiveLoaderZip::CArchive::getFileBuffer(const IFileArchive::SFileList::found_t& item)
+{
+	// stored entries are served straight from the archive's mapping
+	if (item->allocatorType!=IFileArchive::EAT_BORROWED)
+	{
+		const auto buffer = decompress(item);
+		return {buffer.data,buffer.size,nullptr};
+	}
+	const auto buffer = getCachedBuffer(item);
+	return {buffer.data,buffer.size,static_cast<CBorrowedBufferAllocator::IOwner*>(&m_cache)};
+}
+
+CArchiveLoaderZip::CEntryCache::SBuffer CArchiveLoaderZip::CArchive::getCachedBuffer(const IFileArchive::SFileList::found_t& item)
+{
+	if (const auto resident=m_cache.acquire(item->ID); resident.data)
+		return resident;
+	// decompress without holding any lock, so different entries inflate in parallel
+	const auto buffer = decompress(item);
+	if (!buffer.data)
+		return buffer;
+	return m_cache.insert(item->ID,buffer);
+}
+
+void CArchiveLoaderZip::CArchive::prefetch(std::span<const path> pathsRelativeToArchive)
+{
+	core::CTaskScheduler::getDefault()->parallel_for(pathsRelativeToArchive.size(),[&](const size_t i)->void
+	{
+		const auto item = getItemFromPath(pathsRelativeToArchive[i]);
+		// prefetching something the cache can't hold would only evict other entries
+		if (!item || item->allocatorType!=IFileArchive::EAT_BORROWED || item->size>m_cache.getBudget())
+			return;
+		// leave it resident but unpinned, opening the file will pin it again
+		if (const auto buffer=getCachedBuffer(item); buffer.data)
+			m_cache.release(buffer.data);
+	},0u,1u);
+}
+
 
 #ifdef _NBL_COMPILE_WITH_LZMA_
 //! Used for LZMA decompression. The lib has no default memory management
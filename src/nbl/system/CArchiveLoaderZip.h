@@ -33,6 +33,58 @@ class CArchiveLoaderZip final : public IArchiveLoader
 			// extra field (variable size )
 		} PACK_STRUCT;
 		#include "nbl/nblunpack.h"
+		//! Keeps decompressed entries resident after the last `IFile` over them dies, up to a byte budget
+		/** Entries which are in use are pinned and never evicted, the rest get evicted least recently used first.
+		The lock is only held for bookkeeping, never while decompressing. */
+		class CEntryCache final : public CBorrowedBufferAllocator::IOwner
+		{
+			public:
+				struct SBuffer
+				{
+					void* data = nullptr;
+					size_t size = 0ull;
+					// 0 if the memory is not ours (e.g. stored entries pointing into the archive's mapping)
+					size_t allocationSize = 0ull;
+				};
+
+				inline CEntryCache(const size_t entryCount, const size_t budget) : m_entries(entryCount), m_budget(budget) {}
+				~CEntryCache();
+
+				inline size_t getBudget() const {return m_budget;}
+
+				inline bool contains(const uint32_t entryID)
+				{
+					std::unique_lock lock(m_mutex);
+					return m_entries[entryID].buffer.data;
+				}
+
+				//! Returns a pinned buffer, or an empty one if the entry is not resident
+				SBuffer acquire(const uint32_t entryID);
+				//! Takes ownership of a freshly decompressed `buffer` and returns it pinned,
+				//! if somebody else has inserted the entry in the meantime `buffer` is freed and theirs returned instead
+				SBuffer insert(const uint32_t entryID, const SBuffer& buffer);
+				//! Unpins
+				void release(void* data) override;
+
+			private:
+				struct SEntry
+				{
+					SBuffer buffer;
+					uint32_t pinCount = 0u;
+					core::list<uint32_t>::iterator lruIt;
+				};
+				// needs to be called with the lock held, returns what needs freeing after the lock is dropped
+				core::vector<SBuffer> evict();
+				static void deallocate(const core::vector<SBuffer>& buffers);
+
+				std::mutex m_mutex;
+				core::vector<SEntry> m_entries;
+				core::unordered_map<const void*,uint32_t> m_entryOfBuffer;
+				// unpinned resident entries, front is least recently used
+				core::list<uint32_t> m_lru;
+				const size_t m_budget;
+				size_t m_residentSize = 0ull;
+		};
 		class CArchive final : public CFileArchive
 		{
 			public:
@@ -40,20 +92,42 @@ class CArchiveLoaderZip final : public IArchiveLoader
 					core::smart_refctd_ptr<IFile>&& _file,
 					system::logger_opt_smart_ptr&& logger,
 					std::shared_ptr<core::vector<IFileArchive::SFileList::SEntry>> _items,
-					core::vector<SZIPFileHeader>&& _itemsMetadata
+					core::vector<SZIPFileHeader>&& _itemsMetadata,
+					const size_t cacheBudget
 				) : CFileArchive(path(_file->getFileName()),std::move(logger),_items),
-					m_file(std::move(_file)), m_itemsMetadata(std::move(_itemsMetadata)), m_password("")
+					m_file(std::move(_file)), m_itemsMetadata(std::move(_itemsMetadata)), m_password(""),
+					m_cache(m_itemsMetadata.size(),cacheBudget)
 				{}
 
+				//! Decompresses the entries into the cache using all threads of the default `core::CTaskScheduler`
+				void prefetch(std::span<const path> pathsRelativeToArchive) override;
+
 			private:
+				core::smart_refctd_ptr<IFile> getFile_impl(const IFileArchive::SFileList::found_t& found, const core::bitflag<IFile::E_CREATE_FLAGS> flags, const std::string_view& password) override;
 				file_buffer_t getFileBuffer(const IFileArchive::SFileList::found_t& item) override;
+				// returns a buffer allocated with `VirtualMemoryAllocator` unless the entry is stored uncompressed
+				CEntryCache::SBuffer decompress(const IFileArchive::SFileList::found_t& item);
+				// pinned, decompresses only if the entry is not resident
+				CEntryCache::SBuffer getCachedBuffer(const IFileArchive::SFileList::found_t& item);
+				//
+				inline const std::byte* getCompressedData(const IFileArchive::SFileList::found_t& item) const
+				{
+					const IFile* cFile = m_file.get();
+					return reinterpret_cast<const std::byte*>(cFile->getMappedPointer())+item->offset;
+				}
 
 				core::smart_refctd_ptr<IFile> m_file;
 				core::vector<SZIPFileHeader> m_itemsMetadata;
 				const std::string m_password; // TODO password
+				CEntryCache m_cache;
 		};
 
-		CArchiveLoaderZip(system::logger_opt_smart_ptr&& logger) : IArchiveLoader(std::move(logger)) {}
+		//! Deflated entries at least this large get inflated on demand as they're read, unless the file is requested as `ECF_MAPPABLE`
+		static inline constexpr size_t StreamingThreshold = 0x1u<<25u;
+
+		//! `decompressedCacheBudget` bounds the decompressed entries each archive keeps around once they're no longer open
+		CArchiveLoaderZip(system::logger_opt_smart_ptr&& logger, const size_t decompressedCacheBudget=0x1ull<<28u) :
+			IArchiveLoader(std::move(logger)), m_decompressedCacheBudget(decompressedCacheBudget) {}
 
 		inline bool isALoadableFileFormat(IFile* file) const override
 		{
@@ -75,6 +149,8 @@ class CArchiveLoaderZip final : public IArchiveLoader
 
 	private:
 		core::smart_refctd_ptr<IFileArchive> createArchive_impl(core::smart_refctd_ptr<system::IFile>&& file, const std::string_view& password) const override;
+
+		const size_t m_decompressedCacheBudget;
 };
 
 }
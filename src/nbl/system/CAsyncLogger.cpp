@@ -0,0 +1,166 @@
+#include "nbl/system/CAsyncLogger.h"
+
+#include <exception>
+#include <mutex>
+
+using namespace nbl;
+using namespace nbl::system;
+
+namespace
+{
+// every live logger, so that `flushAll` can be called from a crash handler
+std::mutex g_registryMutex;
+core::vector<CAsyncLogger*> g_registry;
+std::terminate_handler g_prevTerminateHandler = nullptr;
+
+void flushingTerminateHandler()
+{
+	CAsyncLogger::flushAll();
+	if (g_prevTerminateHandler)
+		g_prevTerminateHandler();
+	std::abort();
+}
+}
+
+CAsyncLogger::CAsyncLogger(SCreationParams&& params, const core::bitflag<E_LOG_LEVEL> logLevelMask)
+	: ILogger(params.sink ? (logLevelMask&params.sink->getLogLevelMask()):core::bitflag<E_LOG_LEVEL>(ELL_NONE)),
+	m_sink(std::move(params.sink)), m_overflowPolicy(params.overflowPolicy), m_sampleRate(core::max(params.sampleRate,1u)),
+	m_slots(core::roundUpToPoT(core::max(params.queueCapacity,2u)))
+{
+	m_mask = m_slots.size()-1ull;
+	for (uint64_t i=0ull; i<m_slots.size(); i++)
+		m_slots[i].sequence.store(i,std::memory_order_relaxed);
+	m_thread = std::thread(&CAsyncLogger::drain,this);
+
+	std::unique_lock lock(g_registryMutex);
+	g_registry.push_back(this);
+	static std::once_flag installTerminateHandler;
+	if (params.flushOnTerminate)
+		std::call_once(installTerminateHandler,[](){g_prevTerminateHandler = std::set_terminate(flushingTerminateHandler);});
+}
+
+CAsyncLogger::~CAsyncLogger()
+{
+	{
+		std::unique_lock lock(g_registryMutex);
+		g_registry.erase(std::find(g_registry.begin(),g_registry.end(),this));
+	}
+	m_quit.store(true);
+	m_published.fetch_add(1ull);
+	m_published.notify_one();
+	m_thread.join();
+}
+
+void CAsyncLogger::flush()
+{
+	// the sink might log back into us from the background thread, which would wait on itself
+	if (std::this_thread::get_id()==m_thread.get_id())
+		return;
+	const uint64_t target = m_enqueuePos.load();
+	for (uint64_t pos=m_dequeuePos.load(); pos<target; pos=m_dequeuePos.load())
+	{
+		m_waiters.fetch_add(1u);
+		m_dequeuePos.wait(pos);
+		m_waiters.fetch_sub(1u);
+	}
+}
+
+void CAsyncLogger::flushAll()
+{
+	std::unique_lock lock(g_registryMutex);
+	for (auto* logger : g_registry)
+		logger->flush();
+}
+
+void CAsyncLogger::log_impl(const std::string_view& fmtString, E_LOG_LEVEL logLevel, va_list args)
+{
+	// format into a per-thread buffer, so the queue slot gets held for just a copy
+	thread_local std::string buffer;
+	va_list sizeArgs;
+	va_copy(sizeArgs,args);
+	const int size = vsnprintf(nullptr,0,fmtString.data(),sizeArgs);
+	va_end(sizeArgs);
+	if (size<0)
+		return;
+	buffer.resize(size);
+	vsnprintf(buffer.data(),size+1ull,fmtString.data(),args);
+
+	if (tryEnqueue(buffer,logLevel))
+		return;
+	bool wait = m_overflowPolicy==EOP_BLOCK || logLevel==ELL_ERROR;
+	if (m_overflowPolicy==EOP_SAMPLE)
+		wait = wait || (m_overflows.fetch_add(1u,std::memory_order_relaxed)%m_sampleRate)==0u;
+	if (wait)
+		enqueueBlocking(buffer,logLevel);
+	else
+		m_dropped.fetch_add(1u,std::memory_order_relaxed);
+}
+
+bool CAsyncLogger::tryEnqueue(const std::string_view& text, const E_LOG_LEVEL logLevel)
+{
+	uint64_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+	SSlot* slot;
+	while (true)
+	{
+		slot = m_slots.data()+(pos&m_mask);
+		const int64_t diff = static_cast<int64_t>(slot->sequence.load(std::memory_order_acquire)-pos);
+		if (diff==0ll)
+		{
+			if (m_enqueuePos.compare_exchange_weak(pos,pos+1ull,std::memory_order_relaxed))
+				break;
+		}
+		else if (diff<0ll) // the background thread hasn't gotten to this slot since it was last written
+			return false;
+		else
+			pos = m_enqueuePos.load(std::memory_order_relaxed);
+	}
+	slot->level = logLevel;
+	slot->text.assign(text);
+	slot->sequence.store(pos+1ull,std::memory_order_release);
+
+	m_published.fetch_add(1ull,std::memory_order_release);
+	m_published.notify_one();
+	return true;
+}
+
+void CAsyncLogger::enqueueBlocking(const std::string_view& text, const E_LOG_LEVEL logLevel)
+{
+	m_waiters.fetch_add(1u);
+	while (true)
+	{
+		// load before trying, so that if the background thread advances in between we don't sleep
+		const uint64_t dequeuePos = m_dequeuePos.load();
+		if (tryEnqueue(text,logLevel))
+			break;
+		m_dequeuePos.wait(dequeuePos);
+	}
+	m_waiters.fetch_sub(1u);
+}
+
+void CAsyncLogger::drain()
+{
+	uint64_t pos = 0ull;
+	while (true)
+	{
+		const uint64_t published = m_published.load(std::memory_order_acquire);
+		const bool quit = m_quit.load();
+
+		for (SSlot* slot=m_slots.data()+(pos&m_mask); slot->sequence.load(std::memory_order_acquire)==pos+1ull; slot=m_slots.data()+(pos&m_mask))
+		{
+			m_sink->log("%s",slot->level,slot->text.c_str());
+			slot->sequence.store(pos+m_mask+1ull,std::memory_order_release);
+			pos++;
+		}
+		if (const uint32_t dropped=m_dropped.exchange(0u,std::memory_order_relaxed))
+			m_sink->log("CAsyncLogger queue overflowed, %u messages were dropped!",ELL_WARNING,dropped);
+
+		m_dequeuePos.store(pos);
+		if (m_waiters.load())
+			m_dequeuePos.notify_all();
+
+		// by the time we got told to quit nobody can log anymore, so the above was the last drain
+		if (quit)
+			break;
+		m_published.wait(published,std::memory_order_acquire);
+	}
+}
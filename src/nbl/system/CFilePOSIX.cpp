@@ -26,15 +26,16 @@ CFilePOSIX::~CFilePOSIX()
 	close(m_native);
 }
 
+// positional I/O, because requests for the same file may execute concurrently
 size_t CFilePOSIX::asyncRead(void* buffer, size_t offset, size_t sizeToRead)
 {
-	lseek(m_native, offset, SEEK_SET);
-	return ::read(m_native, buffer, sizeToRead);
+	const ssize_t retval = ::pread(m_native, buffer, sizeToRead, offset);
+	return retval>0 ? static_cast<size_t>(retval):0ull;
 }
 
 size_t CFilePOSIX::asyncWrite(const void* buffer, size_t offset, size_t sizeToWrite)
 {
-	lseek(m_native, offset, SEEK_SET);
-	return ::write(m_native, buffer, sizeToWrite);
+	const ssize_t retval = ::pwrite(m_native, buffer, sizeToWrite, offset);
+	return retval>0 ? static_cast<size_t>(retval):0ull;
 }
 #endif
\ No newline at end of file
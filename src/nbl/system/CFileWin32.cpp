@@ -33,18 +33,25 @@ CFileWin32::~CFileWin32()
 	CloseHandle(m_native);
 }
 
+// the offset goes through the OVERLAPPED struct instead of the shared file pointer, because requests for the same file may execute concurrently
 size_t CFileWin32::asyncRead(void* buffer, size_t offset, size_t sizeToRead)
 {
-	seek(offset);
-	DWORD numOfBytesRead;
-	ReadFile(m_native, buffer, sizeToRead, &numOfBytesRead, nullptr);
+	OVERLAPPED overlapped = {};
+	overlapped.Offset = LODWORD(offset);
+	overlapped.OffsetHigh = HIDWORD(offset);
+	DWORD numOfBytesRead = 0u;
+	if (!ReadFile(m_native, buffer, sizeToRead, &numOfBytesRead, &overlapped))
+		return 0ull;
 	return numOfBytesRead;
 }
 size_t CFileWin32::asyncWrite(const void* buffer, size_t offset, size_t sizeToWrite)
 {
-	seek(offset);
-	DWORD numOfBytesWritten;
-	WriteFile(m_native, buffer, sizeToWrite, &numOfBytesWritten, nullptr);
+	OVERLAPPED overlapped = {};
+	overlapped.Offset = LODWORD(offset);
+	overlapped.OffsetHigh = HIDWORD(offset);
+	DWORD numOfBytesWritten = 0u;
+	if (!WriteFile(m_native, buffer, sizeToWrite, &numOfBytesWritten, &overlapped))
+		return 0ull;
 	return numOfBytesWritten;
 }
 
@@ -0,0 +1,248 @@
+#include "nbl/system/CIOBackendURing.h"
+
+#ifdef _NBL_PLATFORM_LINUX_
+#include "nbl/system/CFilePOSIX.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+using namespace nbl;
+using namespace nbl::system;
+
+namespace
+{
+int io_uring_setup(const uint32_t entries, io_uring_params* params)
+{
+	return static_cast<int>(syscall(__NR_io_uring_setup,entries,params));
+}
+int io_uring_enter(const int fd, const uint32_t toSubmit, const uint32_t minComplete, const uint32_t flags)
+{
+	return static_cast<int>(syscall(__NR_io_uring_enter,fd,toSubmit,minComplete,flags,nullptr,0ull));
+}
+int io_uring_register(const int fd, const uint32_t opcode, void* arg, const uint32_t argCount)
+{
+	return static_cast<int>(syscall(__NR_io_uring_register,fd,opcode,arg,argCount));
+}
+
+// the features don't tell whether the plain read/write opcodes exist (5.6+), on 5.5 they'd complete with -EINVAL
+bool supportsRequiredOpcodes(const int fd)
+{
+	constexpr uint32_t MaxOpCount = 256u;
+	// the kernel rejects a probe which isn't zeroed, also fails on kernels older than 5.6 since the probe itself is that new
+	core::vector<uint8_t> storage(sizeof(io_uring_probe)+MaxOpCount*sizeof(io_uring_probe_op),0u);
+	auto* const probe = reinterpret_cast<io_uring_probe*>(storage.data());
+	if (io_uring_register(fd,IORING_REGISTER_PROBE,probe,MaxOpCount)<0)
+		return false;
+	for (const uint8_t opcode : {IORING_OP_NOP,IORING_OP_READ,IORING_OP_WRITE})
+	if (opcode>probe->last_op || !(probe->ops[opcode].flags&IO_URING_OP_SUPPORTED))
+		return false;
+	return true;
+}
+
+// the kernel updates the ring indices concurrently with us
+inline uint32_t load_acquire(uint32_t* ptr)
+{
+	return std::atomic_ref<uint32_t>(*ptr).load(std::memory_order_acquire);
+}
+inline void store_release(uint32_t* ptr, const uint32_t value)
+{
+	std::atomic_ref<uint32_t>(*ptr).store(value,std::memory_order_release);
+}
+
+// a single read or write syscall never transfers more than this on Linux
+constexpr size_t MaxTransferSize = 0x7ffff000ull;
+}
+
+core::smart_refctd_ptr<CIOBackendURing> CIOBackendURing::create(logger_opt_smart_ptr&& logger, const uint32_t queueDepth)
+{
+	io_uring_params params = {};
+	SRing ring;
+	ring.fd = io_uring_setup(queueDepth,&params);
+	if (ring.fd<0)
+		return nullptr;
+
+	auto fail = [&ring]() -> core::smart_refctd_ptr<CIOBackendURing>
+	{
+		if (ring.sqes)
+			munmap(ring.sqes,ring.sqesSize);
+		if (ring.ringPtr)
+			munmap(ring.ringPtr,ring.ringSize);
+		close(ring.fd);
+		return nullptr;
+	};
+	// single mmap for both rings and no dropped completions are 5.4/5.5 features, older kernels get the worker pool
+	constexpr uint32_t RequiredFeatures = IORING_FEAT_SINGLE_MMAP|IORING_FEAT_NODROP;
+	if ((params.features&RequiredFeatures)!=RequiredFeatures || !supportsRequiredOpcodes(ring.fd))
+		return fail();
+
+	ring.ringSize = core::max<size_t>(params.sq_off.array+params.sq_entries*sizeof(uint32_t),params.cq_off.cqes+params.cq_entries*sizeof(io_uring_cqe));
+	void* ringPtr = mmap(nullptr,ring.ringSize,PROT_READ|PROT_WRITE,MAP_SHARED|MAP_POPULATE,ring.fd,IORING_OFF_SQ_RING);
+	if (ringPtr==MAP_FAILED)
+		return fail();
+	ring.ringPtr = ringPtr;
+	ring.sqesSize = params.sq_entries*sizeof(io_uring_sqe);
+	void* sqes = mmap(nullptr,ring.sqesSize,PROT_READ|PROT_WRITE,MAP_SHARED|MAP_POPULATE,ring.fd,IORING_OFF_SQES);
+	if (sqes==MAP_FAILED)
+		return fail();
+	ring.sqes = reinterpret_cast<io_uring_sqe*>(sqes);
+
+	auto* const base = reinterpret_cast<uint8_t*>(ringPtr);
+	ring.sqHead = reinterpret_cast<uint32_t*>(base+params.sq_off.head);
+	ring.sqTail = reinterpret_cast<uint32_t*>(base+params.sq_off.tail);
+	ring.sqArray = reinterpret_cast<uint32_t*>(base+params.sq_off.array);
+	ring.sqMask = *reinterpret_cast<uint32_t*>(base+params.sq_off.ring_mask);
+	ring.sqEntries = params.sq_entries;
+	ring.cqHead = reinterpret_cast<uint32_t*>(base+params.cq_off.head);
+	ring.cqTail = reinterpret_cast<uint32_t*>(base+params.cq_off.tail);
+	ring.cqes = reinterpret_cast<io_uring_cqe*>(base+params.cq_off.cqes);
+	ring.cqMask = *reinterpret_cast<uint32_t*>(base+params.cq_off.ring_mask);
+
+	return core::smart_refctd_ptr<CIOBackendURing>(new CIOBackendURing(ring,std::move(logger)),core::dont_grab);
+}
+
+CIOBackendURing::CIOBackendURing(const SRing& ring, logger_opt_smart_ptr&& logger) : m_ring(ring), m_logger(std::move(logger)), m_sqTail(*ring.sqTail),
+	m_slots(ring.sqEntries), m_freeSlots(ring.sqEntries)
+{
+	// never more requests in flight than SQ entries, the CQ is at least twice as large so it can't overflow
+	for (uint32_t i=0u; i<m_ring.sqEntries; i++)
+		m_freeSlots[i] = m_ring.sqEntries-1u-i;
+	m_completionThread = std::thread(&CIOBackendURing::reap,this);
+}
+
+CIOBackendURing::~CIOBackendURing()
+{
+	// the queue thread is gone by now, so we're the only submitter
+	flush();
+	{
+		std::unique_lock lock(m_slotMutex);
+		m_slotCvar.wait(lock,[this](){return m_freeSlots.size()==m_slots.size();});
+	}
+	pushSQE(IORING_OP_NOP,-1,nullptr,0u,0ull,0ull);
+	flush();
+	m_completionThread.join();
+
+	munmap(m_ring.sqes,m_ring.sqesSize);
+	munmap(m_ring.ringPtr,m_ring.ringSize);
+	close(m_ring.fd);
+}
+
+void CIOBackendURing::submit(const SRequest& request, const bool lastInBatch)
+{
+	auto* const file = dynamic_cast<CFilePOSIX*>(request.file);
+	if (file && request.size)
+	{
+		const uint32_t slot = acquireSlot();
+		m_slots[slot] = request;
+		const uint32_t size = static_cast<uint32_t>(core::min(request.size,MaxTransferSize));
+		pushSQE(request.write ? IORING_OP_WRITE:IORING_OP_READ,file->getNativeHandle(),request.buffer,size,request.offset,slot+1ull);
+	}
+	else // not backed by a file descriptor (or nothing to transfer), just do it on the queue thread
+		complete(request,execute(request));
+
+	if (lastInBatch || m_unsubmitted==m_ring.sqEntries)
+		flush();
+}
+
+uint32_t CIOBackendURing::acquireSlot()
+{
+	std::unique_lock lock(m_slotMutex);
+	if (m_freeSlots.empty())
+	{
+		// whatever is still sitting in the SQ needs to be submitted before we wait, or nothing will ever complete
+		lock.unlock();
+		flush();
+		lock.lock();
+		m_slotCvar.wait(lock,[this](){return !m_freeSlots.empty();});
+	}
+	const uint32_t slot = m_freeSlots.back();
+	m_freeSlots.pop_back();
+	return slot;
+}
+
+void CIOBackendURing::pushSQE(const uint8_t opcode, const int fd, void* buffer, const uint32_t size, const uint64_t offset, const uint64_t userData)
+{
+	const uint32_t index = m_sqTail&m_ring.sqMask;
+	io_uring_sqe& sqe = m_ring.sqes[index];
+	sqe = {};
+	sqe.opcode = opcode;
+	sqe.fd = fd;
+	sqe.addr = reinterpret_cast<uint64_t>(buffer);
+	sqe.len = size;
+	sqe.off = offset;
+	sqe.user_data = userData;
+	m_ring.sqArray[index] = index;
+	store_release(m_ring.sqTail,++m_sqTail);
+	m_unsubmitted++;
+}
+
+void CIOBackendURing::flush()
+{
+	while (m_unsubmitted)
+	{
+		const int submitted = io_uring_enter(m_ring.fd,m_unsubmitted,0u,0u);
+		if (submitted<0)
+		{
+			// out of kernel resources or interrupted, give the completion thread a chance to drain and retry
+			if (errno==EINTR || errno==EAGAIN || errno==EBUSY)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+			assert(false);
+			break;
+		}
+		m_unsubmitted -= static_cast<uint32_t>(submitted);
+	}
+}
+
+void CIOBackendURing::reap()
+{
+	bool quit = false;
+	while (!quit)
+	{
+		if (io_uring_enter(m_ring.fd,0u,1u,IORING_ENTER_GETEVENTS)<0 && errno!=EINTR)
+			std::this_thread::yield();
+
+		uint32_t head = *m_ring.cqHead;
+		const uint32_t tail = load_acquire(m_ring.cqTail);
+		for (; head!=tail; head++)
+		{
+			const io_uring_cqe& cqe = m_ring.cqes[head&m_ring.cqMask];
+			if (cqe.user_data==0ull)
+			{
+				quit = true;
+				continue;
+			}
+			const uint32_t slot = static_cast<uint32_t>(cqe.user_data-1ull);
+			const SRequest request = m_slots[slot];
+			{
+				std::unique_lock lock(m_slotMutex);
+				m_freeSlots.push_back(slot);
+			}
+			m_slotCvar.notify_one();
+			// the future only carries the byte count, so a failure would be indistinguishable from reading at EOF
+			const size_t requested = core::min(request.size,MaxTransferSize);
+			if (cqe.res<0)
+			{
+				m_logger.log("io_uring %s of %zu bytes at offset %zu of \"%s\" failed with %d (%s)",ILogger::ELL_ERROR,
+					request.write ? "write":"read",requested,request.offset,request.file->getFileName().string().c_str(),cqe.res,strerror(-cqe.res)
+				);
+			}
+			else if (request.write && static_cast<size_t>(cqe.res)<requested)
+			{
+				m_logger.log("io_uring write of %zu bytes at offset %zu of \"%s\" only wrote %d bytes",ILogger::ELL_WARNING,
+					requested,request.offset,request.file->getFileName().string().c_str(),cqe.res
+				);
+			}
+			complete(request,cqe.res>0 ? static_cast<size_t>(cqe.res):0ull);
+		}
+		store_release(m_ring.cqHead,head);
+	}
+}
+#endif
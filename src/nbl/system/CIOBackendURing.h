@@ -0,0 +1,82 @@
+#ifndef _NBL_SYSTEM_C_IO_BACKEND_URING_H_INCLUDED_
+#define _NBL_SYSTEM_C_IO_BACKEND_URING_H_INCLUDED_
+
+#include "nbl/core/declarations.h"
+#include "nbl/system/IIOBackend.h"
+#include "nbl/system/ILogger.h"
+
+#ifdef _NBL_PLATFORM_LINUX_
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace nbl::system
+{
+
+//! Linux backend, batches the requests into an io_uring submission queue and reaps their completions on a dedicated thread
+/*
+	Talks to the kernel through the raw syscalls so there's no dependency on liburing.
+	At most `queueDepth` requests are in flight, further submissions block the queue thread until a slot frees up.
+*/
+class CIOBackendURing final : public IIOBackend
+{
+	public:
+		//! Returns nullptr if the kernel lacks io_uring or the features we rely on, failed completions get reported to `logger`
+		static core::smart_refctd_ptr<CIOBackendURing> create(logger_opt_smart_ptr&& logger=nullptr, const uint32_t queueDepth=256u);
+
+		void submit(const SRequest& request, const bool lastInBatch) override;
+
+	protected:
+		~CIOBackendURing();
+
+	private:
+		struct SRing
+		{
+			int fd = -1;
+			void* ringPtr = nullptr;
+			size_t ringSize = 0ull;
+			io_uring_sqe* sqes = nullptr;
+			size_t sqesSize = 0ull;
+			// submission queue
+			uint32_t* sqHead = nullptr;
+			uint32_t* sqTail = nullptr;
+			uint32_t* sqArray = nullptr;
+			uint32_t sqMask = 0u;
+			uint32_t sqEntries = 0u;
+			// completion queue
+			uint32_t* cqHead = nullptr;
+			uint32_t* cqTail = nullptr;
+			io_uring_cqe* cqes = nullptr;
+			uint32_t cqMask = 0u;
+		};
+		CIOBackendURing(const SRing& ring, logger_opt_smart_ptr&& logger);
+
+		// queue thread only
+		uint32_t acquireSlot();
+		void pushSQE(const uint8_t opcode, const int fd, void* buffer, const uint32_t size, const uint64_t offset, const uint64_t userData);
+		void flush();
+
+		void reap();
+
+		SRing m_ring;
+		const logger_opt_smart_ptr m_logger;
+		// only the queue thread (or the destructor after it stopped) touches the submission queue tail
+		uint32_t m_sqTail;
+		uint32_t m_unsubmitted = 0u;
+
+		// `user_data` of an SQE is the slot index plus one, zero tells the completion thread to exit
+		core::vector<SRequest> m_slots;
+		std::mutex m_slotMutex;
+		std::condition_variable m_slotCvar;
+		core::vector<uint32_t> m_freeSlots;
+
+		std::thread m_completionThread;
+};
+
+}
+#endif
+
+#endif
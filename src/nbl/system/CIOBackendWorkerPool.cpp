@@ -0,0 +1,51 @@
+#include "nbl/system/CIOBackendWorkerPool.h"
+
+using namespace nbl;
+using namespace nbl::system;
+
+CIOBackendWorkerPool::CIOBackendWorkerPool(uint32_t threadCount)
+{
+	// storage latency rather than CPU is the bottleneck, so don't go below a handful of workers even on small machines
+	if (threadCount==0u)
+		threadCount = core::max(std::thread::hardware_concurrency(),4u);
+	m_threads.reserve(threadCount);
+	for (uint32_t i=0u; i<threadCount; i++)
+		m_threads.emplace_back(&CIOBackendWorkerPool::worker,this);
+}
+
+CIOBackendWorkerPool::~CIOBackendWorkerPool()
+{
+	{
+		std::unique_lock lock(m_mutex);
+		m_quit = true;
+	}
+	m_cvar.notify_all();
+	for (auto& thread : m_threads)
+		thread.join();
+}
+
+void CIOBackendWorkerPool::submit(const SRequest& request, const bool lastInBatch)
+{
+	{
+		std::unique_lock lock(m_mutex);
+		m_requests.push_back(request);
+	}
+	m_cvar.notify_one();
+}
+
+void CIOBackendWorkerPool::worker()
+{
+	std::unique_lock lock(m_mutex);
+	while (true)
+	{
+		m_cvar.wait(lock,[this](){return m_quit||!m_requests.empty();});
+		// every submitted request needs to be completed, so drain before quitting
+		if (m_requests.empty())
+			return;
+		const SRequest request = m_requests.front();
+		m_requests.pop_front();
+		lock.unlock();
+		complete(request,execute(request));
+		lock.lock();
+	}
+}
@@ -0,0 +1,38 @@
+#ifndef _NBL_SYSTEM_C_IO_BACKEND_WORKER_POOL_H_INCLUDED_
+#define _NBL_SYSTEM_C_IO_BACKEND_WORKER_POOL_H_INCLUDED_
+
+#include "nbl/core/declarations.h"
+#include "nbl/system/IIOBackend.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace nbl::system
+{
+
+//! Portable backend, a few threads doing blocking positional reads and writes so that independent requests overlap
+class CIOBackendWorkerPool final : public IIOBackend
+{
+	public:
+		//! 0 picks a count based on the hardware concurrency
+		CIOBackendWorkerPool(uint32_t threadCount=0u);
+
+		void submit(const SRequest& request, const bool lastInBatch) override;
+
+	protected:
+		~CIOBackendWorkerPool();
+
+	private:
+		void worker();
+
+		std::mutex m_mutex;
+		std::condition_variable m_cvar;
+		core::deque<SRequest> m_requests;
+		bool m_quit = false;
+		core::vector<std::thread> m_threads;
+};
+
+}
+
+#endif
@@ -11,10 +11,25 @@
 #include "nbl/system/CArchiveLoaderTar.h"
 #include "nbl/system/CMountDirectoryArchive.h"
 
+#include "nbl/system/CIOBackendWorkerPool.h"
+#ifdef _NBL_PLATFORM_LINUX_
+#include "nbl/system/CIOBackendURing.h"
+#endif
+
 using namespace nbl;
 using namespace nbl::system;
 
-ISystem::ISystem(core::smart_refctd_ptr<ISystem::ICaller>&& caller) : m_dispatcher(std::move(caller))
+static core::smart_refctd_ptr<IIOBackend> createIOBackend(logger_opt_smart_ptr&& logger)
+{
+    #ifdef _NBL_PLATFORM_LINUX_
+    // io_uring might be missing from the kernel or blocked by a sandbox
+    if (auto uring=CIOBackendURing::create(std::move(logger)))
+        return uring;
+    #endif
+    return core::make_smart_refctd_ptr<CIOBackendWorkerPool>();
+}
+
+ISystem::ISystem(core::smart_refctd_ptr<ISystem::ICaller>&& caller, logger_opt_smart_ptr&& logger) : m_dispatcher(std::move(caller),createIOBackend(std::move(logger)))
 {
     addArchiveLoader(core::make_smart_refctd_ptr<CArchiveLoaderZip>(nullptr));
     addArchiveLoader(core::make_smart_refctd_ptr<CArchiveLoaderTar>(nullptr));
@@ -89,16 +104,16 @@ core::vector<system::path> ISystem::listItemsInDirectory(const system::path& p)
     }
     else
     {
-        // check for part of subpath being an archive
-        auto path = std::filesystem::exists(p) ? std::filesystem::canonical(p):p;
-        // going up the directory tree
-        while (!path.empty() && path.parent_path()!=path)
+        // check for part of subpath being an archive, we know all the mount points so there's no need to go up the directory tree
+        const auto path = (std::filesystem::exists(p) ? std::filesystem::canonical(p):p).lexically_normal();
+        for (const auto& mount : m_cachedArchiveFiles)
         {
-            addArchiveItems(path,p);
-            const bool ex = std::filesystem::exists(path);
-            path = path.parent_path();
-            if (ex)
-                path = std::filesystem::canonical(path);
+            const auto relative = path.lexically_relative(mount.first);
+            if (relative.empty() || *relative.begin()=="..")
+                continue;
+            const auto assets = static_cast<IFileArchive::SFileList::range_t>(mount.second->listAssets(relative));
+            for (auto& item : assets)
+                res.push_back(mount.first/item.pathRelativeToArchive);
         }
     }
     return res;
@@ -182,11 +197,7 @@ bool ISystem::copy(const system::path& from, const system::path& to)
 
 void ISystem::createFile(future_t<core::smart_refctd_ptr<IFile>>& future, std::filesystem::path filename, const core::bitflag<IFileBase::E_CREATE_FLAGS> flags, const std::string_view& accessToken)
 {
-    // canonicalize
-    if (std::filesystem::exists(filename))
-        filename = std::filesystem::canonical(filename);
-
-    // try archives (readonly, for now)
+    // try archives (readonly, for now), before canonicalizing because the archive index lookup doesn't need to touch the filesystem
     if (!(flags.value&IFile::ECF_WRITE))
     {
         const auto found = findFileInArchive(filename);
@@ -203,7 +214,7 @@ void ISystem::createFile(future_t<core::smart_refctd_ptr<IFile>>& future, std::f
 
     //
     if (std::filesystem::exists(filename))
-        filename = std::filesystem::absolute(filename).generic_string();
+        filename = std::filesystem::canonical(filename).generic_string();
     if (filename.string().size()>=MAX_FILENAME_LENGTH)
     {
         future.set_result(nullptr);
@@ -244,35 +255,88 @@ core::smart_refctd_ptr<IFileArchive> ISystem::openFileArchive(core::smart_refctd
 
 ISystem::FoundArchiveFile ISystem::findFileInArchive(const system::path& absolutePath) const
 {
-    system::path path = std::filesystem::exists(absolutePath) ? std::filesystem::canonical(absolutePath.parent_path()):absolutePath.parent_path();
-    // going up the directory tree
-    while (!path.empty() && path.parent_path()!=path)
+    auto lookup = [this](const system::path& path) -> FoundArchiveFile
     {
-        path = std::filesystem::exists(path) ? std::filesystem::canonical(path):path;
-
-        const auto archives = m_cachedArchiveFiles.findRange(path);
-        for (auto& archive : archives)
+        const auto normalPath = path.lexically_normal();
+        const auto found = m_archiveFileIndex.find(normalPath.generic_string());
+        // an unindexed archive only wins over the indexed hit if it's mounted deeper (or at the same depth but earlier)
+        const uint32_t rankLimit = found!=m_archiveFileIndex.end() ? found->second.mountRank:~0u;
+        for (const auto& mount : m_unindexedArchives)
         {
-            const auto relative = std::filesystem::relative(absolutePath,path);
-            const auto items = static_cast<IFileArchive::SFileList::range_t>(archive.second->listAssets());
+            if (mount.mountRank>=rankLimit)
+                break;
+            const auto relative = normalPath.lexically_relative(mount.mountPoint);
+            if (relative.empty() || *relative.begin()=="..")
+                continue;
+            const auto items = static_cast<IFileArchive::SFileList::range_t>(mount.archive->listAssets());
 
             const IFileArchive::SFileList::SEntry itemToFind = { relative };
-            auto found = std::lower_bound(items.begin(), items.end(), itemToFind);
-            if (found!=items.end() && found->pathRelativeToArchive==relative)
-                return {archive.second.get(),relative};
+            const auto item = std::lower_bound(items.begin(), items.end(), itemToFind);
+            if (item!=items.end() && item->pathRelativeToArchive==relative)
+                return {mount.archive,relative};
         }
-        path = path.parent_path();
-    }
+        if (found!=m_archiveFileIndex.end())
+            return found->second.file;
+        return { nullptr,{} };
+    };
+    if (auto found=lookup(absolutePath); found.archive)
+        return found;
+    // a path through a symlink might still lead into a mounted directory, only now we have to ask the filesystem
+    std::error_code err;
+    const auto canonicalPath = std::filesystem::canonical(absolutePath,err);
+    if (!err && canonicalPath!=absolutePath)
+        return lookup(canonicalPath);
     return { nullptr,{} };
 }
 
+void ISystem::rebuildArchiveIndex()
+{
+    m_archiveFileIndex.clear();
+    m_unindexedArchives.clear();
+
+    // deeper mount points take precedence (like when going up the directory tree), a stable sort keeps the mounting order between equal depths
+    core::vector<std::pair<system::path,IFileArchive*>> mounts;
+    mounts.reserve(m_cachedArchiveFiles.getSize());
+    for (const auto& mount : m_cachedArchiveFiles)
+        mounts.emplace_back(mount.first.lexically_normal(),mount.second.get());
+    auto depth = [](const system::path& path) -> ptrdiff_t {return std::distance(path.begin(),path.end());};
+    std::stable_sort(mounts.begin(),mounts.end(),[&depth](const auto& lhs, const auto& rhs){return depth(lhs.first)>depth(rhs.first);});
 
-void ISystem::CAsyncQueue::process_request(base_t::future_base_t* _future_base, SRequestType& req)
+    for (uint32_t rank=0u; rank<mounts.size(); rank++)
+    {
+        const auto& mount = mounts[rank];
+        if (!mount.second->hasStaticListing())
+        {
+            m_unindexedArchives.push_back({mount.first,mount.second,rank});
+            continue;
+        }
+        const auto items = static_cast<IFileArchive::SFileList::range_t>(mount.second->listAssets());
+        for (const auto& item : items)
+            m_archiveFileIndex.try_emplace((mount.first/item.pathRelativeToArchive).lexically_normal().generic_string(),SIndexedArchiveFile{{mount.second,item.pathRelativeToArchive},rank});
+    }
+}
+
+
+bool ISystem::CAsyncQueue::process_request(base_t::future_base_t* _future_base, SRequestType& req)
 {
+    // don't kick the backend off while there are more requests right behind this one, so it can batch them up
+    const bool lastInBatch = base_t::backlog()<=1u;
+    if (const auto* read=std::get_if<SRequestParams_READ>(&req.params))
+    {
+        m_io->submit({read->file,read->buffer,read->offset,read->size,false,_future_base},lastInBatch);
+        return false;
+    }
+    if (const auto* write=std::get_if<SRequestParams_WRITE>(&req.params))
+    {
+        m_io->submit({write->file,const_cast<void*>(write->buffer),write->offset,write->size,true,_future_base},lastInBatch);
+        return false;
+    }
+
     std::visit([=](auto& visitor) {
         using retval_t = std::remove_reference_t<decltype(visitor)>::retval_t;
         visitor(base_t::future_storage_cast<retval_t>(_future_base),m_caller.get());
     }, req.params);
+    return true;
 }
 void ISystem::SRequestParams_CREATE_FILE::operator()(core::StorageTrivializer<retval_t>* retval, ICaller* _caller)
 {
@@ -287,6 +351,17 @@ void ISystem::SRequestParams_WRITE::operator()(core::StorageTrivializer<retval_t
     retval->construct(file->asyncWrite(buffer,offset,size));
 }
 
+void IIOBackend::complete(const SRequest& request, const size_t bytesTransferred)
+{
+    ISystem::CAsyncQueue::complete(request.future,bytesTransferred);
+}
+size_t IIOBackend::execute(const SRequest& request)
+{
+    if (request.write)
+        return request.file->asyncWrite(request.buffer,request.offset,request.size);
+    return request.file->asyncRead(request.buffer,request.offset,request.size);
+}
+
 bool ISystem::ICaller::invalidateMapping(IFile* file, size_t offset, size_t size)
 {
     const auto flags = file->getFlags();
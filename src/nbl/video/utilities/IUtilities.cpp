@@ -430,7 +430,7 @@ bool performCopyUsingImageFilter(
     state.inMipLevel = 0u;
     state.outMipLevel = 0u;
 
-    if (filter.execute(core::execution::par_unseq, &state))
+    if (filter.execute(core::CTaskScheduler::getDefault()->policy(), &state))
         return true;
     else
         return false;
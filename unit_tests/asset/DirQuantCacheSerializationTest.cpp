@@ -0,0 +1,97 @@
+// Copyright (C) 2018-2023 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+// Serializes partially filled direction quantization caches, so that most of their submaps are empty,
+// then checks that the dump validates, loads back into the same contents and that damaged dumps get rejected.
+#include "nbl/core/definitions.h"
+#include "nbl/asset/utils/CQuantNormalCache.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+using namespace nbl;
+
+namespace
+{
+
+constexpr auto CacheFormat = asset::EF_A2B10G10R10_SNORM_PACK32;
+
+core::smart_refctd_ptr<asset::ICPUBuffer> serialize(asset::CQuantNormalCache& cache)
+{
+	asset::SBufferRange<asset::ICPUBuffer> range;
+	range.offset = 0ull;
+	range.size = cache.getSerializedCacheSizeInBytes<CacheFormat>();
+	range.buffer = core::make_smart_refctd_ptr<asset::ICPUBuffer>(range.size);
+	if (!cache.saveCacheToBuffer<CacheFormat>(range))
+		return nullptr;
+	return std::move(range.buffer);
+}
+
+bool load(asset::CQuantNormalCache& cache, const core::smart_refctd_ptr<asset::ICPUBuffer>& buffer, const size_t size)
+{
+	asset::SBufferRange<const asset::ICPUBuffer> range;
+	range.offset = 0ull;
+	range.size = size;
+	range.buffer = buffer;
+	return cache.loadCacheFromBuffer<CacheFormat>(range,true);
+}
+
+bool test(const uint32_t normalCount)
+{
+	std::mt19937 rng(normalCount);
+	std::uniform_real_distribution<float> dist(-1.f,1.f);
+	asset::CQuantNormalCache original;
+	for (uint32_t i=0u; i<normalCount; i++)
+		original.quantize<CacheFormat>(core::vectorSIMDf(dist(rng),dist(rng),dist(rng)));
+
+	const auto dump = serialize(original);
+	if (!dump)
+	{
+		std::fprintf(stderr,"%u normals: failed to serialize\n",normalCount);
+		return false;
+	}
+	const size_t dumpSize = dump->getSize();
+
+	asset::CQuantNormalCache reloaded;
+	if (!load(reloaded,dump,dumpSize))
+	{
+		std::fprintf(stderr,"%u normals: valid dump got rejected\n",normalCount);
+		return false;
+	}
+	const auto redump = serialize(reloaded);
+	if (!redump || redump->getSize()!=dumpSize || memcmp(redump->getPointer(),dump->getPointer(),dumpSize)!=0)
+	{
+		std::fprintf(stderr,"%u normals: cache changed contents in the round trip\n",normalCount);
+		return false;
+	}
+
+	// a truncated dump and one with trailing garbage must both fail validation
+	asset::CQuantNormalCache scratch;
+	if (load(scratch,dump,dumpSize-1ull))
+	{
+		std::fprintf(stderr,"%u normals: truncated dump got accepted\n",normalCount);
+		return false;
+	}
+	const auto padded = core::make_smart_refctd_ptr<asset::ICPUBuffer>(dumpSize+sizeof(size_t));
+	memset(padded->getPointer(),0,padded->getSize());
+	memcpy(padded->getPointer(),dump->getPointer(),dumpSize);
+	if (load(scratch,padded,padded->getSize()))
+	{
+		std::fprintf(stderr,"%u normals: dump with trailing bytes got accepted\n",normalCount);
+		return false;
+	}
+	return true;
+}
+
+}
+
+int main()
+{
+	// no entries at all, a couple so that most submaps stay empty, and enough to fill every submap
+	for (const uint32_t normalCount : {0u,1u,3u,20u,5000u})
+	if (!test(normalCount))
+		return EXIT_FAILURE;
+	return EXIT_SUCCESS;
+}
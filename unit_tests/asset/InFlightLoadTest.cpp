@@ -0,0 +1,190 @@
+// Copyright (C) 2018-2023 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+// Loads the same path from nested `parallel_for` tasks while the loader itself waits on a task group,
+// so threads which hold the in-flight claim for the path pick up requests for it while helping out.
+// Then loads two files which reference each other from two threads, so each load requests the path the other one holds.
+#include "nbl/asset/IAssetManager.h"
+#include "nbl/system/CSystemLinux.h"
+#include "nbl/system/IApplicationFramework.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+using namespace nbl;
+
+namespace
+{
+
+class CSlowBufferLoader final : public asset::IAssetLoader
+{
+	public:
+		CSlowBufferLoader(core::CTaskScheduler* scheduler) : m_scheduler(scheduler) {}
+
+		bool isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger) const override {return _file->getFileName().extension()==".nbltest";}
+
+		const char** getAssociatedFileExtensions() const override
+		{
+			static const char* extensions[]{ "nbltest", nullptr };
+			return extensions;
+		}
+
+		uint64_t getSupportedAssetTypesBitfield() const override { return asset::IAsset::ET_BUFFER; }
+
+		asset::SAssetBundle loadAsset(system::IFile* _file, const asset::IAssetLoader::SAssetLoadParams& _params, asset::IAssetLoader::IAssetLoaderOverride* _override = nullptr, uint32_t _hierarchyLevel = 0u) override
+		{
+			loadCount++;
+			// the helping wait inside is what lets this thread run the tasks which request the same path
+			m_scheduler->parallel_for(16u,[](const size_t i)->void
+			{
+				std::this_thread::sleep_for(std::chrono::microseconds(200));
+			});
+			return asset::SAssetBundle(nullptr,{core::make_smart_refctd_ptr<asset::ICPUBuffer>(_file->getSize())});
+		}
+
+		std::atomic_uint32_t loadCount = 0u;
+
+	private:
+		core::CTaskScheduler* const m_scheduler;
+};
+
+// the file contains the path of the other file, which only gets requested by top-level loads
+class CCrossReferencingLoader final : public asset::IAssetLoader
+{
+	public:
+		CCrossReferencingLoader(asset::IAssetManager* manager) : m_manager(manager) {}
+
+		bool isALoadableFileFormat(system::IFile* _file, const system::logger_opt_ptr logger) const override {return _file->getFileName().extension()==".nbltestref";}
+
+		const char** getAssociatedFileExtensions() const override
+		{
+			static const char* extensions[]{ "nbltestref", nullptr };
+			return extensions;
+		}
+
+		uint64_t getSupportedAssetTypesBitfield() const override { return asset::IAsset::ET_BUFFER; }
+
+		asset::SAssetBundle loadAsset(system::IFile* _file, const asset::IAssetLoader::SAssetLoadParams& _params, asset::IAssetLoader::IAssetLoaderOverride* _override = nullptr, uint32_t _hierarchyLevel = 0u) override
+		{
+			if (_hierarchyLevel==0u)
+			{
+				// both loads need to hold their claims before either of them asks for the other file
+				startedCount++;
+				while (startedCount.load()<2u)
+					std::this_thread::yield();
+
+				std::string otherPath(_file->getSize(),'\0');
+				system::IFile::success_t success;
+				_file->read(success,otherPath.data(),0,otherPath.size());
+				if (!success)
+					return {};
+				// a task, so that the request can end up on a thread which doesn't hold any claim itself
+				asset::SAssetBundle other;
+				core::CTaskScheduler::CTaskGroup group(m_manager->getScheduler());
+				group.run([&]()->void
+				{
+					other = interm_getAssetInHierarchy(m_manager,otherPath,_params,_hierarchyLevel+1u,_override);
+				});
+				group.wait();
+				if (other.getContents().empty())
+					return {};
+			}
+			return asset::SAssetBundle(nullptr,{core::make_smart_refctd_ptr<asset::ICPUBuffer>(_file->getSize())});
+		}
+
+		std::atomic_uint32_t startedCount = 0u;
+
+	private:
+		asset::IAssetManager* const m_manager;
+};
+
+}
+
+int main()
+{
+#ifdef _NBL_PLATFORM_LINUX_
+	auto system = core::make_smart_refctd_ptr<system::CSystemLinux>();
+#else
+	auto system = system::IApplicationFramework::createSystem();
+#endif
+	if (!system)
+		return EXIT_FAILURE;
+
+	auto scheduler = core::make_smart_refctd_ptr<core::CTaskScheduler>(3u);
+	auto assetManager = core::make_smart_refctd_ptr<asset::IAssetManager>(core::smart_refctd_ptr(system),nullptr,core::smart_refctd_ptr(scheduler));
+	auto loader = core::make_smart_refctd_ptr<CSlowBufferLoader>(scheduler.get());
+	assetManager->addAssetLoader(core::smart_refctd_ptr(loader));
+	auto crossLoader = core::make_smart_refctd_ptr<CCrossReferencingLoader>(assetManager.get());
+	assetManager->addAssetLoader(core::smart_refctd_ptr(crossLoader));
+
+	// a deadlock would hang forever, fail instead
+	std::atomic_bool finished = false;
+	std::thread watchdog([&finished]()->void
+	{
+		for (auto i=0; i<600 && !finished.load(); i++)
+			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		if (!finished.load())
+		{
+			std::fprintf(stderr,"Nested loads deadlocked\n");
+			std::_Exit(EXIT_FAILURE);
+		}
+	});
+
+	constexpr uint32_t RoundCount = 8u;
+	bool success = true;
+	for (uint32_t round=0u; round<RoundCount && success; round++)
+	{
+		// a fresh path every round, so that the first requests miss the cache and go through the in-flight claims
+		const auto path = std::filesystem::temp_directory_path()/("nbl_in_flight_load_test_"+std::to_string(round)+".nbltest");
+		std::ofstream(path,std::ios::binary) << "0123456789abcdef";
+
+		std::atomic_uint32_t emptyBundles = 0u;
+		scheduler->parallel_for(8u,[&](const size_t i)->void
+		{
+			scheduler->parallel_for(8u,[&](const size_t j)->void
+			{
+				if (assetManager->getAsset(path.string(),{}).getContents().empty())
+					emptyBundles++;
+			});
+		});
+		success = emptyBundles.load()==0u;
+		std::filesystem::remove(path);
+	}
+	for (uint32_t round=0u; round<RoundCount && success; round++)
+	{
+		const auto tmpDir = std::filesystem::temp_directory_path();
+		const std::filesystem::path paths[2] = {
+			tmpDir/("nbl_in_flight_load_test_a"+std::to_string(round)+".nbltestref"),
+			tmpDir/("nbl_in_flight_load_test_b"+std::to_string(round)+".nbltestref")
+		};
+		std::ofstream(paths[0],std::ios::binary) << paths[1].string();
+		std::ofstream(paths[1],std::ios::binary) << paths[0].string();
+
+		crossLoader->startedCount = 0u;
+		std::atomic_uint32_t emptyBundles = 0u;
+		auto load = [&](const std::filesystem::path& path)->void
+		{
+			if (assetManager->getAsset(path.string(),{}).getContents().empty())
+				emptyBundles++;
+		};
+		std::thread first(load,paths[0]), second(load,paths[1]);
+		first.join();
+		second.join();
+		success = emptyBundles.load()==0u;
+		for (const auto& path : paths)
+			std::filesystem::remove(path);
+	}
+	finished = true;
+	watchdog.join();
+
+	if (!success)
+	{
+		std::fprintf(stderr,"Some of the loads failed\n");
+		return EXIT_FAILURE;
+	}
+	std::printf("%u loads for %u requests\n",loader->loadCount.load(),RoundCount*64u);
+	return EXIT_SUCCESS;
+}
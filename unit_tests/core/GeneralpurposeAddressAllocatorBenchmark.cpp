@@ -0,0 +1,128 @@
+// Copyright (C) 2018-2023 - DevSH Graphics Programming Sp. z O.O.
+// This file is part of the "Nabla Engine".
+// For conditions of distribution and use, see copyright notice in nabla.h
+
+// Times the strategies of `GeneralpurposeAddressAllocator` on the same fragmenting workload (thousands of live blocks,
+// mixed sizes and alignments, frees in random order) while checking every allocation against a reference map.
+// Pass the operation count as the first argument to run a longer benchmark than the default.
+#include "nbl/core/declarations.h"
+#include "nbl/core/definitions.h"
+#include "nbl/core/alloc/GeneralpurposeAddressAllocator.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+
+using namespace nbl;
+
+namespace
+{
+
+struct SResult
+{
+	double milliseconds;
+	size_t failedAllocs;
+	bool valid;
+};
+
+template<class AddressAlloc>
+SResult run(const uint32_t bufferSize, const uint32_t minBlockSize, const uint32_t opCount, const uint64_t seed)
+{
+	constexpr uint32_t MaxAlignment = 64u;
+	constexpr size_t TargetLiveBlocks = 4000ull;
+
+	void* reserved = _NBL_ALIGNED_MALLOC(AddressAlloc::reserved_size(MaxAlignment,bufferSize,minBlockSize),_NBL_SIMD_ALIGNMENT);
+	AddressAlloc alloc(reserved,0u,0u,MaxAlignment,bufferSize,minBlockSize);
+
+	SResult result = {0.0,0ull,true};
+	// the reference is only touched outside of the timed sections
+	std::map<uint32_t,uint32_t> reference;
+	core::vector<std::pair<uint32_t,uint32_t>> live;
+	double elapsed = 0.0;
+	auto timed = [&elapsed](auto&& f)
+	{
+		const auto start = std::chrono::high_resolution_clock::now();
+		const auto retval = f();
+		elapsed += std::chrono::duration<double,std::milli>(std::chrono::high_resolution_clock::now()-start).count();
+		return retval;
+	};
+
+	std::mt19937_64 rng(seed);
+	for (uint32_t op=0u; op<opCount && result.valid; op++)
+	{
+		const bool doAlloc = live.size()<TargetLiveBlocks ? (rng()%3ull!=0ull):(rng()%2ull==0ull);
+		if (doAlloc)
+		{
+			// mostly small blocks with an occasional large one, so the holes left behind vary a lot in size
+			const uint32_t size = 1u+static_cast<uint32_t>(rng()%(rng()%8ull==0ull ? 16384ull:1024ull));
+			const uint32_t alignment = 1u<<static_cast<uint32_t>(rng()%7ull);
+			const uint32_t addr = timed([&](){return alloc.alloc_addr(size,alignment);});
+			if (addr==AddressAlloc::invalid_address)
+			{
+				result.failedAllocs++;
+				continue;
+			}
+
+			const uint32_t reservedSize = core::max(size,minBlockSize);
+			auto next = reference.lower_bound(addr);
+			const bool overlapsNext = next!=reference.end() && next->first<addr+reservedSize;
+			const bool overlapsPrev = next!=reference.begin() && std::prev(next)->first+std::prev(next)->second>addr;
+			if (addr%alignment || addr+reservedSize>bufferSize || overlapsNext || overlapsPrev)
+			{
+				std::fprintf(stderr,"Bad allocation of %u bytes aligned to %u at %u\n",size,alignment,addr);
+				result.valid = false;
+			}
+			reference[addr] = reservedSize;
+			live.emplace_back(addr,size);
+		}
+		else if (!live.empty())
+		{
+			const size_t ix = rng()%live.size();
+			timed([&](){alloc.free_addr(live[ix].first,live[ix].second); return true;});
+			reference.erase(live[ix].first);
+			live[ix] = live.back();
+			live.pop_back();
+		}
+	}
+	for (const auto& block : live)
+		timed([&](){alloc.free_addr(block.first,block.second); return true;});
+
+	if (alloc.get_free_size()!=bufferSize)
+	{
+		std::fprintf(stderr,"%u bytes leaked\n",bufferSize-alloc.get_free_size());
+		result.valid = false;
+	}
+	result.milliseconds = elapsed;
+	_NBL_ALIGNED_FREE(reserved);
+	return result;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+	const uint32_t opCount = argc>1 ? static_cast<uint32_t>(std::strtoul(argv[1],nullptr,10)):200000u;
+	constexpr uint32_t BufferSize = 8u<<20u;
+
+	using tlsf_t = core::GeneralpurposeAddressAllocator<uint32_t,core::impl::GeneralpurposeAddressAllocatorTLSFStrategy<uint32_t>>;
+	using default_t = core::GeneralpurposeAddressAllocator<uint32_t>;
+	using best_fit_t = core::GeneralpurposeAddressAllocator<uint32_t,core::impl::GeneralpurposeAddressAllocatorStrategy<uint32_t,true>>;
+
+	bool success = true;
+	for (const uint32_t minBlockSize : {16u,64u})
+	{
+		std::printf("%u operations on %u bytes, minimum block size %u\n",opCount,BufferSize,minBlockSize);
+		auto report = [&](const char* name, const SResult& result)
+		{
+			std::printf("\t%-10s %10.2f ms %8zu failed allocations\n",name,result.milliseconds,result.failedAllocs);
+			success = success && result.valid;
+		};
+		constexpr uint64_t Seed = 0x45u;
+		report("TLSF",run<tlsf_t>(BufferSize,minBlockSize,opCount,Seed));
+		report("default",run<default_t>(BufferSize,minBlockSize,opCount,Seed));
+		report("best fit",run<best_fit_t>(BufferSize,minBlockSize,opCount,Seed));
+	}
+	return success ? EXIT_SUCCESS:EXIT_FAILURE;
+}